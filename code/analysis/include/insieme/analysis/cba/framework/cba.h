@@ -196,6 +196,28 @@ namespace cba {
 			return callSiteMgr;
 		}
 
+		/**
+		 * Selects the strategy utilized by the constraint solver for subsequent queries.
+		 */
+		void setSolverStrategy(Solver::Strategy strategy) {
+			solver.setStrategy(strategy);
+		}
+
+		Solver::Strategy getSolverStrategy() const {
+			return solver.getStrategy();
+		}
+
+		/**
+		 * Enables the collection of per-variable solver statistics, listed per analysis by plotStats.
+		 */
+		void setCollectSolverStats(bool collect) {
+			solver.setCollectVariableStats(collect);
+		}
+
+		const Solver::Stats& getSolverStats() const {
+			return solver.getStats();
+		}
+
 		// -- main entry point for running analysis --
 
 		template<typename A, typename Context = DefaultContext>
@@ -78,7 +78,11 @@ public:
 
 	typedef typename Base::direction_tag direction_tag;
 
+	typedef BitVectorRepresentationTag representation_tag;
+
 	typedef typename Base::value_type value_type;
+
+	typedef EntityIndex<access::AccessClassPtr> Index;
 	
 	LiveVariables(const CFG& cfg): Base(cfg), aMgr(&cfg, cfg.getTmpVarMap()) { }
 
@@ -101,6 +105,9 @@ public:
 
 	std::pair<value_type,value_type> transfer_func(const value_type& in, const cfg::BlockPtr& block) const;
 
+	void transfer_func(const Index::BitSet& in, const cfg::BlockPtr& block, Index& index,
+					   Index::BitSet& gen, Index::BitSet& kill) const;
+
 };
 
 } // end analyses namespace 
@@ -90,8 +90,13 @@ public:
 
 	typedef typename Base::direction_tag direction_tag;
 
+	// the meet is the set union, values are solved as bit-vectors
+	typedef BitVectorRepresentationTag representation_tag;
+
 	typedef typename Base::value_type value_type;
 
+	typedef EntityIndex<cfg::Address> Index;
+
 	ReachingDefinitions(const CFG& cfg): Base(cfg) { }
 
 	inline value_type init() const { return top(); }
@@ -110,6 +115,9 @@ public:
 
 	std::pair<value_type,value_type> transfer_func(const value_type& in, const cfg::BlockPtr& block) const;
 
+	void transfer_func(const Index::BitSet& in, const cfg::BlockPtr& block, Index& index,
+					   Index::BitSet& gen, Index::BitSet& kill) const;
+
 };
 
 /**
@@ -118,6 +126,12 @@ public:
  */
 void definitionsToAccesses(const typename ReachingDefinitions::value_type& data, insieme::analysis::access::AccessManager& mgr);
 
+/**
+ * Same as above for a set of definitions encoded as a bit-vector over the given index.
+ */
+void definitionsToAccesses(const ReachingDefinitions::Index::BitSet& data, const ReachingDefinitions::Index& index,
+						   insieme::analysis::access::AccessManager& mgr);
+
 
 } } } } // end insieme::analysis::dfa::analyses namespace 
 
@@ -37,6 +37,11 @@
 #pragma once
 
 #include <memory>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include "insieme/analysis/dfa/entity.h"
 #include "insieme/analysis/dfa/value.h"
@@ -57,6 +62,94 @@ struct ForwardAnalysisTag { };
 struct BackwardAnalysisTag { };
 // maybe bidirectional analysis
 
+// Defines how the solver represents the dataflow values of a problem
+struct GenericRepresentationTag { };
+
+/**
+ * Problems defined on the powerset of the extracted entities whose MEET operator is the set union
+ * can be solved on a dense representation: the solver numbers the entities once per CFG and
+ * stores the dataflow values as bit-vectors.
+ *
+ * Such problems provide a second transfer function operating on the bit-vectors directly:
+ *
+ *   void transfer_func(const BitSet& in, const cfg::BlockPtr& block, EntityIndex<T>& index,
+ *                      BitSet& gen, BitSet& kill) const;
+ *
+ * gen and kill are cleared by the solver before the call.
+ */
+struct BitVectorRepresentationTag { };
+
+/**
+ * Assigns a dense index to the entities of a dataflow problem.
+ *
+ * The index is seeded with the entities extracted from the CFG, entities which are only discovered
+ * while solving the problem are appended. Sets of entities are represented as bit-vectors over
+ * this index.
+ */
+template <class T>
+class EntityIndex {
+
+	std::map<T, size_t> index;
+
+	// the entities by their index, points to the keys of the index map
+	std::vector<const T*> entities;
+
+public:
+
+	typedef boost::dynamic_bitset<> BitSet;
+
+	template <class Container>
+	EntityIndex(const Container& universe) {
+		for(const auto& cur : universe) { insert(cur); }
+	}
+
+	/**
+	 * Returns the index of the given entity, the entity is added to the index if not present
+	 */
+	size_t insert(const T& entity) {
+		auto res = index.insert( { entity, entities.size() } );
+		if (res.second) { entities.push_back( &res.first->first ); }
+		return res.first->second;
+	}
+
+	size_t size() const { return entities.size(); }
+
+	const T& operator[](size_t idx) const {
+		assert_lt(idx, entities.size());
+		return *entities[idx];
+	}
+
+	/**
+	 * Extends the given bit-vector to cover all the entities currently in the index
+	 */
+	void fit(BitSet& bits) const {
+		if (bits.size() < size()) { bits.resize(size()); }
+	}
+
+	/**
+	 * Sets the bit of the given entity, the entity is added to the index if not present
+	 */
+	void add(BitSet& bits, const T& entity) {
+		size_t idx = insert(entity);
+		fit(bits);
+		bits.set(idx);
+	}
+
+	BitSet toBitSet(const std::set<T>& set) {
+		BitSet bits(size());
+		for(const auto& cur : set) { add(bits, cur); }
+		return bits;
+	}
+
+	std::set<T> toSet(const BitSet& bits) const {
+		std::set<T> ret;
+		for(size_t idx = bits.find_first(); idx != BitSet::npos; idx = bits.find_next(idx)) {
+			ret.insert( ret.end(), *entities[idx] );
+		}
+		return ret;
+	}
+};
+
 
 template <class Impl, class D, class E, template <class> class Cont>
 class Problem {
@@ -89,6 +182,8 @@ public:
 
 	typedef D direction_tag;
 
+	typedef GenericRepresentationTag representation_tag;
+
 
 	Problem(const CFG& cfg) : cfg(cfg)  { }
 
@@ -39,6 +39,11 @@
 #include <set>
 #include <queue>
 #include <map>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include "insieme/core/ir_expressions.h"
 #include "insieme/analysis/cfg.h"
@@ -91,6 +96,50 @@ public :
 
 };
 
+/**
+ * Worklist utilized by the bit-vector solver.
+ *
+ * Blocks are identified by their rank in the processing order (see getPostOrder()) and the block
+ * with the lowest rank is always dequeued first. Like for the WorklistQueue, a rank is never
+ * contained twice in the worklist.
+ */
+class PriorityWorklist {
+
+	std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> rank_queue;
+
+	// flags the ranks currently in the queue
+	std::vector<bool> queued;
+
+public:
+	PriorityWorklist(size_t size) : queued(size, false) { }
+
+	/**
+	 * Inserts the given rank unless it is already in the worklist
+	 */
+	void enqueue(size_t rank);
+
+	/**
+	 * Removes the lowest rank from the worklist and returns it
+	 *
+	 * Precondition: empty() is false
+	 */
+	size_t dequeue();
+
+	size_t size() const { return rank_queue.size(); }
+
+	bool empty() const { return rank_queue.empty(); }
+
+};
+
+/**
+ * Returns all the blocks of the CFG in depth-first postorder.
+ *
+ * The blocks reachable from the entry of the CFG are listed first, the remaining blocks follow in
+ * the postorder of the traversals started from them. Forward problems converge fastest when
+ * processing blocks in reverse postorder, backward problems when processing them in postorder.
+ */
+std::vector<cfg::BlockPtr> getPostOrder(const CFG& cfg);
+
 namespace detail {
 
 template<typename DirTag> 
@@ -199,6 +248,12 @@ protected:
 		return cfg.isExit(block) ? p.init() : p.top();
 	}
 
+	inline void processing_order(std::vector<cfg::BlockPtr>& blocks, ForwardAnalysisTag) const {
+		std::reverse(blocks.begin(), blocks.end());
+	}
+
+	inline void processing_order(std::vector<cfg::BlockPtr>& blocks, BackwardAnalysisTag) const { }
+
 public:
 
 	/**
@@ -211,7 +266,17 @@ public:
 	inline const Problem& getProblemInstance() const { return df_p; }
 	inline Problem& getProblemInstance() { return df_p; }
 
+	/**
+	 * Solves the problem using the representation selected by the problem
+	 */
 	inline CFGBlockMap solve() {
+		return solve(typename Problem::representation_tag());
+	}
+
+	/**
+	 * Solves the problem by operating on the value_type of the problem
+	 */
+	inline CFGBlockMap solve(GenericRepresentationTag) {
 
 		using namespace detail;
 
@@ -305,6 +370,93 @@ public:
 		return std::move(solver_data);
 	}
 
+	/**
+	 * Solves the problem on bit-vectors, the problem must be defined on a powerset with the set
+	 * union as MEET operator.
+	 *
+	 * The dataflow values of the blocks are stored in a flat array indexed by the rank of the
+	 * block in the processing order, blocks are processed in reverse postorder (postorder for
+	 * backward problems). All the blocks of the CFG are seeded, including the ones unreachable from
+	 * the entry. The bit-vector transfer function of the problem is evaluated once per visit of a
+	 * block.
+	 */
+	inline CFGBlockMap solve(BitVectorRepresentationTag) {
+
+		using namespace detail;
+
+		typedef typename Problem::value_type 	value_type;
+		typedef typename Problem::direction_tag direction_tag;
+
+		typedef EntityIndex<typename value_type::value_type> Index;
+		typedef typename Index::BitSet BitSet;
+
+		df_p.initialize();
+
+		std::vector<cfg::BlockPtr> blocks = getPostOrder(cfg);
+		processing_order(blocks, direction_tag());
+
+		std::unordered_map<size_t, size_t> rank;
+		for(size_t i = 0; i < blocks.size(); ++i) {
+			rank[ blocks[i]->getBlockID() ] = i;
+		}
+
+		Index index(df_p.getExtracted());
+
+		std::vector<BitSet> solver_data(blocks.size());
+
+		PriorityWorklist q(blocks.size());
+		for(size_t i = 0; i < blocks.size(); ++i) {
+			solver_data[i] = index.toBitSet( this->initial_value(blocks[i], df_p, direction_tag()) );
+			q.enqueue(i);
+		}
+
+		BitSet out, gen, kill;
+		while (!q.empty()) {
+
+			size_t cur = q.dequeue();
+			const cfg::BlockPtr& block = blocks[cur];
+
+			gen.reset();
+			kill.reset();
+			df_p.transfer_func(solver_data[cur], block, index, gen, kill);
+
+			// out = (in - kill) U gen
+			out = solver_data[cur];
+			index.fit(out);
+			index.fit(gen);
+			index.fit(kill);
+			out -= kill;
+			out |= gen;
+
+			std::for_each(
+				CFGIterTraits<direction_tag>::NextBegin(block),
+				CFGIterTraits<direction_tag>::NextEnd(block),
+				[&]( const cfg::BlockPtr& succ) {
+					size_t succ_rank = rank.at( succ->getBlockID() );
+
+					BitSet& succ_data = solver_data[ succ_rank ];
+					index.fit(succ_data);
+
+					if (!out.is_subset_of(succ_data)) {
+						succ_data |= out;
+						q.enqueue(succ_rank);
+					}
+				});
+		}
+
+		CFGBlockMap ret;
+		for(size_t i = 0; i < blocks.size(); ++i) {
+			ret[ blocks[i]->getBlockID() ] = index.toSet(solver_data[i]);
+		}
+
+		LOG(DEBUG) << "@@@@@@@@@@@@@@@@@";
+		LOG(DEBUG) << "@@ Final State @@";
+		LOG(DEBUG) << "@@@@@@@@@@@@@@@@@";
+		printDataflowData(LOG_STREAM(DEBUG), ret);
+
+		return ret;
+	}
+
 	/** 
 	 * Print the dataflow values (for debugging purposes)
 	 */
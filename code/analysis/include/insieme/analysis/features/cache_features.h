@@ -37,6 +37,8 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <algorithm>
 
 #include "insieme/utils/assert.h"
 #include "insieme/core/forward_decls.h"
@@ -57,6 +59,17 @@ namespace features {
 
 		virtual bool access(uint64_t location, unsigned size) =0;
 
+		/**
+		 * Simulates the given batch of accesses in order. For each access it is recorded
+		 * within the hits array whether it was a total hit. Models should override this
+		 * to avoid the virtual call per access.
+		 */
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			for (std::size_t i=0; i<num; ++i) {
+				hits[i] = access(locations[i], sizes[i]);
+			}
+		}
+
 		virtual void reset() = 0;
 		virtual TypePtr getFeatureType() const = 0;
 		virtual Value getFeatureValue() const = 0;
@@ -153,6 +166,12 @@ namespace features {
 
 		}
 
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			for (std::size_t i=0; i<num; ++i) {
+				hits[i] = DirectCacheModel::access(locations[i], sizes[i]);
+			}
+		}
+
 	};
 
 	template<int LineSize, int NumSets, int Ways>
@@ -297,6 +316,12 @@ namespace features {
 			return allHit;
 		}
 
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			for (std::size_t i=0; i<num; ++i) {
+				hits[i] = LRUCacheModel::access(locations[i], sizes[i]);
+			}
+		}
+
 	};
 
 	template<int LineSize, int NumLines>
@@ -312,6 +337,10 @@ namespace features {
 
 		virtual bool access(uint64_t location, unsigned size) { /* nothing to do - always hit */ return true; }
 
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			std::fill(hits, hits + num, true);
+		}
+
 		virtual void reset() {};
 		virtual TypePtr getFeatureType() const { return tuple(); }
 		virtual Value getFeatureValue() const { return combineValues(); }
@@ -327,10 +356,47 @@ namespace features {
 
 		MultiLevelCache<Rest...> subLevel;
 
+		// buffers for the accesses of a batch missing this level
+		vector<uint64_t> missLocations;
+		vector<unsigned> missSizes;
+		std::unique_ptr<bool[]> missHits;
+		std::size_t missHitsCapacity = 0;
+
 		virtual bool access(uint64_t location, unsigned size) {
 			return cache.access(location, size) || subLevel.access(location, size);
 		}
 
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			// simulate the whole batch on this level
+			cache.accessAll(locations, sizes, num, hits);
+
+			// forward the accesses missing this level to the next level, preserving their order
+			missLocations.clear();
+			missSizes.clear();
+			for (std::size_t i=0; i<num; ++i) {
+				if (!hits[i]) {
+					missLocations.push_back(locations[i]);
+					missSizes.push_back(sizes[i]);
+				}
+			}
+			if (missLocations.empty()) {
+				return;
+			}
+
+			if (missHitsCapacity < missLocations.size()) {
+				missHitsCapacity = missLocations.size();
+				missHits.reset(new bool[missHitsCapacity]);
+			}
+			subLevel.accessAll(&missLocations[0], &missSizes[0], missLocations.size(), missHits.get());
+
+			std::size_t j = 0;
+			for (std::size_t i=0; i<num; ++i) {
+				if (!hits[i]) {
+					hits[i] = missHits[j++];
+				}
+			}
+		}
+
 		virtual TypePtr getFeatureType() const {
 			vector<TypePtr> res = subLevel.getFeatureType()->getComponents();
 			res.insert(res.begin(), cache.getFeatureType());
@@ -383,9 +449,29 @@ namespace features {
 		virtual bool access(uint64_t location, unsigned size) {
 			bool res = Cache::access(location, size);
 			accesses++;
-			if (accesses % step_size != 0) {
-				return res;
+			if (accesses % step_size == 0) {
+				checkConvergence();
+			}
+			return res;
+		}
+
+		virtual void accessAll(const uint64_t* locations, const unsigned* sizes, std::size_t num, bool* hits) {
+			std::size_t i = 0;
+			while (i < num) {
+				// simulate the batch up to the next convergence check
+				std::size_t chunk = std::min<std::size_t>(num - i, step_size - accesses % step_size);
+				Cache::accessAll(locations + i, sizes + i, chunk, hits + i);
+				accesses += chunk;
+				i += chunk;
+				if (accesses % step_size == 0) {
+					checkConvergence();
+				}
 			}
+		}
+
+	private:
+
+		void checkConvergence() {
 
 			// just take last result
 //			double miss_ratio = Cache::getMissRatio();
@@ -402,7 +488,6 @@ namespace features {
 				throw EarlyTerminationException();
 			}
 			last_ratio = miss_ratio;
-			return res;
 		}
 
 	};
@@ -436,7 +521,37 @@ namespace features {
 	}
 
 
-	bool evalModel(const core::NodePtr& code, CacheModel& model);
+	/**
+	 * Settings controlling the simulation of the memory accesses of a code fragment.
+	 */
+	struct CacheSimulationSettings {
+
+		/**
+		 * The number of accesses collected before they are passed to the cache model.
+		 */
+		unsigned batchSize;
+
+		/**
+		 * If sampling is enabled, only the first sampleLength accesses out of
+		 * every samplePeriod accesses are simulated.
+		 */
+		unsigned sampleLength;
+		unsigned samplePeriod;
+
+		CacheSimulationSettings(unsigned batchSize = 4096, unsigned sampleLength = 0, unsigned samplePeriod = 0)
+			: batchSize(batchSize), sampleLength(sampleLength), samplePeriod(samplePeriod) {}
+
+		bool isSampling() const { return samplePeriod > 0 && sampleLength < samplePeriod; }
+	};
+
+	/**
+	 * Simulates the memory accesses of the given code using the given cache model. The accesses
+	 * are produced by a natively compiled trace kernel (see cache_simulation.h). If no such
+	 * kernel can be built for the given code, the accesses are traced using a Lua script.
+	 *
+	 * @return true if the simulation was successful, false otherwise
+	 */
+	bool evalModel(const core::NodePtr& code, CacheModel& model, const CacheSimulationSettings& settings = CacheSimulationSettings());
 
 
 	class CacheUsageFeature : public Feature {
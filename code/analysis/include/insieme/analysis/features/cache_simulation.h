@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+
+#include <string>
+#include <exception>
+
+#include "insieme/core/ir_node.h"
+#include "insieme/analysis/features/cache_features.h"
+
+namespace insieme {
+namespace analysis {
+namespace features {
+
+	/**
+	 * The possible outcomes of a native cache simulation.
+	 */
+	enum class NativeSimulationResult {
+		Completed,		// all accesses (or all accesses needed by the model) have been simulated
+		Failed,			// the trace kernel failed after accesses have already been simulated
+		Unsupported		// no trace kernel could be built, no access has been simulated
+	};
+
+	/**
+	 * Reduces the given statement to a skeleton containing only the control flow required for
+	 * computing memory locations and calls to the access, read_ptr and fresh_mem_location functions.
+	 */
+	core::StatementPtr extractMemorySkeleton(const core::StatementPtr& stmt);
+
+	/**
+	 * Converts the memory skeleton of the given (sequential) statement into a C program writing the
+	 * stream of memory accesses the statement would perform to its standard output. The stream is
+	 * written in batches, each consisting of
+	 *
+	 *     uint32_t n, uint64_t locations[n], uint32_t sizes[n]
+	 *
+	 * If sampling is enabled within the given settings, the kernel only emits the sampled accesses.
+	 *
+	 * @param stmt the statement to be converted
+	 * @param settings the settings determining the batch size and sampling rate
+	 * @return the source code of the trace kernel
+	 * @throws CacheTraceConversionException if the skeleton can not be converted
+	 */
+	std::string toCacheTraceKernel(const core::StatementPtr& stmt, const CacheSimulationSettings& settings = CacheSimulationSettings());
+
+	/**
+	 * Simulates the memory accesses of the given statement by compiling its trace kernel using the
+	 * default C compiler, running it and passing the produced batches to the given model.
+	 *
+	 * @param stmt the statement to be simulated
+	 * @param model the model to be fed with the memory accesses
+	 * @param settings the settings for the simulation
+	 * @return the outcome of the simulation
+	 */
+	NativeSimulationResult simulateNative(const core::StatementPtr& stmt, CacheModel& model, const CacheSimulationSettings& settings = CacheSimulationSettings());
+
+	/**
+	 * The type of exception been thrown if some construct could
+	 * not be converted into a trace kernel.
+	 */
+	class CacheTraceConversionException : public std::exception {
+
+		/**
+		 * The node which caused the problem.
+		 */
+		core::NodePtr source;
+
+		/**
+		 * A brief description of the encountered problem.
+		 */
+		std::string msg;
+
+	public:
+
+		CacheTraceConversionException(const core::NodePtr& source, const std::string& msg = "");
+		virtual ~CacheTraceConversionException() throw() { }
+		const core::NodePtr& getSource() const { return source; }
+		virtual const char* what() const throw() { return msg.c_str(); }
+	};
+
+} // end namespace features
+} // end namespace analysis
+} // end namespace insieme
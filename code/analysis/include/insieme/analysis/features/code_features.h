@@ -36,6 +36,10 @@
 
 #pragma once
 
+#include <memory>
+
+#include <boost/utility.hpp>
+
 #include "insieme/analysis/features/feature.h"
 
 #include "insieme/core/forward_decls.h"
@@ -78,9 +82,16 @@ namespace features {
 		extractor_function extractor;
 		FeatureAggregationMode mode;
 
+		/**
+		 * A flag indicating whether the extractor may be invoked by multiple threads concurrently. This
+		 * requires the extractor to neither modify node annotations nor to depend on mutable state.
+		 */
+		bool concurrent;
+
 	public:
-		CodeFeatureSpec(const extractor_function& extractor, FeatureAggregationMode mode) : extractor(extractor), mode(mode) {}
-		CodeFeatureSpec(FeatureAggregationMode mode) : mode(mode) {}
+		CodeFeatureSpec(const extractor_function& extractor, FeatureAggregationMode mode, bool concurrent = false)
+			: extractor(extractor), mode(mode), concurrent(concurrent) {}
+		CodeFeatureSpec(FeatureAggregationMode mode) : mode(mode), concurrent(false) {}
 
 		simple_feature_value_type extract(const core::NodePtr& node) const {
 			return extractor(node);
@@ -90,6 +101,10 @@ namespace features {
 			return mode;
 		}
 
+		bool isConcurrent() const {
+			return concurrent;
+		}
+
 	};
 
 	// a generic implementation extracting all kind of simple features
@@ -113,7 +128,8 @@ namespace features {
 
 		SimpleCodeFeatureSpec(const vector<core::TypePtr>& types, const vector<core::ExpressionPtr>& ops, FeatureAggregationMode mode = FA_Weighted);
 
-		SimpleCodeFeatureSpec(const extractor_function& extractor, FeatureAggregationMode mode = FA_Weighted) : CodeFeatureSpec(extractor, mode) {}
+		SimpleCodeFeatureSpec(const extractor_function& extractor, FeatureAggregationMode mode = FA_Weighted, bool concurrent = false)
+			: CodeFeatureSpec(extractor, mode, concurrent) {}
 
 	};
 
@@ -186,6 +202,102 @@ namespace features {
 	FeatureValues evalFeatures(const core::NodePtr& root, const vector<SimpleCodeFeatureSpec>& features);
 	FeatureValues evalFeatures(const core::NodePtr& root, const vector<const SimpleCodeFeatureSpec*>& features);
 
+	// -- batched feature extraction --
+
+	/**
+	 * Throughput statistics collected by a code feature extractor.
+	 */
+	struct FeatureExtractionStatistics : public utils::Printable {
+
+		unsigned numRegions;		/* < the number of regions features have been extracted from */
+		uint64_t numNodes;			/* < the number of nodes the local feature values have been evaluated for */
+		uint64_t numEvaluations;	/* < the number of invocations of individual feature extractors */
+		double time;				/* < the wall clock time spent on the extraction in seconds */
+
+		FeatureExtractionStatistics() : numRegions(0), numNodes(0), numEvaluations(0), time(0) {}
+
+		FeatureExtractionStatistics& operator+=(const FeatureExtractionStatistics& other);
+
+		double getRegionsPerSecond() const;
+		double getNodesPerSecond() const;
+
+		std::ostream& printTo(std::ostream& out) const;
+	};
+
+	namespace detail {
+		class FusedFeatureEvaluator;
+	}
+
+	/**
+	 * An engine extracting a fixed list of code features from a potentially large number of code
+	 * regions. The local values of all features are evaluated within a single pass over each node
+	 * and shared among all aggregation modes. Since IR nodes are immutable and regions share their
+	 * sub-trees, the aggregated per-node values are memorized across regions until the extractor is
+	 * cleared. Hence, an extractor must not outlive the node managers of the processed regions.
+	 */
+	class CodeFeatureExtractor : public boost::noncopyable {
+
+		/**
+		 * The features to be extracted. The specifications are not owned by this extractor.
+		 */
+		vector<const CodeFeatureSpec*> specs;
+
+		/**
+		 * The evaluator maintaining the memorized per-node results.
+		 */
+		std::unique_ptr<detail::FusedFeatureEvaluator> evaluator;
+
+		/**
+		 * The statistics accumulated by this extractor.
+		 */
+		FeatureExtractionStatistics statistics;
+
+	public:
+
+		CodeFeatureExtractor(const vector<const CodeFeatureSpec*>& specs);
+
+		~CodeFeatureExtractor();
+
+		const vector<const CodeFeatureSpec*>& getSpecs() const {
+			return specs;
+		}
+
+		/**
+		 * Extracts the values of all features from the given region. The values are ordered
+		 * according to the list of specifications this extractor has been created for.
+		 */
+		FeatureValues extract(const core::NodePtr& region);
+
+		/**
+		 * Extracts the values of all features from each of the given regions. If more than one thread
+		 * is requested and the regions may be processed concurrently (see supportsConcurrentExtraction),
+		 * the regions are distributed among a pool of threads, each memorizing results privately.
+		 * Otherwise, the regions are processed sequentially, reusing the results memorized by this
+		 * extractor.
+		 */
+		vector<FeatureValues> extract(const vector<core::NodePtr>& regions, unsigned numThreads = 1);
+
+		/**
+		 * Determines whether the given regions may be processed by multiple threads. This is the case
+		 * if all regions are maintained by concurrent node managers, all specifications are concurrent,
+		 * and no features are aggregated polyhedrally (the SCoP analysis annotates nodes).
+		 */
+		bool supportsConcurrentExtraction(const vector<core::NodePtr>& regions) const;
+
+		/**
+		 * Obtains the statistics of all extractions conducted by this extractor so far.
+		 */
+		const FeatureExtractionStatistics& getStatistics() const {
+			return statistics;
+		}
+
+		/**
+		 * Drops all memorized per-node results.
+		 */
+		void clear();
+
+	};
+
 	// -- a generic feature counting individual operators --
 
 	struct OperatorStatistic : public utils::map::PointerMap<core::ExpressionPtr, unsigned> {
@@ -197,6 +197,19 @@ namespace features {
 
 	vector<Value> extractFrom(const core::NodePtr& node, const vector<FeaturePtr>& features);
 
+	/**
+	 * Extracts the given list of features from each of the given code regions. Code features are
+	 * evaluated by a single code feature extractor, sharing the results obtained for common sub-trees
+	 * among all regions. If multiple threads are requested and supported by the features, the regions
+	 * are processed concurrently. All other features are extracted sequentially.
+	 *
+	 * @param regions the code regions to extract features from
+	 * @param features the features to be extracted
+	 * @param numThreads the maximum number of threads to be utilized
+	 * @return the feature values, one list per region
+	 */
+	vector<vector<Value>> extractFrom(const vector<core::NodePtr>& regions, const vector<FeaturePtr>& features, unsigned numThreads = 1);
+
 
 } // end namespace features
 } // end namespace analysis
@@ -205,6 +205,32 @@ namespace cba {
 		out << "-----------------------------------\n";
 		out << format(" %-25s %7d\n", "Total:", sum);
 		out << "-----------------------------------\n";
+
+		// solver statistics per analysis
+		const Solver::Stats& stats = solver.getStats();
+		out << format(" %-25s %9s %9s\n", "Solver", "#Updates", "#Resets");
+		if (solver.isCollectingVariableStats()) {
+			std::map<string,std::pair<std::size_t,std::size_t>> solverCounts;
+			for(const auto& cur : stats.variables) {
+				auto pos = var2analysis.find(cur.first);
+				if (pos == var2analysis.end()) continue;
+				auto& entry = solverCounts[getAnalysisName(pos->second)];
+				entry.first += cur.second.updates;
+				entry.second += cur.second.resets;
+			}
+
+			for(const auto& cur : solverCounts) {
+				out << format(" %-25s %9zu %9zu\n", cur.first, cur.second.first, cur.second.second);
+			}
+			out << "-----------------------------------\n";
+		}
+		out << format(" %-25s %9zu %9zu\n", "Total:", stats.updates, stats.resets);
+		if (solver.getStrategy() == Solver::Components) {
+			out << format(" %-25s %9zu\n", "#Passes", stats.passes);
+			out << format(" %-25s %9zu\n", "#Components", stats.components);
+			out << format(" %-25s %9zu\n", "Max component size", stats.maxComponentSize);
+		}
+		out << "-----------------------------------\n";
 	}
 
 	void CBA::printConstraints(std::ostream& out) const {
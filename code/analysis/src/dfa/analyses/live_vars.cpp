@@ -36,6 +36,8 @@
 
 #include "insieme/analysis/dfa/analyses/live_vars.h"
 
+#include <functional>
+
 #include "insieme/core/analysis/ir_utils.h"
 
 #include "insieme/utils/logging.h"
@@ -60,111 +62,146 @@ value_type LiveVariables::meet(const value_type& lhs, const value_type& rhs) con
 }
 
 
-std::pair<value_type, value_type> LiveVariables::transfer_func(const value_type& in, const cfg::BlockPtr& block) const {
-	
-	value_type gen, kill;
+namespace {
 
-	if (block->empty()) { return {gen,kill}; }
+	typedef std::function<void (const AccessClassPtr&)> ClassVisitor;
 
-	const AccessManager& aMgr = getAccessManager();
+	/**
+	 * Computes the access classes generated and killed by the given block. The forEachLive
+	 * operation enumerates the classes live at the exit of the block, the gen and kill operations
+	 * are invoked with the affected classes.
+	 */
+	template <class ForEachLive, class GenOp, class KillOp>
+	void transfer(const LiveVariables& problem, const cfg::BlockPtr& block,
+				  const ForEachLive& forEachLive, const GenOp& gen, const KillOp& kill)
+	{
+		const AccessManager& aMgr = problem.getAccessManager();
 
-	size_t stmt_idx = 0;
-	for_each(block->stmt_begin(), block->stmt_end(), [&] (const cfg::Element& cur) {
+		size_t stmt_idx = 0;
+		for_each(block->stmt_begin(), block->stmt_end(), [&] (const cfg::Element& cur) {
 
-		core::StatementPtr 		stmtPtr  = cur.getAnalysisStatement();
-		core::StatementAddress	stmt = core::StatementAddress(stmtPtr);
+			core::StatementPtr 		stmtPtr  = cur.getAnalysisStatement();
+			core::StatementAddress	stmt = core::StatementAddress(stmtPtr);
 
-		core::NodeManager& mgr = stmt->getNodeManager();
-		
-		// Makes sure that whatever exit path is taken in the body of this lambda, the stmt_idx
-		// is going to be updated correctly 
-		FinalActions fa([&](){ ++stmt_idx; });
+			core::NodeManager& mgr = stmt->getNodeManager();
 
-		auto handle_rhs = [&](const core::ExpressionAddress& expr) {
+			// Makes sure that whatever exit path is taken in the body of this lambda, the stmt_idx
+			// is going to be updated correctly
+			FinalActions fa([&](){ ++stmt_idx; });
 
-			auto accesses = getAccesses(mgr, 
-				UnifiedAddress(cfg::Address(block,stmt_idx,expr)), 
-				getCFG().getTmpVarMap()
-			);
+			auto handle_rhs = [&](const core::ExpressionAddress& expr) {
 
-			// for each usage of a variable add it to the gen set 
-			for (const auto& acc : accesses) { 
-				auto liveClasses = aMgr.findClass(acc);
-				std::copy(liveClasses.begin(), liveClasses.end(), std::inserter(gen, gen.begin()));
-			}
-		};
+				auto accesses = getAccesses(mgr,
+					UnifiedAddress(cfg::Address(block,stmt_idx,expr)),
+					problem.getCFG().getTmpVarMap()
+				);
 
+				// for each usage of a variable add it to the gen set
+				for (const auto& acc : accesses) {
+					for (const auto& cls : aMgr.findClass(acc)) { gen(cls); }
+				}
+			};
+
+
+			auto handle_def = [&](const core::ExpressionAddress& lhs, const core::ExpressionAddress& rhs) {
+
+				auto defAccess = getImmediateAccess(stmt->getNodeManager(),
+									cfg::Address(block, stmt_idx, lhs),
+									problem.getCFG().getTmpVarMap()
+								);
 
-		auto handle_def = [&](const core::ExpressionAddress& lhs, const core::ExpressionAddress& rhs) { 
-					
-			auto defAccess = getImmediateAccess(stmt->getNodeManager(), 
-								cfg::Address(block, stmt_idx, lhs), 
-								getCFG().getTmpVarMap()
-							);
+				auto defClasses = aMgr.findClass(defAccess);
+				assert_false(defClasses.empty()) << "Invalid class for access. Something wrong in the extract() method";
 
-			auto defClasses = aMgr.findClass(defAccess);
-			assert_false(defClasses.empty()) << "Invalid class for access. Something wrong in the extract() method";
+				AccessClassSet depClasses = getConflicting(defClasses);
+				std::copy(defClasses.begin(), defClasses.end(), std::inserter(depClasses, depClasses.begin()));
 
-			AccessClassSet depClasses = getConflicting(defClasses);
-			std::copy(defClasses.begin(), defClasses.end(), std::inserter(depClasses, depClasses.begin()));
+				bool found = false;
 
-			bool found = false;
+				// Kill Entities
+				forEachLive([&](const AccessClassPtr& live) {
+					if (std::find_if( depClasses.begin(), depClasses.end(),
+							[&](const AccessClassPtr& cur) { return *cur == *live; }) != depClasses.end() ) {
+								found = true;
+								kill( live );
+					}
+				});
 
-			// Kill Entities 
-			for(auto it = in.begin(), end=in.end(); it != end; ++it) {
-				if (std::find_if( depClasses.begin(), depClasses.end(), 
-						[&](const AccessClassPtr& cur) { return *cur == **it; }) != depClasses.end() ) { 
-							found = true; 
-							kill.insert( *it ); 
+				// if the LHS is a not live variable then the RHS should not be detected as a live
+				// variable
+				if (!found) {
+					return; // then any of the uses in the LHS are relevant
 				}
-			}
 
-			// if the LHS is a not live variable then the RHS should not be detected as a live
-			// variable 
-			if (!found) { 
-				return; // then any of the uses in the LHS are relevant 
-			}
+				handle_rhs(rhs);
+			};
 
-			handle_rhs(rhs);
-		};
 
+			// assume scalar variables
+			if (auto decl = core::dynamic_address_cast<const core::DeclarationStmt>(stmt)) {
 
-		// assume scalar variables 
-		if (auto decl = core::dynamic_address_cast<const core::DeclarationStmt>(stmt)) {
+				handle_def(decl->getVariable(), decl->getInitialization());
 
-			handle_def(decl->getVariable(), decl->getInitialization());
+			} else if (auto call = core::dynamic_address_cast<const core::CallExpr>(stmt)) {
 
-		} else if (auto call = core::dynamic_address_cast<const core::CallExpr>(stmt)) {
+				if (core::analysis::isCallOf(call.getAddressedNode(), mgr.getLangBasic().getRefAssign()) ) {
+					handle_def(call->getArgument(0), call->getArgument(1));
+					return;
+				}
 
-			if (core::analysis::isCallOf(call.getAddressedNode(), mgr.getLangBasic().getRefAssign()) ) {
-				handle_def(call->getArgument(0), call->getArgument(1));
-				return;
-			}
+				// function
+				handle_rhs(call);
 
-			// function 
-			handle_rhs(call);
+			} else if (cur.getType() == cfg::Element::LOOP_INCREMENT) {
 
-		} else if (cur.getType() == cfg::Element::LOOP_INCREMENT) {
+				auto cfgAddr = problem.getCFG().find(
+						cur.getStatementAddress().as<core::ForStmtAddress>()->getDeclaration()->getVariable()
+					);
 
-			auto cfgAddr = getCFG().find(
-					cur.getStatementAddress().as<core::ForStmtAddress>()->getDeclaration()->getVariable()
-				);
+				auto accessPtr = getImmediateAccess(mgr, cfgAddr, problem.getCFG().getTmpVarMap());
+				for (const auto& cls : aMgr.findClass(accessPtr)) { gen(cls); }
 
-			auto accessPtr = getImmediateAccess(mgr, cfgAddr, getCFG().getTmpVarMap());
-			auto liveClasses = aMgr.findClass(accessPtr);
+			} else {
 
-			std::copy(liveClasses.begin(), liveClasses.end(), std::inserter(gen, gen.begin()));
+				handle_rhs( core::ExpressionAddress(stmt.as<core::ExpressionPtr>()) );
+
+			}
+		});
+	}
 
-		} else {
+} // end anonymous namespace
 
-			handle_rhs( core::ExpressionAddress(stmt.as<core::ExpressionPtr>()) );
+std::pair<value_type, value_type> LiveVariables::transfer_func(const value_type& in, const cfg::BlockPtr& block) const {
+
+	value_type gen, kill;
 
-		}
-	});
+	if (block->empty()) { return {gen,kill}; }
+
+	transfer(*this, block,
+		[&](const ClassVisitor& visitor) { for(const auto& cur : in) { visitor(cur); } },
+		[&](const AccessClassPtr& cur) { gen.insert(cur); },
+		[&](const AccessClassPtr& cur) { kill.insert(cur); }
+	);
 	
 	return {gen,kill};
 }
 
+void LiveVariables::transfer_func(const Index::BitSet& in, const cfg::BlockPtr& block, Index& index,
+								  Index::BitSet& gen, Index::BitSet& kill) const
+{
+	if (block->empty()) { return; }
+
+	transfer(*this, block,
+		[&](const ClassVisitor& visitor) {
+			for(size_t idx = in.find_first(); idx != Index::BitSet::npos; idx = in.find_next(idx)) {
+				visitor(index[idx]);
+			}
+		},
+		[&](const AccessClassPtr& cur) { index.add(gen, cur); },
+		[&](const AccessClassPtr& cur) { index.add(kill, cur); }
+	);
+}
+
 } // end analyses namespace 
 } // end dfa namespace 
 } // end analysis namespace 
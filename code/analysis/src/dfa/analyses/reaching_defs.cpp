@@ -110,73 +110,115 @@ void definitionsToAccesses(const AnalysisDataType& data, AccessManager& aMgr) {
 }
 
 
-std::pair<AnalysisDataType,AnalysisDataType> 
-ReachingDefinitions::transfer_func(const AnalysisDataType& in, const cfg::BlockPtr& block) const {
+void definitionsToAccesses(const ReachingDefinitions::Index::BitSet& data, const ReachingDefinitions::Index& index,
+						   AccessManager& aMgr)
+{
+	typedef ReachingDefinitions::Index::BitSet BitSet;
+	for(size_t idx = data.find_first(); idx != BitSet::npos; idx = data.find_next(idx)) {
+		const cfg::Address& dfAddress = index[idx];
+		aMgr.getClassFor( getImmediateAccess( dfAddress.getAddressedNode()->getNodeManager(),dfAddress ) );
+	}
+}
 
-	AnalysisDataType gen, kill;
-	
-	if (block->empty()) { return {gen,kill}; }
+namespace {
 
-	// Get the generator 
-	const auto& basic = getCFG().getNodeManager().getLangBasic();
+	/**
+	 * Computes the definitions generated and killed by the given block, the definitions reaching
+	 * the block must already be registered within the access manager. The gen and kill operations
+	 * are invoked with the affected definitions.
+	 */
+	template <class GenOp, class KillOp>
+	void transfer(const CFG& cfg, const cfg::BlockPtr& block, AccessManager& mgr, const GenOp& gen, const KillOp& kill) {
 
-	AccessManager mgr(&getCFG(), getCFG().getTmpVarMap());
-	definitionsToAccesses(in, mgr);
+		const auto& basic = cfg.getNodeManager().getLangBasic();
 
-	size_t stmtIdx=0;
-	for_each(block->stmt_begin(), block->stmt_end(), [&] (const cfg::Element& cur) {
+		size_t stmtIdx=0;
+		for_each(block->stmt_begin(), block->stmt_end(), [&] (const cfg::Element& cur) {
 
-		core::StatementAddress stmt = core::StatementAddress(cur.getAnalysisStatement());
+			core::StatementAddress stmt = core::StatementAddress(cur.getAnalysisStatement());
 
-		auto handle_def = [&](const core::VariableAddress& varAddr) { 
+			auto handle_def = [&](const core::VariableAddress& varAddr) {
 
-			assert_true(varAddr) << "Variable not found within the statement of the CFG Block";
+				assert_true(varAddr) << "Variable not found within the statement of the CFG Block";
 
-			cfg::Address cfgAddr(block, stmtIdx, varAddr);
+				cfg::Address cfgAddr(block, stmtIdx, varAddr);
 
-			auto access = getImmediateAccess(stmt->getNodeManager(), cfgAddr, getCFG().getTmpVarMap());
+				auto access = getImmediateAccess(stmt->getNodeManager(), cfgAddr, cfg.getTmpVarMap());
 
-			// Get the class to which the access belongs to 
-			AccessClassSet collisionSet = mgr.getClassFor(access);
+				// Get the class to which the access belongs to
+				AccessClassSet collisionSet = mgr.getClassFor(access);
 
-			AccessClassSet subClasses;
-			for(const auto& curClass : collisionSet)  {
-				subClasses.insert(curClass);
-				addSubClasses(curClass, subClasses);
-			}
+				AccessClassSet subClasses;
+				for(const auto& curClass : collisionSet)  {
+					subClasses.insert(curClass);
+					addSubClasses(curClass, subClasses);
+				}
 
-			// Kill Entities 
-			if (access->isReference()) 
-				for (auto& curClass : subClasses) 
-					for (auto& acc : *curClass) {
-						kill.insert( acc->getAddress().as<cfg::Address>() );
-					}
+				// Kill Entities
+				if (access->isReference())
+					for (auto& curClass : subClasses)
+						for (auto& acc : *curClass) {
+							kill( acc->getAddress().as<cfg::Address>() );
+						}
 
-			gen.insert( access->getAddress().as<cfg::Address>() );
+				gen( access->getAddress().as<cfg::Address>() );
 
-		};
+			};
 
-		if (core::DeclarationStmtAddress decl = core::dynamic_address_cast<const core::DeclarationStmt>(stmt)) {
+			if (core::DeclarationStmtAddress decl = core::dynamic_address_cast<const core::DeclarationStmt>(stmt)) {
 
-			if (!getCFG().getTmpVarMap().isTmpVar(decl->getVariable().getAddressedNode())) {
-				handle_def( decl->getVariable() );
-			}
+				if (!cfg.getTmpVarMap().isTmpVar(decl->getVariable().getAddressedNode())) {
+					handle_def( decl->getVariable() );
+				}
 
-		} else if (core::CallExprAddress call = core::dynamic_address_cast<const core::CallExpr>(stmt)) {
+			} else if (core::CallExprAddress call = core::dynamic_address_cast<const core::CallExpr>(stmt)) {
 
-			if ( core::analysis::isCallOf(call.getAddressedNode(), basic.getRefAssign()) ) { 
-				handle_def( call->getArgument(0).as<core::VariableAddress>() );
+				if ( core::analysis::isCallOf(call.getAddressedNode(), basic.getRefAssign()) ) {
+					handle_def( call->getArgument(0).as<core::VariableAddress>() );
+				}
 			}
-		}
 
-		if (cur.getType() == cfg::Element::LOOP_INCREMENT) {
-			handle_def( stmt.as<core::ForStmtAddress>()->getDeclaration()->getVariable() );
-		}
+			if (cur.getType() == cfg::Element::LOOP_INCREMENT) {
+				handle_def( stmt.as<core::ForStmtAddress>()->getDeclaration()->getVariable() );
+			}
+
+			++stmtIdx;
+		});
+	}
+
+} // end anonymous namespace
+
+
+std::pair<AnalysisDataType,AnalysisDataType>
+ReachingDefinitions::transfer_func(const AnalysisDataType& in, const cfg::BlockPtr& block) const {
+
+	AnalysisDataType gen, kill;
+
+	if (block->empty()) { return {gen,kill}; }
+
+	AccessManager mgr(&getCFG(), getCFG().getTmpVarMap());
+	definitionsToAccesses(in, mgr);
 
-		++stmtIdx;
-	});
+	transfer(getCFG(), block, mgr,
+		[&](const cfg::Address& def) { gen.insert(def); },
+		[&](const cfg::Address& def) { kill.insert(def); }
+	);
 
 	return {gen, kill};
 }
 
+void ReachingDefinitions::transfer_func(const Index::BitSet& in, const cfg::BlockPtr& block, Index& index,
+										Index::BitSet& gen, Index::BitSet& kill) const
+{
+	if (block->empty()) { return; }
+
+	AccessManager mgr(&getCFG(), getCFG().getTmpVarMap());
+	definitionsToAccesses(in, index, mgr);
+
+	transfer(getCFG(), block, mgr,
+		[&](const cfg::Address& def) { index.add(gen, def); },
+		[&](const cfg::Address& def) { index.add(kill, def); }
+	);
+}
+
 } } } } // end insieme::analysis::dfa::analyses namespace 
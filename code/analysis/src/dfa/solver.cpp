@@ -37,6 +37,9 @@
 #include "insieme/analysis/dfa/solver.h"
 #include "insieme/utils/unused.h"
 
+#include <unordered_set>
+#include <tuple>
+
 namespace insieme {
 namespace analysis {
 namespace dfa {
@@ -63,6 +66,72 @@ cfg::BlockPtr WorklistQueue::dequeue() {
 	return block;
 }
 
+void PriorityWorklist::enqueue(size_t rank) {
+	assert_lt(rank, queued.size());
+	if (!queued[rank]) {
+		rank_queue.push(rank);
+		queued[rank] = true;
+	}
+}
+
+size_t PriorityWorklist::dequeue() {
+
+	if (empty()) { assert_fail() << "Priority Worklist is empty"; }
+
+	size_t rank = rank_queue.top();
+	rank_queue.pop();
+	queued[rank] = false;
+
+	return rank;
+}
+
+std::vector<cfg::BlockPtr> getPostOrder(const CFG& cfg) {
+
+	typedef cfg::Block::successors_iterator Iter;
+
+	std::vector<cfg::BlockPtr> order;
+	order.reserve(cfg.size());
+
+	std::unordered_set<size_t> visited;
+
+	// explicit DFS stack, large CFGs would exhaust the call stack
+	std::vector<std::tuple<cfg::BlockPtr, Iter, Iter>> stack;
+
+	auto&& visit = [&](const cfg::BlockPtr& root) {
+
+		if (!visited.insert(root->getBlockID()).second) { return; }
+		stack.push_back( std::make_tuple(root, root->successors_begin(), root->successors_end()) );
+
+		while(!stack.empty()) {
+			auto& top = stack.back();
+
+			if (std::get<1>(top) == std::get<2>(top)) {
+				order.push_back(std::get<0>(top));
+				stack.pop_back();
+				continue;
+			}
+
+			cfg::BlockPtr succ = *std::get<1>(top);
+			++std::get<1>(top);
+
+			if (visited.insert(succ->getBlockID()).second) {
+				stack.push_back( std::make_tuple(succ, succ->successors_begin(), succ->successors_end()) );
+			}
+		}
+	};
+
+	// the blocks reachable from the entry come first
+	visit( cfg.getBlockPtr(cfg.entry()) );
+
+	// blocks unreachable from the entry are still part of the solution
+	auto&& range = vertices(cfg.getRawGraph());
+	for(auto it = range.first; it != range.second; ++it) {
+		visit( cfg.getBlockPtr(*it) );
+	}
+
+	return order;
+}
+
 
 } // end dfa namespace 
 } // end analysis namespace 
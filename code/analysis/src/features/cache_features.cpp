@@ -35,6 +35,7 @@
  */
 
 #include "insieme/analysis/features/cache_features.h"
+#include "insieme/analysis/features/cache_simulation.h"
 
 #include "insieme/utils/map_utils.h"
 #include "insieme/utils/lua/lua.h"
@@ -931,8 +932,12 @@ namespace features {
 
 	}
 
+	core::StatementPtr extractMemorySkeleton(const core::StatementPtr& stmt) {
+		return toSkeleton(stmt);
+	}
+
 
-	bool evalModel(const core::NodePtr& code, CacheModel& model) {
+	bool evalModel(const core::NodePtr& code, CacheModel& model, const CacheSimulationSettings& settings) {
 
 		core::StatementPtr stmt = dynamic_pointer_cast<core::StatementPtr>(code);
 		if (!stmt) {
@@ -964,6 +969,13 @@ namespace features {
 //			std::cout << "\n";
 //			std::cout << "Lua Script: \n" << toLuaScript(stmt) << "\n";
 
+			// prefer a natively compiled trace kernel, the Lua script only serves as a fall-back
+			switch(simulateNative(stmt, model, settings)) {
+				case NativeSimulationResult::Completed: return true;
+				case NativeSimulationResult::Failed: return false;
+				case NativeSimulationResult::Unsupported: break;
+			}
+
 			// create access wrapper
 			auto accessFun = [&](uint64_t location, unsigned size) {
 				model.access(location, size);
@@ -0,0 +1,640 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include "insieme/analysis/features/cache_simulation.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include "insieme/core/ir_visitor.h"
+#include "insieme/core/ir_builder.h"
+#include "insieme/core/analysis/ir_utils.h"
+#include "insieme/core/transform/manipulation.h"
+#include "insieme/core/transform/sequentialize.h"
+
+#include "insieme/utils/map_utils.h"
+#include "insieme/utils/string_utils.h"
+#include "insieme/utils/logging.h"
+#include "insieme/utils/compiler/compiler.h"
+
+namespace insieme {
+namespace analysis {
+namespace features {
+
+	namespace {
+
+		class KernelConverter;
+
+		typedef std::function<void(KernelConverter&, const core::CallExprPtr&)> OperatorConverter;
+		typedef utils::map::PointerMap<core::ExpressionPtr, OperatorConverter> OperatorConverterTable;
+
+		const OperatorConverterTable& getDefaultConverterTable();
+
+		/**
+		 * The C type used for representing values of the given type within the kernel. Within
+		 * the skeleton, references have been replaced by integers representing their location.
+		 */
+		string getKernelType(const core::TypePtr& type) {
+			const auto& basic = type->getNodeManager().getLangBasic();
+			if (basic.isReal(type)) return "double";
+			if (basic.isBool(type)) return "bool";
+			return "int64_t";
+		}
+
+		/**
+		 * The functions of the skeleton, which are hoisted to the top level of the kernel.
+		 */
+		struct KernelFunctions {
+			utils::map::PointerMap<core::LambdaExprPtr, string> names;
+			std::stringstream declarations;
+			std::stringstream definitions;
+		};
+
+		/**
+		 * Converts the statements and expressions of a memory skeleton into C code. Other than
+		 * the Lua printer, all values are represented by native integers or floating point numbers.
+		 */
+		class KernelConverter : public core::IRVisitor<> {
+
+			const OperatorConverterTable& operatorTable;
+
+			KernelFunctions& functions;
+
+			std::ostream& out;
+
+			unsigned intend;
+
+			bool outermostCall;
+
+		public:
+
+			KernelConverter(KernelFunctions& functions, std::ostream& out, unsigned intend = 0)
+				: operatorTable(getDefaultConverterTable()), functions(functions), out(out), intend(intend), outermostCall(true) {}
+
+			std::ostream& getOut() {
+				return out;
+			}
+
+			void setOutermost(bool value = true) {
+				outermostCall = value;
+			}
+
+		protected:
+
+			void newLine() {
+				out << "\n" << times("    ", intend);
+			}
+
+			void visitLiteral(const core::LiteralPtr& lit) {
+				out << lit->getStringValue();
+			}
+
+			void visitCastExpr(const core::CastExprPtr& cast) {
+				visit(cast->getSubExpression()); // cast are ignored!
+			}
+
+			void visitVariable(const core::VariablePtr& var) {
+				out << *var;
+			}
+
+			void visitCallExpr(const core::CallExprPtr& call) {
+
+				bool outermost = outermostCall;
+				outermostCall = false;
+
+				// test whether for the current call a special format has been registered
+				auto function = call->getFunctionExpr();
+				auto pos = operatorTable.find(function);
+				if (pos != operatorTable.end()) {
+					if (!outermost) out << "(";
+					pos->second(*this, call);
+					if (!outermost) out << ")";
+					return;
+				}
+
+				// check whether it is a built-in literal
+				if (function->getNodeType() == core::NT_Literal) {
+					if (call->getNodeManager().getLangBasic().isBuiltIn(function)) {
+						throw CacheTraceConversionException(call, "Unsupported built-in function!");
+					}
+				}
+
+				// default formating
+				this->visit(function);
+				out << "(";
+				auto arguments = call->getArguments();
+				for(std::size_t i = 0; i < arguments.size(); ++i) {
+					if (i > 0) out << ", ";
+					this->visit(arguments[i]);
+				}
+				out << ")";
+			}
+
+
+			// -- Statements --
+
+			void visitBreakStmt(const core::BreakStmtPtr& stmt) {
+				out << "break";
+			}
+
+			void visitContinueStmt(const core::ContinueStmtPtr& stmt) {
+				out << "continue";
+			}
+
+			void visitReturnStmt(const core::ReturnStmtPtr& stmt) {
+				// skeleton functions do not produce values
+				out << "return";
+			}
+
+			void visitDeclarationStmt(const core::DeclarationStmtPtr& decl) {
+				out << getKernelType(decl->getVariable()->getType()) << " ";
+				visit(decl->getVariable());
+				out << " = ";
+				visit(decl->getInitialization());
+			}
+
+			void visitCompoundStmt(const core::CompoundStmtPtr& stmts) {
+
+				// start a block
+				out << "{";
+				intend++;
+
+				// process statements
+				for_each(stmts->getStatements(), [&](const core::StatementPtr& cur) {
+					this->newLine();
+					this->outermostCall = true;
+					this->visit(cur);
+					out << ";";
+				});
+
+				// finish the block
+				intend--;
+				newLine();
+				out << "}";
+			}
+
+			void visitIfStmt(const core::IfStmtPtr& stmt) {
+				out << "if (";
+				visit(stmt->getCondition());
+				out << ") ";
+				visit(stmt->getThenBody());
+				out << " else ";
+				visit(stmt->getElseBody());
+			}
+
+			void visitWhileStmt(const core::WhileStmtPtr& stmt) {
+				out << "while (";
+				visit(stmt->getCondition());
+				out << ") ";
+				visit(stmt->getBody());
+			}
+
+			void visitForStmt(const core::ForStmtPtr& stmt) {
+				// bounds and step are evaluated once, the end is exclusive
+				const core::VariablePtr& iter = stmt->getIterator();
+				out << "{ int64_t " << *iter << "_end = ";
+				visit(stmt->getEnd());
+				out << "; int64_t " << *iter << "_step = ";
+				visit(stmt->getStep());
+				out << "; for (int64_t " << *iter << " = ";
+				visit(stmt->getStart());
+				out << "; (" << *iter << "_step > 0) ? (" << *iter << " < " << *iter << "_end) : (" << *iter << " > " << *iter << "_end); "
+					<< *iter << " += " << *iter << "_step) ";
+				visit(stmt->getBody());
+				out << " }";
+			}
+
+			void visitLambdaExpr(const core::LambdaExprPtr& lambda) {
+				out << getFunctionName(lambda);
+			}
+
+			void visitNode(const core::NodePtr& node) {
+				throw CacheTraceConversionException(node, "Not implemented!");
+			}
+
+		private:
+
+			/**
+			 * Obtains the name of the top-level function realizing the given lambda, converting it if necessary.
+			 */
+			string getFunctionName(const core::LambdaExprPtr& lambda) {
+				auto pos = functions.names.find(lambda);
+				if (pos != functions.names.end()) {
+					return pos->second;
+				}
+
+				// skip recursive functions for now
+				if (lambda->isRecursive()) {
+					throw CacheTraceConversionException(lambda, "Recursive functions are not supported yet!");
+				}
+
+				string name = format("skeleton_fun_%d", (int)functions.names.size());
+				functions.names[lambda] = name;
+
+				std::stringstream signature;
+				signature << "static void " << name << "(";
+				const auto& params = lambda->getParameterList()->getParameters();
+				for(std::size_t i = 0; i < params.size(); ++i) {
+					if (i > 0) signature << ", ";
+					signature << getKernelType(params[i]->getType()) << " " << *params[i];
+				}
+				if (params.empty()) signature << "void";
+				signature << ")";
+
+				// convert the body separately, it may contain further functions
+				std::stringstream body;
+				KernelConverter(functions, body).visit(lambda->getBody());
+
+				functions.declarations << signature.str() << ";\n";
+				functions.definitions << signature.str() << " " << body.str() << "\n\n";
+				return name;
+			}
+
+		};
+
+
+		OperatorConverterTable buildDefaultConverterTable(core::NodeManager& manager);
+
+		const OperatorConverterTable& getDefaultConverterTable() {
+			static core::NodeManager manager;
+			const static OperatorConverterTable table = buildDefaultConverterTable(manager);
+			return table;
+		}
+
+		OperatorConverterTable buildDefaultConverterTable(core::NodeManager& manager) {
+			const auto& basic = manager.getLangBasic();
+
+			OperatorConverterTable res;
+
+			#define OP_CONVERTER(Conversion) \
+				[](KernelConverter& converter, const core::CallExprPtr& call) Conversion
+
+			#define PRINT_ARG(index) ( converter.visit(call->getArgument(index)) )
+			#define PRINT_EXPR(expr) ( converter.visit(expr) )
+			#define OUT(code) ( converter.getOut() << code )
+
+			// arithmetic operators
+
+			res[basic.getSignedIntAdd()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" + "); PRINT_ARG(1); });
+			res[basic.getSignedIntSub()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" - "); PRINT_ARG(1); });
+			res[basic.getSignedIntMul()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" * "); PRINT_ARG(1); });
+			res[basic.getSignedIntDiv()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" / "); PRINT_ARG(1); });
+			res[basic.getSignedIntMod()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" % "); PRINT_ARG(1); });
+
+			res[basic.getUnsignedIntAdd()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" + "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntSub()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" - "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntMul()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" * "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntDiv()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" / "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntMod()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" % "); PRINT_ARG(1); });
+
+			res[basic.getRealAdd()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" + "); PRINT_ARG(1); });
+			res[basic.getRealSub()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" - "); PRINT_ARG(1); });
+			res[basic.getRealMul()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" * "); PRINT_ARG(1); });
+			res[basic.getRealDiv()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" / "); PRINT_ARG(1); });
+
+			// relational operators
+
+			res[basic.getSignedIntEq()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" == "); PRINT_ARG(1); });
+			res[basic.getSignedIntNe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" != "); PRINT_ARG(1); });
+			res[basic.getSignedIntLt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" < "); PRINT_ARG(1); });
+			res[basic.getSignedIntGt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" > "); PRINT_ARG(1); });
+			res[basic.getSignedIntLe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" <= "); PRINT_ARG(1); });
+			res[basic.getSignedIntGe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" >= "); PRINT_ARG(1); });
+
+			res[basic.getUnsignedIntEq()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" == "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntNe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" != "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntLt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" < "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntGt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" > "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntLe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" <= "); PRINT_ARG(1); });
+			res[basic.getUnsignedIntGe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" >= "); PRINT_ARG(1); });
+
+			res[basic.getRealEq()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" == "); PRINT_ARG(1); });
+			res[basic.getRealNe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" != "); PRINT_ARG(1); });
+			res[basic.getRealLt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" < "); PRINT_ARG(1); });
+			res[basic.getRealGt()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" > "); PRINT_ARG(1); });
+			res[basic.getRealLe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" <= "); PRINT_ARG(1); });
+			res[basic.getRealGe()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" >= "); PRINT_ARG(1); });
+
+			// logical operators
+
+			res[basic.getBoolEq()]   = OP_CONVERTER({ PRINT_ARG(0); OUT(" == "); PRINT_ARG(1); });
+			res[basic.getBoolNe()]   = OP_CONVERTER({ PRINT_ARG(0); OUT(" != "); PRINT_ARG(1); });
+			res[basic.getBoolLAnd()] = OP_CONVERTER({ PRINT_ARG(0); OUT(" && "); PRINT_EXPR(core::transform::evalLazy(call->getNodeManager(), call->getArgument(1))); });
+			res[basic.getBoolLOr()]  = OP_CONVERTER({ PRINT_ARG(0); OUT(" || "); PRINT_EXPR(core::transform::evalLazy(call->getNodeManager(), call->getArgument(1))); });
+			res[basic.getBoolLNot()] = OP_CONVERTER({ OUT("!"); PRINT_ARG(0); });
+
+			// ref operators - within the skeleton, only scalar values remain
+
+			res[basic.getRefDeref()] = OP_CONVERTER({ PRINT_ARG(0); });
+			res[basic.getRefAssign()] = OP_CONVERTER({
+				converter.setOutermost();
+				PRINT_ARG(0); OUT(" = "); PRINT_ARG(1);
+			});
+
+			// special functions
+
+			res[basic.getIfThenElse()] = OP_CONVERTER({
+				core::NodeManager& manager = call->getNodeManager();
+				OUT("(");
+				PRINT_ARG(0);
+				OUT(" ? ");
+				PRINT_EXPR(core::transform::evalLazy(manager, call->getArgument(1)));
+				OUT(" : ");
+				PRINT_EXPR(core::transform::evalLazy(manager, call->getArgument(2)));
+				OUT(")");
+			});
+			res[basic.getScalarToArray()] = OP_CONVERTER({ PRINT_ARG(0); });
+
+			res[basic.getSelect()] = OP_CONVERTER({
+				core::IRBuilder builder(call->getNodeManager());
+				auto& args = call->getArguments();
+				OUT("(");
+				PRINT_EXPR(builder.callExpr(call->getType(), args[2], args[0], args[1]));
+				OUT(" ? ");
+				PRINT_ARG(0);
+				OUT(" : ");
+				PRINT_ARG(1);
+				OUT(")");
+			});
+
+			#undef PRINT_ARG
+			#undef PRINT_EXPR
+			#undef OP_CONVERTER
+			#undef OUT
+
+			return res;
+		}
+
+
+		/**
+		 * The part of the kernel realizing the functions implanted by the skeleton extraction
+		 * and the output of the access stream.
+		 */
+		const char* kernelPrelude = R"(
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// -- the access stream --
+
+static uint64_t trace_locations[TRACE_BATCH_SIZE];
+static uint32_t trace_sizes[TRACE_BATCH_SIZE];
+static uint32_t trace_length = 0;
+#if TRACE_SAMPLE_PERIOD > 0
+static uint64_t trace_position = 0;
+#endif
+
+static void trace_flush() {
+	if (trace_length == 0) return;
+	fwrite(&trace_length, sizeof(uint32_t), 1, stdout);
+	fwrite(trace_locations, sizeof(uint64_t), trace_length, stdout);
+	fwrite(trace_sizes, sizeof(uint32_t), trace_length, stdout);
+	trace_length = 0;
+}
+
+static inline void access(int64_t location, int64_t size) {
+#if TRACE_SAMPLE_PERIOD > 0
+	// systematic sampling, only the first accesses of every period are recorded
+	if (trace_position++ % TRACE_SAMPLE_PERIOD >= TRACE_SAMPLE_LENGTH) return;
+#endif
+	trace_locations[trace_length] = location;
+	trace_sizes[trace_length] = size;
+	if (++trace_length == TRACE_BATCH_SIZE) trace_flush();
+}
+
+// -- memory locations --
+
+static int64_t mem_pointer = 0;
+
+static int64_t fresh_mem_location() {
+	mem_pointer = mem_pointer + (1 << 27) + 64;
+	return mem_pointer;
+}
+
+// pointer values are assigned fresh locations on their first read, free slots have a value of 0
+static int64_t* ptr_keys = NULL;
+static int64_t* ptr_values = NULL;
+static uint64_t ptr_capacity = 0;
+static uint64_t ptr_size = 0;
+
+static uint64_t ptr_find(int64_t pos) {
+	uint64_t i = ((uint64_t)pos * 0x9E3779B97F4A7C15ull) & (ptr_capacity - 1);
+	while (ptr_values[i] != 0 && ptr_keys[i] != pos) {
+		i = (i + 1) & (ptr_capacity - 1);
+	}
+	return i;
+}
+
+static void ptr_grow() {
+	int64_t* keys = ptr_keys;
+	int64_t* values = ptr_values;
+	uint64_t capacity = ptr_capacity;
+	ptr_capacity = (capacity == 0) ? 1024 : 2 * capacity;
+	ptr_keys = (int64_t*)malloc(ptr_capacity * sizeof(int64_t));
+	ptr_values = (int64_t*)calloc(ptr_capacity, sizeof(int64_t));
+	for (uint64_t i = 0; i < capacity; ++i) {
+		if (values[i] == 0) continue;
+		uint64_t j = ptr_find(keys[i]);
+		ptr_keys[j] = keys[i];
+		ptr_values[j] = values[i];
+	}
+	free(keys);
+	free(values);
+}
+
+static int64_t read_ptr(int64_t pos) {
+	if (2 * (ptr_size + 1) > ptr_capacity) ptr_grow();
+	uint64_t i = ptr_find(pos);
+	if (ptr_values[i] == 0) {
+		ptr_keys[i] = pos;
+		ptr_values[i] = fresh_mem_location();
+		ptr_size++;
+	}
+	return ptr_values[i];
+}
+)";
+
+	}
+
+
+	std::string toCacheTraceKernel(const core::StatementPtr& stmt, const CacheSimulationSettings& settings) {
+		core::StatementPtr skeleton = extractMemorySkeleton(stmt);
+		const auto& basic = stmt->getNodeManager().getLangBasic();
+
+		std::stringstream res;
+		res << "#define TRACE_BATCH_SIZE " << std::max(settings.batchSize, 1u) << "\n";
+		res << "#define TRACE_SAMPLE_LENGTH " << settings.sampleLength << "\n";
+		res << "#define TRACE_SAMPLE_PERIOD " << (settings.isSampling() ? settings.samplePeriod : 0) << "\n";
+		res << kernelPrelude;
+
+		// set up free variables - references are pointing to fresh memory blocks, integers are set to a default value
+		std::stringstream init;
+		std::set<string> declared;
+		auto declare = [&](const core::VariablePtr& var) -> bool {
+			string name = toString(*var);
+			if (!declared.insert(name).second) return false;
+			res << "static " << getKernelType(var->getType()) << " " << name << ";\n";
+			return true;
+		};
+		res << "\n// -- free variables --\n\n";
+		for_each(core::analysis::getFreeVariables(stmt), [&](const core::VariablePtr& var) {
+			if (!declare(var)) return;
+			if (var->getType()->getNodeType() == core::NT_RefType) {
+				init << "    " << *var << " = fresh_mem_location();\n";
+			} else if (basic.isInt(var->getType())) {
+				init << "    " << *var << " = 100;\n";
+			}
+		});
+		if (skeleton) {
+			for_each(core::analysis::getFreeVariables(skeleton), [&](const core::VariablePtr& var) { declare(var); });
+		}
+
+		// convert the skeleton
+		KernelFunctions functions;
+		std::stringstream body;
+		if (skeleton) {
+			KernelConverter(functions, body, 1).visit(skeleton);
+		}
+
+		res << "\n// -- skeleton functions --\n\n";
+		res << functions.declarations.str() << "\n";
+		res << functions.definitions.str();
+
+		res << "// -- code skeleton --\n\n";
+		res << "int main() {\n";
+		res << "    static char buffer[1 << 20];\n";
+		res << "    setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));\n";
+		res << init.str();
+		res << "    " << body.str() << ";\n";
+		res << "    trace_flush();\n";
+		res << "    return 0;\n";
+		res << "}\n";
+		return res.str();
+	}
+
+
+	NativeSimulationResult simulateNative(const core::StatementPtr& stmt, CacheModel& model, const CacheSimulationSettings& settings) {
+
+		// start by eliminating parallel constructs
+		core::StatementPtr seq = core::transform::trySequentialize(stmt->getNodeManager(), stmt);
+		if (!seq) { return NativeSimulationResult::Unsupported; }
+
+		// generate the trace kernel
+		string kernel;
+		try {
+			kernel = toCacheTraceKernel(seq, settings);
+		} catch (const CacheTraceConversionException& cte) {
+			LOG(DEBUG) << "Unable to build cache trace kernel: " << cte.what();
+			return NativeSimulationResult::Unsupported;
+		}
+
+		// compile the trace kernel
+		auto compiler = utils::compiler::Compiler::getOptimizedCompiler(utils::compiler::Compiler::getDefaultC99Compiler(), "2");
+		compiler.setSilent();
+		string binary = utils::compiler::compileToBinary(kernel, compiler);
+		if (binary.empty()) {
+			LOG(WARNING) << "Unable to compile cache trace kernel";
+			return NativeSimulationResult::Unsupported;
+		}
+
+		// run the kernel and feed its access stream to the model
+		FILE* trace = popen(binary.c_str(), "r");
+		if (!trace) {
+			boost::filesystem::remove(binary);
+			return NativeSimulationResult::Unsupported;
+		}
+
+		bool stopped = false;
+		vector<uint64_t> locations;
+		vector<uint32_t> sizes;
+		std::unique_ptr<bool[]> hits;
+		std::size_t capacity = 0;
+		try {
+			uint32_t num;
+			while (fread(&num, sizeof(uint32_t), 1, trace) == 1) {
+				if (capacity < num) {
+					capacity = num;
+					locations.resize(capacity);
+					sizes.resize(capacity);
+					hits.reset(new bool[capacity]);
+				}
+				if (fread(&locations[0], sizeof(uint64_t), num, trace) != num || fread(&sizes[0], sizeof(uint32_t), num, trace) != num) {
+					break;
+				}
+				static_assert(sizeof(unsigned) == sizeof(uint32_t), "Access sizes are read as unsigned values!");
+				model.accessAll(&locations[0], reinterpret_cast<const unsigned*>(&sizes[0]), num, hits.get());
+			}
+		} catch (const EarlyTerminationException&) {
+			// the model has seen enough, closing the stream terminates the kernel
+			stopped = true;
+		} catch (...) {
+			pclose(trace);
+			boost::filesystem::remove(binary);
+			throw;
+		}
+
+		int status = pclose(trace);
+		boost::filesystem::remove(binary);
+
+		if (!stopped && status != 0) {
+			LOG(WARNING) << "Cache trace kernel terminated with status " << status;
+			return NativeSimulationResult::Failed;
+		}
+		return NativeSimulationResult::Completed;
+	}
+
+
+	namespace {
+
+		string buildMsg(const core::NodePtr& source, const string& msg) {
+			std::stringstream res;
+			res << "Unable to convert " << *source << " of type " << source->getNodeType() << " into a cache trace kernel.";
+			if (!msg.empty()) {
+				res << " Reason: " << msg;
+			}
+			return res.str();
+		}
+	}
+
+	CacheTraceConversionException::CacheTraceConversionException(const core::NodePtr& source, const string& msg)
+		: source(source), msg(buildMsg(source, msg)) {}
+
+} // end namespace features
+} // end namespace analysis
+} // end namespace insieme
@@ -38,8 +38,12 @@
 
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #include <boost/type_traits/remove_reference.hpp>
 #include <boost/type_traits/remove_const.hpp>
@@ -447,21 +451,21 @@ namespace {
 				generalizeNodeType([=](const core::CallExprPtr& call)->simple_feature_value_type {
 					return *call->getFunctionExpr() == *op;
 				})
-		  ), mode) {}
+		  ), mode, true) {}
 
 	SimpleCodeFeatureSpec::SimpleCodeFeatureSpec(const vector<core::ExpressionPtr>& ops, FeatureAggregationMode mode)
 		: CodeFeatureSpec(extractor_function(
 				generalizeNodeType([=](const core::CallExprPtr& call)->simple_feature_value_type {
 					return ops.empty() || containsPtrToTarget(ops, call->getFunctionExpr());
 				})
-		  ), mode) {}
+		  ), mode, true) {}
 
 	SimpleCodeFeatureSpec::SimpleCodeFeatureSpec(const core::TypePtr& type, const core::ExpressionPtr& op, FeatureAggregationMode mode)
 		: CodeFeatureSpec(extractor_function(
 				generalizeNodeType([=](const core::CallExprPtr& call)->simple_feature_value_type {
 					return *call->getType() == *type && *call->getFunctionExpr() == *op;
 				})
-		  ), mode) {}
+		  ), mode, true) {}
 
 	SimpleCodeFeatureSpec::SimpleCodeFeatureSpec(const vector<core::TypePtr>& types, const vector<core::ExpressionPtr>& ops, FeatureAggregationMode mode)
 		: CodeFeatureSpec(extractor_function(
@@ -469,7 +473,7 @@ namespace {
 					return (types.empty() || containsPtrToTarget(types, call->getType())) &&
 							(ops.empty() || containsPtrToTarget(ops, call->getFunctionExpr()));
 				})
-		  ), mode) {}
+		  ), mode, true) {}
 
 
 	SimpleCodeFeaturePtr createSimpleCodeFeature(const string& name, const string& desc, const SimpleCodeFeatureSpec& spec) {
@@ -557,30 +561,32 @@ namespace {
 
 
 	SimpleCodeFeatureSpec createVectorOpSpec(const core::ExpressionPtr& elementOp, FeatureAggregationMode mode) {
-		return SimpleCodeFeatureSpec(VectorOpCounter(elementOp), mode);
+		return SimpleCodeFeatureSpec(VectorOpCounter(elementOp), mode, true);
 	}
 
 	SimpleCodeFeatureSpec createVectorOpSpec(const vector<core::ExpressionPtr>& elementOps, FeatureAggregationMode mode) {
-		return SimpleCodeFeatureSpec(VectorOpCounter(elementOps), mode);
+		return SimpleCodeFeatureSpec(VectorOpCounter(elementOps), mode, true);
 	}
 
+	// estimating the element width annotates types => such specs can not be evaluated concurrently
+
 	SimpleCodeFeatureSpec createVectorOpSpec(const core::ExpressionPtr& elementOp, bool considerOpWidth, FeatureAggregationMode mode) {
-		return SimpleCodeFeatureSpec(VectorOpCounter(elementOp, considerOpWidth), mode);
+		return SimpleCodeFeatureSpec(VectorOpCounter(elementOp, considerOpWidth), mode, !considerOpWidth);
 	}
 
 	SimpleCodeFeatureSpec createVectorOpSpec(const vector<core::ExpressionPtr>& elementOps, bool considerOpWidth, FeatureAggregationMode mode) {
-		return SimpleCodeFeatureSpec(VectorOpCounter(elementOps, considerOpWidth), mode);
+		return SimpleCodeFeatureSpec(VectorOpCounter(elementOps, considerOpWidth), mode, !considerOpWidth);
 	}
 
 	SimpleCodeFeatureSpec createVectorOpSpec(const vector<core::TypePtr>& elementTypes, const vector<core::ExpressionPtr>& elementOps, bool considerOpWidth, FeatureAggregationMode mode) {
-		return SimpleCodeFeatureSpec(VectorOpCounter(elementTypes, elementOps, considerOpWidth), mode);
+		return SimpleCodeFeatureSpec(VectorOpCounter(elementTypes, elementOps, considerOpWidth), mode, !considerOpWidth);
 	}
 
 	SimpleCodeFeatureSpec createNumForLoopSpec(FeatureAggregationMode mode) {
 		return SimpleCodeFeatureSpec(
 				[](const core::NodePtr& cur)->simple_feature_value_type {
 			return (cur->getNodeType() == core::NT_ForStmt)?1:0;
-		}, mode);
+		}, mode, true);
 	}
 
 
@@ -649,7 +655,7 @@ namespace {
 
 
 	SimpleCodeFeatureSpec createMemoryAccessSpec(MemoryAccessMode mode, MemoryAccessTarget target, FeatureAggregationMode aggregation) {
-		return SimpleCodeFeatureSpec(MemoryAccessCounter(mode, target), aggregation);
+		return SimpleCodeFeatureSpec(MemoryAccessCounter(mode, target), aggregation, true);
 
 	}
 
@@ -709,40 +715,242 @@ namespace {
 	}
 
 	FeatureValues evalFeatures(const core::NodePtr& root, const vector<const SimpleCodeFeatureSpec*>& features) {
+		// a single use extractor is evaluating all features within one pass
+		return CodeFeatureExtractor(vector<const CodeFeatureSpec*>(features.begin(), features.end())).extract(root);
+	}
 
-		typedef std::map<FeatureAggregationMode, vector<std::pair<const SimpleCodeFeatureSpec*, unsigned>>> ModeMap;
 
-		// sort simple code features according to aggregation mode
-		int counter = 0;
-		ModeMap sorted;
-		for_each(features, [&](const SimpleCodeFeatureSpec* cur) {
-			sorted[cur->getMode()].push_back(std::make_pair(cur, counter++));
-		});
+	// -- Batched feature extraction --
 
-		// resolve features mode by mode
-		FeatureValues res(features.size());
-		for_each(sorted, [&](const ModeMap::value_type& cur) {
+	FeatureExtractionStatistics& FeatureExtractionStatistics::operator+=(const FeatureExtractionStatistics& other) {
+		numRegions += other.numRegions;
+		numNodes += other.numNodes;
+		numEvaluations += other.numEvaluations;
+		time += other.time;
+		return *this;
+	}
 
-			// resolve current aggregation mode
-			FeatureValues cur_res = aggregate(root, [&](const core::NodePtr& node)->FeatureValues {
-				FeatureValues res;
-				for_each(cur.second, [&](const std::pair<const SimpleCodeFeatureSpec*, unsigned>& cur) {
-					res.push_back(cur.first->extract(node));
-				});
+	double FeatureExtractionStatistics::getRegionsPerSecond() const {
+		return (time > 0) ? numRegions / time : 0;
+	}
+
+	double FeatureExtractionStatistics::getNodesPerSecond() const {
+		return (time > 0) ? numNodes / time : 0;
+	}
+
+	std::ostream& FeatureExtractionStatistics::printTo(std::ostream& out) const {
+		return out << format("%u regions, %lu nodes, %lu evaluations in %.3f s (%.1f regions/s, %.1f nodes/s)",
+				numRegions, (unsigned long)numNodes, (unsigned long)numEvaluations, time, getRegionsPerSecond(), getNodesPerSecond());
+	}
+
+	namespace detail {
+
+		/**
+		 * The evaluator utilized by code feature extractors. It maintains one aggregator per aggregation
+		 * mode, all of them obtaining the local feature values of nodes from a shared cache. Both, the
+		 * local values and the aggregated values are memorized per node until the evaluator is cleared.
+		 * Evaluators are not thread safe.
+		 */
+		class FusedFeatureEvaluator : public boost::noncopyable {
+
+			/**
+			 * An extractor obtaining the local values of a sub-set of the features from the shared cache.
+			 */
+			struct SliceExtractor {
+
+				FusedFeatureEvaluator& evaluator;
+				const vector<unsigned>& indices;
+
+				SliceExtractor(FusedFeatureEvaluator& evaluator, const vector<unsigned>& indices)
+					: evaluator(evaluator), indices(indices) {}
+
+				FeatureValues operator()(const core::NodePtr& node) const {
+					FeatureValues all = evaluator.local.get(node);
+					FeatureValues res(indices.size());
+					for(std::size_t i=0; i<indices.size(); i++) {
+						res[i] = all[indices[i]];
+					}
+					return res;
+				}
+			};
+
+			/**
+			 * The features aggregated according to the same mode.
+			 */
+			struct ModeGroup {
+
+				vector<unsigned> indices;
+				SliceExtractor extractor;
+				std::unique_ptr<core::IRVisitor<FeatureValues>> aggregator;
+
+				ModeGroup(FusedFeatureEvaluator& evaluator, FeatureAggregationMode mode, const vector<unsigned>& indices)
+					: indices(indices), extractor(evaluator, this->indices), aggregator(createAggregator(mode, extractor)) {}
+
+				static core::IRVisitor<FeatureValues>* createAggregator(FeatureAggregationMode mode, const SliceExtractor& extractor) {
+					switch(mode) {
+					case FA_Static: 		return new StaticFeatureAggregator<SliceExtractor, FeatureValues>(extractor);
+					case FA_Weighted: 		return new EstimatedFeatureAggregator<SliceExtractor, FeatureValues>(extractor);
+					case FA_Real: 			return new RealFeatureAggregator<SliceExtractor, FeatureValues>(extractor);
+					case FA_Polyhedral: 	return new PolyhedralFeatureAggregator<SliceExtractor, FeatureValues>(extractor);
+					}
+					assert_fail() << "Invalid mode selected!";
+					return nullptr;
+				}
+			};
+
+			const vector<const CodeFeatureSpec*>& specs;
+
+			/**
+			 * The local values of all features, indexed by the node.
+			 */
+			utils::cache::PointerCache<core::NodePtr, FeatureValues> local;
+
+			/**
+			 * The aggregators, one for each aggregation mode requested by any of the features.
+			 */
+			vector<std::unique_ptr<ModeGroup>> groups;
+
+			uint64_t numNodes;
+
+		public:
+
+			FusedFeatureEvaluator(const vector<const CodeFeatureSpec*>& specs)
+				: specs(specs), local(fun(*this, &FusedFeatureEvaluator::evalLocal)), numNodes(0) {
+
+				// sort features according to aggregation mode
+				std::map<FeatureAggregationMode, vector<unsigned>> sorted;
+				for(unsigned i=0; i<specs.size(); i++) {
+					sorted[specs[i]->getMode()].push_back(i);
+				}
+
+				for(const auto& cur : sorted) {
+					groups.push_back(std::unique_ptr<ModeGroup>(new ModeGroup(*this, cur.first, cur.second)));
+				}
+			}
+
+			FeatureValues evaluate(const core::NodePtr& root) {
+				FeatureValues res(specs.size());
+				for(const auto& cur : groups) {
+					FeatureValues values = cur->aggregator->visit(root);
+					// aggregators may produce shorter lists if no value has been extracted (e.g. empty SCoPs)
+					for(std::size_t i=0; i<cur->indices.size() && i<values.size(); i++) {
+						res[cur->indices[i]] = values[i];
+					}
+				}
 				return res;
-			}, cur.first);
+			}
 
-			// copy results to result-vector
-			int i=0;
-			for_each(cur.second, [&](const std::pair<const SimpleCodeFeatureSpec*, unsigned>& cur) {
-				res[cur.second] = cur_res[i++];
-			});
-		});
+			uint64_t getNumNodes() const {
+				return numNodes;
+			}
+
+		private:
+
+			FeatureValues evalLocal(const core::NodePtr& node) {
+				numNodes++;
+				FeatureValues res(specs.size());
+				for(std::size_t i=0; i<specs.size(); i++) {
+					res[i] = specs[i]->extract(node);
+				}
+				return res;
+			}
+
+		};
+
+	}
+
+	namespace {
+
+		double getSecondsSince(const std::chrono::steady_clock::time_point& start) {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+	}
+
+	CodeFeatureExtractor::CodeFeatureExtractor(const vector<const CodeFeatureSpec*>& specs)
+		: specs(specs), evaluator(new detail::FusedFeatureEvaluator(this->specs)) {}
+
+	CodeFeatureExtractor::~CodeFeatureExtractor() {}
+
+	FeatureValues CodeFeatureExtractor::extract(const core::NodePtr& region) {
+		auto start = std::chrono::steady_clock::now();
+		uint64_t nodes = evaluator->getNumNodes();
+
+		FeatureValues res = evaluator->evaluate(region);
 
-		// now all the fields within the resulting value vector should be filled
+		// update statistics
+		FeatureExtractionStatistics cur;
+		cur.numRegions = 1;
+		cur.numNodes = evaluator->getNumNodes() - nodes;
+		cur.numEvaluations = cur.numNodes * specs.size();
+		cur.time = getSecondsSince(start);
+		statistics += cur;
 		return res;
 	}
 
+	vector<FeatureValues> CodeFeatureExtractor::extract(const vector<core::NodePtr>& regions, unsigned numThreads) {
+
+		// use sequential extraction if parallelism is not requested or not supported
+		if (numThreads <= 1 || regions.size() <= 1 || !supportsConcurrentExtraction(regions)) {
+			vector<FeatureValues> res;
+			for(const auto& cur : regions) {
+				res.push_back(extract(cur));
+			}
+			return res;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		// distribute regions among threads, each utilizing a private evaluator
+		vector<FeatureValues> res(regions.size());
+		vector<std::exception_ptr> errors(regions.size());
+		std::atomic<std::size_t> next(0);
+		std::atomic<uint64_t> nodes(0);
+
+		auto worker = [&]() {
+			detail::FusedFeatureEvaluator evaluator(specs);
+			for(std::size_t i = next++; i < regions.size(); i = next++) {
+				try {
+					res[i] = evaluator.evaluate(regions[i]);
+				} catch(...) {
+					errors[i] = std::current_exception();
+				}
+			}
+			nodes += evaluator.getNumNodes();
+		};
+
+		// the calling thread is participating as well
+		vector<std::thread> threads;
+		for(unsigned i = 1; i < std::min<std::size_t>(numThreads, regions.size()); ++i) {
+			threads.push_back(std::thread(worker));
+		}
+		worker();
+		for(auto& cur : threads) cur.join();
+
+		// forward the first error
+		for(const auto& cur : errors) {
+			if(cur) std::rethrow_exception(cur);
+		}
+
+		// update statistics
+		FeatureExtractionStatistics cur;
+		cur.numRegions = regions.size();
+		cur.numNodes = nodes;
+		cur.numEvaluations = cur.numNodes * specs.size();
+		cur.time = getSecondsSince(start);
+		statistics += cur;
+		return res;
+	}
+
+	bool CodeFeatureExtractor::supportsConcurrentExtraction(const vector<core::NodePtr>& regions) const {
+		return all(specs, [](const CodeFeatureSpec* cur) { return cur->isConcurrent() && cur->getMode() != FA_Polyhedral; }) &&
+				all(regions, [](const core::NodePtr& cur) { return cur->getNodeManager().isConcurrent(); });
+	}
+
+	void CodeFeatureExtractor::clear() {
+		evaluator.reset(new detail::FusedFeatureEvaluator(specs));
+	}
+
 
 
 	// -- Operator statistics --
@@ -44,6 +44,8 @@
 
 #include "insieme/analysis/features/code_features.h"
 
+#include "insieme/utils/logging.h"
+
 namespace insieme {
 namespace analysis {
 namespace features {
@@ -117,38 +119,70 @@ namespace features {
 	}
 
 
-	vector<Value> extractFrom(const core::NodePtr& node, const vector<FeaturePtr>& features) {
-
+	namespace {
 
-		// create resulting container
-		vector<Value> res(features.size());
+		/**
+		 * Obtains the specification of the given feature if it is a code feature which may be evaluated
+		 * by a code feature extractor, null otherwise.
+		 */
+		const CodeFeatureSpec* getCodeFeatureSpec(const FeaturePtr& feature) {
+			if (SimpleCodeFeaturePtr cur = dynamic_pointer_cast<SimpleCodeFeature>(feature)) return &cur->getSpec();
+			if (PatternCodeFeaturePtr cur = dynamic_pointer_cast<PatternCodeFeature>(feature)) return &cur->getSpec();
+			if (LambdaCodeFeaturePtr cur = dynamic_pointer_cast<LambdaCodeFeature>(feature)) return &cur->getSpec();
+			return nullptr;
+		}
 
-		// separate out simple code features
-		vector<unsigned> indices;
-		vector<const SimpleCodeFeatureSpec*> specs;
+		/**
+		 * Extracts the given features from the given regions, code features in a single pass
+		 * per region. If requested, the throughput of the code feature extraction is logged.
+		 */
+		vector<vector<Value>> extractAll(const vector<core::NodePtr>& regions, const vector<FeaturePtr>& features, unsigned numThreads, bool logStatistics) {
+
+			// create resulting container
+			vector<vector<Value>> res(regions.size(), vector<Value>(features.size()));
+
+			// separate out code features
+			vector<unsigned> indices;
+			vector<const CodeFeatureSpec*> specs;
+			for(unsigned i=0; i<features.size(); i++) {
+				if (const CodeFeatureSpec* spec = getCodeFeatureSpec(features[i])) {
+					indices.push_back(i);
+					specs.push_back(spec);
+				}
+			}
 
-		int counter = 0;
-		for_each(features, [&](const FeaturePtr& cur) {
-			// collect list of simple code feature specifications
-			if (SimpleCodeFeaturePtr simpleFeature = dynamic_pointer_cast<SimpleCodeFeature>(cur)) {
-				indices.push_back(counter++);
-				specs.push_back(&simpleFeature->getSpec());
-			} else {
-				// if not simple => process immediately
-				res[counter++] = cur->extractFrom(node);
+			// process code features within a single pass per region
+			CodeFeatureExtractor extractor(specs);
+			vector<FeatureValues> values = extractor.extract(regions, numThreads);
+			if (logStatistics) {
+				LOG(DEBUG) << "Code feature extraction: " << extractor.getStatistics();
 			}
-		});
 
-		// process simple code features
-		FeatureValues values = evalFeatures(node, specs);
+			// merge in extracted values and process remaining features individually
+			for(std::size_t r=0; r<regions.size(); r++) {
+				assert_eq(indices.size(), values[r].size());
+				for (std::size_t i=0; i<indices.size(); i++) {
+					res[r][indices[i]] = values[r][i];
+				}
+				for (std::size_t i=0; i<features.size(); i++) {
+					if (!getCodeFeatureSpec(features[i])) {
+						res[r][i] = features[i]->extractFrom(regions[r]);
+					}
+				}
+			}
 
-		// merge in extracted values
-		assert_true(indices.size() == specs.size() && indices.size() == values.size());
-		for (std::size_t i=0; i<indices.size(); i++) {
-			res[indices[i]] = values[i];
+			return res;
 		}
 
-		return res;
+	}
+
+
+	vector<Value> extractFrom(const core::NodePtr& node, const vector<FeaturePtr>& features) {
+		return extractAll(toVector(node), features, 1, false).front();
+	}
+
+	vector<vector<Value>> extractFrom(const vector<core::NodePtr>& regions, const vector<FeaturePtr>& features, unsigned numThreads) {
+		return extractAll(regions, features, numThreads, true);
 	}
 
 
@@ -79,7 +79,7 @@ void AffineFunction::buildFromFormula(IterationVector& iterVec, const insieme::c
 	}
 
 		
-	const std::vector<Formula::Term>& terms = formula.getTerms();
+	const Formula::term_list& terms = formula.getTerms();
 	// we have to updated the iteration vector by adding eventual parameters which are being used by
 	// this function. Because by looking to an expression we cannot determine if a variable is an
 	// iterator or a parameter we assume that variables in this expression which do not appear in
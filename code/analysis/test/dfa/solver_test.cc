@@ -41,6 +41,7 @@
 #include "insieme/analysis/dfa/entity.h"
 
 #include "insieme/analysis/dfa/analyses/live_vars.h"
+#include "insieme/analysis/dfa/analyses/reaching_defs.h"
 
 #include "insieme/core/ir_program.h"
 #include "insieme/core/ir_builder.h"
@@ -51,6 +52,7 @@
 
 #include "insieme/utils/set_utils.h"
 #include "insieme/utils/logging.h"
+#include "insieme/utils/timer.h"
 
 using namespace insieme;
 using namespace insieme::core;
@@ -132,3 +134,200 @@ TEST(Problem, LiveVariables) {
 
 }
 
+TEST(Problem, PriorityWorklist) {
+
+	PriorityWorklist q(8);
+	EXPECT_TRUE(q.empty());
+
+	q.enqueue(5);
+	q.enqueue(1);
+	q.enqueue(7);
+	q.enqueue(1);
+	q.enqueue(3);
+	EXPECT_EQ(4u, q.size());
+
+	EXPECT_EQ(1u, q.dequeue());
+	EXPECT_EQ(3u, q.dequeue());
+
+	// a dequeued rank can be inserted again
+	q.enqueue(1);
+	EXPECT_EQ(1u, q.dequeue());
+	EXPECT_EQ(5u, q.dequeue());
+	EXPECT_EQ(7u, q.dequeue());
+	EXPECT_TRUE(q.empty());
+}
+
+TEST(Problem, PostOrder) {
+
+	NodeManager mgr;
+	IRBuilder builder(mgr);
+
+	std::map<std::string, core::NodePtr> symbols;
+	symbols["v"] = builder.variable(builder.parseType("ref<array<int<4>,1>>"));
+	symbols["b"] = builder.variable(builder.parseType("int<4>"));
+
+    auto code = builder.parseStmt(
+		"{"
+		"	decl ref<int<4>> a = 0;"
+		"	for(int<4> i = 10 .. 50) { "
+		"		v[i+b]; "
+		"	}"
+		"	decl int<4> c = *a;"
+		"}", symbols
+    );
+
+    EXPECT_TRUE(code);
+
+	CFGPtr cfg = CFG::buildCFG(code);
+
+	std::set<size_t> visited;
+	cfg->visitDFS([&](const cfg::BlockPtr& block) { visited.insert(block->getBlockID()); });
+
+	auto order = getPostOrder(*cfg);
+	EXPECT_EQ(cfg->size(), order.size());
+
+	// the reachable blocks come first, the entry closes their postorder
+	ASSERT_LE(visited.size(), order.size());
+	EXPECT_TRUE(cfg->isEntry(order[visited.size()-1]));
+
+	std::set<size_t> reachable;
+	for(size_t i = 0; i < visited.size(); ++i) { reachable.insert(order[i]->getBlockID()); }
+	EXPECT_EQ(visited, reachable);
+
+	// every block is listed exactly once
+	std::set<size_t> listed;
+	for(const auto& block : order) { listed.insert(block->getBlockID()); }
+	EXPECT_EQ(cfg->size(), listed.size());
+}
+
+TEST(Problem, EntityIndex) {
+
+	EntityIndex<int> index(std::set<int>({ 7, 3, 5 }));
+	EXPECT_EQ(3u, index.size());
+	EXPECT_EQ(3, index[0]);
+	EXPECT_EQ(7, index[2]);
+
+	auto bits = index.toBitSet(std::set<int>({ 5, 11 }));
+	EXPECT_EQ(4u, index.size());
+	EXPECT_EQ(4u, bits.size());
+	EXPECT_EQ(2u, bits.count());
+	EXPECT_TRUE(bits.test(1));
+	EXPECT_TRUE(bits.test(3));
+
+	EXPECT_EQ(std::set<int>({ 5, 11 }), index.toSet(bits));
+
+	// adding an unknown entity extends both the index and the bit-vector
+	index.add(bits, 13);
+	EXPECT_EQ(5u, index.size());
+	EXPECT_EQ(5u, bits.size());
+	EXPECT_TRUE(bits.test(4));
+	EXPECT_EQ(std::set<int>({ 5, 11, 13 }), index.toSet(bits));
+}
+
+namespace {
+
+	/**
+	 * Generates a loop containing the given number of branches, each of them defining one of two
+	 * variables.
+	 */
+	StatementPtr buildBranches(IRBuilder& builder, unsigned branches) {
+
+		std::stringstream ss;
+		ss << "{"
+		   << "	decl int<4> i = 2; "
+		   << "	decl int<4> j = 3; "
+		   << "	decl ref<int<4>> a = var(0); "
+		   << "	decl ref<int<4>> b = var(1); "
+		   << "	while ( a <= 0 ) { ";
+
+		for(unsigned k = 0; k < branches; ++k) {
+			ss << "	if ( a <= " << k << " ) { a = i+j; } else { b = i+j; } ";
+		}
+
+		ss << "	}"
+		   << "	decl int<4> c = *a;"
+		   << "	decl int<4> d = *b;"
+		   << "}";
+
+		return builder.parseStmt(ss.str());
+	}
+
+}
+
+TEST(Problem, BitVectorReachingDefinitions) {
+
+	NodeManager mgr;
+	IRBuilder builder(mgr);
+
+	auto code = buildBranches(builder, 8);
+	EXPECT_TRUE(code);
+
+	CFGPtr cfg = CFG::buildCFG(code);
+
+	Solver<analyses::ReachingDefinitions> s1(*cfg);
+	auto generic = s1.solve(GenericRepresentationTag());
+
+	Solver<analyses::ReachingDefinitions> s2(*cfg);
+	auto dense = s2.solve(BitVectorRepresentationTag());
+
+	EXPECT_EQ(generic, dense);
+}
+
+TEST(Problem, BitVectorLiveVariables) {
+
+	NodeManager mgr;
+	IRBuilder builder(mgr);
+
+	auto code = buildBranches(builder, 8);
+	EXPECT_TRUE(code);
+
+	CFGPtr cfg = CFG::buildCFG(code);
+
+	// the access classes of the two problem instances are not shared, compare the size of the sets
+	Solver<analyses::LiveVariables> s1(*cfg);
+	auto generic = s1.solve(GenericRepresentationTag());
+
+	Solver<analyses::LiveVariables> s2(*cfg);
+	auto dense = s2.solve(BitVectorRepresentationTag());
+
+	EXPECT_EQ(generic.size(), dense.size());
+	for(const auto& cur : generic) {
+		auto fit = dense.find(cur.first);
+		EXPECT_NE(fit, dense.end());
+		if (fit != dense.end()) { EXPECT_EQ(cur.second.size(), fit->second.size()) << "Block " << cur.first; }
+	}
+}
+
+TEST(Problem, BitVectorBenchmark) {
+
+	NodeManager mgr;
+	IRBuilder builder(mgr);
+
+	for(unsigned branches : { 32u, 128u, 512u }) {
+
+		auto code = buildBranches(builder, branches);
+		EXPECT_TRUE(code);
+
+		CFGPtr cfg = CFG::buildCFG(code);
+
+		Solver<analyses::ReachingDefinitions> s1(*cfg);
+		Solver<analyses::ReachingDefinitions> s2(*cfg);
+		Solver<analyses::LiveVariables> s3(*cfg);
+		Solver<analyses::LiveVariables> s4(*cfg);
+
+		Solver<analyses::ReachingDefinitions>::CFGBlockMap rd1, rd2;
+		Solver<analyses::LiveVariables>::CFGBlockMap lv1, lv2;
+
+		double tRd1 = TIME(rd1 = s1.solve(GenericRepresentationTag()));
+		double tRd2 = TIME(rd2 = s2.solve(BitVectorRepresentationTag()));
+		double tLv1 = TIME(lv1 = s3.solve(GenericRepresentationTag()));
+		double tLv2 = TIME(lv2 = s4.solve(BitVectorRepresentationTag()));
+
+		EXPECT_EQ(rd1, rd2);
+		EXPECT_EQ(lv1.size(), lv2.size());
+
+		std::cout << "Blocks: " << cfg->size()
+				  << " - ReachingDefinitions: " << tRd1 << "s / " << tRd2 << "s"
+				  << " - LiveVariables: " << tLv1 << "s / " << tLv2 << "s\n";
+	}
+}
@@ -41,8 +41,10 @@
 #include "insieme/core/ir_builder.h"
 
 #include "insieme/analysis/features/cache_features.h"
+#include "insieme/analysis/features/cache_simulation.h"
 
 #include "insieme/utils/timer.h"
+#include "insieme/utils/compiler/compiler.h"
 
 namespace insieme {
 namespace analysis {
@@ -310,6 +312,94 @@ namespace features {
 
 	}
 
+	TEST(CacheSimulator, TraceKernel) {
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<array<int<4>,1>>"));
+
+		auto forStmt = builder.parseStmt(
+			"for( int<4> i = 0 .. 100) {"
+			"	v[i] = i;"
+			"}", symbols).as<ForStmtPtr>();
+
+		EXPECT_TRUE(forStmt);
+
+		// the kernel is a self-contained C program
+		string kernel = toCacheTraceKernel(forStmt);
+		EXPECT_PRED2(containsSubString, kernel, "access(");
+		EXPECT_PRED2(containsSubString, kernel, "fresh_mem_location()");
+		EXPECT_TRUE(utils::compiler::compile(kernel)) << kernel;
+
+		// it produces the same accesses as the Lua script
+		DirectCacheModel<16,8> model;
+		model.reset();
+		EXPECT_EQ(NativeSimulationResult::Completed, simulateNative(forStmt, model));
+		EXPECT_EQ((100*4)/16,  model.getMisses());
+		EXPECT_EQ(100*4 - model.getMisses(), model.getHits());
+	}
+
+	TEST(CacheSimulator, TraceSampling) {
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<vector<vector<int<4>,100>,100>>"));
+
+		auto forStmt = builder.parseStmt(
+			"for(int<4> i = 0 .. 100) {"
+			"	for(int<4> j = 0 .. 100) {"
+			"		v[i][j] = i+j;"
+			"	}"
+			"}", symbols).as<ForStmtPtr>();
+
+		EXPECT_TRUE(forStmt);
+
+		// small batches, all accesses
+		EmptyModel model;
+		EXPECT_TRUE(evalModel(forStmt, model, CacheSimulationSettings(7)));
+		EXPECT_EQ(100*100, model.counter);
+
+		// only the first 10 out of every 100 accesses
+		model.reset();
+		EXPECT_TRUE(evalModel(forStmt, model, CacheSimulationSettings(4096, 10, 100)));
+		EXPECT_EQ(100*10, model.counter);
+	}
+
+	TEST(CacheSimulator, BatchedMultiLevelCache) {
+
+		typedef MultiLevelCache<
+			LRUCacheModel<4,2,1>,
+			LRUCacheModel<4,16,2>,
+			LRUCacheModel<4,512,16>
+		> Cache;
+
+		std::unique_ptr<Cache> single(new Cache());
+		std::unique_ptr<Cache> batched(new Cache());
+		single->reset();
+		batched->reset();
+
+		// some irregular access pattern
+		const unsigned num = 10000;
+		vector<uint64_t> locations;
+		vector<unsigned> sizes;
+		for (unsigned i=0; i<num; ++i) {
+			locations.push_back((i * 7919) % 8192 + (i % 3));
+			sizes.push_back((i % 5 == 0) ? 8 : 4);
+		}
+
+		// batches need to be simulated level by level producing the same results
+		std::unique_ptr<bool[]> hits(new bool[num]);
+		for (unsigned i=0; i<num; i+=1000) {
+			batched->accessAll(&locations[i], &sizes[i], 1000, &hits[i]);
+		}
+		for (unsigned i=0; i<num; ++i) {
+			EXPECT_EQ(single->access(locations[i], sizes[i]), hits[i]);
+		}
+		EXPECT_EQ(toString(single->getFeatureValue()), toString(batched->getFeatureValue()));
+	}
+
 } // end namespace features
 } // end namespace analysis
 } // end namespace insieme
@@ -371,6 +371,118 @@ namespace features {
 
 	}
 
+	TEST(CodeFeatures, Extractor) {
+
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+		auto& basic = mgr.getLangBasic();
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<array<int<4>,1>>"));
+
+		auto forStmt = builder.parseStmt(
+			"for(uint<4> i = 10u .. 50u : 1u) {"
+			"	v[i];"
+			"	for(uint<4> j = 5u .. 25u : 1u) {"
+			"		if ( j < 10u ) {"
+			"			v[i+j]; v[i+j];"
+			"		} else {"
+			"			v[i-j]; v[i-j];"
+			"		};"
+			"	};"
+			"}", symbols).as<ForStmtPtr>();
+
+		EXPECT_TRUE(forStmt);
+
+		vector<SimpleCodeFeatureSpec> features;
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntAdd(), FA_Static));
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntAdd(), FA_Weighted));
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntSub(), FA_Real));
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntSub(), FA_Polyhedral));
+		features.push_back(createMemoryAccessSpec(READ_WRITE, ANY, FA_Real));
+		features.push_back(createNumForLoopSpec(FA_Static));
+
+		vector<const CodeFeatureSpec*> specs;
+		for(const auto& cur : features) specs.push_back(&cur);
+
+		// the outer loop and its body are sharing all nodes of the body
+		vector<NodePtr> regions = toVector<NodePtr>(forStmt, forStmt->getBody());
+
+		CodeFeatureExtractor extractor(specs);
+		extractor.extract(forStmt);
+		uint64_t numNodes = extractor.getStatistics().numNodes;
+
+		vector<FeatureValues> values = extractor.extract(regions);
+
+		ASSERT_EQ(regions.size(), values.size());
+		for(std::size_t r=0; r<regions.size(); r++) {
+			ASSERT_EQ(features.size(), values[r].size());
+			for(std::size_t i=0; i<features.size(); i++) {
+				EXPECT_EQ(evalFeature(regions[r], features[i]), values[r][i]) << "Region: " << r << ", Feature: " << i;
+			}
+		}
+
+		// all nodes have been evaluated while processing the first region
+		const FeatureExtractionStatistics& stats = extractor.getStatistics();
+		EXPECT_EQ(3u, stats.numRegions);
+		EXPECT_LT(0u, numNodes);
+		EXPECT_EQ(numNodes, stats.numNodes);
+		EXPECT_EQ(stats.numNodes * features.size(), stats.numEvaluations);
+
+		// after clearing the memorized results, nodes are evaluated again
+		extractor.clear();
+		EXPECT_EQ(values[1], extractor.extract(forStmt->getBody()));
+		EXPECT_LT(numNodes, extractor.getStatistics().numNodes);
+	}
+
+	TEST(CodeFeatures, ExtractorParallel) {
+
+		NodeManager mgr(NodeManager::CONCURRENT_ACCESS);
+		IRBuilder builder(mgr);
+		auto& basic = mgr.getLangBasic();
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<array<int<4>,1>>"));
+
+		// create a list of regions sharing some of their sub-trees
+		vector<NodePtr> regions;
+		for(int i=0; i<20; i++) {
+			regions.push_back(builder.parseStmt(format(
+				"for(uint<4> i = 0u .. %du : 1u) {"
+				"	for(uint<4> j = 0u .. 10u : 1u) {"
+				"		v[i+j]; v[i-j];"
+				"	};"
+				"}", i + 1), symbols));
+		}
+
+		vector<SimpleCodeFeatureSpec> features;
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntAdd(), FA_Static));
+		features.push_back(SimpleCodeFeatureSpec(basic.getUnsignedIntSub(), FA_Real));
+		features.push_back(createMemoryAccessSpec(READ, ARRAY, FA_Weighted));
+
+		vector<const CodeFeatureSpec*> specs;
+		for(const auto& cur : features) specs.push_back(&cur);
+
+		CodeFeatureExtractor sequential(specs);
+		CodeFeatureExtractor parallel(specs);
+		EXPECT_TRUE(parallel.supportsConcurrentExtraction(regions));
+
+		vector<FeatureValues> expected = sequential.extract(regions);
+		EXPECT_EQ(expected, parallel.extract(regions, 4));
+		EXPECT_EQ(regions.size(), parallel.getStatistics().numRegions);
+
+		// polyhedral aggregation and pattern features annotate nodes => sequential only
+		SimpleCodeFeatureSpec polyhedral(basic.getUnsignedIntAdd(), FA_Polyhedral);
+		EXPECT_FALSE(CodeFeatureExtractor(toVector<const CodeFeatureSpec*>(&polyhedral)).supportsConcurrentExtraction(regions));
+
+		LambdaCodeFeatureSpec lambda([](const NodePtr&) { return 1.0; }, FA_Static);
+		EXPECT_FALSE(CodeFeatureExtractor(toVector<const CodeFeatureSpec*>(&lambda)).supportsConcurrentExtraction(regions));
+
+		// regions of a sequential manager are processed sequentially
+		NodeManager seqMgr;
+		vector<NodePtr> seqRegions = toVector<NodePtr>(IRBuilder(seqMgr).intLit(1));
+		EXPECT_FALSE(parallel.supportsConcurrentExtraction(seqRegions));
+	}
 
 } // end namespace features
 } // end namespace analysis
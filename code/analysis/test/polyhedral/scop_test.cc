@@ -45,6 +45,7 @@
 #include "insieme/core/ir_program.h"
 #include "insieme/core/ir_statements.h"
 #include "insieme/utils/logging.h"
+#include "insieme/utils/timer.h"
 
 using namespace insieme::core;
 using namespace insieme::analysis;
@@ -804,4 +805,58 @@ TEST(ScopRegion, ForStmtToIR4) {
 	EXPECT_EQ("{ref<int<4>> v0 = v4; for(int<4> v2 = 10 .. 50 : 1) {ref_assign(v0, ref_deref(v4)); rec v0.{v0=fun(ref<vector<'elem,#l>> v1, uint<8> v2) {return ref_narrow(v1, dp_element(dp_root, v2), type<'elem>);}}(v1, cast<uint<8>>(int_add(v2, v3)));};}", toString(*res));
 }
 
+TEST(ScopRegion, ExtractionBenchmark) {
+	using namespace insieme::core::arithmetic;
+
+	// extracts the SCoPs of the ForStmt4 and ForStmt5 inputs repeatedly, every extraction works on a
+	// fresh node manager such that no annotation of a previous run is reused
+	double time = 0.0;
+	for(int k=0; k<200; k++) {
+
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<vector<int<4>,100>>"),1);
+		symbols["b"] = builder.variable(builder.parseType("int<4>"),2);
+		symbols["ub"] = builder.variable(builder.parseType("int<4>"),3);
+		symbols["lb"] = builder.variable(builder.parseType("int<4>"),4);
 
+		auto forStmt4 = analysis::normalize(builder.parseStmt(
+			"for( int<4> i = cloog_floor(5, 2) .. 20 : 5) { "
+			"	v[i+b]; "
+			"}", symbols)).as<ForStmtPtr>();
+
+		auto forStmt5 = analysis::normalize(builder.parseStmt(
+			"for(int<4> i = cloog_ceil(lb, 3) .. ub : 5) { "
+			"	v[i+b]; "
+			"}", symbols)).as<ForStmtPtr>();
+
+		ASSERT_TRUE(forStmt4 && forStmt5);
+
+		time += TIME(
+			scop::mark(forStmt4);
+			scop::mark(forStmt5);
+		);
+
+		// the extracted regions have to match the results of ForStmt4 and ForStmt5
+		ASSERT_TRUE(forStmt4->hasAnnotation(scop::ScopRegion::KEY));
+		ASSERT_TRUE(forStmt5->hasAnnotation(scop::ScopRegion::KEY));
+
+		scop::ScopRegion& ann4 = *forStmt4->getAnnotation(scop::ScopRegion::KEY);
+		EXPECT_EQ("(v0,v10000,v10001,v10002|v2|1)", toString(ann4.getIterationVector()));
+		EXPECT_EQ("((((((-2*v10000 + -v10001 + 5 == 0) ^ (v10001 + -2 < 0)) ^ (v10001 >= 0)) ^ (v0 + -v10000 >= 0)) ^ (v0 + -20 < 0)) ^ (v0 + -v10000 + -5*v10002 == 0))", toString(ann4.getDomainConstraints()));
+
+		scop::ScopRegion& ann5 = *forStmt5->getAnnotation(scop::ScopRegion::KEY);
+		EXPECT_EQ("(v0,v10000,v10001,v10002|v2,v4,v3|1)", toString(ann5.getIterationVector()));
+		EXPECT_EQ("((((((-3*v10000 + v10001 + v4 == 0) ^ (v10001 + -3 < 0)) ^ (v10001 >= 0)) ^ (v0 + -v10000 >= 0)) ^ (v0 + -v3 < 0)) ^ (v0 + -v10000 + -5*v10002 == 0))", toString(ann5.getDomainConstraints()));
+
+		// the cardinality exercises the formula conversions of the extracted constraints
+		time += TIME(
+			Piecewise pw = cardinality(mgr, ann4.getDomainConstraints());
+			EXPECT_EQ(Formula(4), pw.toFormula());
+		);
+	}
+
+	std::cout << "SCoP extraction benchmark: " << time << "s\n";
+}
@@ -48,7 +48,8 @@ namespace backend {
         	mainFunctionName("main"),
         	areShiftOpsSupported(true),
         	instrumentMainFunction(false),
-        	addIRCodeAsComment(false) {};
+        	addIRCodeAsComment(false),
+        	numShards(1) {};
 
         std::string mainFunctionName;
         std::vector<std::string> additionalHeaderFiles;
@@ -56,6 +57,12 @@ namespace backend {
         bool instrumentMainFunction;
 
         bool addIRCodeAsComment;
+
+        /**
+         * The number of translation units the generated C code should be partitioned into.
+         * If larger than 1, the conversion produces a c_ast::ShardedCCode instance.
+         */
+        unsigned numShards;
 	};
 
 	typedef std::shared_ptr<BackendConfig> BackendConfigPtr;
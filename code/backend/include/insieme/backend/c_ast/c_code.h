@@ -163,6 +163,13 @@ namespace c_ast {
 			return std::make_shared<CCode>(manager, source, fragments);
 		}
 
+		/**
+		 * Obtains the list of code fragments forming this program in the order they are printed.
+		 */
+		const vector<CodeFragmentPtr>& getFragments() const {
+			return fragments;
+		}
+
 		/**
 		 * Allows this code fragment to be printed to some output stream according
 		 * to the Printable interface.
@@ -171,6 +178,92 @@ namespace c_ast {
 
 	};
 
+	/**
+	 * A C code which is additionally partitioned into a number of self-contained translation
+	 * units (shards) sharing a common header. The header contains all type definitions and
+	 * declarations while function definitions are distributed among the shards such that
+	 * the shards can be compiled independently (and in parallel).
+	 *
+	 * Fragments which can not be placed into the shared header and are not plain function
+	 * definitions (e.g. global variables or fragments mixing type and function definitions)
+	 * are placed in the first shard, together with everything depending on them. When printed
+	 * through the Printable interface, the code is presented as a single translation unit.
+	 */
+	class ShardedCCode : public CCode {
+
+		/**
+		 * The fragments to be placed within the shared header.
+		 */
+		vector<CodeFragmentPtr> header;
+
+		/**
+		 * The fragments to be placed within the individual shards.
+		 */
+		vector<vector<CodeFragmentPtr>> shards;
+
+	public:
+
+		/**
+		 * Creates a new sharded C code instance partitioning the given fragments into the
+		 * given number of shards.
+		 *
+		 * @param manager the fragment manager maintaining the given code fragments
+		 * @param source the IR node this code has been generated from
+		 * @param fragments the code fragments this code is consisting of in topological order
+		 * @param numShards the number of shards to be produced, at least 1
+		 */
+		ShardedCCode(const SharedCodeFragmentManager& manager, const core::NodePtr& source, const vector<CodeFragmentPtr>& fragments, unsigned numShards);
+
+		/**
+		 * Creates a new sharded C code instance (see constructor).
+		 */
+		static ShardedCCodePtr createNew(const SharedCodeFragmentManager& manager, const core::NodePtr& source, const vector<CodeFragmentPtr>& fragments, unsigned numShards) {
+			return std::make_shared<ShardedCCode>(manager, source, fragments, numShards);
+		}
+
+		const vector<CodeFragmentPtr>& getHeaderFragments() const {
+			return header;
+		}
+
+		const vector<vector<CodeFragmentPtr>>& getShards() const {
+			return shards;
+		}
+
+		unsigned getNumShards() const {
+			return shards.size();
+		}
+
+		/**
+		 * Prints the shared header to the given output stream.
+		 *
+		 * @param out the stream to be printed to
+		 * @param guard the name of the include guard to be used
+		 */
+		std::ostream& printHeader(std::ostream& out, const string& guard) const;
+
+		/**
+		 * Prints the requested shard to the given output stream.
+		 *
+		 * @param out the stream to be printed to
+		 * @param shard the index of the shard to be printed
+		 * @param headerName the file name of the shared header to be included
+		 */
+		std::ostream& printShard(std::ostream& out, unsigned shard, const string& headerName) const;
+
+		/**
+		 * Writes the shared header and all shards into the given directory. The header is named
+		 * <baseName>.h and the shards <baseName>_<i>.c. Files whose content has not changed are
+		 * not re-written. Since every shard records a checksum of the header it is including,
+		 * any change of the header is also reflected by the content of all shards.
+		 *
+		 * @param directory the directory to write the files to (created if necessary)
+		 * @param baseName the common prefix of the produced files
+		 * @return the list of shard files, to be passed to the compiler
+		 */
+		vector<string> writeTo(const string& directory, const string& baseName = "code") const;
+
+	};
+
 	/**
 	 * An abstract base class for various kinds of specialized code fragments. This base class
 	 * defines an interface for code fragments to be handled uniformly.
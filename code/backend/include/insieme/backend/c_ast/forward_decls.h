@@ -73,6 +73,9 @@ namespace c_ast {
 	class CCode;
 	typedef std::shared_ptr<CCode> CCodePtr;
 
+	class ShardedCCode;
+	typedef std::shared_ptr<ShardedCCode> ShardedCCodePtr;
+
 	class CodeFragment;
 	typedef Ptr<CodeFragment> CodeFragmentPtr;
 
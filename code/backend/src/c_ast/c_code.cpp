@@ -37,7 +37,10 @@
 #include "insieme/backend/c_ast/c_code.h"
 
 #include <fstream>
+#include <sstream>
 
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
@@ -61,41 +64,303 @@ namespace c_ast {
 	CCode::CCode(const SharedCodeFragmentManager& manager, const core::NodePtr& source, const vector<CodeFragmentPtr>& fragments)
 		: TargetCode(source), fragmentManager(manager), fragments(fragments) { }
 
+	namespace {
+
+		void printFileHeader(std::ostream& out) {
+			out << "/**\n";
+			out << " * ------------------------ Auto-generated Code ------------------------ \n";
+			out << " *           This code was generated by the Insieme Compiler \n";
+			out << " * --------------------------------------------------------------------- \n";
+			out << " */\n";
+		}
+
+		void printIncludes(std::ostream& out, const vector<CodeFragmentPtr>& fragments) {
+			// collect and add includes
+			std::set<string> includes;
+			for_each(fragments, [&](const CodeFragmentPtr& cur) {
+				includes.insert(cur->getIncludes().begin(), cur->getIncludes().end());
+			});
+			for_each(includes, [&](const string& cur) {
+				if (cur.empty()) {
+					return;
+				}
+				if (cur[0] == '<' || cur[0] == '"') {
+					out << "#include " << cur << "\n";
+				} else {
+					out << "#include <" << cur << ">\n";
+				}
+			});
+
+			out << "\n";
+		}
+
+	}
+
 	std::ostream& CCode::printTo(std::ostream& out) const {
 
 		// print a header
-		out << "/**\n";
-		out << " * ------------------------ Auto-generated Code ------------------------ \n";
-		out << " *           This code was generated by the Insieme Compiler \n";
-		out << " * --------------------------------------------------------------------- \n";
-		out << " */\n";
+		printFileHeader(out);
 
 		// collect and add includes
-		std::set<string> includes;
-		for_each(fragments, [&](const CodeFragmentPtr& cur) {
-			includes.insert(cur->getIncludes().begin(), cur->getIncludes().end());
+		printIncludes(out, fragments);
+
+		// print topological sorted list of fragments
+		for_each(fragments, [&out](const CodeFragmentPtr& cur) {
+			out << *cur;
 		});
-		for_each(includes, [&](const string& cur) {
-			if (cur.empty()) {
+		return out << "\n";
+
+	}
+
+	// -- Sharded C Code --------------------------------------------------------
+
+	namespace {
+
+		/**
+		 * The placement classes of code fragments within sharded code.
+		 */
+		enum Placement {
+			SHARED,			// < may be placed within the common header
+			DEFINITION,		// < a list of function definitions, may be placed in any shard
+			LOCAL			// < has to be placed within the first shard
+		};
+
+		/**
+		 * Determines the name of the function defined by the given node or an
+		 * empty string if the node is not a function definition with external linkage.
+		 */
+		string getDefinedFunction(const NodePtr& node) {
+			switch(node->getType()) {
+				case NT_Function: {
+					auto fun = static_pointer_cast<Function>(node);
+					return (fun->flags & Function::STATIC) ? "" : fun->name->name;
+				}
+				case NT_MemberFunction: {
+					auto fun = static_pointer_cast<MemberFunction>(node);
+					return fun->className->name + "::" + fun->function->name->name;
+				}
+				default: return "";
+			}
+		}
+
+		/**
+		 * Determines whether the given node may be included by multiple translation units.
+		 */
+		bool isSharable(const NodePtr& node) {
+			switch(node->getType()) {
+				case NT_Comment:
+				case NT_OpaqueCode:
+				case NT_TypeDeclaration:
+				case NT_TypeDefinition:
+				case NT_FunctionPrototype:
+					return true;
+				case NT_GlobalVarDecl:
+					return static_pointer_cast<GlobalVarDecl>(node)->external;
+				case NT_Function:
+					return static_pointer_cast<Function>(node)->flags & Function::STATIC;
+				default:
+					return false;
+			}
+		}
+
+		/**
+		 * Determines the initial placement of the given fragment and the name of the first function
+		 * defined by it (used for assigning definitions to shards).
+		 */
+		Placement classify(const CodeFragmentPtr& fragment, string& name) {
+
+			// includes and dependency aggregations may be shared
+			if (dynamic_pointer_cast<IncludeFragment>(fragment) || dynamic_pointer_cast<DummyFragment>(fragment)) {
+				return SHARED;
+			}
+
+			// other fragments than C code fragments are not known => keep them local
+			auto code = dynamic_pointer_cast<CCodeFragment>(fragment);
+			if (!code) return LOCAL;
+
+			bool shared = true;
+			bool definitions = true;
+			for(const NodePtr& cur : code->getCode()) {
+				string fun = getDefinedFunction(cur);
+				if (name.empty()) name = fun;
+				shared = shared && isSharable(cur);
+				definitions = definitions && (cur->getType() == NT_Comment || !fun.empty());
+			}
+
+			if (shared) return SHARED;
+			if (definitions) return DEFINITION;
+			return LOCAL;
+		}
+
+		std::size_t findRoot(vector<std::size_t>& parent, std::size_t i) {
+			while (parent[i] != i) {
+				parent[i] = parent[parent[i]];
+				i = parent[i];
+			}
+			return i;
+		}
+
+		string readFile(const boost::filesystem::path& file) {
+			std::ifstream in(file.string());
+			std::stringstream content;
+			content << in.rdbuf();
+			return content.str();
+		}
+
+		void writeIfChanged(const boost::filesystem::path& file, const string& content) {
+			if (boost::filesystem::exists(file) && readFile(file) == content) {
 				return;
 			}
-			if (cur[0] == '<' || cur[0] == '"') {
-				out << "#include " << cur << "\n";
-			} else {
-				out << "#include <" << cur << ">\n";
+			std::ofstream out(file.string());
+			out << content;
+		}
+
+	}
+
+	ShardedCCode::ShardedCCode(const SharedCodeFragmentManager& manager, const core::NodePtr& source, const vector<CodeFragmentPtr>& fragments, unsigned numShards)
+		: CCode(manager, source, fragments), shards(std::max(1u, numShards)) {
+
+		// index fragments
+		std::map<const CodeFragment*, std::size_t> index;
+		for(std::size_t i=0; i<fragments.size(); ++i) {
+			index[&*fragments[i]] = i;
+		}
+
+		// classify fragments
+		vector<Placement> placement(fragments.size());
+		vector<string> names(fragments.size());
+		for(std::size_t i=0; i<fragments.size(); ++i) {
+			placement[i] = classify(fragments[i], names[i]);
+		}
+
+		// propagate restrictions along dependencies until a fixpoint is reached
+		bool changed = true;
+		while(changed) {
+			changed = false;
+			for(std::size_t i=0; i<fragments.size(); ++i) {
+				for(const auto& dep : fragments[i]->getDependencies()) {
+					auto pos = index.find(&*dep);
+					if (pos == index.end()) continue;
+					Placement& a = placement[i];
+					Placement& b = placement[pos->second];
+
+					// the header may only depend on the header
+					if (a == SHARED && b != SHARED) {
+						a = LOCAL; changed = true;
+					}
+
+					// local fragments need their dependencies within the same shard
+					if (a == LOCAL && b == DEFINITION) {
+						b = LOCAL; changed = true;
+					}
+
+					// definitions depending on local fragments become local
+					if (a == DEFINITION && b == LOCAL) {
+						a = LOCAL; changed = true;
+					}
+				}
 			}
-		});
+		}
 
-		out << "\n";
+		// group definitions depending on each other
+		vector<std::size_t> parent(fragments.size());
+		for(std::size_t i=0; i<fragments.size(); ++i) {
+			parent[i] = i;
+		}
+		for(std::size_t i=0; i<fragments.size(); ++i) {
+			if (placement[i] != DEFINITION) continue;
+			for(const auto& dep : fragments[i]->getDependencies()) {
+				auto pos = index.find(&*dep);
+				if (pos == index.end() || placement[pos->second] != DEFINITION) continue;
+				std::size_t a = findRoot(parent, i);
+				std::size_t b = findRoot(parent, pos->second);
+				if (a == b) continue;
+				// keep the smallest name as the representative of the group
+				if (names[b] < names[a]) std::swap(a,b);
+				parent[b] = a;
+			}
+		}
 
-		// print topological sorted list of fragments
-		for_each(fragments, [&out](const CodeFragmentPtr& cur) {
+		// distribute fragments - the shard of a group only depends on its name, such that
+		// the assignment is stable when other parts of the code are changing
+		std::hash<string> hasher;
+		for(std::size_t i=0; i<fragments.size(); ++i) {
+			switch(placement[i]) {
+				case SHARED: header.push_back(fragments[i]); break;
+				case LOCAL: shards[0].push_back(fragments[i]); break;
+				case DEFINITION: {
+					const string& name = names[findRoot(parent, i)];
+					shards[hasher(name) % shards.size()].push_back(fragments[i]);
+					break;
+				}
+			}
+		}
+	}
+
+	std::ostream& ShardedCCode::printHeader(std::ostream& out, const string& guard) const {
+
+		printFileHeader(out);
+
+		out << "#ifndef " << guard << "\n";
+		out << "#define " << guard << "\n\n";
+
+		// all includes are collected within the header
+		printIncludes(out, getFragments());
+
+		for(const auto& cur : header) {
 			out << *cur;
-		});
+		}
+
+		return out << "\n#endif // " << guard << "\n";
+	}
+
+	std::ostream& ShardedCCode::printShard(std::ostream& out, unsigned shard, const string& headerName) const {
+		assert_lt(shard, shards.size()) << "Invalid shard index!";
+
+		printFileHeader(out);
+
+		out << "#include \"" << headerName << "\"\n\n";
+
+		for(const auto& cur : shards[shard]) {
+			out << *cur;
+		}
+
 		return out << "\n";
+	}
 
+	vector<string> ShardedCCode::writeTo(const string& directory, const string& baseName) const {
+		namespace fs = boost::filesystem;
+
+		fs::path dir(directory);
+		if (!fs::exists(dir)) {
+			fs::create_directories(dir);
+		}
+
+		// write header
+		string headerName = baseName + ".h";
+		string guard = "INSIEME_" + boost::to_upper_copy(baseName) + "_H";
+		std::stringstream header;
+		printHeader(header, guard);
+		string headerCode = header.str();
+		writeIfChanged(dir / headerName, headerCode);
+
+		// write shards - each recording the hash of the header
+		string headerHash = toString(std::hash<string>()(headerCode));
+
+		vector<string> res;
+		for(unsigned i=0; i<shards.size(); ++i) {
+			std::stringstream code;
+			code << "// shared header checksum: " << headerHash << "\n";
+			printShard(code, i, headerName);
+
+			fs::path file = dir / (baseName + "_" + toString(i) + ".c");
+			writeIfChanged(file, code.str());
+			res.push_back(file.string());
+		}
+		return res;
 	}
 
+
 	// -- Code Fragment Manager -------------------------------------------------
 
 	CodeFragmentManager::~CodeFragmentManager() {
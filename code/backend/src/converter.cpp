@@ -125,6 +125,9 @@ namespace backend {
 		// --------------------------- Finalize --------------------------
 
 		// create resulting code fragment
+		if (config.numShards > 1) {
+			return c_ast::ShardedCCode::createNew(fragmentManager, source, fragments, config.numShards);
+		}
 		return c_ast::CCode::createNew(fragmentManager, source, fragments);
 	}
 
@@ -177,6 +177,11 @@ namespace runtime {
 			table["irt_lock_init"] 		= "irt_all_impls.h";
 			table["irt_lock_acquire"] 	= "irt_all_impls.h";
 			table["irt_lock_release"] 	= "irt_all_impls.h";
+			table["irt_rwlock_init"] 			= "irt_all_impls.h";
+			table["irt_rwlock_read_acquire"] 	= "irt_all_impls.h";
+			table["irt_rwlock_read_release"] 	= "irt_all_impls.h";
+			table["irt_rwlock_write_acquire"] 	= "irt_all_impls.h";
+			table["irt_rwlock_write_release"] 	= "irt_all_impls.h";
 
 			table["irt_atomic_fetch_and_add"]			= "irt_all_impls.h";
 			table["irt_atomic_fetch_and_sub"]			= "irt_all_impls.h";
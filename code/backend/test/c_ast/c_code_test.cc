@@ -36,7 +36,11 @@
 
 #include <gtest/gtest.h>
 
+#include <boost/filesystem.hpp>
+
 #include "insieme/backend/c_ast/c_code.h"
+#include "insieme/backend/c_ast/c_ast_utils.h"
+#include "insieme/utils/compiler/compiler.h"
 #include "insieme/utils/test/test_utils.h"
 
 namespace insieme {
@@ -136,6 +140,85 @@ TEST(C_AST, DependencyCycleDedectionTest) {
 
 }
 
+TEST(C_AST, ShardedCode) {
+	namespace fs = boost::filesystem;
+
+	SharedCodeFragmentManager fragmentManager = CodeFragmentManager::createShared();
+	SharedCNodeManager manager = fragmentManager->getNodeManager();
+
+	TypePtr intType = manager->create<PrimitiveType>(PrimitiveType::Int32);
+
+	// some functions calling each other
+	FunctionPtr f = manager->create<Function>(intType, manager->create("f"), compound(ret(lit(intType, "1"))));
+	FunctionPtr g = manager->create<Function>(intType, manager->create("g"), compound(ret(add(call(f->name), lit(intType, "1")))));
+	FunctionPtr h = manager->create<Function>(intType, manager->create("h"), compound(ret(var(intType, "counter"))));
+	FunctionPtr m = manager->create<Function>(intType, manager->create("main"),
+			compound(ret(add(add(add(call(f->name), call(g->name)), call(h->name)), lit(intType, "-3")))));
+
+	// the shared parts
+	CodeFragmentPtr types = CCodeFragment::createNew(fragmentManager, manager->create<OpaqueCode>("typedef int myint;"));
+	CodeFragmentPtr protos = CCodeFragment::createNew(fragmentManager,
+			manager->create<FunctionPrototype>(f), manager->create<FunctionPrototype>(g), manager->create<FunctionPrototype>(h));
+	protos->addDependency(types);
+	protos->addInclude("stdint.h");
+
+	// the function definitions
+	CodeFragmentPtr defF = CCodeFragment::createNew(fragmentManager, f);
+	CodeFragmentPtr defG = CCodeFragment::createNew(fragmentManager, g);
+	CodeFragmentPtr defM = CCodeFragment::createNew(fragmentManager, m);
+	defF->addDependency(protos);
+	defG->addDependency(protos);
+	defM->addDependency(protos);
+
+	// a global variable and a function depending on it
+	CodeFragmentPtr global = CCodeFragment::createNew(fragmentManager, manager->create<GlobalVarDecl>(intType, "counter", false));
+	global->addDependency(types);
+	global->addInclude("stdint.h");
+	CodeFragmentPtr defH = CCodeFragment::createNew(fragmentManager, h);
+	defH->addDependency(global);
+
+	CodeFragmentPtr root = DummyFragment::createNew(fragmentManager, utils::set::toSet<FragmentSet>(defF, defG, defH, defM));
+	ShardedCCode code(fragmentManager, core::NodePtr(), getOrderedClosure(toVector(root)), 4);
+
+	// check distribution
+	EXPECT_EQ(4u, code.getNumShards());
+	EXPECT_TRUE(contains(code.getHeaderFragments(), types));
+	EXPECT_TRUE(contains(code.getHeaderFragments(), protos));
+	EXPECT_FALSE(contains(code.getHeaderFragments(), global));
+	EXPECT_TRUE(contains(code.getShards()[0], global));
+	EXPECT_TRUE(contains(code.getShards()[0], defH));
+
+	std::size_t count = 0;
+	for(const auto& cur : code.getShards()) {
+		count += cur.size();
+	}
+	EXPECT_EQ(code.getFragments().size(), code.getHeaderFragments().size() + count);
+
+	// the distribution should be deterministic
+	ShardedCCode code2(fragmentManager, core::NodePtr(), getOrderedClosure(toVector(root)), 4);
+	EXPECT_EQ(code.getShards(), code2.getShards());
+
+	// the single-file version should still be complete
+	EXPECT_PRED2(containsSubString, toString(code), "counter");
+
+	// write and compile shards
+	fs::path dir = fs::unique_path(fs::temp_directory_path() / "insieme-shards-%%%%%%%%");
+	vector<string> files = code.writeTo(dir.string());
+	EXPECT_EQ(4u, files.size());
+	EXPECT_TRUE(fs::exists(dir / "code.h"));
+
+	fs::path binary = dir / "code";
+	ASSERT_TRUE(utils::compiler::compileParallel(files, binary.string()));
+	EXPECT_EQ(0, system(binary.string().c_str()));
+
+	// re-writing the unchanged code should not touch any files
+	auto time = fs::last_write_time(dir / "code.h");
+	code.writeTo(dir.string());
+	EXPECT_EQ(time, fs::last_write_time(dir / "code.h"));
+
+	fs::remove_all(dir);
+}
+
 } // end namespace c_ast
 } // end namespace backend
 } // end namespace insieme
@@ -52,7 +52,9 @@ typedef enum {
 	IRT_GUIDED = 20,
 	IRT_GUIDED_CHUNKED = 21,
 	IRT_FIXED = 30,
-	IRT_SHARES = 40
+	IRT_SHARES = 40,
+	IRT_STEALING = 50,
+	IRT_STEALING_CHUNKED = 51
 } irt_loop_sched_policy_type;
 
 #ifdef __cplusplus
@@ -45,6 +45,7 @@
 
 #include "insieme/utils/printable.h"
 #include "insieme/utils/constraint.h"
+#include "insieme/utils/small_vector.h"
 
 namespace insieme {
 namespace core {
@@ -492,6 +493,12 @@ namespace arithmetic {
 		 */
 		typedef pair<Value, int> Factor;
 
+		/**
+		 * The type of list used to store the factors of a product. Most products
+		 * consist of very few factors, which are stored inline (without allocation).
+		 */
+		typedef utils::SmallVector<Factor, 2> factor_list;
+
 	private:
 
 		/**
@@ -500,7 +507,7 @@ namespace arithmetic {
 		 * variables within this list always have to be ordered according to their
 		 * natural order ( < operator).
 		 */
-		vector<Factor> factors;
+		factor_list factors;
 
 		/**
 		 * A private constructor accepting a rvalue reference to a list of factors.
@@ -508,7 +515,7 @@ namespace arithmetic {
 		 * invariant regarding the ordering of the individual factors within the vector
 		 * is maintained at all time.
 		 */
-		Product(const vector<Factor>&& factors);
+		Product(factor_list&& factors);
 
 	public:
 
@@ -542,7 +549,7 @@ namespace arithmetic {
 		 *
 		 * @return a constant reference to the involved factors
 		 */
-		inline const vector<Factor>& getFactors() const {
+		inline const factor_list& getFactors() const {
 			return factors;
 		}
 
@@ -623,7 +630,7 @@ namespace arithmetic {
 		 * @param other the value this product should be multiplied with
 		 * @return the resulting product
 		 */
-		inline const Product operator*(const Product& other) const {
+		inline Product operator*(const Product& other) const {
 			return Product(*this) *= other;
 		}
 
@@ -635,7 +642,7 @@ namespace arithmetic {
 		 * @param other the value this product should be divided by
 		 * @return the resulting product
 		 */
-		inline const Product operator/(const Product& other) const {
+		inline Product operator/(const Product& other) const {
 			return Product(*this) /= other;
 		}
 
@@ -726,6 +733,12 @@ namespace arithmetic {
 		 */
 		typedef pair<Product, Rational> Term;
 
+		/**
+		 * The type of list used to store the terms of a formula. Most formulas
+		 * consist of very few terms, which are stored inline (without allocation).
+		 */
+		typedef utils::SmallVector<Term, 3> term_list;
+
 	private:
 
 		/**
@@ -735,7 +748,7 @@ namespace arithmetic {
 		 * the same product as its first component and now coefficient is allowed to
 		 * be 0.
 		 */
-		vector<Term> terms;
+		term_list terms;
 
 		/**
 		 * A private constructor allowing the creation of a formula based on a
@@ -750,7 +763,7 @@ namespace arithmetic {
 		 * @param terms the terms the resulting formula should consist of
 		 * 		   - satisfying all the defined invariants
 		 */
-		Formula(vector<Term> terms) : terms(std::move(terms)) {};
+		Formula(term_list terms) : terms(std::move(terms)) {};
 
 	public:
 
@@ -947,7 +960,7 @@ namespace arithmetic {
 		 * @param other the formula to be added to this formula.
 		 * @return the sum of this and the given formula
 		 */
-		inline const Formula operator+(const Formula& other) const {
+		inline Formula operator+(const Formula& other) const {
 			return Formula(*this) += other;
 		}
 
@@ -958,7 +971,7 @@ namespace arithmetic {
 		 * @param other the formula to be subtracted from this formula.
 		 * @return the difference of this and the given formula
 		 */
-		inline const Formula operator-(const Formula& other) const {
+		inline Formula operator-(const Formula& other) const {
 			return Formula(*this) -= other;
 		}
 
@@ -967,7 +980,7 @@ namespace arithmetic {
 		 *
 		 * @return a formula representing -f if this formula is f
 		 */
-		const Formula operator-() const;
+		Formula operator-() const;
 
 		/**
 		 * Implements the multiplication operator for formulas. The resulting formula will be
@@ -976,7 +989,7 @@ namespace arithmetic {
 		 * @param other the formula this formula should be multiplied with.
 		 * @return the product of this and the given formula
 		 */
-		inline const Formula operator*(const Formula& other) const {
+		inline Formula operator*(const Formula& other) const {
 			return Formula(*this) *= other;
 		}
 
@@ -988,7 +1001,7 @@ namespace arithmetic {
 		 * @param divisor the divisor this formula should be divided with
 		 * @return the resulting formula containing the reduced coefficients
 		 */
-		inline const Formula operator/(const Rational& divisor) const {
+		inline Formula operator/(const Rational& divisor) const {
 			return Formula(*this) /= divisor;
 		}
 
@@ -998,7 +1011,7 @@ namespace arithmetic {
 		 * @param divisor the product by which all terms of this formula should be divided with
 		 * @return the resulting formula containing the reduced terms
 		 */
-		inline const Formula operator/(const Product& divisor) const {
+		inline Formula operator/(const Product& divisor) const {
 			return Formula(*this) /= divisor;
 		}
 
@@ -1008,7 +1021,7 @@ namespace arithmetic {
 		 * @param divisor the term this formula should be divided by
 		 * @return the resulting formula representing the resulting formula
 		 */
-		inline const Formula operator/(const Term& divisor) const {
+		inline Formula operator/(const Term& divisor) const {
 			return Formula(*this) /= divisor;
 		}
 
@@ -1018,7 +1031,7 @@ namespace arithmetic {
 		 * @param divisor the product by which all terms of this formula should be divided with
 		 * @return the resulting formula containing the reduced terms
 		 */
-		inline const Formula operator/(const VariablePtr& divisor) const {
+		inline Formula operator/(const VariablePtr& divisor) const {
 			return *this / Product(divisor);
 		}
 
@@ -1128,7 +1141,7 @@ namespace arithmetic {
 		 *
 		 * @return a constant reference to the internally maintained list of terms
 		 */
-		const vector<Term>& getTerms() const {
+		const term_list& getTerms() const {
 			return terms;
 		}
 
@@ -1138,6 +1151,58 @@ namespace arithmetic {
 	//                   Overloaded Operators
 	// -----------------------------------------------------------------
 
+	// -- r-value versions, updating temporary operands in place --
+
+	inline Product operator*(Product&& a, const Product& b) {
+		a *= b; return std::move(a);
+	}
+
+	inline Product operator/(Product&& a, const Product& b) {
+		a /= b; return std::move(a);
+	}
+
+	inline Product operator*(Product&& a, const VariablePtr& b) {
+		a *= Product(b); return std::move(a);
+	}
+
+	inline Formula operator+(Formula&& a, const Formula& b) {
+		a += b; return std::move(a);
+	}
+
+	inline Formula operator+(Formula&& a, int b) {
+		a += Formula(b); return std::move(a);
+	}
+
+	inline Formula operator+(Formula&& a, const Rational& b) {
+		a += Formula(b); return std::move(a);
+	}
+
+	inline Formula operator+(Formula&& a, const VariablePtr& b) {
+		a += Formula(b); return std::move(a);
+	}
+
+	inline Formula operator-(Formula&& a, const Formula& b) {
+		a -= b; return std::move(a);
+	}
+
+	inline Formula operator*(Formula&& a, const Formula& b) {
+		a *= b; return std::move(a);
+	}
+
+	inline Formula operator/(Formula&& a, const Rational& b) {
+		a /= b; return std::move(a);
+	}
+
+	inline Formula operator/(Formula&& a, const Product& b) {
+		a /= b; return std::move(a);
+	}
+
+	inline Formula operator/(Formula&& a, const Formula::Term& b) {
+		a /= b; return std::move(a);
+	}
+
+	// -- mixed operands --
+
 	inline Formula operator+(int a, const VariablePtr& b) {
 		return Formula(a) + Formula(b);
 	}
@@ -55,6 +55,20 @@ namespace checks {
 		return check(node, getFullCheck());
 	}
 
+	/**
+	 * Obtains an incremental version of the full check (see makeIncremental). The instance is shared,
+	 * such that the results obtained for nodes are reused by all invocations.
+	 */
+	CheckPtr getIncrementalFullCheck();
+
+	/**
+	 * Applies all known semantic checks on the given node, reusing the results obtained for unmodified
+	 * nodes by previous invocations. The result is the same as the one of check(node).
+	 */
+	inline MessageList checkIncremental(const NodePtr& node) {
+		return check(node, getIncrementalFullCheck());
+	}
+
 
 } // end namespace checks
 } // end namespace core
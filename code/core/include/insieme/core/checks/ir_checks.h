@@ -86,8 +86,26 @@ namespace checks {
 	 * just a special case of an IR Visitor producing an error-message list.
 	 */
 	class IRCheck : public IRVisitor<OptionalMessageList, core::Address> {
+
+			/**
+			 * A flag indicating whether the result of this check for some node depends on the
+			 * context the node is used in (e.g. its parents) or only on the node itself.
+			 */
+			bool addressDependent;
+
 		public:
-			IRCheck(bool visitTypes) : IRVisitor<OptionalMessageList, core::Address>(visitTypes) {}
+
+			IRCheck(bool visitTypes, bool addressDependent = false)
+				: IRVisitor<OptionalMessageList, core::Address>(visitTypes), addressDependent(addressDependent) {}
+
+			/**
+			 * Determines whether the messages produced by this check depend on the context of the
+			 * checked node. Results of checks which are not address dependent may be reused for all
+			 * occurrences of a node (see makeIncremental).
+			 */
+			bool isAddressDependent() const {
+				return addressDependent;
+			}
 	};
 
 	// ----- Check Combinators -----
@@ -96,6 +114,18 @@ namespace checks {
 
 	CheckPtr makeVisitOnce(const CheckPtr& check);
 
+	/**
+	 * Creates a check applying the given check to every node once, like makeVisitOnce. Results
+	 * of address independent checks are memorized per node within an annotation and reused by
+	 * subsequent applications of the resulting check instance, such that after a transformation
+	 * only the modified parts of the IR are re-checked. Address dependent checks are
+	 * re-evaluated on every application.
+	 *
+	 * NOTE: annotations attached to a node after it has been checked are not considered by
+	 * subsequent applications of the resulting check.
+	 */
+	CheckPtr makeIncremental(const CheckPtr& check);
+
 	CheckPtr combine(const CheckList& list);
 
 	template<typename ... Checks>
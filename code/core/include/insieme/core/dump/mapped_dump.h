@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2002-2013 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please 
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details 
+ * regarding third party software licenses.
+ */
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/utility.hpp>
+
+#include "insieme/core/forward_decls.h"
+#include "insieme/core/ir_node.h"
+#include "insieme/core/dump/dump.h"
+#include "insieme/core/dump/annotations.h"
+
+
+namespace insieme {
+namespace core {
+namespace dump {
+
+	/**
+	 * The mapped format is a binary IR format designed to be accessed in-place, e.g. after
+	 * mapping a file into memory. Unlike the stream-based binary format (see binary_dump.h)
+	 * it is organized in sections (nodes, strings, annotations) addressed via offset tables,
+	 * such that opening an encoding is a constant time operation and individual nodes may
+	 * be inspected and materialized on demand.
+	 */
+	namespace mapped {
+
+		/**
+		 * The type used for referencing nodes and strings within an encoding.
+		 */
+		typedef uint32_t index_t;
+
+		/**
+		 * The version of the format produced by this implementation. Encodings of other versions
+		 * are rejected when being opened.
+		 */
+		extern const uint32_t FORMAT_VERSION;
+
+		/**
+		 * Writes an encoding of the given IR node into the given output stream.
+		 *
+		 * @param out the stream to be writing to
+		 * @param ir the code fragment to be written
+		 * @param converterRegister the register of annotation converter to be used
+		 */
+		void dumpIR(std::ostream& out, const NodePtr& ir, const AnnotationConverterRegister& converterRegister = AnnotationConverterRegister::getDefault());
+
+		/**
+		 * Writes an encoding of the given IR node into the given file.
+		 */
+		void dumpIR(const std::string& file, const NodePtr& ir, const AnnotationConverterRegister& converterRegister = AnnotationConverterRegister::getDefault());
+
+		/**
+		 * A read-only view on an encoding in the mapped format. The encoding is either mapped
+		 * into memory from a file or read into an internal buffer from a stream. The view
+		 * provides raw access to the encoded nodes without creating any IR structures.
+		 */
+		class MappedDump : public boost::noncopyable {
+
+		public:
+
+			struct Header;
+
+		private:
+
+			/**
+			 * A buffer for encodings read from a stream (empty if the encoding is mapped).
+			 */
+			std::vector<uint64_t> buffer;
+
+			/**
+			 * The start of the encoding and its length in bytes.
+			 */
+			const char* data;
+			std::size_t size;
+
+			/**
+			 * Whether the data is a memory mapped file to be unmapped when being destroyed.
+			 */
+			bool mapped;
+
+			const Header* header;
+			const uint32_t* nodeTable;
+			const uint32_t* nodeData;
+			const uint64_t* stringTable;
+			const char* stringData;
+			const index_t* converterTable;
+			const uint32_t* annotationTable;
+			const index_t* annotationData;
+
+		public:
+
+			/**
+			 * Maps the encoding stored within the given file into memory. In case the file
+			 * does not contain a valid encoding, an InvalidEncodingException is thrown.
+			 */
+			explicit MappedDump(const std::string& file);
+
+			/**
+			 * Reads the encoding provided by the given stream into an internal buffer. In
+			 * case the stream does not contain a valid encoding, an InvalidEncodingException
+			 * is thrown.
+			 */
+			explicit MappedDump(std::istream& in);
+
+			~MappedDump();
+
+			/**
+			 * Obtains the index of the root node of the encoded IR fragment.
+			 */
+			index_t getRoot() const;
+
+			/**
+			 * Obtains the number of nodes contained in this encoding.
+			 */
+			std::size_t getNumNodes() const;
+
+			/**
+			 * Obtains the size of the encoding in bytes.
+			 */
+			std::size_t getSize() const {
+				return size;
+			}
+
+			/**
+			 * Obtains the type of the node referenced by the given index. Unknown node types
+			 * are rejected by an InvalidEncodingException.
+			 */
+			NodeType getNodeType(index_t node) const;
+
+			/**
+			 * Obtains the indices of the children of the given node (empty for value nodes). Since
+			 * children are encoded before their parents, child indices not smaller than the index
+			 * of the given node are rejected by an InvalidEncodingException.
+			 */
+			std::vector<index_t> getChildren(index_t node) const;
+
+			/**
+			 * Obtains the raw value stored for a value node. For string values, this is the index
+			 * of the string within the string pool.
+			 */
+			uint32_t getValue(index_t node) const;
+
+			/**
+			 * Obtains the string stored at the given index of the string pool.
+			 */
+			std::string getString(index_t string) const;
+
+			/**
+			 * Obtains the number of annotation converters referenced by this encoding.
+			 */
+			std::size_t getNumConverters() const;
+
+			/**
+			 * Obtains the name of the converter with the given index.
+			 */
+			std::string getConverterName(index_t converter) const;
+
+			/**
+			 * Obtains the annotations attached to the given node as pairs of converter indices
+			 * and the indices of the root nodes of the encoded annotations.
+			 */
+			std::vector<std::pair<index_t, index_t>> getAnnotations(index_t node) const;
+
+		private:
+
+			void init();
+
+			void checkNode(index_t node) const;
+		};
+
+		/**
+		 * A loader materializing nodes of a mapped encoding on demand. Only the requested nodes, their
+		 * sub-structures and the encodings of their annotations are created within the target manager.
+		 * The loader must not outlive the encoding it is operating on.
+		 */
+		class LazyLoader : public boost::noncopyable {
+
+			/**
+			 * The encoding to be loaded.
+			 */
+			const MappedDump& dump;
+
+			/**
+			 * The manager used to construct nodes.
+			 */
+			NodeManager& manager;
+
+			/**
+			 * The converters used to restore annotations, in the order of the encoding.
+			 */
+			std::vector<AnnotationConverterPtr> converter;
+
+			/**
+			 * The nodes resolved so far.
+			 */
+			std::unordered_map<index_t, NodePtr> resolved;
+
+		public:
+
+			LazyLoader(const MappedDump& dump, NodeManager& manager, const AnnotationConverterRegister& converterRegister = AnnotationConverterRegister::getDefault());
+
+			/**
+			 * Materializes the root node of the encoding.
+			 */
+			NodePtr getRoot() {
+				return resolve(dump.getRoot());
+			}
+
+			/**
+			 * Materializes the node with the given index within the encoding.
+			 */
+			NodePtr resolve(index_t node);
+
+			/**
+			 * Obtains the number of nodes materialized so far.
+			 */
+			std::size_t getNumResolved() const {
+				return resolved.size();
+			}
+		};
+
+		/**
+		 * Restores an IR code fragment from the given file. For constructing the resulting nodes,
+		 * the given manager will be used. In case the file contains an illegal encoding, an
+		 * InvalidEncodingException will be thrown.
+		 *
+		 * @param file the file to be loaded
+		 * @param manager the node manager to be used for creating nodes
+		 * @param converterRegister the register of annotation converter to be used
+		 * @return the resolved node
+		 */
+		NodePtr loadIR(const std::string& file, NodeManager& manager, const AnnotationConverterRegister& converterRegister = AnnotationConverterRegister::getDefault());
+
+	} // end namespace mapped
+
+} // end namespace dump
+} // end namespace core
+} // end namespace insieme
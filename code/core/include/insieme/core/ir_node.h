@@ -36,12 +36,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <typeindex>
 
 #include <boost/mpl/or.hpp>
 
 #include "insieme/utils/annotation.h"
+#include "insieme/utils/arena.h"
 #include "insieme/utils/hash_utils.h"
 #include "insieme/utils/id_generator.h"
 #include "insieme/utils/instance_manager.h"
@@ -145,16 +148,25 @@ namespace core {
 			 */
 			typedef uint64_t EqualityID;
 
+			/**
+			 * The type used for storing equality IDs. IDs may be updated concurrently, copies
+			 * take over the current value.
+			 */
+			struct AtomicEqualityID : public std::atomic<EqualityID> {
+				AtomicEqualityID(EqualityID id) : std::atomic<EqualityID>(id) {}
+				AtomicEqualityID(const AtomicEqualityID& other) : std::atomic<EqualityID>(other.load(std::memory_order_relaxed)) {}
+			};
+
 			/**
 			 * A static generator for generating equality class IDs
 			 */
-			static utils::SimpleIDGenerator<EqualityID> equalityClassIDGenerator;
+			static utils::AtomicIDGenerator<EqualityID> equalityClassIDGenerator;
 
 			/**
 			 * The ID of the equality class of this node. This ID is used to significantly
 			 * speed up the equality check.
 			 */
-			mutable EqualityID equalityID;
+			mutable AtomicEqualityID equalityID;
 
 			/**
 			 * The annotatable part of the node.
@@ -202,6 +214,19 @@ namespace core {
 				  nodeType(nodeType), children(children), nodeCategory(nodeCategory),
 				  manager(0), equalityID(0) { }
 
+			/**
+			 * Constructs a new node instance based on the given type, category and child list. The
+			 * given child list is moved into the new node.
+			 *
+			 * @param nodeType the type of the resulting node
+			 * @param nodeCategory the category of the resulting node
+			 * @param children the list of children to be moved into the new node
+			 */
+			Node(const NodeType nodeType, const NodeCategory nodeCategory, NodeList&& children)
+				: HashableImmutableData(hashNodes(nodeType, children)),
+				  nodeType(nodeType), children(std::move(children)), nodeCategory(nodeCategory),
+				  manager(0), equalityID(0) { }
+
 			/**
 			 * Make node destructor virtual since sub-types may contain extra data fields.
 			 */
@@ -225,6 +250,22 @@ namespace core {
 				return ::operator delete(ptr);
 			}
 
+			/**
+			 * A protected new operator placing the new node within the given arena. If the arena
+			 * is null, the node is allocated on the heap.
+			 */
+			static void* operator new(size_t size, utils::Arena* arena) {
+				return (arena) ? arena->allocate(size) : ::operator new(size);
+			}
+
+			/**
+			 * The delete operator matching the arena-based new operator. It is only invoked if the
+			 * construction of a node fails. Memory within the arena is released together with the arena.
+			 */
+			void operator delete(void* ptr, utils::Arena* arena) {
+				if (!arena) ::operator delete(ptr);
+			}
+
 			/**
 			 * Defines the new operator for arrays to be protected. This prevents instances of AST nodes to be
 			 * created on the heap or stack without a NodeManager, thereby enforcing the usage of the
@@ -365,7 +406,9 @@ namespace core {
 				}
 
 				// check equality ID (having different IDs does not mean it is different)
-				if (equalityID != 0 && other.equalityID != 0 && equalityID == other.equalityID) {
+				EqualityID id = equalityID.load(std::memory_order_relaxed);
+				EqualityID otherID = other.equalityID.load(std::memory_order_relaxed);
+				if (id != 0 && otherID != 0 && id == otherID) {
 					// has been identified to be equivalent earlier
 					return true;
 				}
@@ -386,28 +429,16 @@ namespace core {
 
 				// infect both nodes with a new ID
 				if (res) {
-					// update equality IDs - both should have the same id
-					if (equalityID == 0 && other.equalityID == 0) {
-						// non is set yet => pick a new ID and use for both
-						equalityID = equalityClassIDGenerator.getNext();
-						other.equalityID = equalityID;
-					} else if (equalityID == 0) {
-						// other.equalityID != 0 ... update local ID with other ID
-						equalityID = other.equalityID;
-					} else if (other.equalityID == 0){
-						// equality ID != 0 ... update other ID
-						other.equalityID = equalityID;
-					} else {
-						// both are != 0
-						assert_true(equalityID != 0 && other.equalityID != 0) << "Equality IDs should be != 0";
-
-						// pick smaller ID for both
-						if (equalityID < other.equalityID) {
-							other.equalityID = equalityID;
-						} else {
-							equalityID = other.equalityID;
-						}
+					// pick the smaller ID of both or a new ID if non is set yet
+					if (id == 0 && otherID == 0) {
+						id = equalityClassIDGenerator.getNext();
+					} else if (id == 0 || (otherID != 0 && otherID < id)) {
+						id = otherID;
 					}
+
+					// update equality IDs - both should have the same id
+					lowerEqualityID(id);
+					other.lowerEqualityID(id);
 				}
 
 				// return the comparison result.
@@ -441,6 +472,17 @@ namespace core {
 
 		protected:
 
+			/**
+			 * Lowers the equality ID of this node to the given ID unless it is already smaller. Since
+			 * equality is transitive, concurrent updates may only merge equality classes.
+			 *
+			 * @param id the ID of an equality class this node is a member of
+			 */
+			void lowerEqualityID(EqualityID id) const {
+				EqualityID cur = equalityID.load(std::memory_order_relaxed);
+				while ((cur == 0 || id < cur) && !equalityID.compare_exchange_weak(cur, id, std::memory_order_relaxed)) {}
+			}
+
 			/**
 			 * Obtains a reference to the value represented by this node if
 			 * it is representing a value.
@@ -481,9 +523,10 @@ namespace core {
 			 * list.
 			 *
 			 * @param children the children to be used for the construction
+			 * @param arena the arena to place the new instance in, null if it should be allocated on the heap
 			 * @return a pointer to a new, fresh instance of the requested node
 			 */
-			virtual Node* createInstanceUsing(const NodeList& children) const =0;
+			virtual Node* createInstanceUsing(const NodeList& children, utils::Arena* arena) const =0;
 
 		private:
 
@@ -541,12 +584,16 @@ namespace core {
 	// 									Node Manager
 	// **********************************************************************************
 
-	// two forward declarations required by the node manager
+	// forward declarations required by the node manager
 	namespace lang {
 		class BasicGenerator;
 		class Extension;
 	}
 
+	namespace pattern {
+		class MatchCache;
+	}
+
 	/**
 	 * A functor realizing the migration of annotations after nodes have been moved
 	 * between node-manager instances.
@@ -594,10 +641,16 @@ namespace core {
 			 */
 			ExtensionMap extensions;
 
+			/**
+			 * The lock protecting the extension store in concurrent managers. Since extensions
+			 * may request other extensions during their construction, it has to be re-entrant.
+			 */
+			std::recursive_mutex extensionLock;
+
 			/**
 			 * A static generator for generating IDs
 			 */
-			utils::SimpleIDGenerator<unsigned> idGenerator;
+			utils::AtomicIDGenerator<unsigned> idGenerator;
 
 			/**
 			 * A constructor for this data structure.
@@ -616,13 +669,52 @@ namespace core {
 		 */
 		std::shared_ptr<NodeManagerData> data;
 
+		/**
+		 * The cache memorizing the results of pattern matches on the nodes owned by this
+		 * manager. Unlike the data above, it is not shared along the manager hierarchy
+		 * since its entries must not outlive the nodes of this manager.
+		 */
+		std::shared_ptr<pattern::MatchCache> matchCache;
+
 	public:
 
+		/**
+		 * The strategies supported for allocating the nodes maintained by a manager.
+		 */
+		enum AllocationMode {
+			HEAP_ALLOCATION,		// < every node is allocated and freed individually
+			ARENA_ALLOCATION		// < nodes are placed in slabs released at once with the manager
+		};
+
+		/**
+		 * The kinds of accesses supported by a manager.
+		 */
+		enum ConcurrencyMode {
+			SEQUENTIAL_ACCESS,		// < the manager is only utilized by a single thread at a time
+			CONCURRENT_ACCESS		// < nodes may be created and looked up by multiple threads concurrently
+		};
+
 		/**
 		 * A default constructor creating a fresh, empty node manager instance.
 		 */
 		NodeManager();
 
+		/**
+		 * Creates a fresh, empty node manager instance allocating its nodes according
+		 * to the given modes. Managers chained to this manager inherit the modes.
+		 *
+		 * Concurrent managers synchronize the creation and lookup of nodes and language
+		 * extensions. All constructs of the basic language are instantiated eagerly. Annotations
+		 * attached to nodes are not synchronized.
+		 */
+		explicit NodeManager(AllocationMode allocation, ConcurrencyMode concurrency = SEQUENTIAL_ACCESS);
+
+		/**
+		 * Creates a fresh, empty node manager supporting the given kind of accesses and
+		 * allocating its nodes on the heap.
+		 */
+		explicit NodeManager(ConcurrencyMode concurrency);
+
 		/**
 		 * A constructor to be used for manager-chaining, allowing to build hierarchies
 		 * of node managers modeling multiple nested scopes.
@@ -665,6 +757,10 @@ namespace core {
 			typename boost::enable_if<boost::is_base_of<lang::Extension, E>, int>::type = 0
 		>
 		const E& getLangExtension() {
+			// in concurrent managers, the extension store needs to be locked
+			std::unique_lock<std::recursive_mutex> guard(data->extensionLock, std::defer_lock);
+			if (isConcurrent()) guard.lock();
+
 			// look up type information within map
 			std::type_index key = typeid(E);
 			auto& ext = data->extensions;
@@ -680,6 +776,13 @@ namespace core {
 
 		const lang::Extension& getLangExtensionByName(const string& name);
 
+		/**
+		 * Obtains access to the cache memorizing pattern match results on nodes owned by this manager.
+		 */
+		pattern::MatchCache& getMatchCache() {
+			return *matchCache;
+		}
+
 		/**
 		 * Obtains a fresh ID to be used within a node.
 		 */
@@ -702,6 +805,29 @@ namespace core {
 	// but it cannot be done directly inline in Node since it requires NodeManager to be defined
 	// **********************************************************************************
 	
+	namespace detail {
+
+		/**
+		 * A node which is only used for looking up nodes of a given type and child list within
+		 * a node manager without creating an instance of the actual node type. Since node
+		 * types must not add value-relevant fields, the probe is equal to the node it represents.
+		 */
+		class NodeProbe : public Node {
+		public:
+			NodeProbe(NodeType type, NodeCategory category, NodeList&& children)
+				: Node(type, category, std::move(children)) {}
+		protected:
+			virtual std::ostream& printTo(std::ostream& out) const {
+				return out << "probe(" << getNodeTypeInternal() << ")";
+			}
+			virtual Node* createInstanceUsing(const NodeList&, utils::Arena*) const {
+				assert_fail() << "Node probes must not be instantiated!";
+				return nullptr;
+			}
+		};
+
+	}
+
 	template<typename Context>
 	NodePtr Node::substituteInternal(NodeManager& manager, NodeMapping<Context>& mapper, Context& c) const {
 		// skip operation if it is a value node
@@ -715,14 +841,20 @@ namespace core {
 			return (&manager != getNodeManagerPtr())?manager.get(*this):NodePtr(this);
 		}
 
-		// create a version having everything substituted
-		Node* node = createInstanceUsing(children);
+		// look up the substituted version first - if present, no temporary instance is required
+		detail::NodeProbe probe(getNodeTypeInternal(), getNodeCategoryInternal(), std::move(children));
+		NodePtr res(manager.lookupPlain(static_cast<const Node*>(&probe)));
+		if (!res) {
 
-		// obtain element within the manager
-		NodePtr res = manager.get(node);
+			// create a version having everything substituted
+			Node* node = createInstanceUsing(probe.getChildNodeList(), nullptr);
 
-		// free temporary instance
-		delete node;
+			// obtain element within the manager
+			res = manager.get(node);
+
+			// free temporary instance
+			delete node;
+		}
 
 		// migrate annotations
 		this->migrateAnnotationsInternal(res);
@@ -1140,8 +1272,8 @@ namespace core {
 		\
 		protected: \
 			/* The function required for the clone process. */ \
-			virtual NAME* createInstanceUsing(const NodeList& children) const { \
-				return new NAME(children); \
+			virtual NAME* createInstanceUsing(const NodeList& children, utils::Arena* arena) const { \
+				return new (arena) NAME(children); \
 			} \
 		public: \
 			/* A factory method creating instances based on a child list */ \
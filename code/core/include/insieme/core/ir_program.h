@@ -87,8 +87,8 @@ namespace core {
 		/**
 		 * The function required for the clone process.
 		 */
-		virtual Program* createInstanceUsing(const NodeList& children) const {
-			return new Program(children);
+		virtual Program* createInstanceUsing(const NodeList& children, utils::Arena* arena) const {
+			return new (arena) Program(children);
 		}
 
 	public:
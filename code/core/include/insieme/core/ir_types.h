@@ -1035,8 +1035,8 @@ namespace core {
 		\
 		protected: \
 			/* The function required for the clone process. */ \
-			virtual NAME* createInstanceUsing(const NodeList& children) const { \
-				return new NAME(children); \
+			virtual NAME* createInstanceUsing(const NodeList& children, utils::Arena* arena) const { \
+				return new (arena) NAME(children); \
 			} \
 		public: \
 			/* A factory method creating instances based on a child list */ \
@@ -1380,8 +1380,8 @@ namespace core {
 		\
 		protected: \
 			/* The function required for the clone process. */ \
-			virtual NAME* createInstanceUsing(const NodeList& children) const { \
-				return new NAME(children); \
+			virtual NAME* createInstanceUsing(const NodeList& children, utils::Arena* arena) const { \
+				return new (arena) NAME(children); \
 			} \
 		public: \
 			/* A factory method creating instances based on a child list */ \
@@ -108,9 +108,9 @@ namespace core {
 				return getValue() < other.getValue(); \
 			} \
 		protected: \
-			virtual Node* createInstanceUsing(const NodeList& children) const { \
+			virtual Node* createInstanceUsing(const NodeList& children, utils::Arena* arena) const { \
 				assert_true(children.empty()) << "Value nodes must no have children!"; \
-				return new NAME ## Value(*this); \
+				return new (arena) NAME ## Value(*this); \
 			} \
 			virtual std::ostream& printTo(std::ostream& out) const { \
 				return out << getValue(); \
@@ -150,6 +150,14 @@ public:
 	TypeSet getDirectSuperTypesOf(const TypePtr& type) const;
 	TypeSet getDirectSubTypesOf(const TypePtr& type) const;
 
+	// ----- concurrency support ---
+
+	/**
+	 * Instantiates all lazily created constructs of this generator. Afterwards, the
+	 * generator may be utilized by multiple threads concurrently.
+	 */
+	void materializeAll() const;
+
 private:
 
 	// obtains a pointer to a lazy-instantiated sub-type lattice
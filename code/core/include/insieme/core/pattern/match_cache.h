@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2002-2014 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "insieme/core/forward_decls.h"
+
+namespace insieme {
+namespace core {
+namespace pattern {
+
+	class MatchCache;
+
+	/**
+	 * A handle to be owned by a pattern whose match results are memorized within match caches.
+	 * Results are indexed by the handle. When the handle is destroyed, all results recorded for
+	 * it are dropped from the caches still alive.
+	 */
+	class MatchCacheHandle : private boost::noncopyable {
+
+		friend class MatchCache;
+
+		/**
+		 * The caches holding results for this handle. Weak references since the caches
+		 * are owned by node managers which may be destroyed before the pattern.
+		 */
+		std::vector<std::weak_ptr<MatchCache>> caches;
+
+		/**
+		 * Protects the list of caches - patterns may be used by several threads at once.
+		 */
+		std::mutex lock;
+
+	public:
+
+		MatchCacheHandle() {}
+
+		~MatchCacheHandle();
+	};
+
+	/**
+	 * A cache memorizing the results of matching patterns against the nodes of a single node
+	 * manager. IR nodes are immutable and live as long as their manager, thus the results remain
+	 * valid across match operations. Every node manager owns one of those caches.
+	 */
+	class MatchCache : public std::enable_shared_from_this<MatchCache>, private boost::noncopyable {
+
+		typedef std::unordered_map<const Node*, bool> ResultMap;
+
+		/**
+		 * The memorized results, indexed by the handle of the matched pattern.
+		 */
+		std::unordered_map<const MatchCacheHandle*, ResultMap> results;
+
+		/**
+		 * Caches of concurrent managers need to synchronize accesses.
+		 */
+		const bool concurrent;
+
+		mutable std::mutex lock;
+
+	public:
+
+		MatchCache(bool concurrent = false) : concurrent(concurrent) {}
+
+		/**
+		 * Looks up the result of matching the pattern owning the given handle against the given node.
+		 *
+		 * @param pattern the handle of the matched pattern
+		 * @param node the matched node
+		 * @param match set to the memorized result if there is one
+		 * @return true if a result has been memorized, false otherwise
+		 */
+		bool lookup(const MatchCacheHandle& pattern, const Node* node, bool& match) const;
+
+		/**
+		 * Memorizes the result of matching the pattern owning the given handle against the given node.
+		 */
+		void store(MatchCacheHandle& pattern, const Node* node, bool match);
+
+		/**
+		 * Removes all results memorized for the given handle.
+		 */
+		void drop(const MatchCacheHandle& pattern);
+
+		/**
+		 * Obtains the number of results memorized within this cache.
+		 */
+		std::size_t size() const;
+
+	};
+
+} // end namespace pattern
+} // end namespace core
+} // end namespace insieme
@@ -106,12 +106,13 @@ namespace arithmetic {
 
 	namespace {
 
-		inline vector<Product::Factor> getSingle(const Value& value, int exponent) {
-			if (exponent == 0) {
+		inline Product::factor_list getSingle(const Value& value, int exponent) {
+			Product::factor_list res;
+			if (exponent != 0) {
 				// do not create an entry if exponent is zero
-				return toVector<Product::Factor>();
+				res.push_back(std::make_pair(value, exponent));
 			}
-			return toVector(std::make_pair(value, exponent));
+			return res;
 		}
 
 		template<typename ExprTy, typename Combinator, typename Extractor, typename Container>
@@ -393,8 +394,8 @@ namespace arithmetic {
 	Product::Product(const Value& value, int exponent)
 		: factors(getSingle(value, exponent)) {};
 
-	Product::Product(const vector<Factor>&& factors)
-		: factors(factors) {};
+	Product::Product(factor_list&& factors)
+		: factors(std::move(factors)) {};
 
 	void Product::appendValues(ValueSet& set) const {
 		for_each(factors, [&](const Factor& cur) {
@@ -434,7 +435,7 @@ namespace arithmetic {
 	}
 
 	Product Product::operator^(int exp) const {
-		vector<Factor> ret;
+		factor_list ret;
 	
 		for_each(factors, [&] ( const Factor& cur ) {
 					ret.push_back( Factor(cur.first, cur.second*exp) );
@@ -494,29 +495,34 @@ namespace arithmetic {
 
 
 	namespace {
-		inline vector<Formula::Term> getSingle(const Product& product, const Rational& coefficient) {
-			return toVector(std::make_pair(product, coefficient));
+		inline Formula::term_list getSingle(Product&& product, const Rational& coefficient) {
+			Formula::term_list res;
+			if (!coefficient.isZero()) {
+				// do not create an entry if coefficient is zero
+				res.push_back(Formula::Term(std::move(product), coefficient));
+			}
+			return res;
 		}
 	}
 
-	Formula::Formula(int value) : terms((value==0)?vector<Term>():toVector(Term(Product(), Rational(value)))) {};
+	Formula::Formula(int value) : terms(getSingle(Product(), Rational(value))) {};
 	
 	Formula::Formula(const Rational& value)
-		: terms((value.isZero())?vector<Term>():toVector(Term(Product(), value))) {};
+		: terms(getSingle(Product(), value)) {};
 
 	Formula::Formula(const Product& product, const Rational& coefficient)
-		: terms(toVector(std::make_pair(product, coefficient))) {
+		: terms(getSingle(Product(product), coefficient)) {
 		assert_false(coefficient.isZero()) << "Coefficient must be != 0!";
 	};
 
 	Formula::Formula(const core::VariablePtr& var, int exponent, const Rational& coefficient)
-		: terms(toVector(std::make_pair(Product(var, exponent), coefficient))) {
+		: terms(getSingle(Product(var, exponent), coefficient)) {
 		assert_ne(exponent, 0) << "Exponent must be != 0!";
 		assert_false(coefficient.isZero()) << "Coefficient must be != 0!";
 	};
 
 	Formula::Formula(const Value& value, int exponent, const Rational& coefficient)
-		: terms(toVector(Term(Product(value, exponent), coefficient))) {
+		: terms(getSingle(Product(value, exponent), coefficient)) {
 		assert_ne(exponent, 0) << "Exponent must be != 0!";
 		assert_false(coefficient.isZero()) << "Coefficient must be != 0!";
 	};
@@ -627,12 +633,12 @@ namespace arithmetic {
 		});
 	}
 
-	const Formula Formula::operator-() const {
-		vector<Term> negTerms;
+	Formula Formula::operator-() const {
+		term_list negTerms;
 		for_each(terms, [&](const Term& cur) {
 			negTerms.push_back(Term(cur.first, -cur.second));
 		});
-		return Formula(negTerms);
+		return Formula(std::move(negTerms));
 	}
 
 	Formula& Formula::operator+=(const Formula& other) {
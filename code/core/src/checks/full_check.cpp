@@ -48,7 +48,7 @@ namespace checks {
 
 	namespace {
 
-		CheckPtr buildFullCheck() {
+		CheckList getFullCheckList() {
 
 			std::vector<CheckPtr> checks;
 			checks.push_back(make_check<KeywordCheck>());
@@ -87,8 +87,13 @@ namespace checks {
 
 			checks.push_back(make_check<LiteralFormatCheck>());
 
+			return checks;
+		}
+
+		CheckPtr buildFullCheck() {
+
 			// assemble the IR check list
-			CheckPtr recursive = makeVisitOnce(combine(checks));
+			CheckPtr recursive = makeVisitOnce(combine(getFullCheckList()));
 
 			return combine(
 					toVector<CheckPtr>(
@@ -105,6 +110,12 @@ namespace checks {
 		return fullChecks;
 	}
 
+	CheckPtr getIncrementalFullCheck() {
+		// share common check-instance such that results are reused among invocations
+		static const CheckPtr incrementalChecks = makeIncremental(combine(getFullCheckList()));
+		return incrementalChecks;
+	}
+
 } // end namespace check
 } // end namespace core
 } // end namespace insieme
@@ -37,6 +37,8 @@
 #include "insieme/core/checks/ir_checks.h"
 
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include "insieme/utils/container_utils.h"
 #include "insieme/core/annotations/source_location.h"
 
@@ -148,7 +150,14 @@ namespace {
 		 * @param checks the checks to be conducted by the resulting check
 		 */
 		CombinedIRCheck(const CheckList& checks = CheckList())
-			: IRCheck(any(checks, [](const CheckPtr& cur) { return cur->isVisitingTypes(); })), checks(checks) {};
+			: IRCheck(any(checks, [](const CheckPtr& cur) { return cur->isVisitingTypes(); }), any(checks, [](const CheckPtr& cur) { return cur->isAddressDependent(); })), checks(checks) {};
+
+		/**
+		 * Obtains the list of checks combined by this check.
+		 */
+		const CheckList& getChecks() const {
+			return checks;
+		}
 
 	protected:
 
@@ -183,7 +192,7 @@ namespace {
 		 * @param check the check to be conducted recursively on all nodes.
 		 */
 		RecursiveIRCheck(const CheckPtr& check)
-			: IRCheck(check->isVisitingTypes()), check(check) {};
+			: IRCheck(check->isVisitingTypes(), check->isAddressDependent()), check(check) {};
 
 	protected:
 
@@ -267,7 +276,7 @@ namespace {
 		 *
 		 * @param check the check to be conducted recursively on all nodes.
 		 */
-		VisitOnceIRCheck(const CheckPtr& check) : IRCheck(check->isVisitingTypes()), check(check) {};
+		VisitOnceIRCheck(const CheckPtr& check) : IRCheck(check->isVisitingTypes(), check->isAddressDependent()), check(check) {};
 
 	protected:
 
@@ -363,6 +372,200 @@ namespace {
 
 	};
 
+
+	/**
+	 * The per-node results of the address independent checks of an incremental check, stored
+	 * within a node annotation. The results are dropped when the node is cloned to another manager.
+	 */
+	struct IncrementalCheckCache : public value_annotation::drop_on_clone {
+
+		struct Entry {
+
+			/**
+			 * The non-empty results of the address independent checks, indexed by their position.
+			 */
+			vector<pair<unsigned, MessageList>> results;
+
+			/**
+			 * Whether the node and all nodes reachable from it are known to produce no messages.
+			 */
+			bool clean;
+
+			Entry() : clean(false) {}
+		};
+
+		/**
+		 * The entries of the incremental check instances this node has been checked by.
+		 */
+		std::shared_ptr<std::map<unsigned, Entry>> entries;
+
+		IncrementalCheckCache() : entries(std::make_shared<std::map<unsigned, Entry>>()) {}
+
+		bool operator==(const IncrementalCheckCache& other) const {
+			return entries == other.entries;
+		}
+	};
+
+	/**
+	 * A check conducting checks on every node once, like the VisitOnceIRCheck, reusing the
+	 * results of address independent checks obtained for nodes by previous runs.
+	 */
+	class IncrementalIRCheck : public IRCheck {
+
+		/**
+		 * The individual checks to be conducted.
+		 */
+		CheckList checks;
+
+		/**
+		 * The ID of this instance, used for identifying cache entries.
+		 */
+		unsigned id;
+
+		/**
+		 * Whether any of the checks is address dependent.
+		 */
+		bool anyAddressDependent;
+
+		static unsigned getFreshID() {
+			static std::atomic<unsigned> counter(0);
+			return ++counter;
+		}
+
+	public:
+
+		/**
+		 * Creates a new incremental check conducting the given check, which might be a combination
+		 * of checks. Results are memorized for each of the combined checks individually.
+		 */
+		IncrementalIRCheck(const CheckPtr& check)
+			: IRCheck(check->isVisitingTypes(), check->isAddressDependent()), id(getFreshID()), anyAddressDependent(check->isAddressDependent()) {
+
+			// unpack combined checks
+			if (auto combined = std::dynamic_pointer_cast<CombinedIRCheck>(check)) {
+				checks = combined->getChecks();
+			} else {
+				checks.push_back(check);
+			}
+		}
+
+	protected:
+
+		OptionalMessageList visitNode(const NodeAddress& node) {
+
+			// create result list
+			MessageList res;
+
+			// collect full list of locations to be checked (skipping clean sub-trees if possible)
+			NodeSet all;
+			vector<CodeLocation> locations;
+			collectLocations(node, all, locations);
+
+			// now check all the locations
+			for(const auto& loc : locations) {
+				const auto& cached = getEntry(loc.getOrigin().getAddressedNode()).results;
+				auto next = cached.begin();
+				for(unsigned i=0; i<checks.size(); ++i) {
+
+					// obtain issues - either from the cache or by running the check
+					OptionalMessageList issues;
+					if (checks[i]->isAddressDependent()) {
+						issues = checks[i]->visit(loc.getOrigin());
+					} else if (next != cached.end() && next->first == i) {
+						issues = (next++)->second;
+					}
+
+					// correct locations
+					if(issues) {
+						for(const Message& cur : issues->getAll()) {
+							res.add(Message(loc, cur.getErrorCode(), cur.getMessage(), cur.getType()));
+						}
+					}
+				}
+			}
+
+			// done
+			return (res.empty()) ? OptionalMessageList() : res;
+		}
+
+	private:
+
+		/**
+		 * Obtains the cache entry of this check for the given node, conducting the address
+		 * independent checks on the node if it has not been processed before.
+		 */
+		IncrementalCheckCache::Entry& getEntry(const NodePtr& node) {
+
+			// get cache annotation
+			if (!node->hasAttachedValue<IncrementalCheckCache>()) {
+				node->attachValue(IncrementalCheckCache());
+			}
+			auto& entries = *node->getAttachedValue<IncrementalCheckCache>().entries;
+
+			// check whether there is already an entry for this check
+			auto pos = entries.find(id);
+			if (pos != entries.end()) return pos->second;
+
+			// run the address independent checks on the isolated node
+			IncrementalCheckCache::Entry& entry = entries[id];
+			for(unsigned i=0; i<checks.size(); ++i) {
+				if (checks[i]->isAddressDependent()) continue;
+				auto issues = checks[i]->visit(NodeAddress(node));
+				if (issues && !issues->empty()) {
+					entry.results.push_back(std::make_pair(i, *issues));
+				}
+			}
+			return entry;
+		}
+
+		/**
+		 * Collects the locations to be checked, like the VisitOnceIRCheck. If there are no address
+		 * dependent checks, sub-trees known to be free of issues are skipped. The result indicates
+		 * whether the sub-tree rooted by the given location is known to be free of issues.
+		 */
+		bool collectLocations(const NodeAddress& cur, NodeSet& all, vector<CodeLocation>& locations) {
+			auto& entry = getEntry(cur.getAddressedNode());
+
+			// skip clean sub-trees
+			if (!anyAddressDependent && entry.clean) return true;
+
+			// add node to known list of nodes
+			bool isNew = all.insert(cur.getAddressedNode()).second;
+			if (!isNew) return entry.clean;		// it has already been known => done
+
+			// add to list of targets (addresses)
+			locations.push_back(cur);
+			bool clean = entry.results.empty();
+
+			// also add locations within check-able annotations
+			auto annotations = cur->getAnnotations();		// annotations might mutate while iterating through them
+			for (const auto& annotation : annotations) {
+				for(const NodePtr& innerNode : annotation.second->getChildNodes()) {
+					assert_true(innerNode) << "Nodes must not be null!";
+
+					// create a inner list of locations
+					vector<CodeLocation> innerList;
+					clean = collectLocations(NodeAddress(innerNode), all, innerList) && clean;
+
+					// merge inner list of locations with outer list
+					for(const auto& loc : innerList) {
+						locations.push_back(loc.shift(cur, annotation.first));
+					}
+				}
+			}
+
+			// add child nodes
+			for (auto c : cur->getChildList()) {
+				clean = collectLocations(c, all, locations) && clean;
+			}
+
+			// remember clean sub-trees
+			entry.clean = clean;
+			return clean;
+		}
+
+	};
+
 }
 
 std::ostream& MessageList::printTo(std::ostream& out) const {
@@ -420,6 +623,10 @@ CheckPtr makeVisitOnce(const CheckPtr& check) {
 	return make_check<VisitOnceIRCheck>(check);
 }
 
+CheckPtr makeIncremental(const CheckPtr& check) {
+	return make_check<IncrementalIRCheck>(check);
+}
+
 CheckPtr combine(const CheckPtr& a) {
 	return combine(toVector<CheckPtr>(a));
 }
@@ -0,0 +1,595 @@
+/**
+ * Copyright (c) 2002-2013 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please 
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details 
+ * regarding third party software licenses.
+ */
+#include "insieme/core/dump/mapped_dump.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "insieme/core/ir_visitor.h"
+#include "insieme/core/ir_builder.h"
+
+#include "insieme/utils/map_utils.h"
+
+namespace insieme {
+namespace core {
+namespace dump {
+
+	namespace mapped {
+
+		// The layout of the mapped format:
+		//		<HEADER> <NODE_TABLE> <NODE_DATA> <CONVERTER_TABLE> <ANNOTATION_TABLE> <ANNOTATION_DATA> <STRING_TABLE> <STRING_DATA>
+		//
+		// where the header is identifying the format and version and lists the offsets
+		// of all the sections. Every section starts at an 8-byte aligned offset. All
+		// values are stored using the byte order of the producing machine.
+		//
+		// The node table is providing for every node the offset of its encoding within
+		// the node data section in 32-bit words. The encoding of a node starts with its
+		// type, followed by
+		//		- the index of its string within the string pool for string values,
+		//		- the value for other value nodes or
+		//		- the number of children and the indices of the child nodes for all others.
+		// Nodes are listed in post-order, thus the indices of child nodes are always smaller
+		// than the index of their parent. This is verified when loading nodes to reject cyclic
+		// encodings.
+		//
+		// The converter table lists the string pool index of the names of all annotation
+		// converters used within the encoding. The annotation table is providing for every
+		// node the index of its first annotation within the annotation data section, which
+		// lists pairs of converter and encoding root node indices. The table contains one
+		// extra entry marking the end of the last node's annotations.
+		//
+		// The string table is providing the offset of every string within the string data
+		// section, again followed by an extra entry marking the end of the last string.
+
+		const uint32_t FORMAT_VERSION = 2;
+
+		struct MappedDump::Header {
+			uint64_t magic;
+			uint32_t version;
+			index_t root;
+			uint32_t numNodes;
+			uint32_t numNodeWords;
+			uint32_t numConverters;
+			uint32_t numAnnotations;
+			uint32_t numStrings;
+			uint32_t reserved;
+			uint64_t nodeTable;
+			uint64_t nodeData;
+			uint64_t converterTable;
+			uint64_t annotationTable;
+			uint64_t annotationData;
+			uint64_t stringTable;
+			uint64_t stringData;
+			uint64_t size;
+		};
+
+		namespace {
+
+			/**
+			 * The magic number stored at the head of all encodings.
+			 */
+			const uint64_t MAGIC_NUMBER = 0x494e53504d4150; // HEX version of INSPMAP
+
+			typedef MappedDump::Header Header;
+
+			uint64_t align(uint64_t offset) {
+				return (offset + 7) & ~uint64_t(7);
+			}
+
+			/**
+			 * A static visitor encoding node values within a single 32-bit word.
+			 */
+			struct ValueEncoder : public boost::static_visitor<uint32_t> {
+
+				uint32_t operator()(bool value) const {
+					return (value)?1:0;
+				}
+
+				uint32_t operator()(char value) const {
+					return (uint8_t)value;
+				}
+
+				uint32_t operator()(int value) const {
+					return (uint32_t)value;
+				}
+
+				uint32_t operator()(unsigned value) const {
+					return value;
+				}
+
+				uint32_t operator()(const string& value) const {
+					assert_fail() << "Should not be handled this way!";
+					return 0;
+				}
+			};
+
+			/**
+			 * The mapped dumper is converting the DAG representing the code fragment to be
+			 * dumped into a list of nodes, a string pool and a list of annotations, which
+			 * are then written into the output stream section by section.
+			 */
+			class MappedDumper {
+
+				/**
+				 * The register of annotation converters to be utilized for the encoding.
+				 */
+				const AnnotationConverterRegister& converterRegister;
+
+				/**
+				 * The list of all involved annotation converter and its reverse index.
+				 */
+				vector<AnnotationConverterPtr> converter;
+				std::map<AnnotationConverterPtr, index_t> converter_index;
+
+				/**
+				 * The list of all nodes to be dumped and its reverse index.
+				 */
+				vector<NodePtr> nodeList;
+				utils::map::PointerMap<NodePtr, index_t> index;
+
+				/**
+				 * The annotations of the nodes - pairs of converter and root node indices.
+				 */
+				std::map<index_t, vector<pair<index_t, index_t>>> annotations;
+
+				/**
+				 * The string pool and its reverse index.
+				 */
+				vector<string> strings;
+				std::map<string, index_t> string_index;
+
+			public:
+
+				MappedDumper(const AnnotationConverterRegister& converterRegister)
+					: converterRegister(converterRegister) {}
+
+				void dump(std::ostream& out, const NodePtr& ir) {
+
+					// create node list and index
+					createIndex(ir);
+
+					// encode nodes
+					vector<uint32_t> nodeTable;
+					vector<uint32_t> nodeData;
+					for(const NodePtr& cur : nodeList) {
+						assert_lt(nodeData.size(), std::numeric_limits<uint32_t>::max()) << "Node data exceeding index limit!";
+						nodeTable.push_back(nodeData.size());
+
+						NodeType type = cur->getNodeType();
+						nodeData.push_back(type);
+
+						if (type == NT_StringValue) {
+							nodeData.push_back(getStringIndex(cur.as<StringValuePtr>()->getValue()));
+						} else if (cur->isValue()) {
+							nodeData.push_back(boost::apply_visitor(ValueEncoder(), cur->getNodeValue()));
+						} else {
+							const NodeList& children = cur->getChildList();
+							nodeData.push_back(children.size());
+							for(const NodePtr& child : children) {
+								assert(index.find(child) != index.end() && "Index not correctly established!");
+								nodeData.push_back(index[child]);
+							}
+						}
+					}
+
+					// encode converters
+					vector<index_t> converterTable;
+					for(const auto& cur : converter) {
+						converterTable.push_back(getStringIndex(cur->getName()));
+					}
+
+					// encode annotations
+					vector<uint32_t> annotationTable;
+					vector<index_t> annotationData;
+					for(index_t i=0; i<nodeList.size(); i++) {
+						annotationTable.push_back(annotationData.size() / 2);
+						auto pos = annotations.find(i);
+						if (pos == annotations.end()) continue;
+						for(const auto& cur : pos->second) {
+							annotationData.push_back(cur.first);
+							annotationData.push_back(cur.second);
+						}
+					}
+					annotationTable.push_back(annotationData.size() / 2);
+
+					// encode strings
+					vector<uint64_t> stringTable;
+					string stringData;
+					for(const auto& cur : strings) {
+						stringTable.push_back(stringData.size());
+						stringData += cur;
+					}
+					stringTable.push_back(stringData.size());
+
+					// compute the layout
+					Header header;
+					memset(&header, 0, sizeof(Header));
+					header.magic = MAGIC_NUMBER;
+					header.version = FORMAT_VERSION;
+					header.root = index[ir];
+					header.numNodes = nodeList.size();
+					header.numNodeWords = nodeData.size();
+					header.numConverters = converter.size();
+					header.numAnnotations = annotationData.size() / 2;
+					header.numStrings = strings.size();
+
+					uint64_t offset = align(sizeof(Header));
+					auto place = [&](uint64_t& section, std::size_t size) {
+						section = offset;
+						offset = align(offset + size);
+					};
+					place(header.nodeTable, nodeTable.size() * sizeof(uint32_t));
+					place(header.nodeData, nodeData.size() * sizeof(uint32_t));
+					place(header.converterTable, converterTable.size() * sizeof(index_t));
+					place(header.annotationTable, annotationTable.size() * sizeof(uint32_t));
+					place(header.annotationData, annotationData.size() * sizeof(index_t));
+					place(header.stringTable, stringTable.size() * sizeof(uint64_t));
+					place(header.stringData, stringData.size());
+					header.size = offset;
+
+					// write the sections
+					uint64_t written = 0;
+					auto emit = [&](uint64_t section, const void* data, std::size_t size) {
+						static const char padding[8] = { 0 };
+						assert_le(written, section);
+						out.write(padding, section - written);
+						out.write((const char*)data, size);
+						written = section + size;
+					};
+					emit(0, &header, sizeof(Header));
+					emit(header.nodeTable, nodeTable.data(), nodeTable.size() * sizeof(uint32_t));
+					emit(header.nodeData, nodeData.data(), nodeData.size() * sizeof(uint32_t));
+					emit(header.converterTable, converterTable.data(), converterTable.size() * sizeof(index_t));
+					emit(header.annotationTable, annotationTable.data(), annotationTable.size() * sizeof(uint32_t));
+					emit(header.annotationData, annotationData.data(), annotationData.size() * sizeof(index_t));
+					emit(header.stringTable, stringTable.data(), stringTable.size() * sizeof(uint64_t));
+					emit(header.stringData, stringData.data(), stringData.size());
+					emit(header.size, nullptr, 0);
+				}
+
+			private:
+
+				index_t getStringIndex(const string& str) {
+					auto pos = string_index.find(str);
+					if (pos != string_index.end()) return pos->second;
+					index_t res = strings.size();
+					strings.push_back(str);
+					string_index[str] = res;
+					return res;
+				}
+
+				/**
+				 * Creates the node index by enlisting all nodes within the IR DAG including
+				 * the encodings of their annotations. Nodes are enlisted in post-order, such
+				 * that all children are indexed before their parents.
+				 */
+				void createIndex(const NodePtr& ir) {
+
+					// obtain the manager used for the conversion of annotations
+					NodeManager& mgr = ir->getNodeManager();
+
+					// index all nodes
+					std::function<void(const NodePtr& cur)> indexer;
+					indexer = [&](const NodePtr& cur) {
+						// check whether index has been assigned before
+						if (index.find(cur) != index.end()) {
+							return;
+						}
+						index_t pos = nodeList.size();
+						index[cur] = pos;
+						nodeList.push_back(cur);
+
+						// process annotations
+						for(auto cur_annotation : cur->getAnnotations()) {
+							auto cur_converter = converterRegister.getConverterFor(cur_annotation.second);
+							if (!cur_converter) continue;
+
+							// convert and index the annotation
+							NodePtr converted = cur_converter->toIR(mgr, cur_annotation.second);
+							assert_true(converted) << "Converted Annotation must not be NULL!";
+							visitDepthFirstOnce(converted, indexer, false);
+
+							// register the converter
+							auto conv = converter_index.find(cur_converter);
+							if (conv == converter_index.end()) {
+								conv = converter_index.insert(std::make_pair(cur_converter, (index_t)converter.size())).first;
+								converter.push_back(cur_converter);
+							}
+
+							// record the annotation
+							annotations[pos].push_back(std::make_pair(conv->second, index[converted]));
+						}
+					};
+
+					// index ir node
+					visitDepthFirstOnce(ir, indexer, false);
+
+					// check whether index limit is sufficient
+					assert(nodeList.size() < std::numeric_limits<index_t>::max()
+							&& "Number of nodes is exceeding index limit!");
+				}
+			};
+
+		}
+
+		void dumpIR(std::ostream& out, const NodePtr& ir, const AnnotationConverterRegister& converterRegister) {
+			MappedDumper(converterRegister).dump(out, ir);
+		}
+
+		void dumpIR(const std::string& file, const NodePtr& ir, const AnnotationConverterRegister& converterRegister) {
+			std::ofstream out(file, std::ios::out | std::ios::binary);
+			dumpIR(out, ir, converterRegister);
+		}
+
+
+		// -- Mapped Dump --
+
+		MappedDump::MappedDump(const std::string& file) : data(nullptr), size(0), mapped(false), header(nullptr) {
+
+			// open the file
+			int fd = open(file.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw InvalidEncodingException("Unable to open file " + file);
+			}
+
+			struct stat info;
+			if (fstat(fd, &info) != 0 || info.st_size == 0) {
+				close(fd);
+				throw InvalidEncodingException("Unable to map empty file " + file);
+			}
+
+			// map its content - pages are only loaded when being accessed
+			void* addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (addr == MAP_FAILED) {
+				throw InvalidEncodingException("Unable to map file " + file);
+			}
+
+			data = (const char*)addr;
+			size = info.st_size;
+			mapped = true;
+
+			try {
+				init();
+			} catch (...) {
+				munmap((void*)data, size);
+				throw;
+			}
+		}
+
+		MappedDump::MappedDump(std::istream& in) : data(nullptr), size(0), mapped(false), header(nullptr) {
+
+			// read the full stream into an 8-byte aligned buffer
+			string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+			buffer.resize((content.size() + 7) / 8);
+			memcpy(buffer.data(), content.data(), content.size());
+
+			data = (const char*)buffer.data();
+			size = content.size();
+			init();
+		}
+
+		MappedDump::~MappedDump() {
+			if (mapped) munmap((void*)data, size);
+		}
+
+		void MappedDump::init() {
+
+			// check the header
+			if (size < sizeof(Header)) {
+				throw InvalidEncodingException("Encoding error: incomplete header!");
+			}
+			header = (const Header*)data;
+			if (header->magic != MAGIC_NUMBER) {
+				throw InvalidEncodingException("Encoding error: wrong magic number!");
+			}
+			if (header->version != FORMAT_VERSION) {
+				throw InvalidEncodingException("Encoding error: unsupported format version " + toString(header->version) + "!");
+			}
+			if (header->size != size) {
+				throw InvalidEncodingException("Encoding error: invalid size!");
+			}
+
+			// check the sections
+			auto section = [&](uint64_t offset, uint64_t length) {
+				if (offset % 8 != 0 || offset > size || length > size - offset) {
+					throw InvalidEncodingException("Encoding error: invalid section offset!");
+				}
+				return data + offset;
+			};
+			nodeTable = (const uint32_t*)section(header->nodeTable, uint64_t(header->numNodes) * sizeof(uint32_t));
+			nodeData = (const uint32_t*)section(header->nodeData, uint64_t(header->numNodeWords) * sizeof(uint32_t));
+			converterTable = (const index_t*)section(header->converterTable, uint64_t(header->numConverters) * sizeof(index_t));
+			annotationTable = (const uint32_t*)section(header->annotationTable, (uint64_t(header->numNodes) + 1) * sizeof(uint32_t));
+			annotationData = (const index_t*)section(header->annotationData, uint64_t(header->numAnnotations) * 2 * sizeof(index_t));
+			stringTable = (const uint64_t*)section(header->stringTable, (uint64_t(header->numStrings) + 1) * sizeof(uint64_t));
+			stringData = section(header->stringData, stringTable[header->numStrings]);
+
+			if (header->root >= header->numNodes) {
+				throw InvalidEncodingException("Encoding error: invalid root node!");
+			}
+		}
+
+		void MappedDump::checkNode(index_t node) const {
+			if (node >= header->numNodes || nodeTable[node] >= header->numNodeWords) {
+				throw InvalidEncodingException("Encoding error: invalid node index " + toString(node) + "!");
+			}
+		}
+
+		index_t MappedDump::getRoot() const {
+			return header->root;
+		}
+
+		std::size_t MappedDump::getNumNodes() const {
+			return header->numNodes;
+		}
+
+		NodeType MappedDump::getNodeType(index_t node) const {
+			checkNode(node);
+			uint32_t type = nodeData[nodeTable[node]];
+			if (type >= NUM_CONCRETE_NODE_TYPES) {
+				throw InvalidEncodingException("Encoding error: invalid node type " + toString(type) + "!");
+			}
+			return NodeType(type);
+		}
+
+		std::vector<index_t> MappedDump::getChildren(index_t node) const {
+			NodeType type = getNodeType(node);
+			if (type == NT_StringValue || type == NT_BoolValue || type == NT_CharValue || type == NT_IntValue || type == NT_UIntValue) {
+				return std::vector<index_t>();
+			}
+			const uint32_t* cur = nodeData + nodeTable[node];
+			if (uint64_t(nodeTable[node]) + 2 > header->numNodeWords || uint64_t(nodeTable[node]) + 2 + cur[1] > header->numNodeWords) {
+				throw InvalidEncodingException("Encoding error: invalid child list!");
+			}
+			// children are listed before their parents => prevents cycles
+			std::vector<index_t> res(cur + 2, cur + 2 + cur[1]);
+			for(index_t child : res) {
+				if (child >= node) {
+					throw InvalidEncodingException("Encoding error: invalid child index " + toString(child) + "!");
+				}
+			}
+			return res;
+		}
+
+		uint32_t MappedDump::getValue(index_t node) const {
+			checkNode(node);
+			if (uint64_t(nodeTable[node]) + 2 > header->numNodeWords) {
+				throw InvalidEncodingException("Encoding error: invalid value!");
+			}
+			return nodeData[nodeTable[node] + 1];
+		}
+
+		std::string MappedDump::getString(index_t string) const {
+			if (string >= header->numStrings || stringTable[string] > stringTable[string+1] || stringTable[string+1] > stringTable[header->numStrings]) {
+				throw InvalidEncodingException("Encoding error: invalid string index " + toString(string) + "!");
+			}
+			return std::string(stringData + stringTable[string], stringTable[string+1] - stringTable[string]);
+		}
+
+		std::size_t MappedDump::getNumConverters() const {
+			return header->numConverters;
+		}
+
+		std::string MappedDump::getConverterName(index_t converter) const {
+			assert_lt(converter, header->numConverters);
+			return getString(converterTable[converter]);
+		}
+
+		std::vector<std::pair<index_t, index_t>> MappedDump::getAnnotations(index_t node) const {
+			checkNode(node);
+			uint32_t begin = annotationTable[node];
+			uint32_t end = annotationTable[node+1];
+			if (begin > end || end > header->numAnnotations) {
+				throw InvalidEncodingException("Encoding error: invalid annotation list!");
+			}
+			std::vector<std::pair<index_t, index_t>> res;
+			for(uint32_t i=begin; i<end; i++) {
+				res.push_back(std::make_pair(annotationData[2*i], annotationData[2*i+1]));
+			}
+			return res;
+		}
+
+
+		// -- Lazy Loader --
+
+		LazyLoader::LazyLoader(const MappedDump& dump, NodeManager& manager, const AnnotationConverterRegister& converterRegister)
+			: dump(dump), manager(manager) {
+
+			// resolve the converters used by the encoding
+			for(index_t i=0; i<dump.getNumConverters(); i++) {
+				converter.push_back(converterRegister.getConverterFor(dump.getConverterName(i)));
+			}
+		}
+
+		NodePtr LazyLoader::resolve(index_t node) {
+
+			// check whether node has been resolved before
+			auto pos = resolved.find(node);
+			if (pos != resolved.end()) {
+				return pos->second;
+			}
+
+			// restore the node
+			IRBuilder builder(manager);
+			NodePtr res;
+			NodeType type = dump.getNodeType(node);
+			switch(type) {
+				case NT_StringValue: res = builder.stringValue(dump.getString(dump.getValue(node))); break;
+				case NT_BoolValue:   res = builder.boolValue(dump.getValue(node) != 0); break;
+				case NT_CharValue:   res = builder.charValue(char(dump.getValue(node))); break;
+				case NT_IntValue:    res = builder.intValue(int(dump.getValue(node))); break;
+				case NT_UIntValue:   res = builder.uintValue(unsigned(dump.getValue(node))); break;
+				default: {
+					NodeList children;
+					for(index_t cur : dump.getChildren(node)) {
+						children.push_back(resolve(cur));
+					}
+					res = builder.get(type, children);
+				}
+			}
+
+			// remember newly resolved node
+			resolved[node] = res;
+
+			// restore its annotations
+			for(const auto& cur : dump.getAnnotations(node)) {
+				if (cur.first >= converter.size() || !converter[cur.first]) continue;
+				converter[cur.first]->attachAnnotation(res, resolve(cur.second).as<ExpressionPtr>());
+			}
+
+			return res;
+		}
+
+		NodePtr loadIR(const std::string& file, NodeManager& manager, const AnnotationConverterRegister& converterRegister) {
+			MappedDump dump(file);
+			return LazyLoader(dump, manager, converterRegister).getRoot();
+		}
+
+	} // end namespace mapped
+
+} // end namespace dump
+} // end namespace core
+} // end namespace insieme
@@ -44,6 +44,8 @@
 #include "insieme/core/printer/pretty_printer.h"
 #include "insieme/core/dump/text_dump.h"
 
+#include "insieme/core/pattern/match_cache.h"
+
 #include "insieme/core/lang/basic.h"
 #include "insieme/core/lang/extension.h"
 #include "insieme/core/lang/extension_registry.h"
@@ -61,7 +63,7 @@ namespace core {
 	/**
 	 * Defining the equality ID generator.
 	 */
-	utils::SimpleIDGenerator<Node::EqualityID> Node::equalityClassIDGenerator;
+	utils::AtomicIDGenerator<Node::EqualityID> Node::equalityClassIDGenerator;
 
 	namespace detail {
 
@@ -135,7 +137,7 @@ namespace core {
 		// create a clone using children within the new manager
 		Node* res;
 		if (isValueInternal()) {
-			res = createInstanceUsing(emptyList);
+			res = createInstanceUsing(emptyList, manager.getArena());
 		} else {
 
 			// clone the child list
@@ -149,14 +151,14 @@ namespace core {
 			}
 
 			// otherwise: create a new node
-			res = createInstanceUsing(clonedChildList);
+			res = createInstanceUsing(clonedChildList, manager.getArena());
 		}
 
 		// update manager
 		res->manager = &manager;
 
 		// update equality ID
-		res->equalityID = equalityID;
+		res->equalityID.store(equalityID.load(std::memory_order_relaxed), std::memory_order_relaxed);
 
 		// done
 		return res;
@@ -204,13 +206,27 @@ namespace core {
 		});
 	}
 
-	NodeManager::NodeManager() : data(new NodeManagerData(*this)) { }
+	NodeManager::NodeManager() : data(new NodeManagerData(*this)), matchCache(std::make_shared<pattern::MatchCache>()) { }
+
+	NodeManager::NodeManager(AllocationMode allocation, ConcurrencyMode concurrency)
+		: InstanceManager<Node, Pointer, move_annotation_on_clone>(allocation == ARENA_ALLOCATION, concurrency == CONCURRENT_ACCESS),
+		  data(new NodeManagerData(*this)), matchCache(std::make_shared<pattern::MatchCache>(isConcurrent())) {
+
+		// lazily initialized constructs of the basic language can not be created concurrently
+		if (concurrency == CONCURRENT_ACCESS) {
+			data->basic->materializeAll();
+		}
+	}
+
+	NodeManager::NodeManager(ConcurrencyMode concurrency)
+		: NodeManager(HEAP_ALLOCATION, concurrency) { }
 
 	NodeManager::NodeManager(NodeManager& manager)
-		: InstanceManager<Node, Pointer, move_annotation_on_clone>(manager), data(manager.data) {}
+		: InstanceManager<Node, Pointer, move_annotation_on_clone>(manager), data(manager.data),
+		  matchCache(std::make_shared<pattern::MatchCache>(isConcurrent())) {}
 
 	NodeManager::NodeManager(unsigned initialFreshID)
-		: data(new NodeManagerData(*this)) { setNextFreshID(initialFreshID); }
+		: data(new NodeManagerData(*this)), matchCache(std::make_shared<pattern::MatchCache>()) { setNextFreshID(initialFreshID); }
 
 	const lang::Extension& NodeManager::getLangExtensionByName(const string& extensionName) {
 		const lang::ExtensionRegistry& registry = lang::ExtensionRegistry::getInstance();
@@ -404,6 +404,18 @@ TypeSet BasicGenerator::getDirectSubTypesOf(const TypePtr& type) const {
 	return getSubTypeLattice()->getSubTypesOf(type);
 }
 
+void BasicGenerator::materializeAll() const {
+	#define TYPE(_id, _spec) get##_id();
+	#define LITERAL(_id, _name, _spec) get##_id();
+	#define DERIVED(_id, _name, _spec) get##_id();
+	#define OPERATION(_type, _op, _name, _spec) get##_type##_op();
+	#define DERIVED_OP(_type, _op, _name, _spec) get##_type##_op();
+	#define GROUP(_id, ...) get##_id##Group();
+	#include "insieme/core/lang/inspire_api/lang.def"
+
+	getSubTypeLattice();
+}
+
 
 std::ostream& operator<<(std::ostream& out, const BasicGenerator::Operator& op) {
 	switch(op) {
@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2002-2014 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include "insieme/core/pattern/match_cache.h"
+
+namespace insieme {
+namespace core {
+namespace pattern {
+
+	MatchCacheHandle::~MatchCacheHandle() {
+		// take the list of caches - the cache locks must not be acquired while holding the handle lock
+		std::vector<std::weak_ptr<MatchCache>> list;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			list.swap(caches);
+		}
+
+		// drop results from all caches still alive
+		for(const auto& cur : list) {
+			if (auto cache = cur.lock()) cache->drop(*this);
+		}
+	}
+
+	bool MatchCache::lookup(const MatchCacheHandle& pattern, const Node* node, bool& match) const {
+		std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+		if (concurrent) guard.lock();
+
+		auto pos = results.find(&pattern);
+		if (pos == results.end()) return false;
+
+		auto res = pos->second.find(node);
+		if (res == pos->second.end()) return false;
+
+		match = res->second;
+		return true;
+	}
+
+	void MatchCache::store(MatchCacheHandle& pattern, const Node* node, bool match) {
+		std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+		if (concurrent) guard.lock();
+
+		// register this cache at the handle when recording the first result of the pattern
+		auto pos = results.find(&pattern);
+		if (pos == results.end()) {
+			{
+				std::lock_guard<std::mutex> handleGuard(pattern.lock);
+				pattern.caches.push_back(shared_from_this());
+			}
+			pos = results.insert(std::make_pair(&pattern, ResultMap())).first;
+		}
+
+		pos->second[node] = match;
+	}
+
+	void MatchCache::drop(const MatchCacheHandle& pattern) {
+		std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+		if (concurrent) guard.lock();
+		results.erase(&pattern);
+	}
+
+	std::size_t MatchCache::size() const {
+		std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+		if (concurrent) guard.lock();
+
+		std::size_t res = 0;
+		for(const auto& cur : results) {
+			res += cur.second.size();
+		}
+		return res;
+	}
+
+} // end namespace pattern
+} // end namespace core
+} // end namespace insieme
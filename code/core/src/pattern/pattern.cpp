@@ -35,8 +35,10 @@
  */
 
 #include <algorithm>
+#include <bitset>
 
 #include "insieme/core/pattern/pattern.h"
+#include "insieme/core/pattern/match_cache.h"
 
 #include "insieme/core/ir.h"
 #include "insieme/core/ir_visitor.h"
@@ -98,12 +100,23 @@ namespace pattern {
 			 */
 			bool isVariableFree;
 
-			Pattern(bool isVariableFree) : isVariableFree(isVariableFree) {}
+			/**
+			 * A flag indicating that the result of matching this pattern only depends on the
+			 * matched node, thus it may be memorized across match operations (no lambdas).
+			 */
+			bool isCacheable;
+
+			Pattern(bool isVariableFree) : isVariableFree(isVariableFree), isCacheable(true) {}
 
 			virtual ~Pattern() {}
 		};
 
 
+		/**
+		 * A set of node types, utilized for indexing the types of nodes a pattern may match.
+		 */
+		typedef std::bitset<core::NUM_CONCRETE_NODE_TYPES> NodeTypeSet;
+
 		// The abstract base class for tree patterns
 		struct TreePattern : public Pattern {
 
@@ -122,7 +135,22 @@ namespace pattern {
 			 */
 			bool mayBeType;
 
-			TreePattern(const Type type, bool isVariableFree, bool mayBeType = true) : Pattern(isVariableFree), type(type), mayBeType(mayBeType) {};
+			/**
+			 * The types of nodes this pattern may match at its root (the first symbols). Nodes
+			 * of any other type are rejected without descending into the pattern.
+			 */
+			NodeTypeSet firstSymbols;
+
+			/**
+			 * The handle indexing the results of this pattern within the match caches of the node
+			 * managers. Results are dropped when the pattern is destroyed.
+			 */
+			mutable MatchCacheHandle cacheHandle;
+
+			TreePattern(const Type type, bool isVariableFree, bool mayBeType = true)
+				: Pattern(isVariableFree), type(type), mayBeType(mayBeType) {
+				firstSymbols.set();
+			};
 
 			bool match(const core::NodePtr& node) const {
 				return matchPointer(node);
@@ -178,7 +206,10 @@ namespace pattern {
 				const TreePtr treeAtom;
 
 				Constant(const core::NodePtr& atom)
-					: TreePattern(TreePattern::Constant, true, details::isTypeOrValueOrParam(atom->getNodeType())), nodeAtom(atom) {}
+					: TreePattern(TreePattern::Constant, true, details::isTypeOrValueOrParam(atom->getNodeType())), nodeAtom(atom) {
+					firstSymbols.reset();
+					firstSymbols.set(atom->getNodeType());
+				}
 				Constant(const TreePtr& atom) : TreePattern(TreePattern::Constant, true), treeAtom(atom) {}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
@@ -196,6 +227,7 @@ namespace pattern {
 
 				factory_type factory;
 
+				// the first symbols are not restricted since the atom is only built on demand
 				LazyConstant(const factory_type& factory)
 					: TreePattern(TreePattern::LazyConstant, true, isType(factory)), factory(factory) {}
 
@@ -229,7 +261,10 @@ namespace pattern {
 				const TreePatternPtr pattern;
 
 				Variable(const std::string& name, const TreePatternPtr& pattern = any)
-					: TreePattern(TreePattern::Variable, false, pattern->mayBeType), name(name), pattern(pattern) {}
+					: TreePattern(TreePattern::Variable, false, pattern->mayBeType), name(name), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+					firstSymbols = pattern->firstSymbols;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					out << "$" << name;
@@ -250,7 +285,10 @@ namespace pattern {
 				Recursion(const string& name)
 					: TreePattern(TreePattern::Recursion, false), name(name), terminal(true) {}
 				Recursion(const string& name, const TreePatternPtr& pattern)
-					: TreePattern(TreePattern::Recursion, pattern->isVariableFree, pattern->mayBeType), name(name), terminal(false), pattern(pattern) {}
+					: TreePattern(TreePattern::Recursion, pattern->isVariableFree, pattern->mayBeType), name(name), terminal(false), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+					firstSymbols = pattern->firstSymbols;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					if(terminal) return out << "rec." << name;
@@ -266,13 +304,21 @@ namespace pattern {
 				const ListPatternPtr pattern;
 
 				Node(const ListPatternPtr& pattern)
-					: TreePattern(TreePattern::Node, pattern->isVariableFree), id(-1), type(-1), pattern(pattern) {}
+					: TreePattern(TreePattern::Node, pattern->isVariableFree), id(-1), type(-1), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+				}
 
 				Node(char id, const ListPatternPtr& pattern)
-					: TreePattern(TreePattern::Node, pattern->isVariableFree), id(id), type(-1), pattern(pattern) {}
+					: TreePattern(TreePattern::Node, pattern->isVariableFree), id(id), type(-1), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+				}
 
 				Node(const core::NodeType type, const ListPatternPtr& pattern)
-					: TreePattern(TreePattern::Node, pattern->isVariableFree, details::isTypeOrValueOrParam(type)), id(-1), type(type), pattern(pattern) {}
+					: TreePattern(TreePattern::Node, pattern->isVariableFree, details::isTypeOrValueOrParam(type)), id(-1), type(type), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+					firstSymbols.reset();
+					firstSymbols.set(type);
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					if(id != -1) {
@@ -293,7 +339,9 @@ namespace pattern {
 				const TreePatternPtr pattern;
 
 				Negation(const TreePatternPtr& pattern)
-					: TreePattern(TreePattern::Negation, pattern->isVariableFree), pattern(pattern) {}
+					: TreePattern(TreePattern::Negation, pattern->isVariableFree), pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << "!(" << *(pattern.get()) << ")";
@@ -307,7 +355,10 @@ namespace pattern {
 				const TreePatternPtr pattern2;
 
 				Conjunction(const TreePatternPtr& a, const TreePatternPtr& b)
-					: TreePattern(TreePattern::Conjunction, a->isVariableFree && b->isVariableFree, a->mayBeType && b->mayBeType), pattern1(a), pattern2(b) {}
+					: TreePattern(TreePattern::Conjunction, a->isVariableFree && b->isVariableFree, a->mayBeType && b->mayBeType), pattern1(a), pattern2(b) {
+					isCacheable = a->isCacheable && b->isCacheable;
+					firstSymbols = a->firstSymbols & b->firstSymbols;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << *(pattern1.get()) << " & " << *(pattern2.get());
@@ -321,7 +372,10 @@ namespace pattern {
 				const TreePatternPtr pattern2;
 
 				Disjunction(const TreePatternPtr& a, const TreePatternPtr& b)
-					: TreePattern(TreePattern::Disjunction, a->isVariableFree && b->isVariableFree, a->mayBeType || b->mayBeType), pattern1(a), pattern2(b) {}
+					: TreePattern(TreePattern::Disjunction, a->isVariableFree && b->isVariableFree, a->mayBeType || b->mayBeType), pattern1(a), pattern2(b) {
+					isCacheable = a->isCacheable && b->isCacheable;
+					firstSymbols = a->firstSymbols | b->firstSymbols;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << *(pattern1.get()) << " | " << *(pattern2.get());
@@ -335,7 +389,9 @@ namespace pattern {
 
 				Descendant(const vector<TreePatternPtr>& patterns)
 					: TreePattern(TreePattern::Descendant, ::all(patterns, [](const TreePatternPtr& cur) { return cur->isVariableFree; })),
-					  subPatterns(patterns) {};
+					  subPatterns(patterns) {
+					isCacheable = ::all(patterns, [](const TreePatternPtr& cur) { return cur->isCacheable; });
+				};
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << "aT(" << join(",", subPatterns, print<deref<TreePatternPtr>>()) << ")";
@@ -351,9 +407,13 @@ namespace pattern {
 				boost::variant<ptr_condition_type, addr_condition_type> condition;
 
 				Lambda(const ptr_condition_type& condition, bool mayBeType = true)
-					: TreePattern(TreePattern::Lambda, true, mayBeType), condition(condition) {}
+					: TreePattern(TreePattern::Lambda, true, mayBeType), condition(condition) {
+					isCacheable = false;
+				}
 				Lambda(const addr_condition_type& condition, bool mayBeType = true)
-					: TreePattern(TreePattern::Lambda, true, mayBeType), condition(condition) {}
+					: TreePattern(TreePattern::Lambda, true, mayBeType), condition(condition) {
+					isCacheable = false;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					core::NodeManager mgr;
@@ -378,7 +438,9 @@ namespace pattern {
 				const TreePatternPtr element;
 
 				Single(const TreePatternPtr& element)
-				: ListPattern(ListPattern::Single, element->isVariableFree, 1, 1), element(element) {}
+				: ListPattern(ListPattern::Single, element->isVariableFree, 1, 1), element(element) {
+					isCacheable = element->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << *element;
@@ -396,7 +458,9 @@ namespace pattern {
 							left->minLength + right->minLength, 								// sum up lower boundaries
 							utils::saturating_add(left->maxLength, right->maxLength)			// sum up upper boundaries (saturation add)
 					  ),
-					  left(left), right(right) {}
+					  left(left), right(right) {
+					isCacheable = left->isCacheable && right->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << *left << "," << *right;
@@ -415,7 +479,9 @@ namespace pattern {
 							std::max(A->maxLength, B->maxLength)
 					  ),
 					  alternative1(A),
-					  alternative2(B) {}
+					  alternative2(B) {
+					isCacheable = A->isCacheable && B->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					return out << *alternative1 << "|" << *alternative2;
@@ -433,7 +499,9 @@ namespace pattern {
 							pattern->minLength * minRep
 					  ),
 					  pattern(pattern),
-					  minRep(minRep) {}
+					  minRep(minRep) {
+					isCacheable = pattern->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					if (minRep == 0) {
@@ -459,7 +527,9 @@ namespace pattern {
 							pattern->maxLength
 					  ),
 					  name(name),
-					  pattern(pattern) {}
+					  pattern(pattern) {
+					isCacheable = pattern->isCacheable;
+				}
 
 				virtual std::ostream& printTo(std::ostream& out) const {
 					out << "$" << name;
@@ -958,6 +1028,68 @@ namespace pattern {
 		};
 
 
+		// -- First Symbols -----------------------------------------------------------
+
+		inline bool mayMatch(const impl::TreePattern& pattern, const core::NodePtr& node) {
+			return pattern.firstSymbols.test(node->getNodeType());
+		}
+
+		inline bool mayMatch(const impl::TreePattern& pattern, const core::NodeAddress& node) {
+			return pattern.firstSymbols.test(node->getNodeType());
+		}
+
+		inline bool mayMatch(const impl::TreePattern& pattern, const TreePtr& tree) {
+			return true;		// test structures are not indexed
+		}
+
+		// -- Persistent Match Cache --------------------------------------------------
+
+		/**
+		 * Determines whether the results of the given pattern should be memorized within the match
+		 * cache of the node manager. Primitive patterns are cheaper to evaluate than to look up.
+		 */
+		inline bool isPersistentlyCached(const impl::TreePattern& pattern) {
+			if (!pattern.isVariableFree || !pattern.isCacheable) return false;
+			switch(pattern.type) {
+				case impl::TreePattern::Node:
+				case impl::TreePattern::Negation:
+				case impl::TreePattern::Conjunction:
+				case impl::TreePattern::Disjunction:
+				case impl::TreePattern::Descendant:
+				case impl::TreePattern::Recursion:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		inline CachedMatchResult persistentMatch(const impl::TreePattern& pattern, const core::NodePtr& node) {
+			bool res;
+			if (!node->getNodeManager().getMatchCache().lookup(pattern.cacheHandle, node.ptr, res)) return Unknown;
+			return (res)?Yes:No;
+		}
+
+		inline CachedMatchResult persistentMatch(const impl::TreePattern& pattern, const core::NodeAddress& node) {
+			return persistentMatch(pattern, node.getAddressedNode());
+		}
+
+		inline CachedMatchResult persistentMatch(const impl::TreePattern& pattern, const TreePtr& tree) {
+			return Unknown;
+		}
+
+		inline void addToPersistentCache(const impl::TreePattern& pattern, const core::NodePtr& node, bool match) {
+			node->getNodeManager().getMatchCache().store(pattern.cacheHandle, node.ptr, match);
+		}
+
+		inline void addToPersistentCache(const impl::TreePattern& pattern, const core::NodeAddress& node, bool match) {
+			addToPersistentCache(pattern, node.getAddressedNode(), match);
+		}
+
+		inline void addToPersistentCache(const impl::TreePattern& pattern, const TreePtr& tree, bool match) {
+			// test structures are not cached
+		}
+
+
 		template<typename T>
 		bool match(const impl::TreePattern& pattern, MatchContext<T>& context, const typename T::value_type& tree, const std::function<bool(MatchContext<T>&)>& delayedCheck);
 
@@ -1479,9 +1611,16 @@ namespace pattern {
 			// skip searching within types if not searching for a type
 			if (!pattern.mayBeType && isTypeOrValueOrParam(tree)) return false;
 
+			// skip nodes of a type the pattern can not match
+			if (!mayMatch(pattern, tree)) return false;
+
 			// use cache if possible
 			if (pattern.isVariableFree) {
+				bool persistent = isPersistentlyCached(pattern);
 				CachedMatchResult cachRes = context.cachedMatch(pattern, tree);
+				if (cachRes == Unknown && persistent) {
+					cachRes = persistentMatch(pattern, tree);
+				}
 				if (cachRes != Unknown) {
 					bool res = (cachRes == Yes) && delayedCheck(context);
 					if (DEBUG) std::cout << "Matching " << pattern << " against " << tree << " with context " << context << " ... - from cache: " << res << "\n";
@@ -1492,6 +1631,7 @@ namespace pattern {
 				std::function<bool(MatchContext<T>&)> accept = [](MatchContext<T>& context) { return true; };
 				bool res = match_internal(pattern, context, tree, accept);
 				context.addToCache(pattern, tree, res);
+				if (persistent) addToPersistentCache(pattern, tree, res);
 
 				// return result + delayed checks
 				res = res && delayedCheck(context);
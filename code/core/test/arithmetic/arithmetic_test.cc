@@ -37,9 +37,12 @@
 #include <gtest/gtest.h>
 
 #include "insieme/core/arithmetic/arithmetic.h"
+#include "insieme/core/arithmetic/arithmetic_utils.h"
 
 #include "insieme/core/ir_builder.h"
 
+#include "insieme/utils/timer.h"
+
 namespace insieme {
 namespace core {
 namespace arithmetic {
@@ -799,6 +802,49 @@ TEST(ArithmeticTest, MinMaxAbs) {
 
 }
 
+TEST(ArithmeticTest, FormulaBenchmark) {
+	NodeManager manager;
+	IRBuilder builder(manager);
+
+	TypePtr type = builder.getLangBasic().getInt4();
+	VariablePtr i = builder.variable(type, 1);
+	VariablePtr j = builder.variable(type, 2);
+
+	Formula fi = i;
+	Formula fj = j;
+
+	// typical index expressions are small - they should be handled within the inline buffers
+	Formula sum;
+	double time = TIME(
+		for(int k=0; k<10000; k++) {
+			sum = Formula(3) * fi * fi - 2 * fj + k;
+		}
+	);
+	EXPECT_EQ(3u, sum.getTerms().size());
+	EXPECT_EQ(Formula(3) * fi * fi - 2 * fj + 9999, sum);
+	EXPECT_TRUE(sum.getTerms().isInline());
+
+	// round-trips through the IR should be stable
+	ExpressionPtr expr;
+	time += TIME(
+		for(int k=0; k<1000; k++) {
+			expr = toIR(manager, sum);
+			EXPECT_EQ(sum, toFormula(expr));
+		}
+	);
+
+	// accumulating larger formulas exercises the move-aware operators
+	Formula acc;
+	time += TIME(
+		for(int k=0; k<200; k++) {
+			acc = std::move(acc) + Product(i, k+1) * (k+1) + 1;
+		}
+	);
+	EXPECT_EQ(201u, acc.getTerms().size());
+
+	std::cout << "Formula benchmark: " << time << "s\n";
+}
+
 } // end namespace arithmetic
 } // end namespace core
 } // end namespace insieme
@@ -196,6 +196,104 @@ TEST(IRCheck, Annotations) {
 }
 
 
+/**
+ * A check counting the nodes it is applied to.
+ */
+class CountingCheck : public IRCheck {
+public:
+	unsigned& counter;
+	CountingCheck(unsigned& counter, bool addressDependent = false) : IRCheck(true, addressDependent), counter(counter) {}
+	OptionalMessageList visitNode(const NodeAddress& node) {
+		counter++;
+		return OptionalMessageList();
+	}
+};
+
+TEST(IRCheck, Incremental) {
+	NodeManager manager;
+	IRBuilder builder(manager);
+
+	// build diamond - again ...
+	GenericTypePtr typeD = builder.genericType("D");
+	GenericTypePtr typeB = builder.genericType("B",toVector<TypePtr>(typeD));
+	GenericTypePtr typeC = builder.genericType("C",toVector<TypePtr>(typeD));
+	GenericTypePtr typeA = builder.genericType("A", toVector<TypePtr>(typeB, typeC));
+
+	// the results should be the same as for the visit-once check
+	CheckPtr onceCheck = makeVisitOnce(combine(toVector<CheckPtr>(make_check<IAmScaredCheck>(), make_check<IDontLikeAnythingCheck>())));
+	CheckPtr incCheck = makeIncremental(combine(toVector<CheckPtr>(make_check<IAmScaredCheck>(), make_check<IDontLikeAnythingCheck>())));
+
+	EXPECT_EQ(check(typeA, onceCheck), check(typeA, incCheck));
+	EXPECT_EQ(check(typeA, onceCheck), check(typeA, incCheck));
+	EXPECT_EQ(check(typeB, onceCheck), check(typeB, incCheck));
+	EXPECT_EQ(check(typeD, onceCheck), check(typeD, incCheck));
+}
+
+TEST(IRCheck, IncrementalReuse) {
+	NodeManager manager;
+	IRBuilder builder(manager);
+
+	GenericTypePtr typeD = builder.genericType("D");
+	GenericTypePtr typeB = builder.genericType("B",toVector<TypePtr>(typeD));
+	GenericTypePtr typeC = builder.genericType("C",toVector<TypePtr>(typeD));
+	GenericTypePtr typeA = builder.genericType("A", toVector<TypePtr>(typeB, typeC));
+
+	unsigned independent = 0;
+	unsigned dependent = 0;
+	CheckPtr incCheck = makeIncremental(combine(toVector<CheckPtr>(std::make_shared<CountingCheck>(independent), std::make_shared<CountingCheck>(dependent, true))));
+	EXPECT_TRUE(incCheck->isAddressDependent());
+
+	// the first run checks all nodes once
+	EXPECT_TRUE(check(typeA, incCheck).empty());
+	unsigned numNodes = independent;
+	EXPECT_LT(0u, numNodes);
+	EXPECT_EQ(numNodes, dependent);
+
+	// the second run only re-evaluates the address dependent check
+	EXPECT_TRUE(check(typeA, incCheck).empty());
+	EXPECT_EQ(numNodes, independent);
+	EXPECT_EQ(2*numNodes, dependent);
+
+	// replacing a sub-tree only checks new nodes
+	GenericTypePtr typeE = builder.genericType("E");
+	GenericTypePtr typeA2 = builder.genericType("A", toVector<TypePtr>(typeB, typeE));
+	EXPECT_TRUE(check(typeA2, incCheck).empty());
+	EXPECT_EQ(numNodes + 4, independent);		// A2, its type parameter list, E and the name of E
+
+	// without address dependent checks, clean sub-trees are not visited at all
+	independent = 0;
+	CheckPtr cleanCheck = makeIncremental(std::make_shared<CountingCheck>(independent));
+	EXPECT_FALSE(cleanCheck->isAddressDependent());
+	EXPECT_TRUE(check(typeA, cleanCheck).empty());
+	EXPECT_EQ(numNodes, independent);
+	EXPECT_TRUE(check(typeA, cleanCheck).empty());
+	EXPECT_EQ(numNodes, independent);
+}
+
+TEST(IRCheck, IncrementalFullCheck) {
+	NodeManager manager;
+	IRBuilder builder(manager);
+
+	// a valid program fragment
+	StatementPtr stmt = builder.parseStmt(
+		"{ "
+		"	decl ref<int<4>> x = var(0); "
+		"	for(uint<4> i = 10u .. 50u) { "
+		"		x = x + 1; "
+		"	} "
+		"}");
+	ASSERT_TRUE(stmt);
+	EXPECT_EQ(check(stmt), checkIncremental(stmt));
+	EXPECT_TRUE(checkIncremental(stmt).empty());
+
+	// an invalid one using it as a sub-tree
+	StatementPtr invalid = builder.compoundStmt(stmt, builder.ifStmt(builder.intLit(1), builder.getNoOp()));
+	EXPECT_FALSE(check(invalid).empty());
+	EXPECT_EQ(check(invalid), checkIncremental(invalid));
+	EXPECT_EQ(check(invalid), checkIncremental(invalid));
+}
+
+
 } // end namespace checks
 } // end namespace core
 } // end namespace insieme
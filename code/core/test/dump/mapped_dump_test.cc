@@ -0,0 +1,424 @@
+/**
+ * Copyright (c) 2002-2013 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please 
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details 
+ * regarding third party software licenses.
+ */
+#include <gtest/gtest.h>
+
+#include "insieme/core/dump/mapped_dump.h"
+#include "insieme/core/dump/binary_dump.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "insieme/core/ir_builder.h"
+#include "insieme/core/encoder/encoder.h"
+
+#include "insieme/utils/timer.h"
+#include "insieme/utils/test/test_utils.h"
+
+namespace insieme {
+namespace core {
+namespace dump {
+
+using namespace std;
+
+namespace {
+
+	NodePtr createCode(NodeManager& manager) {
+		IRBuilder builder(manager);
+
+		std::map<std::string, NodePtr> symbols;
+		symbols["v"] = builder.variable(builder.parseType("ref<array<int<4>,1>>"));
+
+		return builder.parseStmt(
+			"{ "
+			"	for(uint<4> i = 10u .. 50u) { "
+			"		v[i]; "
+			"	} "
+			"	for(uint<4> j = 5u .. 25u) { "
+			"		v[j]; "
+			"	} "
+			"}", symbols);
+	}
+
+	/**
+	 * Creates a tuple type of N independent type chains of the given length.
+	 */
+	TypePtr createWideType(NodeManager& manager, int N, int length) {
+		IRBuilder builder(manager);
+		TypeList elements;
+		for(int i=0; i<N; i++) {
+			TypePtr cur = builder.genericType("A" + toString(i));
+			for(int j=0; j<length; j++) {
+				cur = builder.genericType("T" + toString(j), toVector(cur));
+			}
+			elements.push_back(cur);
+		}
+		return builder.tupleType(elements);
+	}
+
+	struct TempFile {
+		string name;
+		TempFile() {
+			char tmpl[] = "/tmp/insieme_mapped_dump_XXXXXX";
+			int fd = mkstemp(tmpl);
+			if (fd >= 0) close(fd);
+			name = tmpl;
+		}
+		~TempFile() { std::remove(name.c_str()); }
+	};
+
+}
+
+TEST(MappedDump, StoreLoad) {
+
+	// create a code fragment using manager A
+	NodeManager managerA;
+	NodePtr code = createCode(managerA);
+	EXPECT_TRUE(code) << *code;
+
+	// dump IR using the mapped format
+	stringstream buffer(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(buffer, code);
+
+	// reload IR using a different node manager
+	mapped::MappedDump dump(buffer);
+	EXPECT_EQ(0u, dump.getSize() % 8);
+
+	NodeManager managerB;
+	mapped::LazyLoader loader(dump, managerB);
+	NodePtr restored = loader.getRoot();
+
+	EXPECT_NE(code, restored);
+	EXPECT_EQ(*code, *restored);
+	EXPECT_EQ(dump.getNumNodes(), loader.getNumResolved());
+
+	// reloading into the original manager yields the original node
+	mapped::LazyLoader loader2(dump, managerA);
+	EXPECT_EQ(code, loader2.getRoot());
+}
+
+TEST(MappedDump, RoundTripBinary) {
+
+	NodeManager managerA;
+	NodePtr code = createCode(managerA);
+
+	// dump IR using both formats
+	stringstream binaryBuffer(ios_base::out | ios_base::in | ios_base::binary);
+	binary::dumpIR(binaryBuffer, code);
+
+	stringstream mappedBuffer(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(mappedBuffer, code);
+
+	// both should restore the same code
+	NodeManager managerB;
+	NodePtr fromBinary = binary::loadIR(binaryBuffer, managerB);
+
+	mapped::MappedDump dump(mappedBuffer);
+	mapped::LazyLoader loader(dump, managerB);
+	NodePtr fromMapped = loader.getRoot();
+
+	EXPECT_EQ(fromBinary, fromMapped);
+
+	// and a mapped dump of the binary restored code is identical to the original
+	stringstream mappedBuffer2(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(mappedBuffer2, fromBinary);
+	EXPECT_EQ(mappedBuffer.str(), mappedBuffer2.str());
+}
+
+TEST(MappedDump, File) {
+
+	NodeManager managerA;
+	NodePtr code = createCode(managerA);
+
+	TempFile file;
+	mapped::dumpIR(file.name, code);
+
+	NodeManager managerB;
+	NodePtr restored = mapped::loadIR(file.name, managerB);
+	EXPECT_EQ(*code, *restored);
+}
+
+TEST(MappedDump, LazyResolution) {
+
+	NodeManager managerA;
+	TypePtr type = createWideType(managerA, 100, 10);
+
+	stringstream buffer(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(buffer, type);
+
+	// inspect the element types without creating any nodes
+	mapped::MappedDump dump(buffer);
+	EXPECT_EQ(NT_TupleType, dump.getNodeType(dump.getRoot()));
+
+	auto elements = dump.getChildren(dump.getRoot());
+	ASSERT_EQ(100u, elements.size());
+
+	// resolve only this element
+	NodeManager managerB;
+	mapped::LazyLoader loader(dump, managerB);
+	NodePtr element = loader.resolve(elements[0]);
+
+	TupleTypePtr tuple = type.as<TupleTypePtr>();
+	EXPECT_EQ(*tuple->getElementTypes()[0], *element);
+	EXPECT_LT(loader.getNumResolved(), dump.getNumNodes() / 10);
+}
+
+TEST(MappedDump, InvalidEncoding) {
+
+	NodeManager manager;
+	NodePtr code = createCode(manager);
+
+	// a binary dump is not a valid mapped dump
+	stringstream buffer(ios_base::out | ios_base::in | ios_base::binary);
+	binary::dumpIR(buffer, code);
+	EXPECT_THROW(mapped::MappedDump dump(buffer), InvalidEncodingException);
+
+	// a truncated mapped dump is invalid too
+	stringstream buffer2(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(buffer2, code);
+	string data = buffer2.str();
+	stringstream truncated(data.substr(0, data.size() / 2), ios_base::in | ios_base::binary);
+	EXPECT_THROW(mapped::MappedDump dump(truncated), InvalidEncodingException);
+
+	// as are missing files
+	EXPECT_THROW(mapped::MappedDump dump("/this/file/does/not/exist"), InvalidEncodingException);
+
+	// locate the encoding of the root node (offsets of the header fields, see format description)
+	auto word = [&](const string& data, std::size_t offset)->uint32_t {
+		uint32_t res; memcpy(&res, data.data() + offset, sizeof(res)); return res;
+	};
+	auto offset = [&](const string& data, std::size_t field)->uint64_t {
+		uint64_t res; memcpy(&res, data.data() + field, sizeof(res)); return res;
+	};
+	uint32_t root = word(data, 12);
+	uint64_t nodeTable = offset(data, 40);
+	uint64_t nodeData = offset(data, 48);
+	uint64_t rootPos = nodeData + 4 * word(data, nodeTable + 4 * root);
+	ASSERT_LT(0u, word(data, rootPos + 4)) << "Root should have children!";
+
+	// nodes of an unknown type are rejected
+	string invalidType = data;
+	uint32_t type = NUM_CONCRETE_NODE_TYPES + 5;
+	memcpy(&invalidType[rootPos], &type, sizeof(type));
+	{
+		stringstream in(invalidType, ios_base::in | ios_base::binary);
+		mapped::MappedDump dump(in);
+		EXPECT_THROW(dump.getNodeType(root), InvalidEncodingException);
+		EXPECT_THROW(dump.getChildren(root), InvalidEncodingException);
+
+		NodeManager other;
+		mapped::LazyLoader loader(dump, other);
+		EXPECT_THROW(loader.getRoot(), InvalidEncodingException);
+	}
+
+	// as are back-edges forming cycles
+	string cyclic = data;
+	memcpy(&cyclic[rootPos + 8], &root, sizeof(root));
+	{
+		stringstream in(cyclic, ios_base::in | ios_base::binary);
+		mapped::MappedDump dump(in);
+		EXPECT_THROW(dump.getChildren(root), InvalidEncodingException);
+
+		NodeManager other;
+		mapped::LazyLoader loader(dump, other);
+		EXPECT_THROW(loader.getRoot(), InvalidEncodingException);
+	}
+
+	// the unmodified encoding lists children before their parents
+	{
+		stringstream in(data, ios_base::in | ios_base::binary);
+		mapped::MappedDump dump(in);
+		for(mapped::index_t i=0; i<dump.getNumNodes(); i++) {
+			for(mapped::index_t child : dump.getChildren(i)) {
+				EXPECT_LT(child, i);
+			}
+		}
+	}
+}
+
+// ------------ Test Annotations ----------------
+
+struct MappedDummyAnnotation {
+	int x;
+	MappedDummyAnnotation(int x) : x(x) {}
+	bool operator==(const MappedDummyAnnotation& other) const { return x == other.x; };
+};
+
+struct MappedDummyAnnotationConverter : public AnnotationConverter {
+	typedef core::value_node_annotation<MappedDummyAnnotation>::type annotation_type;
+
+	MappedDummyAnnotationConverter() : AnnotationConverter("MappedDummyAnnotationConverter") {}
+
+	virtual ExpressionPtr toIR(NodeManager& manager, const NodeAnnotationPtr& annotation) const {
+		assert(dynamic_pointer_cast<annotation_type>(annotation) && "Only dummy annotations supported!");
+		int x = static_pointer_cast<annotation_type>(annotation)->getValue().x;
+		return encoder::toIR(manager, x);
+	}
+
+	virtual NodeAnnotationPtr toAnnotation(const ExpressionPtr& node) const {
+		assert(encoder::isEncodingOf<int>(node.as<ExpressionPtr>()) && "Invalid encoding encountered!");
+		return std::make_shared<annotation_type>(MappedDummyAnnotation(encoder::toValue<int>(node)));
+	}
+};
+
+TEST(MappedDump, StoreLoadAnnotations) {
+
+	NodeManager managerA;
+	IRBuilder builder(managerA);
+
+	// create conversion register
+	AnnotationConverterRegister registry;
+	registry.registerConverter<MappedDummyAnnotationConverter, core::value_node_annotation<MappedDummyAnnotation>::type>();
+
+	NodePtr code = builder.genericType("A");
+	code->attachValue(MappedDummyAnnotation(12));
+
+	stringstream buffer(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(buffer, code, registry);
+
+	mapped::MappedDump dump(buffer);
+	EXPECT_EQ(1u, dump.getNumConverters());
+	EXPECT_EQ("MappedDummyAnnotationConverter", dump.getConverterName(0));
+
+	// restore with annotations
+	NodeManager managerB;
+	NodePtr restored = mapped::LazyLoader(dump, managerB, registry).getRoot();
+	EXPECT_EQ(*code, *restored);
+	ASSERT_TRUE(restored->hasAttachedValue<MappedDummyAnnotation>());
+	EXPECT_EQ(12, restored->getAttachedValue<MappedDummyAnnotation>().x);
+
+	// restore without the converter
+	NodeManager managerC;
+	NodePtr restored2 = mapped::LazyLoader(dump, managerC).getRoot();
+	EXPECT_EQ(*code, *restored2);
+	EXPECT_FALSE(restored2->hasAttachedValue<MappedDummyAnnotation>());
+}
+
+TEST(MappedDump, LoadAnnotatedCode) {
+
+	NodeManager managerA;
+	IRBuilder builder(managerA);
+
+	AnnotationConverterRegister registry;
+	registry.registerConverter<MappedDummyAnnotationConverter, core::value_node_annotation<MappedDummyAnnotation>::type>();
+
+	// annotate the root and some inner nodes - the encodings share nodes with the annotated code
+	TypePtr type = createWideType(managerA, 5, 3);
+	TypeList elements = type.as<TupleTypePtr>()->getElementTypes();
+	type->attachValue(MappedDummyAnnotation(1));
+	elements[0]->attachValue(MappedDummyAnnotation(2));
+	elements[4]->attachValue(MappedDummyAnnotation(3));
+
+	stringstream buffer(ios_base::out | ios_base::in | ios_base::binary);
+	mapped::dumpIR(buffer, type, registry);
+
+	// the encoding is of the current version
+	string data = buffer.str();
+	uint32_t version;
+	memcpy(&version, data.data() + 8, sizeof(version));
+	EXPECT_EQ(mapped::FORMAT_VERSION, version);
+
+	mapped::MappedDump dump(buffer);
+	EXPECT_EQ(1u, dump.getNumConverters());
+
+	// also the nodes of the annotation encodings are listed after their children
+	for(mapped::index_t i=0; i<dump.getNumNodes(); i++) {
+		for(mapped::index_t child : dump.getChildren(i)) {
+			EXPECT_LT(child, i);
+		}
+	}
+
+	// resolve an annotated element on its own
+	NodeManager managerB;
+	mapped::LazyLoader loader(dump, managerB, registry);
+	NodePtr element = loader.resolve(dump.getChildren(dump.getRoot())[4]);
+	EXPECT_EQ(*elements[4], *element);
+	ASSERT_TRUE(element->hasAttachedValue<MappedDummyAnnotation>());
+	EXPECT_EQ(3, element->getAttachedValue<MappedDummyAnnotation>().x);
+
+	// and the full code
+	NodePtr restored = loader.getRoot();
+	EXPECT_EQ(*type, *restored);
+	ASSERT_TRUE(restored->hasAttachedValue<MappedDummyAnnotation>());
+	EXPECT_EQ(1, restored->getAttachedValue<MappedDummyAnnotation>().x);
+	ASSERT_TRUE(restored.as<TupleTypePtr>()->getElementTypes()[0]->hasAttachedValue<MappedDummyAnnotation>());
+	EXPECT_EQ(2, restored.as<TupleTypePtr>()->getElementTypes()[0]->getAttachedValue<MappedDummyAnnotation>().x);
+	EXPECT_FALSE(restored.as<TupleTypePtr>()->getElementTypes()[1]->hasAttachedValue<MappedDummyAnnotation>());
+}
+
+TEST(MappedDump, LoadSpeed) {
+	bool showTimes = false;
+
+	NodeManager managerA;
+	TypePtr type = createWideType(managerA, 10000, 20);
+
+	TempFile binaryFile, mappedFile;
+	{
+		std::ofstream out(binaryFile.name, ios_base::out | ios_base::binary);
+		binary::dumpIR(out, type);
+	}
+	mapped::dumpIR(mappedFile.name, type);
+
+	// load the full binary dump
+	{
+		NodeManager manager;
+		std::size_t rss = getResidentSetSize();
+		utils::Timer timer("Binary load");
+		std::ifstream in(binaryFile.name, ios_base::in | ios_base::binary);
+		EXPECT_EQ(*type, *binary::loadIR(in, manager));
+		timer.stop();
+		EXPECT_FALSE(showTimes) << timer << "RSS growth: " << (getResidentSetSize() - rss) / 1024 << " KB\n";
+	}
+
+	// open the mapped dump and resolve a single element
+	{
+		NodeManager manager;
+		std::size_t rss = getResidentSetSize();
+		utils::Timer timer("Mapped load");
+		mapped::MappedDump dump(mappedFile.name);
+		mapped::LazyLoader loader(dump, manager);
+		auto elements = dump.getChildren(dump.getRoot());
+		EXPECT_EQ(*type.as<TupleTypePtr>()->getElementTypes()[0], *loader.resolve(elements[0]));
+		timer.stop();
+		EXPECT_FALSE(showTimes) << timer << "RSS growth: " << (getResidentSetSize() - rss) / 1024 << " KB\n";
+	}
+}
+
+} // end namespace dump
+} // end namespace core
+} // end namespace insieme
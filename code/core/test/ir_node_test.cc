@@ -36,13 +36,18 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "insieme/core/ir_node.h"
 #include "insieme/core/ir_address.h"
 #include "insieme/core/ir_values.h"
 #include "insieme/core/ir_int_type_param.h"
 #include "insieme/core/ir_builder.h"
+#include "insieme/core/transform/node_replacer.h"
+#include "insieme/core/lang/static_vars.h"
 
 #include "insieme/utils/timer.h"
+#include "insieme/utils/test/test_utils.h"
 
 namespace insieme {
 namespace core {
@@ -191,6 +196,148 @@ namespace new_core {
 
 	}
 
+	TEST(NodeManager, ArenaAllocation) {
+
+		NodeManager heapMgr;
+		NodeManager arenaMgr(NodeManager::ARENA_ALLOCATION);
+
+		EXPECT_FALSE(heapMgr.getArena());
+		ASSERT_TRUE(arenaMgr.getArena());
+		EXPECT_EQ(0u, arenaMgr.getArena()->getAllocatedBytes());
+
+		// create the same structure within both managers
+		IRBuilder heapBuilder(heapMgr);
+		IRBuilder arenaBuilder(arenaMgr);
+
+		TypePtr A = arenaBuilder.genericType("A");
+		TypePtr B = arenaBuilder.genericType("B", toVector<TypePtr>(A));
+		EXPECT_LT(0u, arenaMgr.getArena()->getAllocatedBytes());
+		EXPECT_TRUE(arenaMgr.addressesLocal(B));
+
+		// nodes are still shared and equal to nodes within other managers
+		TypePtr heapB = heapBuilder.genericType("B", toVector<TypePtr>(heapBuilder.genericType("A")));
+		EXPECT_EQ(B, arenaBuilder.genericType("B", toVector<TypePtr>(A)));
+		EXPECT_EQ(*heapB, *B);
+		EXPECT_EQ(heapB, heapMgr.get(B));
+
+		// substitutions are creating nodes within the arena
+		TypePtr C = arenaBuilder.genericType("C");
+		NodePtr res = transform::replaceAll(arenaMgr, B, A, C);
+		EXPECT_EQ("B<C>", toString(*res));
+		EXPECT_TRUE(arenaMgr.addressesLocal(res));
+
+		// substitutions hitting existing nodes are resolving to the managed instance
+		EXPECT_EQ(B, transform::replaceAll(arenaMgr, res, C, A));
+
+		// chained managers inherit the allocation mode
+		NodeManager child(arenaMgr);
+		EXPECT_TRUE(child.getArena());
+		EXPECT_FALSE(NodeManager(heapMgr).getArena());
+	}
+
+	namespace {
+
+		/**
+		 * Creates N distinct nodes within the given manager.
+		 */
+		void createNodes(NodeManager& manager, int N) {
+			IRBuilder builder(manager);
+			TypePtr last = builder.genericType("A");
+			for (int i=0; i<N; i++) {
+				last = builder.genericType("T" + toString(i), toVector<TypePtr>(last));
+			}
+		}
+
+	}
+
+	TEST(NodeManager, AllocationModeSpeed) {
+
+		int N = 100; //0000;
+		bool showTimes = false;
+
+		for (auto mode : { NodeManager::HEAP_ALLOCATION, NodeManager::ARENA_ALLOCATION }) {
+			std::string name = (mode == NodeManager::HEAP_ALLOCATION) ? "heap" : "arena";
+
+			std::size_t rss = getResidentSetSize();
+			utils::Timer timer(name);
+			{
+				NodeManager manager(mode);
+				createNodes(manager, N);
+				timer.step();
+				EXPECT_FALSE(showTimes) << name << " - resident set growth: " << (getResidentSetSize() - rss) / 1024 << " KB";
+			}
+			timer.stop();
+			EXPECT_FALSE(showTimes) << timer;
+		}
+
+	}
+
+	TEST(NodeManager, ConcurrentAccess) {
+
+		NodeManager manager(NodeManager::CONCURRENT_ACCESS);
+		EXPECT_TRUE(manager.isConcurrent());
+		EXPECT_TRUE(NodeManager(manager).isConcurrent());
+		EXPECT_FALSE(NodeManager().isConcurrent());
+
+		// let multiple threads build the same nodes
+		const int N = 1000;
+		const int T = 4;
+		vector<vector<TypePtr>> types(T);
+		vector<const lang::StaticVariableExtension*> extensions(T);
+		vector<std::thread> threads;
+		for (int t=0; t<T; t++) {
+			threads.push_back(std::thread([&, t]() {
+				IRBuilder builder(manager);
+				TypePtr last = builder.genericType("A");
+				for (int i=0; i<N; i++) {
+					last = builder.genericType("T" + toString(i), toVector<TypePtr>(last));
+					types[t].push_back(last);
+				}
+				extensions[t] = &manager.getLangExtension<lang::StaticVariableExtension>();
+			}));
+		}
+		for (auto& cur : threads) {
+			cur.join();
+		}
+
+		// all threads should have obtained the same instances
+		for (int t=1; t<T; t++) {
+			EXPECT_EQ(types[0], types[t]);
+			EXPECT_EQ(extensions[0], extensions[t]);
+		}
+
+		// nodes obtained concurrently are still equal to nodes within other managers
+		NodeManager other;
+		EXPECT_EQ(*types[0].back(), *other.get(types[0].back()));
+	}
+
+	TEST(NodeManager, ConcurrentSpeed) {
+
+		int N = 100; //0000;
+		int T = 4;
+		bool showTimes = false;
+
+		NodeManager manager(NodeManager::CONCURRENT_ACCESS);
+		for (int threads = 1; threads <= T; threads *= 2) {
+			utils::Timer timer(toString(threads) + " threads");
+			vector<std::thread> workers;
+			for (int t=0; t<threads; t++) {
+				workers.push_back(std::thread([&, t]() {
+					IRBuilder builder(manager);
+					TypePtr last = builder.genericType("A");
+					for (int i=0; i<N; i++) {
+						last = builder.genericType("T" + toString(threads) + "_" + toString(t) + "_" + toString(i), toVector<TypePtr>(last));
+					}
+				}));
+			}
+			for (auto& cur : workers) {
+				cur.join();
+			}
+			timer.stop();
+			EXPECT_FALSE(showTimes) << timer << " - " << (threads * N / timer.getTime()) << " nodes/s";
+		}
+	}
+
 	TEST(Node, DumpTest) {
 
 		// just create some node and dump it
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "insieme/core/ir_builder.h"
+#include "insieme/core/pattern/ir_pattern.h"
+#include "insieme/core/pattern/match_cache.h"
+
+namespace insieme {
+namespace core {
+namespace pattern {
+
+	TEST(MatchCache, MemorizedResults) {
+
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+
+		auto a = builder.variable(builder.getLangBasic().getInt4());
+		auto stmt = builder.compoundStmt(builder.add(a, builder.intLit(1)), builder.mul(a, a));
+
+		MatchCache& cache = mgr.getMatchCache();
+		EXPECT_EQ(0u, cache.size());
+
+		{
+			TreePattern pattern = aT(irp::literal("1"));
+			EXPECT_TRUE(pattern.match(stmt));
+			EXPECT_FALSE(pattern.match(a));
+
+			// results of composite patterns are memorized within the manager
+			std::size_t size = cache.size();
+			EXPECT_LT(0u, size);
+
+			// repeated matches re-use those results
+			EXPECT_TRUE(pattern.match(stmt));
+			EXPECT_EQ(size, cache.size());
+
+			// lambdas and primitive patterns are not memorized
+			EXPECT_TRUE(aT(lambda([](const NodePtr& node) { return node->getNodeType() == NT_Literal; })).match(stmt));
+			EXPECT_TRUE(irp::atom(stmt).match(stmt));
+			EXPECT_EQ(size, cache.size());
+		}
+
+		// the results are dropped with the pattern
+		EXPECT_EQ(0u, cache.size());
+	}
+
+	TEST(MatchCache, ManagerScope) {
+
+		TreePattern pattern = aT(irp::literal("1"));
+
+		NodeManager mgrA;
+		IRBuilder builderA(mgrA);
+		EXPECT_TRUE(pattern.match(builderA.compoundStmt(builderA.intLit(1))));
+
+		{
+			// child managers maintain their own results
+			NodeManager mgrB(mgrA);
+			IRBuilder builderB(mgrB);
+			EXPECT_FALSE(pattern.match(builderB.compoundStmt(builderB.intLit(2))));
+			EXPECT_LT(0u, mgrB.getMatchCache().size());
+		}
+
+		// the pattern remains usable after the destruction of a manager holding its results
+		EXPECT_FALSE(pattern.match(builderA.compoundStmt(builderA.intLit(3))));
+		EXPECT_LT(0u, mgrA.getMatchCache().size());
+	}
+
+	TEST(MatchCache, ConcurrentAccess) {
+
+		NodeManager mgr(NodeManager::CONCURRENT_ACCESS);
+		IRBuilder builder(mgr);
+
+		// build a list of statements, every third one containing the searched literal
+		auto a = builder.variable(builder.getLangBasic().getInt4());
+		vector<StatementPtr> stmts;
+		for(int i=0; i<300; i++) {
+			stmts.push_back(builder.compoundStmt(builder.add(a, builder.intLit(i % 3))));
+		}
+
+		TreePattern pattern = aT(irp::literal("1"));
+
+		// match the same pattern against the same nodes from several threads
+		const unsigned numThreads = 4;
+		vector<unsigned> counts(numThreads, 0);
+		vector<std::thread> threads;
+		for(unsigned t=0; t<numThreads; t++) {
+			threads.push_back(std::thread([&,t]() {
+				for(const auto& cur : stmts) {
+					if (pattern.match(cur)) counts[t]++;
+				}
+			}));
+		}
+		for(auto& cur : threads) cur.join();
+
+		for(unsigned t=0; t<numThreads; t++) {
+			EXPECT_EQ(100u, counts[t]);
+		}
+		EXPECT_LT(0u, mgr.getMatchCache().size());
+	}
+
+} // end namespace pattern
+} // end namespace core
+} // end namespace insieme
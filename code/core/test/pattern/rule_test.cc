@@ -40,6 +40,9 @@
 #include "insieme/core/pattern/ir_pattern.h"
 #include "insieme/core/pattern/ir_generator.h"
 #include "insieme/core/pattern/variable.h"
+#include "insieme/core/pattern/match_cache.h"
+
+#include "insieme/utils/timer.h"
 
 namespace insieme {
 namespace core {
@@ -286,6 +289,53 @@ namespace pattern {
 
 	}
 
+	TEST(Rule, NestedRuleBenchmark) {
+
+		ListVariable xs = "x";
+		ListVariable ys = "y";
+
+		NodeManager mgr;
+		IRBuilder builder(mgr);
+
+		// eliminates empty compound statements and statements referencing the marker
+		auto marker = builder.intLit(-1);
+		auto r = Rule(
+				irp::compoundStmt(xs << (irp::compoundStmt() | aT(irp::atom(marker))) << ys),
+				irg::compoundStmt(xs << ys)
+		);
+
+		// build a large program containing a few empty compound statements
+		auto a = builder.variable(builder.getLangBasic().getInt4());
+		vector<StatementPtr> stmts;
+		for(int i=0; i<500; i++) {
+			auto sum = builder.add(a, builder.intLit(i));
+			stmts.push_back(builder.compoundStmt(sum, builder.mul(sum, sum)));
+			if (i % 100 == 0) stmts.push_back(builder.compoundStmt());
+		}
+		auto program = builder.compoundStmt(stmts);
+
+		// the first application fills the match cache of the manager, the second one re-uses it
+		NodePtr res1, res2;
+		double t1 = TIME(res1 = r.fixpointNested(program));
+		std::size_t cached = mgr.getMatchCache().size();
+		double t2 = TIME(res2 = r.fixpointNested(program));
+
+		EXPECT_EQ(res1, res2);
+		EXPECT_EQ(500u, res1.as<CompoundStmtPtr>().size());
+		EXPECT_FALSE(aT(irp::compoundStmt()).match(res1));
+		EXPECT_TRUE(aT(irp::compoundStmt()).match(program));
+
+		// the second application does not add further results
+		EXPECT_LT(0u, cached);
+		EXPECT_EQ(cached, mgr.getMatchCache().size());
+
+		// nodes of other types are rejected by the root node type
+		EXPECT_FALSE(irp::compoundStmt(xs).match(a));
+		EXPECT_FALSE((irp::compoundStmt(xs) | irp::compoundStmt()).match(builder.intLit(1)));
+
+		std::cout << "Nested rule application: first run " << t1 << "s, second run " << t2 << "s\n";
+	}
+
 } // end namespace pattern
 } // end namespace core
 } // end namespace insieme
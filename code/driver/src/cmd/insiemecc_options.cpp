@@ -200,6 +200,12 @@ namespace cmd {
 			res.job.setOption(fe::ConversionJob::NoWarnings, res.settings.noWarnings);
 			res.job.setOption(fe::ConversionJob::WinCrossCompile, res.settings.winCrossCompile);
 			res.job.setOption(fe::ConversionJob::NoDefaultExtensions, res.settings.noDefaultExtensions);
+			res.job.setNumJobs(res.settings.numJobs);
+
+			// translation unit cache
+			if(!res.settings.tuCache.empty()) {
+				res.job.setCache(std::make_shared<fe::tu::IRTranslationUnitCache>(res.settings.tuCache, uintmax_t(res.settings.tuCacheSize) << 20));
+			}
 
 			// check for libraries and add LD_LIBRARY_PATH entries to lib search path
 			std::vector<frontend::path> ldpath;
@@ -70,6 +70,7 @@
 #include "insieme/backend/sequential/sequential_backend.h"
 #include "insieme/backend/ocl_host/host_backend.h"
 #include "insieme/backend/ocl_kernel/kernel_backend.h"
+#include "insieme/backend/c_ast/c_code.h"
 #include "insieme/annotations/ocl/ocl_annotations.h"
 #include "insieme/driver/cmd/insiemecc_options.h"
 #include "insieme/driver/object_file_utils.h"
@@ -436,8 +437,8 @@ int main(int argc, char** argv) {
 	// update input files
 	options.job.setFiles(inputs);
 
-    // Step 3: load input code
-	co::NodeManager mgr;
+    // Step 3: load input code - parallel conversion requires a concurrently accessible manager
+	co::NodeManager mgr((options.job.getNumJobs() > 1) ? co::NodeManager::CONCURRENT_ACCESS : co::NodeManager::SEQUENTIAL_ACCESS);
 
 	// load libraries
 	options.job.setLibs(::transform(libs, [&](const fe::path& cur) {
@@ -481,6 +482,9 @@ int main(int argc, char** argv) {
     if(options.settings.showStatistics)
     	showStatistics(program);
 
+    if(options.settings.showStatistics && options.job.getCache())
+    	std::cout << "Translation unit cache: " << options.job.getCache()->getStatistics() << "\n";
+
     if(options.settings.benchmarkCore)
     	benchmarkCore(program);
 
@@ -500,6 +504,7 @@ int main(int argc, char** argv) {
 	// Step 3: produce output code
 	std::cout << "Creating target code ...\n";
 	backend::BackendPtr backend = getBackend(program, options);
+	backend->getConfiguration().numShards = options.settings.backendShards;
 	auto targetCode = backend->convert(program);
 
 	// dump source file if requested, exit if requested
@@ -568,6 +573,12 @@ int main(int argc, char** argv) {
         compiler.addFlag("-std=c++0x");
     }
 
+	// sharded code is compiled in parallel, unchanged shards are reused
+	if(auto shardedCode = std::dynamic_pointer_cast<be::c_ast::ShardedCCode>(targetCode)) {
+		auto files = shardedCode->writeTo(options.settings.outFile.string() + ".shards");
+		return !cp::compileParallel(files, options.settings.outFile.string(), compiler);
+	}
+
 	return !cp::compileToBinary(*targetCode, options.settings.outFile.string(), compiler);
 }
 
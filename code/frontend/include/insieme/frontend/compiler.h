@@ -251,6 +251,13 @@ public:
      */
 	bool isCXX() const;
 
+	/**
+	 * Runs the preprocessor on the represented translation unit and writes the result
+	 * (including line markers) to the given stream. This consumes the input of the
+	 * preprocessor, thus the compiler instance can not be used for parsing afterwards.
+	 */
+	void printPreprocessedSource(std::ostream& out) const;
+
 	~ClangCompiler();
 };
 
@@ -151,6 +151,14 @@ namespace extensions {
          * */
         virtual boost::optional<std::string> isPrerequisiteMissing(ConversionSetup& setup) const;
 
+        /**
+         *  Prints the settings of this extension influencing the conversion result. It is
+         *  part of the key identifying cached translation units. Extensions having additional
+         *  settings need to extend the printed configuration.
+         *  @param out the stream to print the configuration to
+         */
+        virtual void printConfiguration(std::ostream& out) const;
+
         /*****************PRE CLANG STAGE*****************/
         /**
          *  Returns the list with user defined macros.
@@ -351,6 +359,15 @@ namespace extensions {
          */
 		virtual insieme::frontend::tu::IRTranslationUnit IRVisit(insieme::frontend::tu::IRTranslationUnit& tu);
 
+        /**
+         *  Will be called instead of the translation unit IRVisit for translation units restored
+         *  from the translation unit cache. Those have been processed by IRVisit within an earlier
+         *  conversion job, so ids which have to be unique within a job need to be re-assigned.
+         *  @param tu restored insieme translation unit
+         *  @return modified insieme translation unit. If tu is returned no modification is done
+         */
+		virtual insieme::frontend::tu::IRTranslationUnit CachedIRVisit(insieme::frontend::tu::IRTranslationUnit& tu);
+
 		/*****************PRAGMA HANDLING*****************/
         /**
          *  Used to retrieve the list of user defined pragma handlers.
@@ -36,7 +36,10 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "insieme/frontend/extensions/frontend_extension.h"
+#include "insieme/frontend/omp/omp_sema.h"
 
 using namespace insieme::frontend;
 
@@ -46,11 +49,14 @@ namespace extensions {
 
 class OmpFrontendExtension : public FrontendExtension {
     std::list<core::ExpressionPtr> thread_privates;
+    std::mutex thread_privates_lock;    // pragmas of files converted in parallel are handled concurrently
+    omp::SemaState semaState;           // keeps generated ids unique among the units of a conversion job
     bool flagActivated;
 public:
     OmpFrontendExtension();
     virtual flagHandler registerFlag(boost::program_options::options_description& options);
 	virtual insieme::frontend::tu::IRTranslationUnit IRVisit(insieme::frontend::tu::IRTranslationUnit& tu);
+	virtual insieme::frontend::tu::IRTranslationUnit CachedIRVisit(insieme::frontend::tu::IRTranslationUnit& tu);
 };
 
 }   //end namespace extensions
@@ -46,6 +46,7 @@
 #include "insieme/core/ir_program.h"
 
 #include "insieme/frontend/tu/ir_translation_unit.h"
+#include "insieme/frontend/tu/ir_translation_unit_cache.h"
 #include "insieme/frontend/extensions/frontend_extension.h"
 #include "insieme/frontend/extensions/frontend_cleanup_extension.h"
 
@@ -397,25 +398,43 @@ namespace frontend {
 
 		std::vector<std::pair<extensions::FrontendExtension::FrontendExtensionPtr, extensions::FrontendExtension::flagHandler>> extensions;
 		std::vector<string> unparsedOptions;
+
+		/**
+		 * The maximum number of files to be converted in parallel. Parallel conversion
+		 * is only performed if the target node manager supports concurrent access.
+		 */
+		unsigned numJobs;
+
+		/**
+		 * An optional cache for the translation units obtained from the individual input files.
+		 */
+		std::shared_ptr<tu::IRTranslationUnitCache> cache;
+
+		/**
+		 * Computes the key identifying the conversion of the given file within the cache. It
+		 * covers the preprocessed source, the conversion options and the active extensions.
+		 */
+		string getCacheKey(const path& file) const;
+
 	public:
 
 		/**
 		 * Creates an empty conversion job covering no files.
 		 */
-		ConversionJob() : ConversionSetup(vector<path>()) {}
+		ConversionJob() : ConversionSetup(vector<path>()), numJobs(1) {}
 
 		/**
 		 * Creates a new conversion job covering a single file.
 		 */
 		ConversionJob(const path& file, const vector<path>& includeDirs = vector<path>())
-			: ConversionSetup(includeDirs), files(toVector(file)) {
+			: ConversionSetup(includeDirs), files(toVector(file)), numJobs(1) {
 	        }
 
 		/**
 		 * Creates a new conversion job covering the given files.
 		 */
 		ConversionJob(const vector<path>& files, const vector<path>& includeDirs = vector<path>())
-			: ConversionSetup(includeDirs), files(files) {
+			: ConversionSetup(includeDirs), files(files), numJobs(1) {
 			assert_false(files.empty());
 
 	            // The user defined headers path is extended with c source files directories
@@ -447,6 +466,36 @@ namespace frontend {
 			this->files = files;
 		}
 
+		/**
+		 * Obtains the maximum number of files converted in parallel by this job.
+		 */
+		unsigned getNumJobs() const {
+			return numJobs;
+		}
+
+		/**
+		 * Updates the maximum number of files converted in parallel by this job. A value
+		 * of 0 or 1 results in a sequential conversion.
+		 */
+		void setNumJobs(unsigned numJobs) {
+			this->numJobs = numJobs;
+		}
+
+		/**
+		 * Obtains the translation unit cache utilized by this job, null if there is none.
+		 */
+		const std::shared_ptr<tu::IRTranslationUnitCache>& getCache() const {
+			return cache;
+		}
+
+		/**
+		 * Updates the translation unit cache to be utilized by this job. If set, files whose
+		 * conversion result is present within the cache are not converted again.
+		 */
+		void setCache(const std::shared_ptr<tu::IRTranslationUnitCache>& cache) {
+			this->cache = cache;
+		}
+
 		/**
 		 * Obtains a reference to the libs to be considered by this conversion job.
 		 */
@@ -507,6 +556,10 @@ namespace frontend {
 
 		/**
 		 * Triggers the conversion of the files covered by this job into a translation unit.
+		 * If more than one job is requested and the given manager supports concurrent access,
+		 * the files are converted in parallel, each within a private child manager of the given
+		 * manager. Cache accesses, extension post-processing and the migration of the resulting
+		 * units into the given manager are performed sequentially in the order of the files.
 		 *
 		 * @param manager the node manager to be used for building the IR
 		 * @return the resulting, converted program
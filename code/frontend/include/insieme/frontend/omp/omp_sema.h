@@ -50,14 +50,41 @@ namespace tu { class IRTranslationUnit; }
 
 namespace omp {
 
+/**
+ * The state of the OMP sema shared by all translation units of a conversion, keeping the
+ * identifiers generated for reductions and regions unique within the resulting program.
+ */
+struct SemaState {
+
+	// the id of the last generated reduction
+	unsigned reductionId;
+
+	// the id of the next region - 0 is reserved for the main work item
+	unsigned regionId;
+
+	SemaState() : reductionId(0), regionId(1) {}
+};
+
 /**
  * Applies OMP semantics to all the definitions within the given translation unit.
  *
  * @param unit the translation unit to be processed
  * @param mgr the node manager to be utilized for creating IR nodes
+ * @param state the state of the conversion the given unit is part of
+ * @return the modified translation unit
+ */
+tu::IRTranslationUnit applySema(const tu::IRTranslationUnit& unit, core::NodeManager& mgr, SemaState& state);
+
+/**
+ * Re-assigns the region ids and reduction locks generated by applySema within an earlier conversion,
+ * such that they are unique within the conversion the given state is belonging to.
+ *
+ * @param unit the translation unit to be processed, OMP semantics have already been applied to it
+ * @param mgr the node manager to be utilized for creating IR nodes
+ * @param state the state of the conversion the given unit is added to
  * @return the modified translation unit
  */
-tu::IRTranslationUnit applySema(const tu::IRTranslationUnit& unit, core::NodeManager& mgr);
+tu::IRTranslationUnit renumber(const tu::IRTranslationUnit& unit, core::NodeManager& mgr, SemaState& state);
 
 
 } // namespace omp
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <boost/utility.hpp>
+
+#include "insieme/frontend/tu/ir_translation_unit.h"
+
+namespace insieme {
+namespace frontend {
+namespace tu {
+
+	/**
+	 * A persistent, size-bounded cache for translation units. Entries are stored as binary
+	 * dumps (see ir_translation_unit_io.h) within a cache directory, one file per key. If the
+	 * total size of the stored entries exceeds the capacity of the cache, the least recently
+	 * used entries are evicted. The recency of an entry is tracked via the modification time
+	 * of its file, such that it is preserved across multiple runs.
+	 *
+	 * Instances may be shared among multiple threads.
+	 */
+	class IRTranslationUnitCache : public boost::noncopyable {
+
+	public:
+
+		/**
+		 * The default capacity of a cache in bytes.
+		 */
+		static const uintmax_t DEFAULT_CAPACITY;
+
+		/**
+		 * A summary of the operations performed on a cache instance.
+		 */
+		struct Statistics {
+			unsigned hits;
+			unsigned misses;
+			unsigned stores;
+			unsigned evictions;
+
+			friend std::ostream& operator<<(std::ostream& out, const Statistics& stats);
+		};
+
+	private:
+
+		/**
+		 * The meta-data maintained for each cache entry.
+		 */
+		struct Entry {
+			uintmax_t size;
+			std::time_t lastUse;	// < persistent, in seconds
+			uint64_t tick;			// < orders uses within the current run
+		};
+
+		/**
+		 * The directory hosting the cache entries.
+		 */
+		boost::filesystem::path directory;
+
+		/**
+		 * The maximum total size of all cached entries in bytes.
+		 */
+		uintmax_t capacity;
+
+		/**
+		 * The index of all entries currently stored within the cache directory.
+		 */
+		std::map<std::string, Entry> entries;
+
+		/**
+		 * The total size of all entries in bytes.
+		 */
+		uintmax_t size;
+
+		/**
+		 * A logical clock ordering the uses of entries within this instance.
+		 */
+		uint64_t clock;
+
+		/**
+		 * The statistics collected by this instance.
+		 */
+		Statistics stats;
+
+		/**
+		 * A lock synchronizing accesses to the index and the statistics.
+		 */
+		mutable std::mutex lock;
+
+	public:
+
+		/**
+		 * Creates a new cache instance operating on the given directory. The directory is created
+		 * if necessary and already present entries are re-used.
+		 *
+		 * @param directory the directory to store cache entries in
+		 * @param capacity the maximum number of bytes to be occupied by cache entries
+		 */
+		IRTranslationUnitCache(const boost::filesystem::path& directory, uintmax_t capacity = DEFAULT_CAPACITY);
+
+		/**
+		 * Computes a key for the given data. Keys are stable across different runs and platforms.
+		 */
+		static std::string computeKey(const std::string& data);
+
+		/**
+		 * Obtains the translation unit stored for the given key, if present. The resulting
+		 * unit is loaded into the given node manager.
+		 */
+		boost::optional<IRTranslationUnit> lookup(const std::string& key, core::NodeManager& manager);
+
+		/**
+		 * Stores the given translation unit for the given key and evicts the least recently
+		 * used entries if the capacity of the cache is exceeded.
+		 */
+		void store(const std::string& key, const IRTranslationUnit& unit);
+
+		/**
+		 * Removes all entries from this cache.
+		 */
+		void clear();
+
+		/**
+		 * Obtains the number of entries stored within this cache.
+		 */
+		std::size_t getNumEntries() const;
+
+		/**
+		 * Obtains the total size of all entries stored within this cache in bytes.
+		 */
+		uintmax_t getSize() const;
+
+		/**
+		 * Obtains the capacity of this cache in bytes.
+		 */
+		uintmax_t getCapacity() const {
+			return capacity;
+		}
+
+		/**
+		 * Obtains a snapshot of the statistics collected by this cache instance.
+		 */
+		Statistics getStatistics() const;
+
+	private:
+
+		boost::filesystem::path getFile(const std::string& key) const;
+
+		void evict();
+
+	};
+
+} // end namespace tu
+} // end namespace frontend
+} // end namespace insieme
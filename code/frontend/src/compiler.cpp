@@ -72,6 +72,7 @@
 //FIXME: debug
 #include <llvm/Support/raw_os_ostream.h>
 #include <clang/Frontend/Utils.h>
+#include <clang/Frontend/PreprocessorOutputOptions.h>
 #include <clang/Lex/HeaderSearch.h>
 #pragma GCC diagnostic pop
 
@@ -386,6 +387,15 @@ TargetInfo& 		ClangCompiler::getTargetInfo()    const { return pimpl->clang.getT
 ExtASTUnit*         ClangCompiler::getASTUnit()       const { return &(pimpl->ast_unit); }
 bool				ClangCompiler::isCXX()			  const { return pimpl->m_isCXX; }
 
+void ClangCompiler::printPreprocessedSource(std::ostream& out) const {
+	clang::PreprocessorOutputOptions opts;
+	opts.ShowCPP = 1;
+	opts.ShowLineMarkers = 1;
+	opts.ShowMacroComments = 0;
+	llvm::raw_os_ostream stream(out);
+	clang::DoPrintPreprocessedInput(getPreprocessor(), &stream, opts);
+}
+
 ClangCompiler::~ClangCompiler() {
     //Source file has to be ended only if no clang::ASTUnit was created. In the
     //case of an available clang::ASTUnit the destructor of clang::ASTUnit will
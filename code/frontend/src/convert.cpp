@@ -211,9 +211,9 @@ inline string  createPrefix(const std::string& name, unsigned pass, unsigned of)
 
 /**
  * some tool to print a progress bar, some day would be cool to have an infrastructure to do so
+ * the last printed position is kept by the caller, since conversions may run concurrently
  */
-inline void printProgress (const std::string& prefix, unsigned cur, unsigned max) {
-	static unsigned lastPos = 0;
+inline void printProgress (unsigned& lastPos, const std::string& prefix, unsigned cur, unsigned max) {
 	unsigned a = ((float)cur/ (float)max) * 60.0f;
 	if (a > lastPos) {
 		lastPos = a;
@@ -284,13 +284,17 @@ tu::IRTranslationUnit Converter::convert() {
 	// collect all type definitions
 	auto declContext = clang::TranslationUnitDecl::castToDeclContext(getCompiler().getASTContext().getTranslationUnitDecl());
 
+	// the position of the progress bar
+	unsigned progress = 0;
+
 	unsigned count = countTypes(declContext);
 	struct TypeVisitor : public analysis::PrunableDeclVisitor<TypeVisitor> {
 
 		Converter& converter;
 		unsigned count;
 		unsigned processed;
-		TypeVisitor(Converter& converter, unsigned count) : converter(converter), count(count), processed(0) {}
+		unsigned& progress;
+		TypeVisitor(Converter& converter, unsigned count, unsigned& progress) : converter(converter), count(count), processed(0), progress(progress) {}
 
         Converter& getConverter() {
             return converter;
@@ -308,7 +312,7 @@ tu::IRTranslationUnit Converter::convert() {
 
 			if (converter.getConversionSetup().hasOption(ConversionSetup::ProgressBar)) {
 				auto str = createPrefix( converter.getTranslationUnit().getJustFileName(),1,3);
-				printProgress (str, ++processed, count);
+				printProgress (progress, str, ++processed, count);
 			}
 		}
 		// typedefs and typealias
@@ -322,10 +326,10 @@ tu::IRTranslationUnit Converter::convert() {
 
 			if (converter.getConversionSetup().hasOption(ConversionSetup::ProgressBar)) {
 				auto str = createPrefix( converter.getTranslationUnit().getJustFileName(),1,3);
-				printProgress (str, ++processed, count);
+				printProgress (progress, str, ++processed, count);
 			}
 		}
-	} typeVisitor(*this, count);
+	} typeVisitor(*this, count, progress);
 	typeVisitor.traverseDeclCtx (declContext);
 
 	// collect all global declarations
@@ -335,7 +339,8 @@ tu::IRTranslationUnit Converter::convert() {
 		Converter& converter;
 		unsigned count;
 		unsigned processed;
-		GlobalVisitor(Converter& converter, unsigned count) : converter(converter), count (count), processed(0) {}
+		unsigned& progress;
+		GlobalVisitor(Converter& converter, unsigned count, unsigned& progress) : converter(converter), count (count), processed(0), progress(progress) {}
 
         Converter& getConverter() {
             return converter;
@@ -353,10 +358,10 @@ tu::IRTranslationUnit Converter::convert() {
 
 			if (converter.getConversionSetup().hasOption(ConversionSetup::ProgressBar)) {
 				auto str = createPrefix( converter.getTranslationUnit().getJustFileName(),2,3);
-				printProgress (str, ++processed, count);
+				printProgress (progress, str, ++processed, count);
 			}
 		}
-	} varVisitor(*this, count);
+	} varVisitor(*this, count, progress);
 	varVisitor.traverseDeclCtx(declContext);
 
 	// collect all global declarations
@@ -368,8 +373,9 @@ tu::IRTranslationUnit Converter::convert() {
 		bool externC;
 		unsigned count;
 		unsigned& processed;
-		FunctionVisitor(Converter& converter, bool Ccode, unsigned count, unsigned& processed)
-		: converter(converter), externC(Ccode), count(count), processed(processed)
+		unsigned& progress;
+		FunctionVisitor(Converter& converter, bool Ccode, unsigned count, unsigned& processed, unsigned& progress)
+		: converter(converter), externC(Ccode), count(count), processed(processed), progress(progress)
 		{}
 
         Converter& getConverter() {
@@ -378,7 +384,7 @@ tu::IRTranslationUnit Converter::convert() {
 
 		void VisitLinkageSpec(const clang::LinkageSpecDecl* link) {
 			bool isC =  link->getLanguage () == clang::LinkageSpecDecl::lang_c;
-			FunctionVisitor vis(converter, isC, count,processed);
+			FunctionVisitor vis(converter, isC, count,processed,progress);
 			vis.traverseDeclCtx(llvm::cast<clang::DeclContext> (link));
 		}
 
@@ -392,10 +398,10 @@ tu::IRTranslationUnit Converter::convert() {
 			if (externC) annotations::c::markAsExternC(irFunc.as<core::LiteralPtr>());
 			if (converter.getConversionSetup().hasOption(ConversionSetup::ProgressBar)) {
 				auto str = createPrefix( converter.getTranslationUnit().getJustFileName(),3,3);
-				printProgress (str, processed, count);
+				printProgress (progress, str, processed, count);
 			}
 		}
-	} funVisitor(*this, false, count,processed);
+	} funVisitor(*this, false, count,processed,progress);
 	funVisitor.traverseDeclCtx(declContext);
 
 	//frontend done
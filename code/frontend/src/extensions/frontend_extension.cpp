@@ -35,11 +35,16 @@
  */
 
 #include "insieme/frontend/extensions/frontend_extension.h"
+
+#include <typeinfo>
+
 #include "insieme/frontend/clang.h"
 #include "insieme/frontend/stmt_converter.h"
 #include "insieme/frontend/pragma/matcher.h"
 #include "insieme/frontend/pragma/handler.h"
 
+#include "insieme/utils/string_utils.h"
+
 namespace insieme {
 namespace frontend {
 namespace extensions {
@@ -80,6 +85,14 @@ namespace extensions {
 		return boost::optional<std::string>();
 	}
 
+	void FrontendExtension::printConfiguration(std::ostream& out) const {
+		out << typeid(*this).name();
+		out << " macros: " << join(",", macros, [](std::ostream& out, const std::pair<std::string,std::string>& cur) { out << cur.first << "=" << cur.second; });
+		out << " injected headers: " << join(",", injectedHeaders);
+		out << " kidnapped headers: " << join(",", kidnappedHeaders);
+		out << " include dirs: " << join(",", includeDirs);
+	}
+
     // ############ PRE CLANG STAGE ############ //
     const FrontendExtension::macroMap& FrontendExtension::getMacroList() const {
         return macros;
@@ -185,6 +198,10 @@ namespace extensions {
         return tu;
     }
 
+    insieme::frontend::tu::IRTranslationUnit FrontendExtension::CachedIRVisit(insieme::frontend::tu::IRTranslationUnit& tu) {
+        return tu;
+    }
+
     // ############ PRAGMA HANDLING ############ //
     const FrontendExtension::pragmaHandlerVec& FrontendExtension::getPragmaHandlers() const {
         return pragmaHandlers;
@@ -1072,6 +1072,7 @@ namespace {
                         [&](const MatchObject& object, core::NodeList nodes) {
                             //store the name of the variables
                             omp::VarListPtr tp = handleIdentifierList(object, "thread_private");
+                            std::lock_guard<std::mutex> guard(thread_privates_lock);
                             for(unsigned i=0; i<tp->size(); i++) {
                                     thread_privates.push_back(tp->at(i));
                             }
@@ -1129,11 +1130,16 @@ namespace {
         }
 
         // apply open mp sema
-        tu = omp::applySema(tu, tu.getNodeManager());
+        tu = omp::applySema(tu, tu.getNodeManager(), semaState);
 
         return tu;
 	}
 
+	insieme::frontend::tu::IRTranslationUnit OmpFrontendExtension::CachedIRVisit(insieme::frontend::tu::IRTranslationUnit& tu) {
+		// the unit has been processed by IRVisit within an earlier job, only the generated ids need to be updated
+		return omp::renumber(tu, tu.getNodeManager(), semaState);
+	}
+
     FrontendExtension::flagHandler OmpFrontendExtension::registerFlag(boost::program_options::options_description& options) {
         //register omp flag
         options.add_options()("fopenmp", boost::program_options::value<bool>(&flagActivated)->implicit_value(true), "OpenMP support");
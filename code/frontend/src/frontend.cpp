@@ -35,10 +35,15 @@
  */
 
 #include <sstream>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
 
 #include "insieme/frontend/frontend.h"
 
 #include "insieme/frontend/convert.h"
+#include "insieme/frontend/compiler.h"
 #include "insieme/utils/config.h"
 #include "insieme/frontend/omp/omp_annotation.h"
 
@@ -46,6 +51,7 @@
 
 #include "insieme/utils/container_utils.h"
 #include "insieme/utils/compiler/compiler.h"
+#include "insieme/utils/logging.h"
 
 #include "insieme/core/transform/manipulation_utils.h"
 #include "insieme/core/annotations/naming.h"
@@ -133,14 +139,78 @@ namespace frontend {
     }
 
 
+	namespace {
+
+		/**
+		 * Runs the given operation for every index within [0,n) using up to the given number of
+		 * threads. Exceptions raised by the operation are forwarded to the caller; if multiple
+		 * operations fail, the exception of the lowest index is re-thrown.
+		 */
+		template<typename Op>
+		void parallelFor(std::size_t n, unsigned numThreads, const Op& op) {
+			vector<std::exception_ptr> errors(n);
+			std::atomic<std::size_t> next(0);
+
+			auto worker = [&]() {
+				for(std::size_t i = next++; i < n; i = next++) {
+					try {
+						op(i);
+					} catch(...) {
+						errors[i] = std::current_exception();
+					}
+				}
+			};
+
+			// the calling thread is participating as well
+			vector<std::thread> threads;
+			for(unsigned i = 1; i < std::min<std::size_t>(numThreads, n); ++i) {
+				threads.push_back(std::thread(worker));
+			}
+			worker();
+			for(auto& cur : threads) cur.join();
+
+			// forward the first error
+			for(const auto& cur : errors) {
+				if(cur) std::rethrow_exception(cur);
+			}
+		}
+
+	}
+
+	string ConversionJob::getCacheKey(const path& file) const {
+		std::stringstream data;
+
+		// the preprocessed source - the path is covered by the line markers
+		ClangCompiler compiler(*this, file);
+		compiler.printPreprocessedSource(data);
+
+		// the conversion options
+		data << "\nstandard: " << getStandard();
+		data << "\nflags: " << hasOption(WinCrossCompile) << hasOption(TAG_MPI);
+		data << "\ndefinitions: " << getDefinitions();
+		data << "\ninclude dirs: " << getIncludeDirectories();
+		data << "\nsystem header dirs: " << getSystemHeadersDirectories();
+		data << "\ninterceptions: " << getInterceptedNameSpacePatterns();
+		data << "\nintercepted header dirs: " << getInterceptedHeaderDirs();
+		data << "\ncross compilation dir: " << getCrossCompilationSystemHeadersDir();
+		data << "\nf flags: " << getFFlags();
+		data << "\nunparsed options: " << unparsedOptions;
+
+		// the active extensions and their settings
+		data << "\nextensions: " << join(",", getExtensions(), [](std::ostream& out, const extensions::FrontendExtension::FrontendExtensionPtr& cur) {
+			cur->printConfiguration(out);
+		});
+
+		return tu::IRTranslationUnitCache::computeKey(data.str());
+	}
+
 	tu::IRTranslationUnit ConversionJob::toIRTranslationUnit(core::NodeManager& manager) {
 
 		// extension initialization
 		frontendExtensionInit();
 
-		// convert files to translation units
-		auto units = ::transform(files, [&](const path& file)->tu::IRTranslationUnit {
-			auto res = convert(manager, file, *this);
+		// post-process a freshly converted translation unit
+		auto visitUnit = [&](tu::IRTranslationUnit res)->tu::IRTranslationUnit {
 
             // maybe a visitor wants to manipulate the IR program
             for(auto extension : getExtensions())
@@ -148,10 +218,92 @@ namespace frontend {
 
 			// done
 			return res;
+		};
+
+		// re-establish the job-wide unique ids within a translation unit restored from the cache
+		auto visitCachedUnit = [&](tu::IRTranslationUnit res)->tu::IRTranslationUnit {
+			for(auto extension : getExtensions())
+				res = extension->CachedIRVisit(res);
+			return res;
+		};
+
+		// parallel conversion requires a manager supporting concurrent access
+		unsigned jobs = std::min<std::size_t>(std::max(numJobs, 1u), files.size());
+		if(jobs > 1 && !manager.isConcurrent()) {
+			LOG(WARNING) << "Node manager does not support concurrent access - converting " << files.size() << " files sequentially.";
+			jobs = 1;
+		}
+
+		// sequential case
+		if(jobs <= 1) {
+
+			// convert files to translation units
+			auto units = ::transform(files, [&](const path& file)->tu::IRTranslationUnit {
+
+				// check whether the conversion result is already cached
+				string key;
+				if(cache) {
+					key = getCacheKey(file);
+					if(auto res = cache->lookup(key, manager)) {
+						VLOG(1) << "Loaded translation unit of " << file << " from cache";
+						return visitCachedUnit(*res);
+					}
+				}
+
+				auto res = visitUnit(convert(manager, file, *this));
+
+				// store the result for later conversions
+				if(cache) cache->store(key, res);
+
+				// done
+				return res;
+			});
+
+			// merge the translation units
+			auto singleTu = tu::merge(manager, tu::merge(manager, libs), tu::merge(manager, units));
+			if(cache) LOG(INFO) << "Translation unit cache: " << cache->getStatistics();
+
+			// forward the C++ flag
+			singleTu.setCXX(this->isCxx());
+			return singleTu;
+		}
+
+		// look up cached results - the cache and the target manager are only accessed by this thread
+		vector<string> keys(files.size());
+		vector<boost::optional<tu::IRTranslationUnit>> cached(files.size());
+		if(cache) {
+			parallelFor(files.size(), jobs, [&](std::size_t i) {
+				keys[i] = getCacheKey(files[i]);
+			});
+			for(std::size_t i = 0; i < files.size(); ++i) {
+				cached[i] = cache->lookup(keys[i], manager);
+				if(cached[i]) VLOG(1) << "Loaded translation unit of " << files[i] << " from cache";
+			}
+		}
+
+		// convert the remaining files in parallel - each within a private child manager of the target manager
+		// (the managers are declared first such that they outlive the units referencing them)
+		vector<std::unique_ptr<core::NodeManager>> managers(files.size());
+		vector<tu::IRTranslationUnit> units(files.size(), tu::IRTranslationUnit(manager));
+		parallelFor(files.size(), jobs, [&](std::size_t i) {
+			if(cached[i]) return;
+			managers[i].reset(new core::NodeManager(manager));
+			units[i] = convert(*managers[i], files[i], *this);
 		});
 
-		// merge the translation units
+		// post-process and store the results in the order of the files, like the sequential conversion
+		for(std::size_t i = 0; i < files.size(); ++i) {
+			if(cached[i]) {
+				units[i] = visitCachedUnit(*cached[i]);
+				continue;
+			}
+			units[i] = visitUnit(units[i]);
+			if(cache) cache->store(keys[i], units[i]);
+		}
+
+		// migrate the translation units to the target manager and merge them in the order of the files
 		auto singleTu = tu::merge(manager, tu::merge(manager, libs), tu::merge(manager, units));
+		if(cache) LOG(INFO) << "Translation unit cache: " << cache->getStatistics();
 
 		// forward the C++ flag
 		singleTu.setCXX(this->isCxx());
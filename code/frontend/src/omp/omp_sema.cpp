@@ -110,13 +110,16 @@ class OMPSemaMapper : public insieme::core::transform::CachedNodeMapping {
     // To generate per-objective-clause param id (OMP+)
     unsigned int paramCounter;
 
+	// the ids of reductions and regions shared with the other units of the conversion
+	SemaState& state;
+
 public:
-	OMPSemaMapper(NodeManager& nodeMan)
+	OMPSemaMapper(NodeManager& nodeMan, SemaState& state)
 			: nodeMan(nodeMan), build(nodeMan), basic(nodeMan.getLangBasic()), toFlatten(),
 			  fixStructType(false), adjustStruct(), adjustedStruct(), thisLambdaTPAccesses(),
 			  orderedCountLit(build.literal("ordered_counter", build.volatileType(build.refType(basic.getInt8())))),
 			  orderedItLit(build.literal("ordered_loop_it", basic.getInt8())),
-			  orderedIncLit(build.literal("ordered_loop_inc", basic.getInt8())), paramCounter(0) {
+			  orderedIncLit(build.literal("ordered_loop_inc", basic.getInt8())), paramCounter(0), state(state) {
 	}
 
 	StructTypePtr getAdjustStruct() { return adjustStruct; }
@@ -513,7 +516,6 @@ protected:
 
 	// implements reduction steps after parallel / for clause
 	CompoundStmtPtr implementReductions(const DatasharingClause* clause, NodeMap& publicToPrivateMap) {
-		static unsigned redId = 0;
 		StatementList replacements;
 		for_each(clause->getReduction().getVars(), [&](const ExpressionPtr& varExp) {
 			StatementPtr operation;
@@ -549,7 +551,7 @@ protected:
 			}
 			replacements.push_back(operation);
 		});
-		return makeCritical(build.compoundStmt(replacements), string("reduce_") + toString(++redId));
+		return makeCritical(build.compoundStmt(replacements), string("reduce_") + toString(++state.reductionId));
 	}
 
 	// returns the correct initial reduction value for the given operator and type
@@ -866,8 +868,7 @@ protected:
         paramCounter = 0;
 
         // regionId 0 is reserved for main work item
-        static unsigned regionId = 1;
-        objective.region_id = regionId ++;
+        objective.region_id = state.regionId++;
 
         node->attachValue(objective);
 
@@ -1196,9 +1197,9 @@ namespace {
 }
 
 
-tu::IRTranslationUnit applySema(const tu::IRTranslationUnit& unit, core::NodeManager& mgr) {
+tu::IRTranslationUnit applySema(const tu::IRTranslationUnit& unit, core::NodeManager& mgr, SemaState& state) {
 	// everything has to run through the OMP sema mapper
-	OMPSemaMapper semaMapper(mgr);
+	OMPSemaMapper semaMapper(mgr, state);
 
 	// resulting tu
 	tu::IRTranslationUnit res(mgr);
@@ -1248,6 +1249,67 @@ tu::IRTranslationUnit applySema(const tu::IRTranslationUnit& unit, core::NodeMan
 	return res;
 }
 
+tu::IRTranslationUnit renumber(const tu::IRTranslationUnit& unit, core::NodeManager& mgr, SemaState& state) {
+	typedef insieme::annotations::ompp_objective_info objective_info;
+	static const string reductionLock = "global_omp_critical_lock_reduce_";
+
+	// collect regions and reduction locks, fresh ids are assigned in the order of their occurrence
+	IRBuilder builder(mgr);
+	vector<NodePtr> regionNodes;
+	std::map<unsigned, unsigned> regionIds;
+	NodeMap locks;
+	auto collect = [&](const NodePtr& root) {
+		if (!root) return;
+		visitDepthFirstOnce(root, [&](const NodePtr& cur) {
+			if (cur->hasAttachedValue<objective_info>() && !contains(regionNodes, cur)) {
+				regionNodes.push_back(cur);
+				unsigned id = cur->getAttachedValue<objective_info>().region_id;
+				if (regionIds.find(id) == regionIds.end()) regionIds[id] = state.regionId++;
+			}
+			if (LiteralPtr lit = cur.isa<LiteralPtr>()) {
+				if (lit->getStringValue().find(reductionLock) == 0 && locks.find(lit) == locks.end()) {
+					locks[lit] = builder.literal(lit->getType(), reductionLock + toString(++state.reductionId));
+				}
+			}
+		});
+	};
+	unit.visitAll(collect);
+
+	// update the region ids - like applySema, the objectives are attached to the nodes directly
+	for(const auto& cur : regionNodes) {
+		objective_info objective = cur->getAttachedValue<objective_info>();
+		objective.region_id = regionIds[objective.region_id];
+		cur->attachValue(objective);
+	}
+
+	if (locks.empty()) return unit;
+
+	// rename the reduction locks - the objectives are migrated along with the modified nodes
+	auto rename = [&](const NodePtr& node) { return transform::replaceAll(mgr, node, locks, false); };
+
+	tu::IRTranslationUnit res(mgr);
+	for(auto& cur : unit.getTypes()) {
+		res.addType(cur.first, rename(cur.second).as<TypePtr>());
+	}
+	for(auto& cur : unit.getMetaInfos()) {
+		res.addMetaInfo(cur.first, cur.second);
+	}
+	for(auto& cur : unit.getFunctions()) {
+		res.addFunction(cur.first, rename(cur.second).as<LambdaExprPtr>());
+	}
+	for(auto& cur : unit.getGlobals()) {
+		res.addGlobal(rename(cur.first).as<LiteralPtr>(), (cur.second) ? rename(cur.second).as<ExpressionPtr>() : cur.second);
+	}
+	for(auto& cur : unit.getInitializer()) {
+		res.addInitializer(rename(cur).as<ExpressionPtr>());
+	}
+	for(auto& cur : unit.getEntryPoints()) {
+		res.addEntryPoints(cur);
+	}
+	res.setCXX(unit.isCXX());
+	return res;
+}
+
 
 
 } // namespace omp
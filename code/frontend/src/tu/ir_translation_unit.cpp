@@ -78,7 +78,7 @@ namespace tu {
 		} else {
 			//global is already in globalsList, if the "new one" has a initValue update the init
 			if(newGlobal.second) {
-				git->second = newGlobal.second;
+				git->second = mgr->get(newGlobal.second);
 			}
 		}
 	}
@@ -736,15 +736,45 @@ namespace tu {
 		return resolved;
 	}
 
+	namespace {
+
+		/**
+		 * Obtains a copy of the given meta info referencing instances managed by the given manager.
+		 */
+		core::ClassMetaInfo migrateMetaInfo(core::NodeManager& mgr, const core::ClassMetaInfo& metaInfo) {
+			core::ClassMetaInfo res = metaInfo;
+
+			// migrate constructors
+			res.setConstructors(::transform(metaInfo.getConstructors(), [&](const core::ExpressionPtr& cur) { return mgr.get(cur); }));
+
+			// migrate destructor
+			if (metaInfo.getDestructor()) res.setDestructor(mgr.get(metaInfo.getDestructor()));
+
+			// migrate member functions
+			auto memberFunctions = metaInfo.getMemberFunctions();
+			for(auto& cur : memberFunctions) { cur.setImplementation(mgr.get(cur.getImplementation())); }
+			res.setMemberFunctions(memberFunctions);
+
+			return res;
+		}
+
+	}
+
 	void IRTranslationUnit::addMetaInfo(const core::TypePtr& classType, const core::ClassMetaInfo& metaInfo) {
 		//TODO: optimization/simplification: store the metainfos already merged?
-		metaInfos[classType].push_back(metaInfo);
+		if (&classType->getNodeManager() == mgr) {
+			metaInfos[classType].push_back(metaInfo);
+			return;
+		}
+
+		// meta infos of other units (e.g. when merging) need to be migrated to this manager
+		metaInfos[mgr->get(classType)].push_back(migrateMetaInfo(*mgr, metaInfo));
 	}
 
 	void IRTranslationUnit::addMetaInfo(const core::TypePtr& classType, const std::vector<core::ClassMetaInfo>& metaInfoList) {
 		//TODO:  optimization/simplification: store the metainfos already merged?
 		for(auto m : metaInfoList) {
-			metaInfos[classType].push_back(m);
+			addMetaInfo(classType, m);
 		}
 	}
 
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#include "insieme/frontend/tu/ir_translation_unit_cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "insieme/frontend/tu/ir_translation_unit_io.h"
+
+#include "insieme/utils/logging.h"
+
+namespace insieme {
+namespace frontend {
+namespace tu {
+
+	namespace fs = boost::filesystem;
+
+	namespace {
+
+		const char* FILE_EXTENSION = ".tu";
+
+		/**
+		 * A 64-bit FNV-1a hash - in contrast to std::hash its value is defined by the algorithm.
+		 */
+		uint64_t fnv1a(const std::string& data, uint64_t hash) {
+			for(unsigned char c : data) {
+				hash ^= c;
+				hash *= 0x100000001b3ull;
+			}
+			return hash;
+		}
+
+	}
+
+	const uintmax_t IRTranslationUnitCache::DEFAULT_CAPACITY = uintmax_t(1) << 30;
+
+	std::ostream& operator<<(std::ostream& out, const IRTranslationUnitCache::Statistics& stats) {
+		return out << "hits: " << stats.hits << ", misses: " << stats.misses << ", stores: " << stats.stores << ", evictions: " << stats.evictions;
+	}
+
+	IRTranslationUnitCache::IRTranslationUnitCache(const fs::path& directory, uintmax_t capacity)
+		: directory(directory), capacity(capacity), size(0), clock(0), stats({0,0,0,0}) {
+
+		// create cache directory if necessary
+		fs::create_directories(directory);
+
+		// index already present entries
+		for(auto it = fs::directory_iterator(directory); it != fs::directory_iterator(); ++it) {
+			const fs::path& file = it->path();
+			if(!fs::is_regular_file(file) || file.extension() != FILE_EXTENSION) continue;
+			Entry entry { fs::file_size(file), fs::last_write_time(file), 0 };
+			entries[file.stem().string()] = entry;
+			size += entry.size;
+		}
+
+		// a previous run may have used a larger capacity
+		std::lock_guard<std::mutex> guard(lock);
+		evict();
+	}
+
+	std::string IRTranslationUnitCache::computeKey(const std::string& data) {
+		// two independently seeded hashes are combined to a 128-bit key
+		std::stringstream res;
+		res << std::hex << std::setfill('0');
+		res << std::setw(16) << fnv1a(data, 0xcbf29ce484222325ull);
+		res << std::setw(16) << fnv1a(data, 0x84222325cbf29ce4ull);
+		return res.str();
+	}
+
+	fs::path IRTranslationUnitCache::getFile(const std::string& key) const {
+		return directory / (key + FILE_EXTENSION);
+	}
+
+	boost::optional<IRTranslationUnit> IRTranslationUnitCache::lookup(const std::string& key, core::NodeManager& manager) {
+		fs::path file = getFile(key);
+
+		// check the index
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto pos = entries.find(key);
+			if(pos == entries.end() || !fs::exists(file)) {
+				stats.misses++;
+				return boost::optional<IRTranslationUnit>();
+			}
+
+			// mark entry as being the most recently used one
+			pos->second.lastUse = std::time(nullptr);
+			pos->second.tick = ++clock;
+			fs::last_write_time(file, pos->second.lastUse);
+		}
+
+		// load the unit outside the critical section
+		try {
+			std::ifstream in(file.string(), std::ios::in | std::ios::binary);
+			auto res = load(in, manager);
+			std::lock_guard<std::mutex> guard(lock);
+			stats.hits++;
+			return res;
+		} catch(const std::exception& e) {
+			LOG(WARNING) << "Unable to load cached translation unit " << file << ": " << e.what();
+		}
+
+		// drop the corrupted entry
+		std::lock_guard<std::mutex> guard(lock);
+		auto pos = entries.find(key);
+		if(pos != entries.end()) {
+			size -= pos->second.size;
+			entries.erase(pos);
+		}
+		boost::system::error_code ec;
+		fs::remove(file, ec);
+		stats.misses++;
+		return boost::optional<IRTranslationUnit>();
+	}
+
+	void IRTranslationUnitCache::store(const std::string& key, const IRTranslationUnit& unit) {
+		fs::path file = getFile(key);
+
+		// write the entry to a temporary file first such that concurrent readers never observe partial entries
+		fs::path tmp = directory / fs::unique_path("%%%%-%%%%-%%%%-%%%%.tmp");
+		{
+			std::ofstream out(tmp.string(), std::ios::out | std::ios::binary);
+			dump(out, unit);
+			if(!out) {
+				LOG(WARNING) << "Unable to write cached translation unit " << file;
+				boost::system::error_code ec;
+				fs::remove(tmp, ec);
+				return;
+			}
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		fs::rename(tmp, file);
+
+		// update the index
+		Entry entry { fs::file_size(file), std::time(nullptr), ++clock };
+		auto pos = entries.find(key);
+		if(pos != entries.end()) size -= pos->second.size;
+		entries[key] = entry;
+		size += entry.size;
+		stats.stores++;
+
+		// enforce the capacity limit
+		evict();
+	}
+
+	void IRTranslationUnitCache::evict() {
+		if(size <= capacity) return;
+
+		// order the entries by their last use
+		std::vector<std::tuple<std::time_t, uint64_t, std::string>> order;
+		for(const auto& cur : entries) {
+			order.push_back(std::make_tuple(cur.second.lastUse, cur.second.tick, cur.first));
+		}
+		std::sort(order.begin(), order.end());
+
+		// remove least recently used entries until the cache fits
+		for(const auto& cur : order) {
+			if(size <= capacity) break;
+			const std::string& key = std::get<2>(cur);
+			boost::system::error_code ec;
+			fs::remove(getFile(key), ec);
+			size -= entries[key].size;
+			entries.erase(key);
+			stats.evictions++;
+		}
+	}
+
+	void IRTranslationUnitCache::clear() {
+		std::lock_guard<std::mutex> guard(lock);
+		for(const auto& cur : entries) {
+			boost::system::error_code ec;
+			fs::remove(getFile(cur.first), ec);
+		}
+		entries.clear();
+		size = 0;
+	}
+
+	std::size_t IRTranslationUnitCache::getNumEntries() const {
+		std::lock_guard<std::mutex> guard(lock);
+		return entries.size();
+	}
+
+	uintmax_t IRTranslationUnitCache::getSize() const {
+		std::lock_guard<std::mutex> guard(lock);
+		return size;
+	}
+
+	IRTranslationUnitCache::Statistics IRTranslationUnitCache::getStatistics() const {
+		std::lock_guard<std::mutex> guard(lock);
+		return stats;
+	}
+
+} // end namespace tu
+} // end namespace frontend
+} // end namespace insieme
@@ -43,6 +43,8 @@
 #include "insieme/core/checks/full_check.h"
 #include "insieme/core/printer/pretty_printer.h"
 
+#include "insieme/driver/cmd/insiemecc_options.h"
+
 #include "test_utils.inc"
 
 namespace insieme {
@@ -224,6 +226,145 @@ namespace frontend {
 		EXPECT_TRUE(core::checks::check(program).empty()) << core::checks::check(program);
 	}
 
+	TEST(Converter, ParallelConversion) {
+
+		// create a few temporary source files referencing each other
+		Source even(
+				R"(
+					int odd(unsigned x);
+					int even(unsigned x) {
+						return (x==0)?1:odd(x-1);
+					}
+				)"
+		);
+
+		Source odd(
+				R"(
+					int even(unsigned x);
+					int odd(unsigned x) {
+						return (x==0)?0:even(x-1);
+					}
+				)"
+		);
+
+		Source main(
+				R"(
+					int even(unsigned x);
+					int odd(unsigned x);
+					int main(int argc, char* argv[]) {
+						return even(10) + odd(10);
+					}
+				)"
+		);
+
+		vector<path> files = toVector<path>(even, odd, main);
+
+		// convert the files sequentially
+		core::NodeManager seqMgr;
+		ConversionJob seqJob(files);
+		auto seqUnit = seqJob.toIRTranslationUnit(seqMgr);
+
+		// convert the files in parallel
+		core::NodeManager parMgr(core::NodeManager::CONCURRENT_ACCESS);
+		ConversionJob parJob(files);
+		parJob.setNumJobs(3);
+		auto parUnit = parJob.toIRTranslationUnit(parMgr);
+
+		// the results should be the same
+		EXPECT_EQ(seqUnit.getFunctions().size(), parUnit.getFunctions().size());
+		EXPECT_EQ(seqUnit.getEntryPoints().size(), parUnit.getEntryPoints().size());
+
+		auto seqProgram = tu::toProgram(seqMgr, seqUnit);
+		auto parProgram = tu::toProgram(parMgr, parUnit);
+		EXPECT_EQ(toString(core::printer::PrettyPrinter(seqProgram)), toString(core::printer::PrettyPrinter(parProgram)));
+		EXPECT_TRUE(core::checks::check(parProgram).empty()) << core::checks::check(parProgram);
+
+		// without a concurrent manager the conversion falls back to the sequential mode
+		core::NodeManager mgr;
+		auto unit = parJob.toIRTranslationUnit(mgr);
+		EXPECT_EQ(toString(core::printer::PrettyPrinter(seqProgram)), toString(core::printer::PrettyPrinter(tu::toProgram(mgr, unit))));
+
+		// with a cache, the second parallel conversion loads all units from the cache
+		auto cacheDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("insieme_tu_cache_%%%%-%%%%");
+		auto cache = std::make_shared<tu::IRTranslationUnitCache>(cacheDir);
+		parJob.setCache(cache);
+		for(int i=0; i<2; i++) {
+			core::NodeManager cacheMgr(core::NodeManager::CONCURRENT_ACCESS);
+			auto cachedUnit = parJob.toIRTranslationUnit(cacheMgr);
+			EXPECT_EQ(toString(core::printer::PrettyPrinter(seqProgram)), toString(core::printer::PrettyPrinter(tu::toProgram(cacheMgr, cachedUnit))));
+		}
+		EXPECT_EQ(3u, cache->getStatistics().misses);
+		EXPECT_EQ(3u, cache->getStatistics().stores);
+		EXPECT_EQ(3u, cache->getStatistics().hits);
+		boost::filesystem::remove_all(cacheDir);
+	}
+
+	TEST(Converter, CachedOmpConversion) {
+
+		// two files containing a reduction each - both require a reduction lock
+		string code =
+				R"(
+					int sum(int* a, int n) {
+						int s = 0;
+						#pragma omp parallel for reduction(+:s)
+						for(int i=0; i<n; i++) {
+							s += a[i];
+						}
+						return s;
+					}
+				)";
+
+		Source first(code);
+		Source second(code);
+
+		auto cacheDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("insieme_tu_cache_%%%%-%%%%");
+		auto cache = std::make_shared<tu::IRTranslationUnitCache>(cacheDir);
+
+		auto getLocks = [](const tu::IRTranslationUnit& unit) {
+			std::set<string> locks;
+			for(const auto& cur : unit.getGlobals()) {
+				string name = cur.first->getStringValue();
+				if(name.find("global_omp_critical_lock_reduce_") == 0) locks.insert(name);
+			}
+			return locks;
+		};
+
+		// the first job converts the first file and stores it in the cache
+		{
+			core::NodeManager mgr;
+			std::vector<std::string> args = { "compiler", first.getPath().string(), "-fopenmp" };
+			auto options = driver::cmd::Options::parse(args);
+			options.job.setCache(cache);
+			EXPECT_EQ(1u, getLocks(options.job.toIRTranslationUnit(mgr)).size());
+		}
+
+		// the second job converts the second file and loads the first one from the cache
+		{
+			core::NodeManager mgr;
+			std::vector<std::string> args = { "compiler", second.getPath().string(), first.getPath().string(), "-fopenmp" };
+			auto options = driver::cmd::Options::parse(args);
+			options.job.setCache(cache);
+			auto unit = options.job.toIRTranslationUnit(mgr);
+			EXPECT_EQ(1u, cache->getStatistics().hits);
+
+			// the ids of the cached unit must not collide with the ids of the converted one
+			EXPECT_EQ(2u, getLocks(unit).size());
+			EXPECT_TRUE(core::checks::check(tu::toProgram(mgr, unit)).empty());
+		}
+
+		// without OpenMP support the cached unit must not be reused
+		{
+			core::NodeManager mgr;
+			std::vector<std::string> args = { "compiler", first.getPath().string() };
+			auto options = driver::cmd::Options::parse(args);
+			options.job.setCache(cache);
+			options.job.toIRTranslationUnit(mgr);
+			EXPECT_EQ(1u, cache->getStatistics().hits);
+		}
+
+		boost::filesystem::remove_all(cacheDir);
+	}
+
 	TEST(Converter, MutualRecursiveClasses) {
 
 		// create a temporary source file
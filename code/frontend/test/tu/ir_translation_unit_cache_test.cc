@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include "insieme/frontend/tu/ir_translation_unit_cache.h"
+
+#include "insieme/core/ir_builder.h"
+
+namespace insieme {
+namespace frontend {
+namespace tu {
+
+	namespace fs = boost::filesystem;
+
+	namespace {
+
+		IRTranslationUnit createUnit(core::NodeManager& mgr, const string& name) {
+			core::IRBuilder builder(mgr);
+			IRTranslationUnit unit(mgr);
+			unit.addType(builder.parseType(name).as<core::GenericTypePtr>(), builder.parseType("struct { int<4> x; }"));
+			unit.addFunction(builder.parseExpr("lit(\"" + name + "_f\":()->unit)").as<core::LiteralPtr>(), builder.parseExpr("lambda ()->unit { return; }").as<core::LambdaExprPtr>());
+			return unit;
+		}
+
+		/**
+		 * A temporary directory being removed at the end of its life cycle.
+		 */
+		struct TempDir {
+			fs::path path;
+			TempDir() : path(fs::temp_directory_path() / fs::unique_path("insieme_tu_cache_%%%%-%%%%")) {}
+			~TempDir() { fs::remove_all(path); }
+		};
+
+	}
+
+	TEST(TranslationUnitCache, Keys) {
+		auto a = IRTranslationUnitCache::computeKey("int main() {}");
+		auto b = IRTranslationUnitCache::computeKey("int main() { }");
+
+		EXPECT_EQ(32u, a.size());
+		EXPECT_EQ(a, IRTranslationUnitCache::computeKey("int main() {}"));
+		EXPECT_NE(a, b);
+	}
+
+	TEST(TranslationUnitCache, HitAndMiss) {
+		TempDir dir;
+		core::NodeManager mgr;
+		auto unit = createUnit(mgr, "A");
+
+		IRTranslationUnitCache cache(dir.path);
+		auto key = IRTranslationUnitCache::computeKey("A");
+
+		// initially, there is nothing
+		EXPECT_FALSE(cache.lookup(key, mgr));
+		cache.store(key, unit);
+		EXPECT_EQ(1u, cache.getNumEntries());
+
+		// now the unit should be present
+		core::NodeManager mgr2;
+		auto res = cache.lookup(key, mgr2);
+		ASSERT_TRUE(res);
+		EXPECT_EQ(toString(unit), toString(*res));
+
+		auto stats = cache.getStatistics();
+		EXPECT_EQ(1u, stats.hits);
+		EXPECT_EQ(1u, stats.misses);
+		EXPECT_EQ(1u, stats.stores);
+		EXPECT_EQ(0u, stats.evictions);
+
+		// entries are persistent
+		IRTranslationUnitCache cache2(dir.path);
+		EXPECT_EQ(1u, cache2.getNumEntries());
+		EXPECT_EQ(cache.getSize(), cache2.getSize());
+		EXPECT_TRUE(cache2.lookup(key, mgr2));
+
+		// and may be cleared
+		cache2.clear();
+		EXPECT_EQ(0u, cache2.getNumEntries());
+		EXPECT_FALSE(cache2.lookup(key, mgr2));
+	}
+
+	TEST(TranslationUnitCache, Eviction) {
+		TempDir dir;
+		core::NodeManager mgr;
+
+		// determine the size of a single entry
+		uintmax_t entrySize;
+		{
+			IRTranslationUnitCache cache(dir.path);
+			cache.store("probe", createUnit(mgr, "P"));
+			entrySize = cache.getSize();
+			cache.clear();
+		}
+
+		// create a cache for roughly two entries
+		IRTranslationUnitCache cache(dir.path, 2 * entrySize + entrySize / 2);
+		cache.store("A", createUnit(mgr, "A"));
+		cache.store("B", createUnit(mgr, "B"));
+		EXPECT_EQ(2u, cache.getNumEntries());
+
+		// use A, such that B is the least recently used entry
+		EXPECT_TRUE(cache.lookup("A", mgr));
+
+		// adding a third entry evicts B
+		cache.store("C", createUnit(mgr, "C"));
+		EXPECT_EQ(2u, cache.getNumEntries());
+		EXPECT_LE(cache.getSize(), cache.getCapacity());
+		EXPECT_EQ(1u, cache.getStatistics().evictions);
+
+		EXPECT_TRUE(cache.lookup("A", mgr));
+		EXPECT_FALSE(cache.lookup("B", mgr));
+		EXPECT_TRUE(cache.lookup("C", mgr));
+	}
+
+} // end namespace tu
+} // end namespace frontend
+} // end namespace insieme
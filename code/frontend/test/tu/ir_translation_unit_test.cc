@@ -220,6 +220,11 @@ namespace tu {
 		//after merge
 		auto metaInfoC = unitC.getMetaInfo(def);
 		EXPECT_EQ(3, metaInfoC.getConstructors().size()) << metaInfoC;
+
+		// the merged meta info is migrated to the target manager
+		for(const auto& cur : metaInfoC.getConstructors()) {
+			EXPECT_EQ(&mgrC, &cur->getNodeManager()) << cur;
+		}
 	}
 
 	TEST(TranslationUnit, MetaClassInfoDumpMerge) {
@@ -52,12 +52,23 @@
 #else
 	//#define IRT_SCHED_POLICY IRT_SCHED_POLICY_STATIC
 	#define IRT_SCHED_POLICY IRT_SCHED_POLICY_STEALING_CIRCULAR
+	//#define IRT_SCHED_POLICY IRT_SCHED_POLICY_STEALING_CHASE_LEV
 	//#define IRT_SCHED_POLICY IRT_SCHED_POLICY_UBER
 #endif
 #endif
 
 #define IRT_LOOP_SCHED_POLICY_ENV "IRT_LOOP_SCHED_POLICY"
 
+// topology-aware victim selection for the work stealing policies
+// - if set, victims sharing a cache are preferred over those on the same NUMA node and over remote ones
+// - requires workers to be pinned using an affinity policy
+#define IRT_HIERARCHICAL_STEALING_ENV "IRT_HIERARCHICAL_STEALING"
+// failed steal attempts on the cache, node and remote level before escalating to the next one, e.g. "2,4,8"
+#define IRT_STEAL_ESCALATION_ENV "IRT_STEAL_ESCALATION"
+#ifndef IRT_STEAL_ESCALATION_DEFAULT
+#define IRT_STEAL_ESCALATION_DEFAULT { 2, 4, 8 }
+#endif
+
 // determines if workers should ever go to sleep
 // - needs to be unset for the stealing policies!
 // workers must not sleep when compiling/running a program on windows xp because condition variables are not supported there
@@ -94,9 +105,12 @@
 #define IRT_INST_WORKER_EVENT_LOGGING_ENV "IRT_INST_WORKER_EVENT_LOGGING"
 #define IRT_INST_WORKER_EVENT_TYPES_ENV "IRT_INST_WORKER_EVENT_TYPES"
 #define IRT_INST_WORKER_PD_BLOCKSIZE	512
+#define IRT_INST_STREAMING_OUTPUT_ENV "IRT_INST_STREAMING_OUTPUT"
+#define IRT_INST_WORKER_EVENT_STREAM_BLOCKSIZE	4096
 #define IRT_INST_REGION_INSTRUMENTATION_ENV "IRT_INST_REGION_INSTRUMENTATION"
 #define IRT_INST_REGION_INSTRUMENTATION_TYPES_ENV "IRT_INST_REGION_INSTRUMENTATION_TYPES"
 #define IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE 256
+#define IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS 4 // keep members within IRT_WG_RING_BUFFER_SIZE loops of each other
 
 // standalone
 #define IRT_NUM_WORKERS_ENV "IRT_NUM_WORKERS"
@@ -118,16 +132,67 @@
 
 // work group
 #define IRT_WG_RING_BUFFER_SIZE 1024
+// fan-in of the combining tree used by work group barriers, define IRT_WG_BARRIER_SCHEDULED to use the event based barrier instead
+#ifndef IRT_WG_BARRIER_ARITY
+#define IRT_WG_BARRIER_ARITY 4
+#endif
+// bounds for the adaptively tuned number of iterations a work item waiting in a combining tree barrier spins before it suspends
+#ifndef IRT_WG_BARRIER_SPIN_MIN
+#define IRT_WG_BARRIER_SPIN_MIN 64
+#endif
+#ifndef IRT_WG_BARRIER_SPIN_MAX
+#define IRT_WG_BARRIER_SPIN_MAX 4096
+#endif
+
+// locks
+// bounds for the adaptively tuned number of spin iterations before a contended acquisition suspends
+#ifndef IRT_LOCK_SPIN_MIN
+#define IRT_LOCK_SPIN_MIN 16
+#endif
+#ifndef IRT_LOCK_SPIN_MAX
+#define IRT_LOCK_SPIN_MAX 4096
+#endif
 
 // worker
 #define IRT_DEFAULT_VARIANT_ENV "IRT_DEFAULT_VARIANT"
 
+// adaptive implementation variant selection, enabled by setting IRT_VARIANT_SELECTION to "adaptive"
+#define IRT_VARIANT_SELECTION_ENV "IRT_VARIANT_SELECTION"
+// file the gathered variant statistics are loaded from at startup and stored to at shutdown
+#define IRT_VARIANT_SELECTION_FILE_ENV "IRT_VARIANT_SELECTION_FILE"
+// number of range size classes statistics are kept for, class c covers ranges of 2^c to 2^(c+1)-1 elements
+#ifndef IRT_VARIANT_SELECTION_SIZE_CLASSES
+#define IRT_VARIANT_SELECTION_SIZE_CLASSES 16
+#endif
+// number of executions of each variant before the fastest one is exploited
+#ifndef IRT_VARIANT_SELECTION_MIN_SAMPLES
+#define IRT_VARIANT_SELECTION_MIN_SAMPLES 4
+#endif
+// exploration rate, after n executions of a size class a random variant is chosen with probability
+// IRT_VARIANT_SELECTION_EXPLORATION * num_variants / n
+#ifndef IRT_VARIANT_SELECTION_EXPLORATION
+#define IRT_VARIANT_SELECTION_EXPLORATION 8
+#endif
+
 // TODO : better configurability, maybe per-wi stack size set by compiler?
 // updated to 8MB due to failing test cases (quicksort, jacobi)
 // don't misalign!
 #ifndef IRT_WI_STACK_SIZE
 #define IRT_WI_STACK_SIZE 8 * 1024 * 1024
 #endif
+// number of stack size classes, class c provides IRT_WI_STACK_SIZE / 4^c bytes - 1 disables smaller stacks
+// smaller classes are only used for implementation variants annotated with a stack_bound meta info
+#ifndef IRT_WI_STACK_CLASSES
+#define IRT_WI_STACK_CLASSES 3
+#endif
+// number of idle stacks per worker and size class keeping their memory committed, further ones are trimmed
+#ifndef IRT_WI_STACK_POOL_HIGH_WATER
+#define IRT_WI_STACK_POOL_HIGH_WATER 4
+#endif
+// the stack usage of the first IRT_WI_STACK_SAMPLES work items of each implementation variant is measured,
+// afterwards every IRT_WI_STACK_SAMPLE_INTERVAL-th work item of a worker (for statistics only)
+#define IRT_WI_STACK_SAMPLES 16
+#define IRT_WI_STACK_SAMPLE_INTERVAL 64
 
 #ifndef IRT_DEF_WORKERS
 #define IRT_DEF_WORKERS 1
@@ -60,10 +60,27 @@
  * Internally, the list of blocks is handled within a linked list. Blocks
  * are added at the front, increasing indices incrementally. Further, more
  * recent region definitions are covering older definitions automatically.
+ *
+ * To locate blocks, every page covered by a block is additionally entered
+ * into a page-indexed hash table. Entries are added to the front of the
+ * buckets, such that lookups encounter more recent blocks first.
  */
 
+// the size of the pages blocks are indexed by (as a power of 2)
+#define IRT_CAP_DBI_PAGE_BITS 12
+
+// the number of buckets of the page index (must be a power of 2)
+#define IRT_CAP_DBI_INDEX_SIZE (1<<16)
+
+typedef struct _irt_cap_dbi_page_entry {
+	uint64 page;									// the number of the page covered by the block
+	const irt_cap_data_block_info* block;			// the block covering the page
+	struct _irt_cap_dbi_page_entry* volatile next;	// the next entry within the same bucket
+} irt_cap_dbi_page_entry;
+
 typedef struct _irt_cap_data_block_info_list_node {
 	irt_cap_data_block_info info;
+	irt_cap_dbi_page_entry* pages;		// the entries of this block within the page index
 	struct _irt_cap_data_block_info_list_node* next;
 } irt_cap_data_block_info_list_node;
 
@@ -73,6 +90,22 @@ typedef struct _irt_cap_data_block_info_list_node {
  */
 irt_cap_data_block_info_list_node* volatile irt_g_cap_data_block_list = NULL;
 
+/**
+ * The index of the global list of data blocks, one bucket list per set of pages.
+ */
+irt_cap_dbi_page_entry* volatile irt_g_cap_dbi_page_index[IRT_CAP_DBI_INDEX_SIZE];
+
+/**
+ * The lock serializing the registration of blocks (lookups are lock-free).
+ */
+irt_spinlock irt_g_cap_dbi_lock;
+
+/**
+ * A counter increased whenever the outcome of recording an access may change due to
+ * the registration of a block or the start or end of a region.
+ */
+volatile uint32 irt_g_cap_epoch = 1;
+
 const irt_cap_data_block_info* irt_cap_dbi_register_block(void* base, uint32 size) {
 
 	// create new block
@@ -80,16 +113,31 @@ const irt_cap_data_block_info* irt_cap_dbi_register_block(void* base, uint32 siz
 	node->info.base = base;
 	node->info.size = size;
 
-	// insert into list of blocks (lock-free)
-	do {
-		// add next pointer
-		node->next = irt_g_cap_data_block_list;
+	// create its page index entries
+	uint64 first_page = (uint64)base >> IRT_CAP_DBI_PAGE_BITS;
+	uint64 num_pages = (size == 0) ? 0 : (((uint64)base + size - 1) >> IRT_CAP_DBI_PAGE_BITS) - first_page + 1;
+	node->pages = (irt_cap_dbi_page_entry*)malloc(num_pages * sizeof(irt_cap_dbi_page_entry));
+
+	irt_spin_lock(&irt_g_cap_dbi_lock);
+
+	// insert into list of blocks and update the id for the new block
+	node->next = irt_g_cap_data_block_list;
+	node->info.id = (node->next)?(node->next->info.id + 1):1;
+	irt_g_cap_data_block_list = node;
+
+	// publish the block within the index - concurrent lookups see either the old or the new bucket head
+	for(uint64 i=0; i<num_pages; i++) {
+		irt_cap_dbi_page_entry* entry = &(node->pages[i]);
+		entry->page = first_page + i;
+		entry->block = &(node->info);
+		irt_cap_dbi_page_entry* volatile* bucket = &irt_g_cap_dbi_page_index[entry->page & (IRT_CAP_DBI_INDEX_SIZE-1)];
+		entry->next = *bucket;
+		irt_atomic_store(bucket, entry);
+	}
 
-		// update the id for the new block
-		node->info.id = (node->next)?(node->next->info.id + 1):1;
+	irt_atomic_inc(&irt_g_cap_epoch, uint32);
 
-		// try adding the element to list
-	} while (!irt_atomic_bool_compare_and_swap((intptr_t*)&irt_g_cap_data_block_list, (intptr_t)(node->next), (intptr_t)node, intptr_t));
+	irt_spin_unlock(&irt_g_cap_dbi_lock);
 
 	// return pointer to stored information
 	return &(node->info);
@@ -97,14 +145,17 @@ const irt_cap_data_block_info* irt_cap_dbi_register_block(void* base, uint32 siz
 
 const irt_cap_data_block_info* irt_cap_dbi_lookup(void* ptr) {
 
-	// search for the corresponding block
-	irt_cap_data_block_info_list_node* cur = irt_g_cap_data_block_list;
+	// search for the most recent block covering the location within the page index
 	uint64 pos = (uint64)ptr;
+	uint64 page = pos >> IRT_CAP_DBI_PAGE_BITS;
+	irt_cap_dbi_page_entry* cur = irt_g_cap_dbi_page_index[page & (IRT_CAP_DBI_INDEX_SIZE-1)];
 	while(cur != NULL) {
 		// check whether block is covering the location pointed to
-		uint64 base = (uint64)cur->info.base;
-		if (base <= pos && pos < base + cur->info.size) {
-			return &(cur->info);
+		if (cur->page == page) {
+			uint64 base = (uint64)cur->block->base;
+			if (base <= pos && pos < base + cur->block->size) {
+				return cur->block;
+			}
 		}
 		cur = cur->next;
 	}
@@ -115,6 +166,8 @@ const irt_cap_data_block_info* irt_cap_dbi_lookup(void* ptr) {
 
 void irt_cap_dbi_init() {
 	irt_g_cap_data_block_list = NULL;
+	memset((void*)irt_g_cap_dbi_page_index, 0, sizeof(irt_g_cap_dbi_page_index));
+	irt_spin_init(&irt_g_cap_dbi_lock);
 }
 
 void irt_cap_dbi_finalize() {
@@ -122,10 +175,150 @@ void irt_cap_dbi_finalize() {
 	irt_cap_data_block_info_list_node* cur = irt_g_cap_data_block_list;
 	while(cur != NULL) {
 		irt_cap_data_block_info_list_node* next = cur->next;
+		free(cur->pages);
 		free(cur);
 		cur = next;
 	}
 	irt_g_cap_data_block_list = NULL;
+	memset((void*)irt_g_cap_dbi_page_index, 0, sizeof(irt_g_cap_dbi_page_index));
+	irt_spin_destroy(&irt_g_cap_dbi_lock);
+	irt_atomic_inc(&irt_g_cap_epoch, uint32);
+}
+
+
+// ------------------------------------------------------------------------------------
+//    Range Sets
+// ------------------------------------------------------------------------------------
+
+void irt_cap_range_set_init(irt_cap_range_set* set) {
+	set->ranges = NULL;
+	set->size = 0;
+	set->capacity = 0;
+}
+
+void irt_cap_range_set_destroy(irt_cap_range_set* set) {
+	free(set->ranges);
+}
+
+/**
+ * Obtains the index of the first range within the set ending after the given position.
+ */
+static inline uint32 irt_cap_range_set_find(const irt_cap_range_set* set, uint32 pos) {
+	uint32 lo = 0, hi = set->size;
+	while(lo < hi) {
+		uint32 mid = (lo + hi) / 2;
+		if (set->ranges[mid].end <= pos) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+static inline void irt_cap_range_set_insert_at(irt_cap_range_set* set, uint32 index, uint32 begin, uint32 end) {
+	if (set->size == set->capacity) {
+		set->capacity = (set->capacity == 0) ? 4 : set->capacity * 2;
+		set->ranges = (irt_cap_range*)realloc(set->ranges, set->capacity * sizeof(irt_cap_range));
+	}
+	memmove(&(set->ranges[index+1]), &(set->ranges[index]), (set->size - index) * sizeof(irt_cap_range));
+	set->ranges[index].begin = begin;
+	set->ranges[index].end = end;
+	set->size++;
+}
+
+bool irt_cap_range_set_contains(const irt_cap_range_set* set, uint32 pos) {
+	uint32 i = irt_cap_range_set_find(set, pos);
+	return i < set->size && set->ranges[i].begin <= pos;
+}
+
+bool irt_cap_range_set_intersects(const irt_cap_range_set* set, uint32 begin, uint32 end) {
+	uint32 i = irt_cap_range_set_find(set, begin);
+	return i < set->size && set->ranges[i].begin < end;
+}
+
+/**
+ * Adds the range [begin, end) to the given set, merging it with overlapping and adjacent ranges.
+ */
+void irt_cap_range_set_add(irt_cap_range_set* set, uint32 begin, uint32 end) {
+	if (begin >= end) return;
+
+	// find the ranges [first, last) to be merged with the new one
+	uint32 first = (begin == 0) ? 0 : irt_cap_range_set_find(set, begin - 1);
+	uint32 last = first;
+	while(last < set->size && set->ranges[last].begin <= end) {
+		begin = MIN(begin, set->ranges[last].begin);
+		end = MAX(end, set->ranges[last].end);
+		last++;
+	}
+
+	if (first == last) {
+		irt_cap_range_set_insert_at(set, first, begin, end);
+		return;
+	}
+
+	set->ranges[first].begin = begin;
+	set->ranges[first].end = end;
+	memmove(&(set->ranges[first+1]), &(set->ranges[last]), (set->size - last) * sizeof(irt_cap_range));
+	set->size -= last - first - 1;
+}
+
+/**
+ * Removes the range [begin, end) from the given set.
+ */
+void irt_cap_range_set_remove(irt_cap_range_set* set, uint32 begin, uint32 end) {
+	if (begin >= end) return;
+
+	uint32 i = irt_cap_range_set_find(set, begin);
+	if (i < set->size && set->ranges[i].begin < begin) {
+		if (set->ranges[i].end > end) {
+			// split the range covering the removed one
+			irt_cap_range_set_insert_at(set, i+1, end, set->ranges[i].end);
+			set->ranges[i].end = begin;
+			return;
+		}
+		// cut off the tail of the first range
+		set->ranges[i].end = begin;
+		i++;
+	}
+
+	// drop all ranges completely covered and cut off the head of the last one
+	uint32 j = i;
+	while(j < set->size && set->ranges[j].end <= end) {
+		j++;
+	}
+	if (j < set->size && set->ranges[j].begin < end) {
+		set->ranges[j].begin = end;
+	}
+	memmove(&(set->ranges[i]), &(set->ranges[j]), (set->size - j) * sizeof(irt_cap_range));
+	set->size -= j - i;
+}
+
+/**
+ * Obtains the next sub-range of [*cursor, end) not covered by the given set and advances
+ * the cursor beyond it. Returns false if there is no such sub-range left.
+ */
+bool irt_cap_range_set_next_gap(const irt_cap_range_set* set, uint32* cursor, uint32 end, irt_cap_range* gap) {
+	while(*cursor < end) {
+		uint32 i = irt_cap_range_set_find(set, *cursor);
+		if (i == set->size || set->ranges[i].begin >= end) {
+			// the rest is uncovered
+			gap->begin = *cursor;
+			gap->end = end;
+			*cursor = end;
+			return true;
+		}
+		if (set->ranges[i].begin > *cursor) {
+			// uncovered up to the next range
+			gap->begin = *cursor;
+			gap->end = set->ranges[i].begin;
+			*cursor = set->ranges[i].end;
+			return true;
+		}
+		// skip covered range
+		*cursor = set->ranges[i].end;
+	}
+	return false;
 }
 
 
@@ -182,6 +375,7 @@ void irt_cap_region_start(uint32 id) {
 	elem->region.active = true;
 	irt_spin_init(&elem->region.lock);
 	elem->region.usage = NULL;
+	memset((void*)elem->region.usage_index, 0, sizeof(elem->region.usage_index));
 
 	// add to list
 	elem->next = irt_g_cap_region_list;
@@ -196,6 +390,8 @@ void irt_cap_region_start(uint32 id) {
 	do {
 		stackElem->next = irt_g_cap_region_stack;
 	} while (!irt_atomic_bool_compare_and_swap((intptr_t*)&irt_g_cap_region_stack, (intptr_t)stackElem->next, (intptr_t)stackElem, intptr_t));
+
+	irt_atomic_inc(&irt_g_cap_epoch, uint32);
 }
 
 void irt_cap_region_stop(uint32 id) {
@@ -214,27 +410,38 @@ void irt_cap_region_stop(uint32 id) {
 
 	// delete stack element
 	free(top);
+
+	irt_atomic_inc(&irt_g_cap_epoch, uint32);
 }
 
-irt_cap_block_usage_info* irt_cap_get_usage_info(irt_cap_region* region, void* ptr) {
-	irt_cap_block_usage_info* cur = region->usage;
-	uint64 pos = (uint64)ptr;
+static inline irt_cap_block_usage_info* volatile* irt_cap_get_usage_bucket(irt_cap_region* region, const irt_cap_data_block_info* block) {
+	return &(region->usage_index[block->id % IRT_CAP_USAGE_INDEX_SIZE]);
+}
+
+irt_cap_block_usage_info* irt_cap_get_usage_info(irt_cap_region* region, const irt_cap_data_block_info* block) {
+	irt_cap_block_usage_info* cur = *irt_cap_get_usage_bucket(region, block);
 	while(cur != NULL) {
-		// check whether block is covering the location pointed to
-		const irt_cap_data_block_info* info = cur->block;
-		if ((uint64)info->base <= pos && pos < (uint64)info->base + info->size) {
+		if (cur->block == block) {
 			return cur;
 		}
-		cur = cur->next;
+		cur = cur->next_in_bucket;
 	}
 	return NULL;
 }
 
-irt_cap_block_usage_info* irt_cat_get_or_create_usage_info(irt_cap_region* region, void* pos) {
+irt_cap_block_usage_info* irt_cat_get_or_create_usage_info(irt_cap_region* region, const irt_cap_data_block_info* block) {
+
+	IRT_ASSERT(block, IRT_ERR_INTERNAL, "Cannot create usage info for unregistered block!");
+
+	irt_cap_block_usage_info* res = irt_cap_get_usage_info(region, block);
+	if (res) {
+		return res;
+	}
 
 	irt_spin_lock(&region->lock);
 
-	irt_cap_block_usage_info* res = irt_cap_get_usage_info(region, pos);
+	// check again while holding the lock
+	res = irt_cap_get_usage_info(region, block);
 	if (res) {
 		irt_spin_unlock(&region->lock);
 		return res;
@@ -243,33 +450,33 @@ irt_cap_block_usage_info* irt_cat_get_or_create_usage_info(irt_cap_region* regio
 	// not found ...
 	// 	=> create new information
 
-	const irt_cap_data_block_info* info = irt_cap_dbi_lookup(pos);
-	IRT_ASSERT(info, IRT_ERR_INTERNAL, "Cannot create usage info for unregistered block!");
 	irt_cap_block_usage_info* elem = (irt_cap_block_usage_info*)malloc(sizeof(irt_cap_block_usage_info));
 
-	elem->block = info;
+	elem->block = block;
 	elem->tag = -1;
 
-	// init locks
-	elem->locks = (irt_spinlock*)malloc(info->size * sizeof(irt_spinlock));
-	for(int i=0; i<info->size; i++) {
-		irt_spin_init(&elem->locks[i]);
-	}
+	// init lock
+	irt_spin_init(&elem->lock);
 
 	// init data fields
-	elem->life_in_values  = (char*)malloc(info->size);
-	elem->life_out_values = (char*)malloc(info->size);
+	elem->life_in_values  = (char*)malloc(block->size);
+	elem->life_out_values = (char*)malloc(block->size);
 
-	// init flag masks
-	elem->read 				= (bool*)calloc(info->size, sizeof(bool));
-	elem->is_pointer 		= (bool*)calloc(info->size, sizeof(bool));
-	elem->last_written 		= (bool*)calloc(info->size, sizeof(bool));
-	elem->is_life_out 		= (bool*)calloc(info->size, sizeof(bool));
+	// init range sets
+	irt_cap_range_set_init(&elem->read);
+	irt_cap_range_set_init(&elem->is_pointer);
+	irt_cap_range_set_init(&elem->last_written);
+	irt_cap_range_set_init(&elem->is_life_out);
 
 	// add to usage
 	elem->next = region->usage;
 	region->usage = elem;
 
+	// publish within the index - lookups are not synchronized
+	irt_cap_block_usage_info* volatile* bucket = irt_cap_get_usage_bucket(region, block);
+	elem->next_in_bucket = *bucket;
+	irt_atomic_store(bucket, elem);
+
 	irt_spin_unlock(&region->lock);
 
 	return elem;
@@ -277,8 +484,9 @@ irt_cap_block_usage_info* irt_cat_get_or_create_usage_info(irt_cap_region* regio
 
 void irt_cap_tag_block(void* pos, uint16 id) {
 	irt_cap_region* region = irt_g_cap_region_stack->region;
-	IRT_ASSERT(irt_cat_get_or_create_usage_info(region, pos)->tag < 0, IRT_ERR_INTERNAL, "Tag must only be assigned once!");
-	irt_cat_get_or_create_usage_info(region, pos)->tag = id;
+	const irt_cap_data_block_info* block = irt_cap_dbi_lookup(pos);
+	IRT_ASSERT(irt_cat_get_or_create_usage_info(region, block)->tag < 0, IRT_ERR_INTERNAL, "Tag must only be assigned once!");
+	irt_cat_get_or_create_usage_info(region, block)->tag = id;
 }
 
 void irt_cap_print_report() {
@@ -298,7 +506,7 @@ void irt_cap_print_report() {
 
 		it = cur->region.usage;
 		while (it != NULL) {
-			printf("  Block %d from %p size %u - is pointer: %d\n", it->tag, (void*) it->block->base, it->block->size, it->is_pointer[0]);
+			printf("  Block %d from %p size %u - is pointer: %d\n", it->tag, (void*) it->block->base, it->block->size, irt_cap_range_set_contains(&it->is_pointer, 0));
 			it = it->next;
 		}
 
@@ -308,8 +516,68 @@ void irt_cap_print_report() {
 }
 
 
+// ------------------------------------------------------------------------------------
+//    Per-Thread Recording Buffers
+// ------------------------------------------------------------------------------------
+
+/**
+ * Reading the same location a second time without a block being registered or a region
+ * being started or stopped in between does not change the recorded information: values
+ * are only recorded when being read the first time and retired regions only loose the
+ * ownership of written values. Every thread therefore buffers the locations it has read
+ * within the current epoch, such that repeated reads skip the block lookup and the
+ * synchronization on the usage information. Buffer entries cover one cache line each.
+ */
+
+// the number of entries of the per-thread buffers (must be a power of 2)
+#define IRT_CAP_READ_BUFFER_SIZE 1024
+
+// the number of bytes covered by a buffer entry (as a power of 2, at most 64)
+#define IRT_CAP_READ_BUFFER_LINE_BITS 6
+
+typedef struct {
+	uint64 line;	// the address of the covered line, shifted by IRT_CAP_READ_BUFFER_LINE_BITS
+	uint64 mask;	// the bytes within the line read by the owning thread
+	uint32 epoch;	// the epoch this entry is valid for
+} irt_cap_read_buffer_entry;
+
+typedef struct _irt_cap_thread_buffer {
+	irt_cap_read_buffer_entry reads[IRT_CAP_READ_BUFFER_SIZE];
+	struct _irt_cap_thread_buffer* next;	// enables this struct to be used within a list
+} irt_cap_thread_buffer;
+
+/**
+ * The key of the thread local buffers and the list of all of them.
+ */
+irt_tls_key irt_g_cap_thread_buffer_key;
+irt_cap_thread_buffer* volatile irt_g_cap_thread_buffers = NULL;
+
+irt_cap_thread_buffer* irt_cap_get_thread_buffer() {
+	irt_cap_thread_buffer* buffer = (irt_cap_thread_buffer*)irt_tls_get(irt_g_cap_thread_buffer_key);
+	if (!buffer) {
+		buffer = (irt_cap_thread_buffer*)calloc(1, sizeof(irt_cap_thread_buffer));
+		irt_tls_set(irt_g_cap_thread_buffer_key, buffer);
+
+		// register buffer for being freed
+		do {
+			buffer->next = irt_g_cap_thread_buffers;
+		} while (!irt_atomic_bool_compare_and_swap((intptr_t*)&irt_g_cap_thread_buffers, (intptr_t)buffer->next, (intptr_t)buffer, intptr_t));
+	}
+	return buffer;
+}
+
+/**
+ * Obtains the mask of the bytes accessed within the line of pos, 0 if the access is spanning multiple lines.
+ */
+static inline uint64 irt_cap_read_buffer_mask(void* pos, uint16 size) {
+	uint32 offset = (uint64)pos & ((1 << IRT_CAP_READ_BUFFER_LINE_BITS) - 1);
+	if (size == 0 || offset + size > (1 << IRT_CAP_READ_BUFFER_LINE_BITS)) return 0;
+	return ((size == 64) ? ~(uint64)0 : (((uint64)1 << size) - 1)) << offset;
+}
+
+
 void irt_cap_region_init() {
-	// nothing to do
+	irt_tls_key_create(&irt_g_cap_thread_buffer_key);
 }
 
 void irt_cap_region_finalize() {
@@ -338,18 +606,15 @@ void irt_cap_region_finalize() {
 			while (it != NULL) {
 				irt_cap_block_usage_info* t = it->next;
 
-				for(int i=0; i<it->block->size; i++) {
-					irt_spin_destroy(&it->locks[i]);
-				}
+				irt_spin_destroy(&it->lock);
 
 				// free all members
-				free((void*)it->locks);
 				free(it->life_in_values);
 				free(it->life_out_values);
-				free(it->read);
-				free(it->last_written);
-				free(it->is_life_out);
-				free(it->is_pointer);
+				irt_cap_range_set_destroy(&it->read);
+				irt_cap_range_set_destroy(&it->last_written);
+				irt_cap_range_set_destroy(&it->is_life_out);
+				irt_cap_range_set_destroy(&it->is_pointer);
 
 				// free usage info itself
 				free(it);
@@ -357,6 +622,8 @@ void irt_cap_region_finalize() {
 				it = t;
 			}
 
+			irt_spin_destroy(&cur->region.lock);
+
 			// free region list entry
 			free(cur);
 
@@ -365,6 +632,20 @@ void irt_cap_region_finalize() {
 	}
 
 	irt_g_cap_region_list = NULL;
+
+	// clear per-thread buffers
+	{
+		irt_cap_thread_buffer* cur = irt_g_cap_thread_buffers;
+		while (cur != NULL) {
+			irt_cap_thread_buffer* next = cur->next;
+			free(cur);
+			cur = next;
+		}
+	}
+
+	irt_g_cap_thread_buffers = NULL;
+	irt_tls_key_delete(irt_g_cap_thread_buffer_key);
+	irt_atomic_inc(&irt_g_cap_epoch, uint32);
 }
 
 /**
@@ -374,103 +655,105 @@ void irt_cap_region_finalize() {
 void irt_cap_read_internal(void* pos, void* value, uint16 size, bool is_ptr) {
 	//printf("Reading ..\n");
 
-	if (!irt_cap_dbi_lookup(pos)) {
-		return; // not a registered memory location => can be ignored
-	}
-
-	// mark value being read within all active regions
-	irt_cap_region_stack* cur = irt_g_cap_region_stack;
-	while (cur != NULL) {
-
-		irt_cap_block_usage_info* info;
-		if (is_ptr) {	// external pointer to local may be ignored
-			info = irt_cap_get_usage_info(cur->region, pos);
-		} else {
-			info = irt_cat_get_or_create_usage_info(cur->region, pos);
+	// check whether this thread has recorded this read before (pointers are always processed)
+	irt_cap_read_buffer_entry* entry = NULL;
+	uint64 line = (uint64)pos >> IRT_CAP_READ_BUFFER_LINE_BITS;
+	uint64 mask = (is_ptr) ? 0 : irt_cap_read_buffer_mask(pos, size);
+	uint32 epoch = irt_g_cap_epoch;
+	if (mask) {
+		entry = &(irt_cap_get_thread_buffer()->reads[line & (IRT_CAP_READ_BUFFER_SIZE-1)]);
+		if (entry->epoch == epoch && entry->line == line && (entry->mask & mask) == mask) {
+			return; // nothing new
 		}
+	}
 
-		if (info) {
-			int offset = ((uint64)pos - (uint64)info->block->base)/sizeof(char);
-			char* data = (char*)value;
+	const irt_cap_data_block_info* block = irt_cap_dbi_lookup(pos);
+	if (block) {
+		uint32 begin = (uint64)pos - (uint64)block->base;
+		uint32 end = MIN(begin + size, block->size);
+		char* data = (char*)value;
 
-			// process each of the read bytes
-			for (int i = 0; i<size/sizeof(char); i++) {
-				int absPos = i + offset;
+		// mark value being read within all active regions
+		irt_cap_region_stack* cur = irt_g_cap_region_stack;
+		while (cur != NULL) {
 
-				// request the lock
-				irt_spinlock* lock = &info->locks[absPos];
-				irt_spin_lock(lock);
+			irt_cap_block_usage_info* info;
+			if (is_ptr) {	// external pointer to local may be ignored
+				info = irt_cap_get_usage_info(cur->region, block);
+			} else {
+				info = irt_cat_get_or_create_usage_info(cur->region, block);
+			}
 
-				// check whether value has already been written
-				if (info->last_written[absPos]) {
-					irt_spin_unlock(lock);
-					continue; // can be ignored
-				}
+			if (info) {
+				irt_spin_lock(&info->lock);
 
-				// check whether it has been read before
-				if (info->read[absPos]) {
-					irt_spin_unlock(lock);
-					continue; // has been read before
-				}
+				// record all values which have neither been written nor been read before
+				uint32 cursor = begin;
+				irt_cap_range unwritten;
+				while (irt_cap_range_set_next_gap(&info->last_written, &cursor, end, &unwritten)) {
+					uint32 inner = unwritten.begin;
+					irt_cap_range unread;
+					while (irt_cap_range_set_next_gap(&info->read, &inner, unwritten.end, &unread)) {
 
-				// mark as read
-				info->read[absPos] = true;
+						// record value
+						memcpy(&(info->life_in_values[unread.begin]), &(data[unread.begin - begin]), unread.end - unread.begin);
 
-				// record value
-				info->life_in_values[absPos] = data[i];
+						// set pointer flag
+						IRT_ASSERT(is_ptr || !irt_cap_range_set_intersects(&info->is_pointer, unread.begin, unread.end), IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
+						if (is_ptr) irt_cap_range_set_add(&info->is_pointer, unread.begin, unread.end);
 
-				// set pointer flag
-				IRT_ASSERT(is_ptr || !info->is_pointer[absPos], IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
-				info->is_pointer[absPos] = is_ptr;
+						// mark as read
+						irt_cap_range_set_add(&info->read, unread.begin, unread.end);
 
-				// release the lock
-				irt_spin_unlock(lock);
+						//DEBUG(printf("New value read - pos %d - size %d\n", unread.begin, (int)(unread.end - unread.begin)));
+					}
+				}
 
-				//DEBUG(printf("New value read - pos %d - size %d\n", absPos, (int)size));
+				irt_spin_unlock(&info->lock);
 			}
-		}
 
-		cur = cur->next;
-	}
+			cur = cur->next;
+		}
 
-	// for all retired regions => marke value as being alive
-	irt_cap_region_list* it = irt_g_cap_region_list;
-	while(it != NULL) {
-		if (!it->region.active) { 	// region has retired
+		// for all retired regions => marke value as being alive
+		irt_cap_region_list* it = irt_g_cap_region_list;
+		while(it != NULL) {
+			if (!it->region.active) { 	// region has retired
 
-			irt_cap_block_usage_info* info = irt_cap_get_usage_info(&(it->region), pos);
-			if (info) {
+				irt_cap_block_usage_info* info = irt_cap_get_usage_info(&(it->region), block);
+				if (info) {
+					irt_spin_lock(&info->lock);
 
-				int offset = ((uint64)pos - (uint64)info->block->base)/sizeof(char);
+					// values last written by this region are life-out
+					for(uint32 i = irt_cap_range_set_find(&info->last_written, begin); i < info->last_written.size && info->last_written.ranges[i].begin < end; i++) {
+						uint32 from = MAX(begin, info->last_written.ranges[i].begin);
+						uint32 to = MIN(end, info->last_written.ranges[i].end);
 
-				// process each of the read bytes
-				for (int i = 0; i<size/sizeof(char); i++) {
-					int absPos = i + offset;
+						// make sure, position has not been used as a pointer!
+						IRT_ASSERT(is_ptr || !irt_cap_range_set_intersects(&info->is_pointer, from, to), IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
 
-					// request the lock
-					irt_spin_lock(&info->locks[absPos]);
+						// update the is_life_out flags
+						irt_cap_range_set_add(&info->is_life_out, from, to);
 
-					// check whether the value has last been writen by this region
-					if (!info->last_written[absPos]) {
-						irt_spin_unlock(&info->locks[absPos]);
-						continue; // can be ignored
+						//DEBUG(printf("Life-out discovered - pos %d - size %d\n", from, (int)(to - from)));
 					}
 
-					// make sure, position has not been used as a pointer!
-					IRT_ASSERT(is_ptr || !info->is_pointer[absPos], IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
-
-					// update ti is_life_out flag
-					info->is_life_out[absPos] = true;
-
-					// release the lock
-					irt_spin_unlock(&info->locks[absPos]);
-
-					//DEBUG(printf("Life-out discovered - pos %d - size %d\n", absPos, (int)size));
+					irt_spin_unlock(&info->lock);
 				}
 			}
+
+			it = it->next;
 		}
+	}
 
-		it = it->next;
+	// remember read within the buffer of this thread
+	if (entry) {
+		if (entry->epoch != epoch || entry->line != line) {
+			entry->epoch = epoch;
+			entry->line = line;
+			entry->mask = 0;
+		}
+		entry->mask |= mask;
 	}
 }
 
@@ -481,83 +764,65 @@ void irt_cap_read_internal(void* pos, void* value, uint16 size, bool is_ptr) {
 void irt_cap_written_internal(void* pos, void* value, uint16 size, bool is_ptr) {
 	//printf("Writing ..\n");
 
-	if (!irt_cap_dbi_lookup(pos)) {
+	const irt_cap_data_block_info* block = irt_cap_dbi_lookup(pos);
+	if (!block) {
 		return; // not a registered memory location => can be ignored
 	}
 
+	uint32 begin = (uint64)pos - (uint64)block->base;
+	uint32 end = MIN(begin + size, block->size);
+	char* data = (char*)value;
+
 	// mark value being read within all active regions
 	irt_cap_region_stack* cur = irt_g_cap_region_stack;
 	while (cur != NULL) {
 
 		irt_cap_block_usage_info* info;
 		if (is_ptr) {	// external pointer to local may be ignored
-			info = irt_cap_get_usage_info(cur->region, pos);
+			info = irt_cap_get_usage_info(cur->region, block);
 		} else {
-			info = irt_cat_get_or_create_usage_info(cur->region, pos);
+			info = irt_cat_get_or_create_usage_info(cur->region, block);
 		}
 
 		if (info) {
-			int offset = ((uint64)pos - (uint64)info->block->base)/sizeof(char);
-			char* data = (char*)value;
-
-			// process each of the written bytes
-			for (int i = 0; i<size/sizeof(char); i++) {
-				int absPos = i + offset;
-
-				// request the lock
-				irt_spin_lock(&info->locks[absPos]);
+			irt_spin_lock(&info->lock);
 
-				// mark as being written
-				info->last_written[absPos] = true;
+			// mark as being written
+			irt_cap_range_set_add(&info->last_written, begin, end);
 
-				// safe written value (as a life-out value)
-				info->life_out_values[absPos] = data[i];
+			// safe written value (as a life-out value)
+			memcpy(&(info->life_out_values[begin]), data, end - begin);
 
-				// mark as pointer, if necessary
-				IRT_ASSERT(is_ptr || !info->is_pointer[absPos], IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
+			// mark as pointer, if necessary
+			IRT_ASSERT(is_ptr || !irt_cap_range_set_intersects(&info->is_pointer, begin, end), IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
+			if (is_ptr) irt_cap_range_set_add(&info->is_pointer, begin, end);
 
-				info->is_pointer[absPos] = is_ptr;
+			irt_spin_unlock(&info->lock);
 
-				// release the lock
-				irt_spin_unlock(&info->locks[absPos]);
-
-				//DEBUG(printf("New value written - pos %d - size %d\n", absPos, (int)size));
-			}
+			//DEBUG(printf("New value written - pos %d - size %d\n", begin, (int)size));
 		}
 
 		cur = cur->next;
 	}
 
 	// mark all retired regions not to be the last writer
-	// for all retired regions => marke value as being alive
 	irt_cap_region_list* it = irt_g_cap_region_list;
 	while(it != NULL) {
 		if (!it->region.active) { 	// region has retired
 
-			irt_cap_block_usage_info* info = irt_cap_get_usage_info(&(it->region), pos);
+			irt_cap_block_usage_info* info = irt_cap_get_usage_info(&(it->region), block);
 			if (info) {
+				irt_spin_lock(&info->lock);
 
-				int offset = ((uint64)pos - (uint64)info->block->base)/sizeof(char);
-
-				// process each of the written bytes
-				for (int i = 0; i<size/sizeof(char); i++) {
-
-					int absPos = i + offset;
-
-					// request the lock
-					irt_spin_lock(&info->locks[absPos]);
+				// remove last-written flags
+				irt_cap_range_set_remove(&info->last_written, begin, end);
 
-					// remove last-written flag
-					info->last_written[absPos] = false;
+				// make sure, position has not been used as a pointer!
+				IRT_ASSERT(is_ptr || !irt_cap_range_set_intersects(&info->is_pointer, begin, end), IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
 
-					// make sure, position has not been used as a pointer!
-					IRT_ASSERT(is_ptr || !info->is_pointer[absPos], IRT_ERR_INTERNAL, "Cannot support mixture of values and pointers!");
+				DEBUG(printf("Life-out terminated - pos %d - size %d\n", begin, (int)size));
 
-					DEBUG(printf("Life-out terminated - pos %d - size %d\n", absPos, (int)size));
-
-					// release the lock
-					irt_spin_unlock(&info->locks[absPos]);
-				}
+				irt_spin_unlock(&info->lock);
 			}
 		}
 
@@ -639,15 +904,8 @@ void irt_cap_written_pointer(void** pos) {
 
 #define OUT(X) (tmp = X, fwrite((&tmp),sizeof(tmp), 1, f))
 
-uint32 irt_cap_count_mask_fragments(bool* marks, size_t size) {
-	uint32 counter = 0;
-	for(uint32 i=1; i<size-1; i++) {
-		if (marks[i-1] && !marks[i]) { // increment whenever a fragment is done
-			counter++;
-		}
-	}
-	if(marks[size-1]) counter++;
-	return counter;
+uint32 irt_cap_count_fragments(irt_cap_range_set* set) {
+	return set->size;
 }
 
 uint32 irt_cap_sum_of_block_sizes(irt_cap_block_usage_info* list) {
@@ -655,30 +913,13 @@ uint32 irt_cap_sum_of_block_sizes(irt_cap_block_usage_info* list) {
 	return list->block->size + irt_cap_sum_of_block_sizes(list->next);
 }
 
-void irt_cap_output_append_data_fragments(char* data, bool* flags, size_t size, FILE* f) {
+void irt_cap_output_append_data_fragments(char* data, irt_cap_range_set* set, FILE* f) {
 	uint32 tmp; // used by write macro
 
-	int start = -1;
-	for(uint32 i=0; i<size; i++) {
-		if (flags[i] && start == -1) {
-			// start new fragment
-			start = i;
-		} else if (!flags[i] && start != -1) {
-			// write fragment data
-			uint32 length = (size_t)(i - start);
-			OUT(start);
-			OUT(length);
-
-			if (data) fwrite(&(data[start]),sizeof(char), length, f);
-
-			DEBUG(printf("Safed Fragment from %d - size %d.\n", start, (int)length));
-
-			start = -1;
-		}
-	}
-	if(flags[size-1]) {
+	for(uint32 i=0; i<set->size; i++) {
 		// write fragment data
-		uint32 length = (size_t)(size - start);
+		uint32 start = set->ranges[i].begin;
+		uint32 length = set->ranges[i].end - start;
 		OUT(start);
 		OUT(length);
 
@@ -688,8 +929,8 @@ void irt_cap_output_append_data_fragments(char* data, bool* flags, size_t size,
 	}
 }
 
-void irt_cap_output_append_mask_fragments(bool* flags, size_t size, FILE* f) {
-	irt_cap_output_append_data_fragments(NULL, flags, size, f);
+void irt_cap_output_append_mask_fragments(irt_cap_range_set* set, FILE* f) {
+	irt_cap_output_append_data_fragments(NULL, set, f);
 }
 
 uint32 irt_cap_get_num_regions() {
@@ -751,38 +992,36 @@ void irt_cap_profile_save() {
 			OUT(size);
 
 			// add number of life-in fragments
-			OUT(irt_cap_count_mask_fragments(info->read, size));
+			OUT(irt_cap_count_fragments(&info->read));
 
 			// add life-in fragments
-			irt_cap_output_append_data_fragments(info->life_in_values, info->read, size, f);
+			irt_cap_output_append_data_fragments(info->life_in_values, &info->read, f);
 
 		}
 
 		// write pointer information
 		for(irt_cap_block_usage_info* it2 = region->usage; it2 !=NULL; it2 = it2->next) {
 			irt_cap_block_usage_info* info = it2;
-			uint32 size = info->block->size;
 
 			// add number of pointer fragments
-			OUT(irt_cap_count_mask_fragments(info->is_pointer, size));
+			OUT(irt_cap_count_fragments(&info->is_pointer));
 
 			// add is_pointer fragments
-			irt_cap_output_append_mask_fragments(info->is_pointer, size, f);
+			irt_cap_output_append_mask_fragments(&info->is_pointer, f);
 		}
 
 //		// write life_out information
 //		for(irt_cap_block_usage_info* it2 = region->usage; it2 !=NULL; it2 = it2->next) {
 //			irt_cap_block_usage_info* info = it2;
-//			uint32 size = info->block->size;
 //
 //			// add block id
 //			OUT(info->block->id);
 //
 //			// add number of life-out fragments
-//			OUT(irt_cap_count_mask_fragments(info->is_life_out, size));
+//			OUT(irt_cap_count_fragments(&info->is_life_out));
 //
 //			// add life-out fragments
-//			irt_cap_output_append_data_fragments(info->life_out_values, info->is_life_out, size, f);
+//			irt_cap_output_append_data_fragments(info->life_out_values, &info->is_life_out, f);
 //		}
 	}
 
@@ -59,6 +59,26 @@ typedef struct {
 } irt_cap_data_block_info;
 
 
+/**
+ * A range of bytes [begin, end) within a data block.
+ */
+typedef struct {
+	uint32 begin;
+	uint32 end;
+} irt_cap_range;
+
+/**
+ * A set of bytes within a data block, represented by a sorted list of disjoint,
+ * non-adjacent ranges. It replaces per-byte flag masks, since accesses tend to
+ * cover contiguous parts of blocks.
+ */
+typedef struct {
+	irt_cap_range* ranges;		// the ranges within this set, sorted by their begin
+	uint32 size;				// the number of ranges within this set
+	uint32 capacity;			// the number of ranges the list may hold before it has to grow
+} irt_cap_range_set;
+
+
 /**
  * A struct summarizing the usage of a block being accessed by a region. For every region,
  * the read / write operations on every block element is recorded.
@@ -69,22 +89,26 @@ typedef struct _irt_cap_block_usage_info {
 
 	int32 tag;					// the user defined tag identifying this region (negative if untagged)
 
-	irt_spinlock* locks;  // a list of locks for synchronous access
+	irt_spinlock lock;  		// a lock for synchronous access
 
 	char* life_in_values;		// the life_in_values of the block when being read the first time when entering a region
-	bool* read;					// a flag mask marking read values
+	irt_cap_range_set read;		// the set of read values
 
-	bool* is_pointer;			// a flag mask marking data being interpreted as pointers
+	irt_cap_range_set is_pointer;	// the set of data being interpreted as pointers
 
 	char* life_out_values;		// the data written to the memory cells within the region
-	bool* last_written;			// a flag mask marking values been written last by the corrsponding region
+	irt_cap_range_set last_written;	// the set of values been written last by the corrsponding region
 
-	bool* is_life_out;			// a flag mask marking written values being read after the region
+	irt_cap_range_set is_life_out;	// the set of written values being read after the region
 
 	struct _irt_cap_block_usage_info* next; 	// enables this struct to be used within a list
+	struct _irt_cap_block_usage_info* volatile next_in_bucket;	// the successor within the usage index of the region
 
 } irt_cap_block_usage_info;
 
+// the number of buckets of the per-region index of block usage infos
+#define IRT_CAP_USAGE_INDEX_SIZE 256
+
 
 /**
  * A struct representing a code region within the context capturing. A region
@@ -96,6 +120,7 @@ typedef struct {
 	bool active;								// a flag indicating wheather this region is currently active or not
 	irt_spinlock lock;					// a lock used to protect the usage list
 	irt_cap_block_usage_info* volatile usage;	// a list of data block usage information maintained per accessed block
+	irt_cap_block_usage_info* volatile usage_index[IRT_CAP_USAGE_INDEX_SIZE];	// the usage information hashed by block ID
 } irt_cap_region;
 
 
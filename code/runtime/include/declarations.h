@@ -99,6 +99,7 @@ typedef union _irt_joinable irt_joinable;
 /* ------------------------------ locking ----- */
 
 typedef struct _irt_lock irt_lock;
+typedef struct _irt_rwlock irt_rwlock;
 
 /* ------------------------------ loop scheduling ----- */
 
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+#ifndef __GUARD_IMPL_INSTRUMENTATION_EVENT_TRACE_IMPL_H
+#define __GUARD_IMPL_INSTRUMENTATION_EVENT_TRACE_IMPL_H
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "instrumentation_event_trace.h"
+
+#define IRT_INST_EVENT_TRACE_VARINT_MAX_BYTES 10
+#define IRT_INST_EVENT_TRACE_BUFFER_SIZE 4096
+
+static inline uint32 _irt_inst_event_trace_put_varint(unsigned char* buffer, uint64 value) {
+	uint32 length = 0;
+	while(value >= 0x80) {
+		buffer[length++] = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	buffer[length++] = (unsigned char)value;
+	return length;
+}
+
+static inline bool _irt_inst_event_trace_get_varint(FILE* file, uint64* value) {
+	uint64 result = 0;
+	for(uint32 shift = 0; shift < 7 * IRT_INST_EVENT_TRACE_VARINT_MAX_BYTES; shift += 7) {
+		int byte = fgetc(file);
+		if(byte == EOF)
+			return false;
+		result |= (uint64)(byte & 0x7F) << shift;
+		if(!(byte & 0x80)) {
+			*value = result;
+			return true;
+		}
+	}
+	return false; // malformed
+}
+
+void irt_inst_event_trace_write_header(FILE* file) {
+	const uint64 unknown_ticks_per_sec = 0;
+	fwrite(IRT_INST_EVENT_TRACE_VERSION, 1, strlen(IRT_INST_EVENT_TRACE_VERSION), file);
+	fwrite(&unknown_ticks_per_sec, sizeof(uint64), 1, file);
+	fwrite(&(irt_g_inst_num_event_types), sizeof(uint32), 1, file);
+	for(uint32 i = 0; i < irt_g_inst_num_event_types; ++i) {
+		fprintf(file, "%-4s", irt_g_instrumentation_group_names[i]);
+		fprintf(file, "%-60s", irt_g_instrumentation_event_names[i]);
+	}
+}
+
+void irt_inst_event_trace_write_block(FILE* file, const irt_instrumentation_event_data* events, uint32 count, uint64* last_timestamp) {
+	unsigned char buffer[IRT_INST_EVENT_TRACE_BUFFER_SIZE];
+	uint32 length = _irt_inst_event_trace_put_varint(buffer, count);
+	uint64 previous = *last_timestamp;
+
+	for(uint32 i = 0; i < count; ++i) {
+		// flush if the next event might not fit anymore
+		if(length + 4 * IRT_INST_EVENT_TRACE_VARINT_MAX_BYTES > IRT_INST_EVENT_TRACE_BUFFER_SIZE) {
+			fwrite(buffer, 1, length, file);
+			length = 0;
+		}
+		// timestamps of a worker are not guaranteed to be monotonic, hence zigzag encode the signed difference
+		int64 delta = (int64)(events[i].timestamp - previous);
+		length += _irt_inst_event_trace_put_varint(buffer + length, ((uint64)delta << 1) ^ (uint64)(delta >> 63));
+		length += _irt_inst_event_trace_put_varint(buffer + length, events[i].event_id);
+		length += _irt_inst_event_trace_put_varint(buffer + length, events[i].thread);
+		length += _irt_inst_event_trace_put_varint(buffer + length, events[i].index);
+		previous = events[i].timestamp;
+	}
+
+	fwrite(buffer, 1, length, file);
+	*last_timestamp = previous;
+}
+
+void irt_inst_event_trace_write_ticks_per_sec(FILE* file, uint64 ticks_per_sec) {
+	long position = ftell(file);
+	fseek(file, strlen(IRT_INST_EVENT_TRACE_VERSION), SEEK_SET);
+	fwrite(&ticks_per_sec, sizeof(uint64), 1, file);
+	fseek(file, position, SEEK_SET);
+}
+
+bool irt_inst_event_trace_open(irt_inst_event_trace_reader* reader, FILE* file) {
+	char version[sizeof(IRT_INST_EVENT_TRACE_VERSION)] = { 0 };
+	memset(reader, 0, sizeof(irt_inst_event_trace_reader));
+	reader->file = file;
+
+	if(fread(version, 1, strlen(IRT_INST_EVENT_TRACE_VERSION), file) != strlen(IRT_INST_EVENT_TRACE_VERSION) || strcmp(version, IRT_INST_EVENT_TRACE_VERSION) != 0)
+		return false;
+	if(fread(&reader->ticks_per_sec, sizeof(uint64), 1, file) != 1 || fread(&reader->num_event_types, sizeof(uint32), 1, file) != 1)
+		return false;
+
+	reader->group_names = (char(*)[IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH+1])calloc(reader->num_event_types, IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH+1);
+	reader->event_names = (char(*)[IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH+1])calloc(reader->num_event_types, IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH+1);
+	for(uint32 i = 0; i < reader->num_event_types; ++i) {
+		if(fread(reader->group_names[i], 1, IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH, file) != IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH
+				|| fread(reader->event_names[i], 1, IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH, file) != IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH)
+			return false;
+		// strip the padding
+		for(int32 j = IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH-1; j >= 0 && reader->group_names[i][j] == ' '; --j)
+			reader->group_names[i][j] = '\0';
+		for(int32 j = IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH-1; j >= 0 && reader->event_names[i][j] == ' '; --j)
+			reader->event_names[i][j] = '\0';
+	}
+	return true;
+}
+
+bool irt_inst_event_trace_next(irt_inst_event_trace_reader* reader, irt_instrumentation_event_data* event) {
+	uint64 delta, event_id, thread, index;
+	// skip to the next non-empty block
+	while(reader->remaining_block_events == 0)
+		if(!_irt_inst_event_trace_get_varint(reader->file, &reader->remaining_block_events))
+			return false;
+
+	if(!_irt_inst_event_trace_get_varint(reader->file, &delta) || !_irt_inst_event_trace_get_varint(reader->file, &event_id)
+			|| !_irt_inst_event_trace_get_varint(reader->file, &thread) || !_irt_inst_event_trace_get_varint(reader->file, &index))
+		return false;
+
+	reader->last_timestamp += (uint64)((int64)(delta >> 1) ^ -(int64)(delta & 1));
+	reader->remaining_block_events--;
+	event->timestamp = reader->last_timestamp;
+	event->event_id = (uint16)event_id;
+	event->thread = (uint16)thread;
+	event->index = (uint32)index;
+	return true;
+}
+
+void irt_inst_event_trace_close(irt_inst_event_trace_reader* reader) {
+	free(reader->group_names);
+	free(reader->event_names);
+	reader->group_names = NULL;
+	reader->event_names = NULL;
+}
+
+#endif // #ifndef __GUARD_IMPL_INSTRUMENTATION_EVENT_TRACE_IMPL_H
@@ -47,6 +47,7 @@
 #include "utils/timing.h"
 #include "instrumentation_events.h"
 #include "impl/error_handling.impl.h"
+#include "impl/instrumentation_event_trace.impl.h"
 
 #ifdef IRT_ENABLE_INSTRUMENTATION
 
@@ -67,21 +68,191 @@ void _irt_inst_event_data_table_resize(irt_instrumentation_event_data_table* tab
 	IRT_ASSERT(table->data != NULL, IRT_ERR_INSTRUMENTATION, "Instrumentation: Could not perform realloc for event instrumentation data table: %s", strerror(errno))
 }
 
+// ======================= streaming output ==========================================
+
+// opens the trace file of a worker and writes the header
+FILE* _irt_inst_event_stream_open(irt_worker* worker) {
+	char outputfilename[IRT_INST_OUTPUT_PATH_CHAR_SIZE];
+	char defaultoutput[] = ".";
+	char* outputprefix = defaultoutput;
+	if(getenv(IRT_INST_OUTPUT_PATH_ENV)) outputprefix = getenv(IRT_INST_OUTPUT_PATH_ENV);
+
+#ifndef _GEMS_SIM
+	struct stat st;
+	if(stat(outputprefix, &st) != 0)
+		mkdir(outputprefix, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+	IRT_ASSERT(stat(outputprefix, &st) == 0, IRT_ERR_INSTRUMENTATION, "Instrumentation: Error creating directory for event trace writing: %s", strerror(errno));
+#endif
+
+	sprintf(outputfilename, "%s/worker_event_trace.%04u", outputprefix, worker->id.thread);
+
+	FILE* outputfile = fopen(outputfilename, "wb");
+	IRT_ASSERT(outputfile != 0, IRT_ERR_INSTRUMENTATION, "Instrumentation: Unable to open file for event trace writing: %s", strerror(errno));
+
+	irt_inst_event_trace_write_header(outputfile);
+	return outputfile;
+}
+
+// passes the full block of a table to the writer thread and continues with the other block,
+// only waits if the writer has not yet written the other block to disk
+void _irt_inst_event_stream_hand_off(irt_instrumentation_event_data_table* table) {
+	irt_instrumentation_event_stream* stream = table->stream;
+	irt_instrumentation_event_stream_writer* writer = &irt_g_inst_event_stream_writer;
+	uint32 next = 1 - stream->current;
+
+	irt_mutex_lock(&writer->signal.mutex);
+	stream->pending_elements[stream->current] = table->number_of_elements;
+	irt_cond_wake_one(&writer->signal.condvar);
+	irt_mutex_unlock(&writer->signal.mutex);
+
+	while(stream->pending_elements[next] != 0)
+		irt_thread_yield();
+
+	stream->current = next;
+	table->data = stream->blocks[next];
+	table->number_of_elements = 0;
+}
+
+bool _irt_inst_event_stream_has_pending(irt_instrumentation_event_stream_writer* writer) {
+	for(uint32 i = 0; i < writer->num_tables; ++i) {
+		irt_instrumentation_event_data_table* table = writer->tables[i];
+		if(table && (table->stream->pending_elements[0] != 0 || table->stream->pending_elements[1] != 0))
+			return true;
+	}
+	return false;
+}
+
+// writes all blocks handed over by the workers, returns whether there were any
+bool _irt_inst_event_stream_write_pending(irt_instrumentation_event_stream_writer* writer) {
+	bool written = false;
+	for(uint32 i = 0; i < writer->num_tables; ++i) {
+		irt_instrumentation_event_data_table* table = writer->tables[i];
+		if(!table)
+			continue;
+		irt_instrumentation_event_stream* stream = table->stream;
+		// if both blocks are pending, the worker is waiting for the one it does not own, which is the older one
+		uint32 first = 1 - stream->current;
+		for(uint32 j = 0; j < 2; ++j) {
+			uint32 block = (first + j) % 2;
+			uint32 count = stream->pending_elements[block];
+			if(count == 0)
+				continue;
+			irt_inst_event_trace_write_block(stream->file, stream->blocks[block], count, &stream->last_timestamp);
+			// release the block to the worker
+			irt_atomic_bool_compare_and_swap(&stream->pending_elements[block], count, 0, uint32);
+			written = true;
+		}
+	}
+	return written;
+}
+
+void* _irt_inst_event_stream_writer_func(void* arg) {
+	irt_instrumentation_event_stream_writer* writer = (irt_instrumentation_event_stream_writer*)arg;
+	bool done = false;
+	while(!done) {
+		if(_irt_inst_event_stream_write_pending(writer))
+			continue;
+		irt_mutex_lock(&writer->signal.mutex);
+		bool pending = _irt_inst_event_stream_has_pending(writer);
+		if(!pending && writer->running)
+			irt_cond_wait(&writer->signal.condvar, &writer->signal.mutex);
+		done = !pending && !writer->running;
+		irt_mutex_unlock(&writer->signal.mutex);
+	}
+	return NULL;
+}
+
+// starts the background writer thread, needs to be called before any worker creates its event table
+void irt_inst_event_stream_start() {
+	irt_instrumentation_event_stream_writer* writer = &irt_g_inst_event_stream_writer;
+	if(writer->running)
+		return;
+	writer->running = true;
+	writer->num_tables = 0;
+	for(uint32 i = 0; i < IRT_MAX_WORKERS; ++i)
+		writer->tables[i] = NULL;
+	irt_cond_bundle_init(&writer->signal);
+	irt_thread_create(&_irt_inst_event_stream_writer_func, writer, &writer->thread);
+}
+
+// writes the remaining events of all workers, stops the writer thread and closes all trace files
+void irt_inst_event_stream_finalize() {
+	irt_instrumentation_event_stream_writer* writer = &irt_g_inst_event_stream_writer;
+	if(!writer->running)
+		return;
+
+	// workers are already shut down, hence their partially filled blocks can be handed over
+	for(uint32 i = 0; i < writer->num_tables; ++i) {
+		irt_instrumentation_event_data_table* table = writer->tables[i];
+		if(table && table->number_of_elements > 0)
+			_irt_inst_event_stream_hand_off(table);
+	}
+
+	irt_mutex_lock(&writer->signal.mutex);
+	writer->running = false;
+	irt_cond_wake_one(&writer->signal.condvar);
+	irt_mutex_unlock(&writer->signal.mutex);
+	irt_thread_join(&writer->thread);
+
+	for(uint32 i = 0; i < writer->num_tables; ++i) {
+		irt_instrumentation_event_data_table* table = writer->tables[i];
+		if(!table)
+			continue;
+		irt_inst_event_trace_write_ticks_per_sec(table->stream->file, irt_g_time_ticks_per_sec);
+		fclose(table->stream->file);
+		table->stream->file = NULL;
+		writer->tables[i] = NULL;
+	}
+	writer->num_tables = 0;
+	irt_cond_bundle_destroy(&writer->signal);
+}
+
 // =============== functions for creating and destroying performance tables ===============
 
 // allocates memory for performance data, sets all fields
-irt_instrumentation_event_data_table* irt_inst_create_event_data_table() {
+irt_instrumentation_event_data_table* irt_inst_create_event_data_table(irt_worker* worker) {
 	irt_instrumentation_event_data_table* table = (irt_instrumentation_event_data_table*)malloc(sizeof(irt_instrumentation_event_data_table));
-	table->size = IRT_INST_WORKER_PD_BLOCKSIZE * 2;
 	table->number_of_elements = 0;
-	table->data = (irt_instrumentation_event_data*)malloc(sizeof(irt_instrumentation_event_data) * table->size);
+	table->stream = NULL;
+
+	if(!irt_g_instrumentation_event_output_is_streaming) {
+		table->size = IRT_INST_WORKER_PD_BLOCKSIZE * 2;
+		table->data = (irt_instrumentation_event_data*)malloc(sizeof(irt_instrumentation_event_data) * table->size);
+		return table;
+	}
+
+	// streaming output: two fixed-size blocks instead of a growing table
+	irt_instrumentation_event_stream* stream = (irt_instrumentation_event_stream*)malloc(sizeof(irt_instrumentation_event_stream));
+	for(uint32 i = 0; i < 2; ++i) {
+		stream->blocks[i] = (irt_instrumentation_event_data*)malloc(sizeof(irt_instrumentation_event_data) * IRT_INST_WORKER_EVENT_STREAM_BLOCKSIZE);
+		stream->pending_elements[i] = 0;
+	}
+	stream->current = 0;
+	stream->file = _irt_inst_event_stream_open(worker);
+	stream->last_timestamp = 0;
+	table->stream = stream;
+	table->size = IRT_INST_WORKER_EVENT_STREAM_BLOCKSIZE;
+	table->data = stream->blocks[0];
+
+	// register with the writer thread
+	irt_instrumentation_event_stream_writer* writer = &irt_g_inst_event_stream_writer;
+	irt_mutex_lock(&writer->signal.mutex);
+	writer->tables[worker->id.thread] = table;
+	if(worker->id.thread >= writer->num_tables)
+		writer->num_tables = worker->id.thread + 1;
+	irt_mutex_unlock(&writer->signal.mutex);
 	return table;
 }
 
 // frees allocated memory
 void irt_inst_destroy_event_data_table(irt_instrumentation_event_data_table* table) {
 	if(table != NULL) {
-		if(table->data != NULL)
+		if(table->stream != NULL) {
+			free(table->stream->blocks[0]);
+			free(table->stream->blocks[1]);
+			free(table->stream);
+		} else if(table->data != NULL)
 			free(table->data);
 		free(table);
 	}
@@ -92,8 +263,12 @@ void _irt_inst_event_insert_time(irt_worker* worker, const int event, const uint
 
 	IRT_ASSERT(table->number_of_elements <= table->size, IRT_ERR_INSTRUMENTATION, "Instrumentation: Number of event table entries larger than table size")
 
-	if(table->number_of_elements >= table->size)
-		_irt_inst_event_data_table_resize(table);
+	if(table->number_of_elements >= table->size) {
+		if(table->stream)
+			_irt_inst_event_stream_hand_off(table);
+		else
+			_irt_inst_event_data_table_resize(table);
+	}
 
 	irt_instrumentation_event_data* pd = &(table->data[table->number_of_elements]);
 
@@ -401,6 +576,16 @@ void irt_inst_set_all_instrumentation_from_env() {
 			irt_log_setting_s(IRT_INST_BINARY_OUTPUT_ENV, "disabled");
 		}
 
+		// set whether events are streamed to disk while running instead of being dumped at shutdown
+		if(getenv(IRT_INST_STREAMING_OUTPUT_ENV) && (strcmp(getenv(IRT_INST_STREAMING_OUTPUT_ENV), "enabled") == 0)) {
+			irt_g_instrumentation_event_output_is_streaming = true;
+			irt_log_setting_s(IRT_INST_STREAMING_OUTPUT_ENV, "enabled");
+			irt_inst_event_stream_start();
+		} else {
+			irt_g_instrumentation_event_output_is_streaming = false;
+			irt_log_setting_s(IRT_INST_STREAMING_OUTPUT_ENV, "disabled");
+		}
+
 		char* types = getenv(IRT_INST_WORKER_EVENT_TYPES_ENV);
 		if(!types || strcmp(types, "") == 0) {
 			irt_inst_set_all_instrumentation(true);
@@ -442,6 +627,7 @@ void irt_inst_set_all_instrumentation_from_env() {
 		return;
 	}
 	irt_inst_set_all_instrumentation(false);
+	irt_g_instrumentation_event_output_is_streaming = false;
 	irt_log_setting_s(IRT_INST_WORKER_EVENT_LOGGING_ENV, "disabled");
 }
 
@@ -449,7 +635,7 @@ void irt_inst_set_all_instrumentation_from_env() {
 
 // ============ to be used if IRT_ENABLE_INSTRUMENTATION is not set ==============
 
-irt_instrumentation_event_data_table* irt_inst_create_event_data_table() { return NULL; }
+irt_instrumentation_event_data_table* irt_inst_create_event_data_table(irt_worker* worker) { return NULL; }
 void irt_inst_destroy_event_data_table(irt_instrumentation_event_data_table* table) {}
 
 void irt_inst_insert_wi_event(irt_worker* worker, irt_instrumentation_event event, irt_work_item_id subject_id) {}
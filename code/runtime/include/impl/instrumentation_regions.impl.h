@@ -87,10 +87,68 @@ irt_inst_region_context_data* _irt_inst_region_stack_pop(irt_work_item* wi) {
 	return retval;
 }
 
+// stamp used to determine the most recent value of NONE-aggregated metrics across workers
+volatile uint64 irt_g_inst_region_sequence = 0;
+
+void _irt_inst_region_ring_buffer_init(irt_inst_region_ring_buffer* rb, uint32 slot_size) {
+	rb->slot_size = slot_size;
+	for(uint32 i = 0; i < IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS; ++i) {
+		rb->segments[i] = NULL;
+		rb->retired[i] = 0;
+	}
+}
+
+void _irt_inst_region_ring_buffer_cleanup(irt_inst_region_ring_buffer* rb) {
+	for(uint32 i = 0; i < IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS; ++i)
+		free(rb->segments[i]);
+}
+
+// get the slot of a running index, allocating its segment if this is the first access to it
+volatile void* _irt_inst_region_ring_buffer_get(irt_inst_region_ring_buffer* rb, uint64 index) {
+	uint32 segment = (index / IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE) % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS;
+	void* data = rb->segments[segment];
+	if(!data) {
+		void* fresh = calloc(IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE, rb->slot_size);
+		if(irt_atomic_bool_compare_and_swap((uintptr_t*)&rb->segments[segment], (uintptr_t)0, (uintptr_t)fresh, uintptr_t)) {
+			data = fresh;
+		} else {
+			// someone else was faster
+			free(fresh);
+			data = rb->segments[segment];
+		}
+	}
+	return (volatile char*)data + (index % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE) * rb->slot_size;
+}
+
+// mark the slot of a running index as no longer used, the last retired slot of a segment frees it
+void _irt_inst_region_ring_buffer_retire(irt_inst_region_ring_buffer* rb, uint64 index) {
+	uint32 segment = (index / IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE) % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS;
+	if(irt_atomic_add_and_fetch(&rb->retired[segment], 1, uint32) == IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE) {
+		void* data = rb->segments[segment];
+		rb->retired[segment] = 0;
+		rb->segments[segment] = NULL;
+		free(data);
+	}
+}
+
+// get the region accumulators of the given worker, allocated on first use
+irt_inst_region_worker_data* _irt_inst_region_get_worker_data(irt_context* context, irt_worker* worker) {
+	IRT_ASSERT(worker->id.thread < IRT_MAX_WORKERS, IRT_ERR_INSTRUMENTATION, "Worker id %u exceeds IRT_MAX_WORKERS", worker->id.thread)
+	irt_inst_region_worker_data* data = context->inst_region_worker_data[worker->id.thread];
+	if(!data) {
+		// pad by a cache line on both ends such that no other allocation shares a cache line with the accumulators
+		char* block = (char*)calloc(1, context->num_regions * sizeof(irt_inst_region_worker_data) + 2 * 64);
+		data = (irt_inst_region_worker_data*)(block + 64);
+		context->inst_region_worker_data[worker->id.thread] = data;
+	}
+	return data;
+}
+
 void _irt_inst_region_start_early_entry_measurements(irt_work_item* wi) {
 //	printf("current id: %u, current entries: %llu\n", irt_inst_region_get_current(wi)->id, wi->wg_memberships[0].wg_id.cached->region_data_entries[irt_inst_region_get_current(wi)->id]);
-	uint32 index = wi->wg_memberships[0].wg_id.cached->region_data_entries[irt_inst_region_get_current(wi)->id]++;
-	volatile irt_inst_region_wi_data* rg = &wi->wg_memberships[0].wg_id.cached->region_data[irt_inst_region_get_current(wi)->id][index % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE];
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
+	uint64 index = irt_atomic_fetch_and_add(&wg->region_data_entries[irt_inst_region_get_current(wi)->id], 1, uint64);
+	volatile irt_inst_region_wi_data* rg = (volatile irt_inst_region_wi_data*)_irt_inst_region_ring_buffer_get(&wg->region_data[irt_inst_region_get_current(wi)->id], index);
 //	irt_inst_region_context_data* rg = irt_inst_region_get_current(wi);
 	irt_context* context = irt_context_table_lookup(wi->context_id);
 #pragma GCC diagnostic push
@@ -115,8 +173,9 @@ void _irt_inst_region_end_late_exit_measurements(irt_work_item* wi) {
 	irt_inst_region_list* list = wi->inst_region_list;
 	uint64 length = list->length;
 	IRT_ASSERT(length > 0, IRT_ERR_INSTRUMENTATION, "Tried to get region data from a WI that has no region data")
-	uint32 index = wi->wg_memberships[0].wg_id.cached->region_data_exits[irt_inst_region_get_current(wi)->id]++;
-	volatile irt_inst_region_wi_data* rg = &wi->wg_memberships[0].wg_id.cached->region_data[irt_inst_region_get_current(wi)->id][index % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE];
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
+	uint64 index = irt_atomic_fetch_and_add(&wg->region_data_exits[irt_inst_region_get_current(wi)->id], 1, uint64);
+	volatile irt_inst_region_wi_data* rg = (volatile irt_inst_region_wi_data*)_irt_inst_region_ring_buffer_get(&wg->region_data[irt_inst_region_get_current(wi)->id], index);
 //	printf("region %u %u end start: last %llu\n", irt_inst_region_get_current(wi)->id, index, rg->last_wall_time);
 	irt_context* context = irt_context_table_lookup(wi->context_id);
 #define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
@@ -138,27 +197,28 @@ void _irt_inst_region_end_late_exit_measurements(irt_work_item* wi) {
 	}
 #include "irt_metrics.def"
 //	printf("region %u %u end end: aggregated %llu, using last %p\n", irt_inst_region_get_current(wi)->id, index, rg->aggregated_wall_time, (void*) &rg->last_wall_time);
-	irt_inst_region_context_data* current_region = irt_inst_region_get_current(wi);
-	irt_spin_lock(&(current_region->lock));
+	// fold into the accumulators of the current worker, no locking required
+	irt_inst_region_worker_data* cur = &_irt_inst_region_get_worker_data(context, irt_worker_get_current())[irt_inst_region_get_current(wi)->id];
 #define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
 	/* only propagate metrics that were touched by late exit measurements (i.e. only EE/LE metrics) */ \
 	if(rg->aggregated_##_name__ != old_aggregated_##_name__) {	\
 		switch(_aggregation__) { \
 			case IRT_METRIC_AGGREGATOR_AVG: \
-				current_region->aggregated_##_name__ = (current_region->aggregated_##_name__ * current_region->num_executions + rg->aggregated_##_name__) / (current_region->num_executions + 1); \
+				cur->sum_##_name__ += rg->aggregated_##_name__; \
+				cur->count_##_name__++; \
 				break; \
 			case IRT_METRIC_AGGREGATOR_NONE: \
-				current_region->aggregated_##_name__ = rg->aggregated_##_name__; \
-                break; \
+				cur->aggregated_##_name__ = rg->aggregated_##_name__; \
+				cur->count_##_name__ = irt_atomic_add_and_fetch(&irt_g_inst_region_sequence, 1, uint64); \
+				break; \
 			case IRT_METRIC_AGGREGATOR_SUM: \
 			default: \
-				current_region->aggregated_##_name__ += rg->aggregated_##_name__; \
+				cur->aggregated_##_name__ += rg->aggregated_##_name__; \
 		} \
-		/*current_region->aggregated_##_name__ += rg->aggregated_##_name__;*/ /* current_region->aggregated_##_name__ += rg->aggregated_##_name__ - old_aggregated_##_name__;*/ \
 		rg->aggregated_##_name__ = 0; \
 	}
 #include "irt_metrics.def"
-	irt_spin_unlock(&(current_region->lock));
+	_irt_inst_region_ring_buffer_retire(&wg->region_data[irt_inst_region_get_current(wi)->id], index);
 }
 #pragma GCC diagnostic pop // needs to be done after ending the function scope
 
@@ -240,26 +300,24 @@ void irt_inst_region_wg_init(irt_work_group* wg) {
 	irt_context* context = irt_context_get_current();
 	wg->regions_ended = 0;
 	wg->regions_started = 0;
-	wg->region_data = (volatile irt_inst_region_wi_data**)malloc(sizeof(irt_inst_region_wi_data*) * context->num_regions);
+	wg->region_data = (irt_inst_region_ring_buffer*)malloc(sizeof(irt_inst_region_ring_buffer) * context->num_regions);
 	wg->region_data_entries = (volatile uint64*)malloc(sizeof(uint64) * context->num_regions);
 	wg->region_data_exits = (volatile uint64*)malloc(sizeof(uint64) * context->num_regions);
-	memset((void*)wg->region_completions_required, 0, sizeof(uint64)*IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE);
+	_irt_inst_region_ring_buffer_init(&wg->region_completions_required, sizeof(uint64));
 	memset((void*)wg->region_data_entries, 0, sizeof(uint64)*context->num_regions);
 	memset((void*)wg->region_data_exits, 0, sizeof(uint64)*context->num_regions);
-	for(uint32 i = 0; i < context->num_regions; ++i) {
-		wg->region_data[i] = (irt_inst_region_wi_data*)malloc(sizeof(irt_inst_region_wi_data) * IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE);
-		memset((void*)wg->region_data[i], 0, sizeof(uint64)*IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE);
-	}
+	for(uint32 i = 0; i < context->num_regions; ++i)
+		_irt_inst_region_ring_buffer_init(&wg->region_data[i], sizeof(irt_inst_region_wi_data));
 }
 
 void irt_inst_region_wg_finalize(irt_work_group* wg) {
 	free((void*)wg->region_data_entries);
 	free((void*)wg->region_data_exits);
 	irt_context* context = irt_context_get_current();
-	for(uint32 i = 0; i < context->num_regions; ++i) {
-		free((void*)wg->region_data[i]);
-	}
+	for(uint32 i = 0; i < context->num_regions; ++i)
+		_irt_inst_region_ring_buffer_cleanup(&wg->region_data[i]);
 	free(wg->region_data);
+	_irt_inst_region_ring_buffer_cleanup(&wg->region_completions_required);
 }
 
 void irt_inst_region_init(irt_context* context) {
@@ -273,6 +331,7 @@ void irt_inst_region_init(irt_context* context) {
 		context->inst_region_data[i].aggregated_##_name__ = 0;
 #include "irt_metrics.def"
 	}
+	context->inst_region_worker_data = (irt_inst_region_worker_data**)calloc(IRT_MAX_WORKERS, sizeof(irt_inst_region_worker_data*));
 	_irt_inst_region_metrics_init(context);
 	irt_inst_region_select_metrics_from_env();
 }
@@ -284,11 +343,17 @@ void irt_inst_region_init_worker(irt_worker* worker) {
 void irt_inst_region_finalize(irt_context* context) {
 	_irt_inst_region_metrics_finalize(context);
 	irt_time_ticks_per_sec_calibration_mark(); // needs to be done before any time instrumentation processing!
+	irt_inst_region_merge(context);
 	irt_inst_region_output();
 	//irt_inst_region_debug_output();
 	for(uint32 i = 0; i < context->num_regions; ++i) {
 		irt_spin_destroy(&context->inst_region_data[i].lock);
 	}
+	for(uint32 i = 0; i < IRT_MAX_WORKERS; ++i) {
+		if(context->inst_region_worker_data[i])
+			free((char*)context->inst_region_worker_data[i] - 64);
+	}
+	free(context->inst_region_worker_data);
 	free(context->inst_region_data);
 }
 
@@ -298,33 +363,93 @@ void irt_inst_region_finalize_worker(irt_worker* worker) {
 
 void irt_inst_region_propagate_data_from_wi_to_regions(irt_work_item* wi) {
 	irt_inst_region_list* list = wi->inst_region_list;
+	irt_inst_region_worker_data* worker_data = NULL;
+	if(list->length > 0)
+		worker_data = _irt_inst_region_get_worker_data(irt_context_table_lookup(wi->context_id), irt_worker_get_current());
 
 	for(uint64 i = 0; i < list->length; ++i) {
 		irt_inst_region_context_data* cur_region = list->items[i];
 
 		IRT_ASSERT(cur_region, IRT_ERR_INSTRUMENTATION, "Tried to get region data from a WI that has no region data")
 
-		irt_spin_lock(&(cur_region->lock));
+		irt_inst_region_worker_data* cur = &worker_data[cur_region->id];
 #define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
 		switch(_aggregation__) { \
 		case IRT_METRIC_AGGREGATOR_NONE: \
 			/* special case e.g. for region-only instrumentation that do not require WI measurements or aggregation */ \
 			break; \
 		case IRT_METRIC_AGGREGATOR_AVG: \
-			cur_region->aggregated_##_name__ = (cur_region->aggregated_##_name__ * cur_region->num_executions + wi->inst_region_data->aggregated_##_name__) / (cur_region->num_executions + 1); \
+			cur->sum_##_name__ += wi->inst_region_data->aggregated_##_name__; \
+			cur->count_##_name__++; \
 			break; \
 		case IRT_METRIC_AGGREGATOR_SUM: \
 		default: \
-			cur_region->aggregated_##_name__ += wi->inst_region_data->aggregated_##_name__; \
+			cur->aggregated_##_name__ += wi->inst_region_data->aggregated_##_name__; \
 		}
 #include "irt_metrics.def"
-		irt_spin_unlock(&(cur_region->lock));
 	}
 #define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
 		wi->inst_region_data->aggregated_##_name__ = 0;
 #include "irt_metrics.def"
 }
 
+// fold the accumulators of all workers into the region data of the context, needs to be called before reading the latter
+void irt_inst_region_merge(irt_context* context) {
+	for(uint32 i = 0; i < context->num_regions; ++i) {
+		irt_inst_region_context_data* rg = &context->inst_region_data[i];
+		uint64 num_executions = 0;
+#define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
+		_data_type__ aggregated_##_name__ = 0; \
+		double sum_##_name__ = 0; \
+		uint64 count_##_name__ = 0;
+#include "irt_metrics.def"
+
+		for(uint32 w = 0; w < IRT_MAX_WORKERS; ++w) {
+			irt_inst_region_worker_data* worker_data = context->inst_region_worker_data[w];
+			if(!worker_data)
+				continue;
+			irt_inst_region_worker_data* cur = &worker_data[i];
+			num_executions += cur->num_executions;
+#define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
+			switch(_aggregation__) { \
+			case IRT_METRIC_AGGREGATOR_NONE: \
+				/* keep the most recently written value */ \
+				if(cur->count_##_name__ > count_##_name__) { \
+					aggregated_##_name__ = cur->aggregated_##_name__; \
+					count_##_name__ = cur->count_##_name__; \
+				} \
+				break; \
+			case IRT_METRIC_AGGREGATOR_AVG: \
+				sum_##_name__ += cur->sum_##_name__; \
+				count_##_name__ += cur->count_##_name__; \
+				break; \
+			case IRT_METRIC_AGGREGATOR_SUM: \
+			default: \
+				aggregated_##_name__ += cur->aggregated_##_name__; \
+			}
+#include "irt_metrics.def"
+		}
+
+		irt_spin_lock(&(rg->lock));
+		rg->num_executions = num_executions;
+#define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
+		switch(_aggregation__) { \
+		case IRT_METRIC_AGGREGATOR_NONE: \
+			if(count_##_name__ > 0) \
+				rg->aggregated_##_name__ = aggregated_##_name__; \
+			break; \
+		case IRT_METRIC_AGGREGATOR_AVG: \
+			rg->aggregated_##_name__ = count_##_name__ > 0 ? (_data_type__)(sum_##_name__ / count_##_name__) : 0; \
+			break; \
+		case IRT_METRIC_AGGREGATOR_SUM: \
+		default: \
+			rg->aggregated_##_name__ = aggregated_##_name__; \
+		}
+#include "irt_metrics.def"
+		irt_spin_unlock(&(rg->lock));
+	}
+}
+
 void irt_inst_region_start_measurements(irt_work_item* wi) {
 	if(wi->inst_region_list->length <= 0)
 		return;
@@ -395,16 +520,18 @@ void irt_inst_region_start(const irt_inst_region_id id) {
 
 	IRT_ASSERT(wi->num_groups > 0, IRT_ERR_INSTRUMENTATION, "Encountered a WI that is not member of any group")
 
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
 	wi->inst_region_data->region_entries++;
 
-	// lock while ring buffer is full
-	while(wi->inst_region_data->region_entries - wi->wg_memberships[0].wg_id.cached->regions_ended >= IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE);
+	// the ring buffer grows on demand, only lock if a member is so far ahead that all segments but one are in use
+	// (keeping one segment spare ensures a segment is completely retired before it is reused)
+	while(wi->inst_region_data->region_entries - wg->regions_ended >= IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE * (IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS - 1));
 
-	if(irt_atomic_bool_compare_and_swap(&wi->wg_memberships[0].wg_id.cached->regions_started, wi->inst_region_data->region_entries-1, wi->inst_region_data->region_entries, uint64)) {
+	if(irt_atomic_bool_compare_and_swap(&wg->regions_started, wi->inst_region_data->region_entries-1, wi->inst_region_data->region_entries, uint64)) {
 		// first
 		_irt_inst_region_stack_push(wi, inner_region);
 		_irt_inst_region_start_early_entry_measurements(wi);
-		wi->wg_memberships[0].wg_id.cached->region_completions_required[wi->inst_region_data->region_entries % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE] = wi->wg_memberships[0].wg_id.cached->local_member_count;
+		*(volatile uint64*)_irt_inst_region_ring_buffer_get(&wg->region_completions_required, wi->inst_region_data->region_entries-1) = wg->local_member_count;
 	} else {
 		// all others
 		_irt_inst_region_stack_push(wi, inner_region);
@@ -436,18 +563,21 @@ void irt_inst_region_end(const irt_inst_region_id id) {
 
 	// only increase count if wi is not member in any work group or has wg id == 0
 	if(wi->num_groups == 0 || (wi->num_groups > 0 && wi->wg_memberships[0].num == 0))
-		inner_region->num_executions++;
+		_irt_inst_region_get_worker_data(context, irt_worker_get_current())[inner_region->id].num_executions++;
 
-	wi->inst_region_data->region_exits++;
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
+	uint64 index = wi->inst_region_data->region_exits++;
+	volatile uint64* completions_required = (volatile uint64*)_irt_inst_region_ring_buffer_get(&wg->region_completions_required, index);
 
 	// lock until at least one WI has started the region
-	while(wi->wg_memberships[0].wg_id.cached->region_completions_required[wi->inst_region_data->region_exits % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE] <= 0);
+	while(*completions_required <= 0);
 
-	if(irt_atomic_sub_and_fetch(&wi->wg_memberships[0].wg_id.cached->region_completions_required[wi->inst_region_data->region_exits % IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE], 1, uint64) == 0) {
+	if(irt_atomic_sub_and_fetch(completions_required, 1, uint64) == 0) {
 		// last
 		_irt_inst_region_end_late_exit_measurements(wi);
 		_irt_inst_region_stack_pop(wi);
-		irt_atomic_inc(&wi->wg_memberships[0].wg_id.cached->regions_ended, uint64);
+		_irt_inst_region_ring_buffer_retire(&wg->region_completions_required, index);
+		irt_atomic_inc(&wg->regions_ended, uint64);
 	} else {
 		// all others
 		_irt_inst_region_stack_pop(wi);
@@ -518,6 +648,7 @@ void irt_inst_region_select_metrics_from_env() {
 void irt_inst_region_debug_output() {
 	irt_context* context = irt_context_get_current();
 	uint32 num_regions = context->num_regions;
+	irt_inst_region_merge(context);
 	printf("%u region(s):\n", num_regions);
 	for(uint32 i = 0; i < num_regions; ++i) {
 		irt_inst_region_context_data* rg = &context->inst_region_data[i];
@@ -614,6 +745,7 @@ void irt_inst_region_init_worker(irt_worker* worker) { }
 void irt_inst_region_finalize(irt_context* context) { }
 void irt_inst_region_finalize_worker(irt_worker* worker) { }
 void irt_inst_region_propagate_data_from_wi_to_regions(irt_work_item* wi) { }
+void irt_inst_region_merge(irt_context* context) { }
 
 void irt_inst_region_start_measurements(irt_work_item* wi) {
 #ifdef IRT_ENABLE_APP_TIME_ACCOUNTING
@@ -46,6 +46,7 @@
 #include "instrumentation_regions.h"
 #include "instrumentation_events.h"
 #include "wi_implementation.h"
+#include "irt_variant_selection.h"
 
 #include "utils/lookup_tables.h"
 
@@ -71,6 +72,7 @@ void irt_context_initialize(irt_context* context) {
 		context->init_fun(context);
 	}
 	irt_optimizer_context_startup(context);
+	irt_variant_selection_init(context);
 	irt_inst_region_init(context);
 }
 
@@ -85,13 +87,16 @@ irt_context* irt_context_create(irt_client_app* app, init_context_fun* init_fun,
 void irt_context_destroy(irt_context* context) {
 	irt_inst_region_finalize(context);
 #ifdef IRT_ENABLE_INSTRUMENTATION
-	if(irt_g_instrumentation_event_output_is_enabled)
+	if(irt_g_instrumentation_event_output_is_streaming)
+		irt_inst_event_stream_finalize();
+	else if(irt_g_instrumentation_event_output_is_enabled)
 		irt_inst_event_data_output_all(irt_g_instrumentation_event_output_is_binary);
 	for(uint32 i = 0; i < irt_g_worker_count; ++i)
 		irt_inst_destroy_event_data_table(irt_g_workers[i]->instrumentation_event_data);
 #endif
 
 	irt_optimizer_context_destroy(context);
+	irt_variant_selection_finalize(context);
 
 	if (context->cleanup_fun) {
 		context->cleanup_fun(context);
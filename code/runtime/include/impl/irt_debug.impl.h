@@ -112,6 +112,8 @@ void irt_dbg_print_worker_state(int32 wid) {
 	printf("Worker #%03d: %32s - q:%4d || ", wid, irt_dbg_get_worker_state_string(irt_atomic_load(&irt_g_workers[wid]->state)),
 #if IRT_SCHED_POLICY == IRT_SCHED_POLICY_UBER
 		irt_cwb_size(&irt_g_workers[wid]->sched_data.queue)
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV
+		(int)irt_cld_size(&irt_g_workers[wid]->sched_data.queue)
 #else
 		irt_g_workers[wid]->sched_data.queue.size
 #endif
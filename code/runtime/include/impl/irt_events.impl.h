@@ -39,7 +39,10 @@
 #define __GUARD_IMPL_IRT_EVENTS_IMPL_H
 
 #include "irt_events.h"
-#include "abstraction/spin_locks.h"
+#include "abstraction/atomic.h"
+#include "abstraction/threads.h"
+#include "work_item.h"
+#include "work_group.h"
 
 
 #define IRT_DEFINE_EVENTS(__subject__, __short__, __num_events__) \
@@ -47,7 +50,11 @@
  \
 /* Define the functions we need */ \
  \
-/* Helper function to get a new or re-used event register from the current worker */ \
+void irt_##__short__##_event_register_init(irt_##__short__##_event_register* reg) { \
+	memset(reg, 0, sizeof(irt_##__short__##_event_register)); \
+} \
+ \
+/* Helper function to get a new or re-used register for items without cached pointer from the current worker */ \
 irt_##__short__##_event_register* _irt_get_##__short__##_event_register() { \
 	irt_worker* self = irt_worker_get_current(); \
 	/* Try to get a register from the re-use list */ \
@@ -55,62 +62,105 @@ irt_##__short__##_event_register* _irt_get_##__short__##_event_register() { \
 	if(reg) { \
 		self->__short__##_ev_register_list = reg->lookup_table_next; \
 		reg->lookup_table_next = NULL; \
-		memset(reg->occured_flag, false, __num_events__ * sizeof(bool)); \
-		memset(reg->handler, 0, __num_events__ * sizeof(irt_##__short__##_event_lambda*)); \
 	} else { \
 		/* Otherwise we have to create a new one */ \
 		reg = (irt_##__short__##_event_register*)calloc(1, sizeof(irt_##__short__##_event_register)); \
 	} \
-	irt_spin_init(&reg->lock); \
 	return reg; \
 } \
  \
+/* Returns the register of the given item and marks it as being in use, NULL if it does not exist (anymore) */ \
+static inline irt_##__short__##_event_register* _irt_##__short__##_event_register_acquire(const irt_##__subject__##_id item_id) { \
+	irt_##__short__##_event_register* reg; \
+	if(item_id.cached) { \
+		reg = &item_id.cached->event_register; \
+	} else { \
+		irt_##__short__##_event_register_id reg_id; \
+		reg_id.full = item_id.full; \
+		reg_id.cached = NULL; \
+		reg = irt_##__short__##_event_register_table_lookup(reg_id); \
+		if(reg == NULL) return NULL; \
+	} \
+	irt_atomic_inc(&reg->users, uint32); \
+	/* the register might belong to an item which ended in the meantime - since ids are unique, a matching id can not be stale */ \
+	if(irt_atomic_load(&reg->id.full) != item_id.full) { \
+		irt_atomic_dec(&reg->users, uint32); \
+		return NULL; \
+	} \
+	return reg; \
+} \
+ \
+static inline void _irt_##__short__##_event_register_release(irt_##__short__##_event_register* reg) { \
+	irt_atomic_dec(&reg->users, uint32); \
+} \
+ \
+/* Pushes the linked handlers first ... last to the handler stack of event_code, keeping the occurred flag */ \
+static inline void _irt_##__short__##_event_handler_push(irt_##__short__##_event_register* reg, const irt_##__short__##_event_code event_code, irt_##__short__##_event_lambda* first, irt_##__short__##_event_lambda* last) { \
+	uintptr_t old; \
+	do { \
+		old = irt_atomic_load(&reg->handler[event_code]); \
+		last->next = (irt_##__short__##_event_lambda*)(old & ~IRT_EVENT_OCCURRED_FLAG); \
+	} while(!irt_atomic_bool_compare_and_swap(&reg->handler[event_code], old, (uintptr_t)first | (old & IRT_EVENT_OCCURRED_FLAG), uintptr_t)); \
+} \
+ \
 void irt_##__short__##_event_register_create(const irt_##__subject__##_id item_id) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register* reg = _irt_get_##__short__##_event_register(); \
-	reg->id.full = item_id.full; \
+	irt_##__short__##_event_register* reg = item_id.cached ? &item_id.cached->event_register : _irt_get_##__short__##_event_register(); \
+	for(uint32 i = 0; i < __num_events__; ++i) { \
+		irt_atomic_store(&reg->handler[i], (uintptr_t)0); \
+	} \
 	reg->id.cached = reg; \
-	irt_##__short__##_event_register_table_insert(reg); \
+	/* setting the id makes the register accessible */ \
+	irt_atomic_store(&reg->id.full, item_id.full); \
+	if(!item_id.cached) irt_##__short__##_event_register_table_insert(reg); \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_register_create for [%d %d %d] -> reg=%p\n", item_id.node, item_id.thread, item_id.index, (void*) reg) \
 } \
  \
 void irt_##__short__##_event_register_destroy(const irt_##__subject__##_id item_id) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register_id reg_id; \
-	reg_id.full = item_id.full; \
-	reg_id.cached = NULL; \
-	irt_##__short__##_event_register* reg = irt_##__short__##_event_register_table_remove(reg_id); \
-	/* No locking needed here - the lookup table already locked the lock for us */ \
-	IRT_ASSERT(reg != NULL, IRT_ERR_INTERNAL, "Couldn't find register for [%d %d %d] to remove", item_id.node, item_id.thread, item_id.index); \
-	irt_worker* self = irt_worker_get_current(); \
-	reg->lookup_table_next = self->__short__##_ev_register_list; \
-	self->__short__##_ev_register_list = reg; \
-	irt_spin_unlock(&reg->lock); /* For better style we unlock the lock here as it has been locked by the lookup table, even though it won't be used anymore */ \
+	irt_##__short__##_event_register* reg; \
+	if(item_id.cached) { \
+		reg = &item_id.cached->event_register; \
+	} else { \
+		irt_##__short__##_event_register_id reg_id; \
+		reg_id.full = item_id.full; \
+		reg_id.cached = NULL; \
+		reg = irt_##__short__##_event_register_table_remove(reg_id); \
+	} \
+	IRT_ASSERT(reg != NULL && reg->id.full == item_id.full, IRT_ERR_INTERNAL, "Couldn't find register for [%d %d %d] to remove", item_id.node, item_id.thread, item_id.index); \
+	/* turn away new users, then wait for the current ones before the register may be reused */ \
+	irt_atomic_store(&reg->id.full, (uint64)0); \
+	while(irt_atomic_load(&reg->users) != 0) { \
+		irt_thread_yield(); \
+	} \
+	if(!item_id.cached) { \
+		irt_worker* self = irt_worker_get_current(); \
+		reg->lookup_table_next = self->__short__##_ev_register_list; \
+		self->__short__##_ev_register_list = reg; \
+	} \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_register_destroy for [%d %d %d]\n", item_id.node, item_id.thread, item_id.index) \
 } \
  \
 static inline bool _irt_##__short__##_event_handler_check_and_register_impl(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code, irt_##__short__##_event_lambda* handler, const bool check_occured) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register_id reg_id; \
-	reg_id.full = item_id.full; \
-	reg_id.cached = NULL; \
-	irt_##__short__##_event_register* reg = irt_##__short__##_event_register_table_lookup(reg_id); \
+	irt_##__short__##_event_register* reg = _irt_##__short__##_event_register_acquire(item_id); \
 	if (reg == NULL) { \
 		_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_handler_check_and_register on for [%d %d %d], event_code=%d, handler=%p, check_occured=%d -> reg not found\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) handler, check_occured) \
 		/* in case there is no register for this item */ \
 		return false; \
 	} \
-	/* No locking needed here - the lookup table already locked the lock for us */ \
-	if (check_occured && reg->occured_flag[event_code]) { \
-		irt_spin_unlock(&reg->lock); \
-		_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_handler_check_and_register on for [%d %d %d], event_code=%d, handler=%p, check_occured=%d -> reg=%p - did not register\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) handler, check_occured, (void*) reg) \
-		/* in case the event already happened and we should check for that */ \
-		return false; \
-	} \
-	/* insert additional handler */ \
-	handler->next = reg->handler[event_code]; \
-	reg->handler[event_code] = handler; \
-	irt_spin_unlock(&reg->lock); \
+	/* insert additional handler, unless the event already happened and we should check for that */ \
+	uintptr_t old; \
+	do { \
+		old = irt_atomic_load(&reg->handler[event_code]); \
+		if (check_occured && (old & IRT_EVENT_OCCURRED_FLAG)) { \
+			_irt_##__short__##_event_register_release(reg); \
+			_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_handler_check_and_register on for [%d %d %d], event_code=%d, handler=%p, check_occured=%d -> reg=%p - did not register\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) handler, check_occured, (void*) reg) \
+			return false; \
+		} \
+		handler->next = (irt_##__short__##_event_lambda*)(old & ~IRT_EVENT_OCCURRED_FLAG); \
+	} while(!irt_atomic_bool_compare_and_swap(&reg->handler[event_code], old, (uintptr_t)handler | (old & IRT_EVENT_OCCURRED_FLAG), uintptr_t)); \
+	_irt_##__short__##_event_register_release(reg); \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_handler_check_and_register for [%d %d %d], event_code=%d, handler=%p, check_occured=%d -> reg=%p - registered successfully\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) handler, check_occured, (void*) reg) \
 	return true; \
 } \
@@ -125,37 +175,36 @@ bool irt_##__short__##_event_handler_check_and_register(const irt_##__subject__#
  \
 void irt_##__short__##_event_handler_remove(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code, irt_##__short__##_event_lambda* handler) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register_id reg_id; \
-	reg_id.full = item_id.full; \
-	reg_id.cached = NULL; \
-	irt_##__short__##_event_register* reg = irt_##__short__##_event_register_table_lookup(reg_id); \
+	irt_##__short__##_event_register* reg = _irt_##__short__##_event_register_acquire(item_id); \
 	IRT_ASSERT(reg != NULL, IRT_ERR_INTERNAL, "Deleting " # __short__ " event handler for register [%d %d %d] (event_code %d) that doesn't exist", item_id.node, item_id.thread, item_id.index, event_code); \
-	/* No locking needed here - the lookup table already locked the lock for us */ \
+	/* detach all handlers, keeping the occurred flag */ \
+	uintptr_t old; \
+	do { \
+		old = irt_atomic_load(&reg->handler[event_code]); \
+	} while(!irt_atomic_bool_compare_and_swap(&reg->handler[event_code], old, old & IRT_EVENT_OCCURRED_FLAG, uintptr_t)); \
 	/* go through all event handlers */ \
-	irt_##__short__##_event_lambda *cur = reg->handler[event_code]; \
-	irt_##__short__##_event_lambda *prev = NULL, *nex = NULL; \
-	while(cur != NULL) { \
-		nex = cur->next; \
-		if(cur == handler) { /* if found, delete */ \
-			if(prev == NULL) reg->handler[event_code] = nex; \
-			else prev->next = nex; \
-			break; \
-		} else { /* else keep iterating */ \
-			prev = cur; \
-		} \
-		cur = nex; \
+	irt_##__short__##_event_lambda *first = (irt_##__short__##_event_lambda*)(old & ~IRT_EVENT_OCCURRED_FLAG); \
+	irt_##__short__##_event_lambda *cur = first, *prev = NULL; \
+	while(cur != NULL && cur != handler) { \
+		prev = cur; \
+		cur = cur->next; \
 	} \
 	IRT_ASSERT(cur != NULL, IRT_ERR_INTERNAL, "Deleting " # __short__ " event handler which doesn't exist (but register [%d %d %d] does)", item_id.node, item_id.thread, item_id.index); \
-	irt_spin_unlock(&reg->lock); \
+	/* if found, delete and re-attach the remaining handlers */ \
+	if(prev == NULL) first = cur->next; \
+	else prev->next = cur->next; \
+	if(first != NULL) { \
+		irt_##__short__##_event_lambda *last = first; \
+		while(last->next != NULL) last = last->next; \
+		_irt_##__short__##_event_handler_push(reg, event_code, first, last); \
+	} \
+	_irt_##__short__##_event_register_release(reg); \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_handler_remove for [%d %d %d], event_code=%d, handler=%p -> removed handler for reg=%p\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) handler, (void*) reg) \
 } \
  \
 static inline void _irt_##__short__##_event_trigger_impl(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code, const bool assert_if_not_exists) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register_id reg_id; \
-	reg_id.full = item_id.full; \
-	reg_id.cached = NULL; \
-	irt_##__short__##_event_register* reg = irt_##__short__##_event_register_table_lookup(reg_id); \
+	irt_##__short__##_event_register* reg = _irt_##__short__##_event_register_acquire(item_id); \
 	if (reg == NULL) { \
 		if (assert_if_not_exists) { \
 			IRT_ASSERT(false, IRT_ERR_INTERNAL, "Triggering " # __short__ " event with no associated register [%d %d %d] for event_code %d", item_id.node, item_id.thread, item_id.index, event_code); \
@@ -164,22 +213,22 @@ static inline void _irt_##__short__##_event_trigger_impl(const irt_##__subject__
 			return; \
 		} \
 	} \
-	/* No locking needed here - the lookup table already locked the lock for us */ \
-	reg->occured_flag[event_code] = true; \
+	/* set the occurred flag and take all handlers in a single step */ \
+	uintptr_t old; \
+	do { \
+		old = irt_atomic_load(&reg->handler[event_code]); \
+	} while(!irt_atomic_bool_compare_and_swap(&reg->handler[event_code], old, IRT_EVENT_OCCURRED_FLAG, uintptr_t)); \
 	/* go through all event handlers */ \
-	irt_##__short__##_event_lambda *cur = reg->handler[event_code]; \
-	irt_##__short__##_event_lambda *prev = NULL, *nex = NULL; \
+	irt_##__short__##_event_lambda *cur = (irt_##__short__##_event_lambda*)(old & ~IRT_EVENT_OCCURRED_FLAG); \
+	irt_##__short__##_event_lambda *nex = NULL; \
 	while(cur != NULL) { \
 		nex = cur->next; \
-		if(!cur->func(cur->data)) { /* if the event handler doesn't want to stay registered, remove */ \
-			if(prev == NULL) reg->handler[event_code] = nex; \
-			else prev->next = nex; \
-		} else { /* else keep the handler in the list */ \
-			prev = cur; \
+		if(cur->func(cur->data)) { /* if the event handler wants to stay registered, re-insert */ \
+			_irt_##__short__##_event_handler_push(reg, event_code, cur, cur); \
 		} \
 		cur = nex; \
 	} \
-	irt_spin_unlock(&reg->lock); \
+	_irt_##__short__##_event_register_release(reg); \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_trigger for [%d %d %d], event_code=%d, -> triggered on reg=%p\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) reg) \
 } \
  \
@@ -193,24 +242,23 @@ void irt_##__short__##_event_trigger_if_exists(const irt_##__subject__##_id item
  \
 void irt_##__short__##_event_reset(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code) { \
 	_IRT_EVENT_DEBUG_HEADER(__short__) \
-	irt_##__short__##_event_register_id reg_id; \
-	reg_id.full = item_id.full; \
-	reg_id.cached = NULL; \
-	irt_##__short__##_event_register* reg = irt_##__short__##_event_register_table_lookup(reg_id); \
+	irt_##__short__##_event_register* reg = _irt_##__short__##_event_register_acquire(item_id); \
 	IRT_ASSERT(reg != NULL, IRT_ERR_INTERNAL, "Triggering " # __short__ " event with no associated register [%d %d %d] for event_code %d", item_id.node, item_id.thread, item_id.index, event_code); \
-	/* No locking needed here - the lookup table already locked the lock for us */ \
-	reg->occured_flag[event_code] = false; \
-	irt_spin_unlock(&reg->lock); \
+	uintptr_t old; \
+	do { \
+		old = irt_atomic_load(&reg->handler[event_code]); \
+	} while(!irt_atomic_bool_compare_and_swap(&reg->handler[event_code], old, old & ~IRT_EVENT_OCCURRED_FLAG, uintptr_t)); \
+	_irt_##__short__##_event_register_release(reg); \
 	_IRT_EVENT_DEBUG_FOOTER(__short__, "Called event_reset for [%d %d %d], event_code=%d, -> reset on reg=%p\n", item_id.node, item_id.thread, item_id.index, event_code, (void*) reg) \
 }
 
 
 // WI events //////////////////////////////////////
-IRT_DEFINE_LOCKED_LOOKUP_TABLE_WITH_POST_LOOKUP_ACTION(wi_event_register, lookup_table_next, IRT_ID_HASH, IRT_EVENT_LT_BUCKETS, {if(element) {irt_spin_lock(&((irt_wi_event_register*) element)->lock);}})
+IRT_DEFINE_LOCKED_LOOKUP_TABLE(wi_event_register, lookup_table_next, IRT_ID_HASH, IRT_EVENT_LT_BUCKETS)
 IRT_DEFINE_EVENTS(work_item, wi, IRT_WI_EV_NUM)
 
 // WG events //////////////////////////////////////
-IRT_DEFINE_LOCKED_LOOKUP_TABLE_WITH_POST_LOOKUP_ACTION(wg_event_register, lookup_table_next, IRT_ID_HASH, IRT_EVENT_LT_BUCKETS, {if(element) {irt_spin_lock(&((irt_wg_event_register*) element)->lock);}})
+IRT_DEFINE_LOCKED_LOOKUP_TABLE(wg_event_register, lookup_table_next, IRT_ID_HASH, IRT_EVENT_LT_BUCKETS)
 IRT_DEFINE_EVENTS(work_group, wg, IRT_WG_EV_NUM)
 
 
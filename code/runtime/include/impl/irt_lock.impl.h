@@ -45,50 +45,238 @@
 #include "impl/worker.impl.h"
 #include "utils/impl/minlwt.impl.h"
 
-#define IRT_LOCK_NANOS_BUSY_WAIT 10000
-#define IRT_LOCK_NANOS_INTERVAL 500
+static inline void _irt_lock_cpu_relax() {
+	#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+	#endif
+}
+
+// adapts a spinning budget after a contended acquisition, spun == 0 indicates that spinning failed
+static inline void _irt_lock_adapt_spin_limit(volatile uint32* spin_limit, uint32 spun) {
+	uint32 limit = *spin_limit;
+	if(spun == 0) {
+		limit /= 2;
+	} else {
+		// move towards twice the number of iterations it took, like glibc's adaptive mutexes
+		limit = limit + ((int32)(2*spun) - (int32)limit) / 8;
+	}
+	if(limit < IRT_LOCK_SPIN_MIN) limit = IRT_LOCK_SPIN_MIN;
+	if(limit > IRT_LOCK_SPIN_MAX) limit = IRT_LOCK_SPIN_MAX;
+	// races only lose updates of a heuristic value
+	*spin_limit = limit;
+}
+
+static inline void _irt_lock_enqueue(locked_wi** front, locked_wi** back, locked_wi* waiter) {
+	waiter->next = NULL;
+	if(*back) (*back)->next = waiter;
+	else *front = waiter;
+	*back = waiter;
+}
+
+static inline locked_wi* _irt_lock_dequeue(locked_wi** front, locked_wi** back) {
+	locked_wi* waiter = *front;
+	*front = waiter->next;
+	if(!*front) *back = NULL;
+	return waiter;
+}
+
+// suspends the current work item, needs to be called with the queue mutex locked and releases it
+static inline void _irt_lock_suspend(irt_spinlock* mutex, locked_wi** front, locked_wi** back, bool exclusive) {
+	irt_worker *wo = irt_worker_get_current();
+	irt_work_item *wi = wo->cur_wi;
+	locked_wi selflocked = {wi, wo, exclusive, NULL};
+	_irt_lock_enqueue(front, back, &selflocked);
+	irt_spin_unlock(mutex);
+	irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_SUSPENDED_LOCK, wi->id);
+	_irt_worker_switch_from_wi(wo, wi);
+	// ownership has been handed over by the releasing work item
+}
+
+// continues a waiter which has been handed the lock
+static inline void _irt_lock_wake(locked_wi* waiter) {
+	irt_worker* wo = waiter->worker;
+	irt_inst_insert_wi_event(irt_worker_get_current(), IRT_INST_WORK_ITEM_RESUMED_LOCK, waiter->wi->id);
+	irt_scheduling_continue_wi(wo, waiter->wi);
+	irt_signal_worker(wo);
+}
+
+/////////////////////////////////////////////////////////////////////////////// irt_lock
+
+static inline bool _irt_lock_try(irt_lock* lock) {
+	// do not overtake queued work items
+	return lock->locked == 0 && irt_atomic_load(&lock->front) == NULL && irt_atomic_bool_compare_and_swap(&lock->locked, 0, 1, uint32);
+}
 
 void irt_lock_init(irt_lock* lock) {
 	irt_spin_init(&lock->mutex);
-	lock->top = NULL;
+	lock->front = NULL;
+	lock->back = NULL;
 	lock->locked = 0;
+	lock->spin_limit = IRT_LOCK_SPIN_MIN;
+	lock->stats = (irt_lock_stats){ 0, 0, 0 };
 }
 
 void irt_lock_acquire(irt_lock* lock) {
-	//uint64 start_t = irt_time_ns();
-	//restart:
+	if(_irt_lock_try(lock)) {
+		lock->stats.acquisitions++;
+		return;
+	}
+
+	irt_worker *wo = irt_worker_get_current();
+	irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_LOCK_CONTENDED, wo->cur_wi->id);
+
+	// spinning phase, pointless once there are queued work items the lock will be handed to
+	uint32 limit = lock->spin_limit;
+	for(uint32 i = 1; i <= limit && irt_atomic_load(&lock->front) == NULL; ++i) {
+		_irt_lock_cpu_relax();
+		if(_irt_lock_try(lock)) {
+			_irt_lock_adapt_spin_limit(&lock->spin_limit, i);
+			lock->stats.acquisitions++;
+			lock->stats.contended++;
+			irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_LOCK_SPIN_ACQUIRED, wo->cur_wi->id);
+			return;
+		}
+	}
+	_irt_lock_adapt_spin_limit(&lock->spin_limit, 0);
+
+	// suspending phase
 	irt_spin_lock(&lock->mutex);
-	if(lock->locked) { // suspend if locked
-		//if(irt_time_ns()-start_t < IRT_LOCK_NANOS_BUSY_WAIT) {
-		//	irt_spin_unlock(&lock->mutex);
-		//	irt_busy_nanosleep(IRT_LOCK_NANOS_INTERVAL);
-		//	goto restart;
-		//}
-		irt_worker *wo = irt_worker_get_current();
-		irt_work_item *wi = wo->cur_wi;
-		locked_wi selflocked = {wi, wo, lock->top};
-		lock->top = &selflocked;
-		irt_spin_unlock(&lock->mutex);
-		irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_SUSPENDED_LOCK, wi->id);
-        _irt_worker_switch_from_wi(wo, wi);
-	} else { // acquire lock
-		lock->locked = 1;
+	if(irt_atomic_load(&lock->front) == NULL && irt_atomic_bool_compare_and_swap(&lock->locked, 0, 1, uint32)) {
 		irt_spin_unlock(&lock->mutex);
+		lock->stats.acquisitions++;
+		lock->stats.contended++;
+		return;
 	}
+	_irt_lock_suspend(&lock->mutex, &lock->front, &lock->back, true);
+	lock->stats.acquisitions++;
+	lock->stats.contended++;
+	lock->stats.suspended++;
 }
 
 void irt_lock_release(irt_lock* lock) {
 	irt_spin_lock(&lock->mutex);
-	if(lock->top) { // release a waiting task
-		locked_wi *task = lock->top;
-		lock->top = task->next;
-		irt_worker* wo = task->worker;
-		irt_scheduling_continue_wi(task->worker, task->wi);
-		irt_signal_worker(wo);
+	if(lock->front) { // hand the lock over to the oldest waiting task, it stays locked
+		_irt_lock_wake(_irt_lock_dequeue(&lock->front, &lock->back));
 	} else { // none waiting, lock is now unlocked
-		lock->locked = 0;
+		irt_atomic_store(&lock->locked, 0);
+	}
+	irt_spin_unlock(&lock->mutex);
+}
+
+irt_lock_stats irt_lock_get_stats(irt_lock* lock) {
+	return lock->stats;
+}
+
+/////////////////////////////////////////////////////////////////////////////// irt_rwlock
+
+#define IRT_RWLOCK_WRITER 1
+#define IRT_RWLOCK_READER 2
+
+static inline bool _irt_rwlock_try_read(irt_rwlock* lock) {
+	uint32 state = lock->state;
+	return !(state & IRT_RWLOCK_WRITER) && irt_atomic_load(&lock->front) == NULL
+		&& irt_atomic_bool_compare_and_swap(&lock->state, state, state + IRT_RWLOCK_READER, uint32);
+}
+
+static inline bool _irt_rwlock_try_write(irt_rwlock* lock) {
+	return lock->state == 0 && irt_atomic_load(&lock->front) == NULL && irt_atomic_bool_compare_and_swap(&lock->state, 0, IRT_RWLOCK_WRITER, uint32);
+}
+
+static inline void _irt_rwlock_count(irt_rwlock* lock, bool contended, bool suspended) {
+	irt_atomic_inc(&lock->stats.acquisitions, uint64);
+	if(contended) irt_atomic_inc(&lock->stats.contended, uint64);
+	if(suspended) irt_atomic_inc(&lock->stats.suspended, uint64);
+}
+
+// hands a free lock to the front of the queue, needs to be called with the queue mutex locked
+static inline void _irt_rwlock_handoff(irt_rwlock* lock) {
+	if(!lock->front) return;
+	if(lock->front->exclusive) {
+		// fails if a reader entered in the meantime, its release will hand the lock over
+		if(irt_atomic_bool_compare_and_swap(&lock->state, 0, IRT_RWLOCK_WRITER, uint32)) {
+			_irt_lock_wake(_irt_lock_dequeue(&lock->front, &lock->back));
+		}
+		return;
+	}
+	// admit all readers at the front of the queue
+	uint32 readers = 0;
+	for(locked_wi* cur = lock->front; cur && !cur->exclusive; cur = cur->next) readers++;
+	irt_atomic_fetch_and_add(&lock->state, readers * IRT_RWLOCK_READER, uint32);
+	while(readers-- > 0) {
+		_irt_lock_wake(_irt_lock_dequeue(&lock->front, &lock->back));
+	}
+}
+
+static inline void _irt_rwlock_acquire(irt_rwlock* lock, bool exclusive) {
+	bool (*try_acquire)(irt_rwlock*) = exclusive ? &_irt_rwlock_try_write : &_irt_rwlock_try_read;
+	if(try_acquire(lock)) {
+		_irt_rwlock_count(lock, false, false);
+		return;
+	}
+
+	irt_worker *wo = irt_worker_get_current();
+	irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_LOCK_CONTENDED, wo->cur_wi->id);
+
+	uint32 limit = lock->spin_limit;
+	for(uint32 i = 1; i <= limit && irt_atomic_load(&lock->front) == NULL; ++i) {
+		_irt_lock_cpu_relax();
+		if(try_acquire(lock)) {
+			_irt_lock_adapt_spin_limit(&lock->spin_limit, i);
+			_irt_rwlock_count(lock, true, false);
+			irt_inst_insert_wi_event(wo, IRT_INST_WORK_ITEM_LOCK_SPIN_ACQUIRED, wo->cur_wi->id);
+			return;
+		}
+	}
+	_irt_lock_adapt_spin_limit(&lock->spin_limit, 0);
+
+	irt_spin_lock(&lock->mutex);
+	if(try_acquire(lock)) {
+		irt_spin_unlock(&lock->mutex);
+		_irt_rwlock_count(lock, true, false);
+		return;
 	}
-	irt_spin_unlock(&lock->mutex);	
+	_irt_lock_suspend(&lock->mutex, &lock->front, &lock->back, exclusive);
+	_irt_rwlock_count(lock, true, true);
+}
+
+void irt_rwlock_init(irt_rwlock* lock) {
+	irt_spin_init(&lock->mutex);
+	lock->front = NULL;
+	lock->back = NULL;
+	lock->state = 0;
+	lock->spin_limit = IRT_LOCK_SPIN_MIN;
+	lock->stats = (irt_lock_stats){ 0, 0, 0 };
+}
+
+void irt_rwlock_read_acquire(irt_rwlock* lock) {
+	_irt_rwlock_acquire(lock, false);
+}
+
+void irt_rwlock_read_release(irt_rwlock* lock) {
+	irt_spin_lock(&lock->mutex);
+	if(irt_atomic_sub_and_fetch(&lock->state, IRT_RWLOCK_READER, uint32) == 0) {
+		_irt_rwlock_handoff(lock);
+	}
+	irt_spin_unlock(&lock->mutex);
+}
+
+void irt_rwlock_write_acquire(irt_rwlock* lock) {
+	_irt_rwlock_acquire(lock, true);
+}
+
+void irt_rwlock_write_release(irt_rwlock* lock) {
+	irt_spin_lock(&lock->mutex);
+	if(lock->front && lock->front->exclusive) { // direct hand over to the next writer
+		_irt_lock_wake(_irt_lock_dequeue(&lock->front, &lock->back));
+	} else {
+		irt_atomic_store(&lock->state, 0);
+		_irt_rwlock_handoff(lock);
+	}
+	irt_spin_unlock(&lock->mutex);
+}
+
+irt_lock_stats irt_rwlock_get_stats(irt_rwlock* lock) {
+	return lock->stats;
 }
 
 
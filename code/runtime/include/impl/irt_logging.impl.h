@@ -89,6 +89,8 @@ void irt_log_init() {
 	irt_log_setting_s("IRT_SCHED_POLICY", "IRT_SCHED_POLICY_STEALING");
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CIRCULAR
 	irt_log_setting_s("IRT_SCHED_POLICY", "IRT_SCHED_POLICY_STEALING_CIRCULAR");
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV
+	irt_log_setting_s("IRT_SCHED_POLICY", "IRT_SCHED_POLICY_STEALING_CHASE_LEV");
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_UBER
 	irt_log_setting_s("IRT_SCHED_POLICY", "IRT_SCHED_POLICY_UBER");
 #else
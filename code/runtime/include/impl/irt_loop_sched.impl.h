@@ -218,6 +218,130 @@ inline static void irt_schedule_loop_shares(irt_work_item* self, uint32 id, irt_
 	_irt_loop_fragment_run(self, base_range, impl, args);
 }
 
+// number of iterations of the given range, loops with begin >= end are empty
+static inline uint64 _irt_loop_num_iterations(irt_work_item_range base_range) {
+	if(base_range.begin >= base_range.end || base_range.step <= 0) return 0;
+	uint64 range = base_range.end - base_range.begin;
+	return range / base_range.step + (range % base_range.step > 0);
+}
+
+// takes the upper half of the remaining iterations of another participant and makes them the own range
+// victims are searched in blocks of doubling size around the thief, preferring participants with close ids
+// (and therefore usually close workers), within a block the one with the most remaining iterations is chosen
+inline static bool _irt_loop_sched_steal(irt_loop_sched_range* ranges, uint32 id, uint32 participants, uint64 chunk) {
+	for(uint32 span = 2; span < 2 * participants; span *= 2) {
+		uint32 first = id - id % span;
+		uint32 last = MIN(first + span, participants);
+		uint32 victim = id;
+		uint64 most = chunk;
+		for(uint32 v = first; v < last; ++v) {
+			uint64 begin = ranges[v].begin, end = ranges[v].end;
+			if(v != id && end > begin && end - begin > most) {
+				victim = v;
+				most = end - begin;
+			}
+		}
+		if(victim == id) continue;
+
+		irt_spin_lock(&ranges[victim].lock);
+		uint64 begin = ranges[victim].begin, end = ranges[victim].end;
+		if(end > begin && end - begin > chunk) {
+			uint64 mid = begin + (end - begin) / 2;
+			ranges[victim].end = mid;
+			irt_spin_unlock(&ranges[victim].lock);
+			irt_spin_lock(&ranges[id].lock);
+			ranges[id].begin = mid;
+			ranges[id].end = end;
+			irt_spin_unlock(&ranges[id].lock);
+			return true;
+		}
+		irt_spin_unlock(&ranges[victim].lock);
+		// the victim made progress in the meantime, search the same block again
+		span /= 2;
+	}
+	return false;
+}
+
+// implements range stealing loop scheduling:
+// each participant processes its pre-partitioned range in chunks, idle participants steal half of the remaining range of others
+inline static void irt_schedule_loop_stealing(irt_work_item* self, uint32 id, irt_work_item_range base_range,
+		irt_wi_implementation* impl, irt_lw_data_item* args, volatile irt_loop_sched_data *sched_data) {
+
+	uint32 participants = sched_data->policy.participants;
+	uint64 chunk = sched_data->policy.param.chunk_size;
+	uint64 numit = _irt_loop_num_iterations(base_range);
+	irt_loop_sched_range* ranges = sched_data->ranges;
+	irt_loop_sched_range* own = &ranges[id];
+	uint64 executed = 0;
+
+	irt_work_item_range range;
+	range.step = base_range.step;
+	for(;;) {
+		irt_spin_lock(&own->lock);
+		uint64 begin = own->begin;
+		uint64 end = MIN(begin + chunk, own->end);
+		own->begin = MAX(begin, end);
+		irt_spin_unlock(&own->lock);
+
+		if(begin < end) {
+			range.begin = base_range.begin + begin * base_range.step;
+			range.end = (end == numit) ? base_range.end : base_range.begin + end * base_range.step;
+			_irt_loop_fragment_run(self, range, impl, args);
+			executed += end - begin;
+		} else if(!_irt_loop_sched_steal(ranges, id, participants, chunk)) {
+			break;
+		}
+	}
+	own->executed = executed;
+
+	// the last participant to finish records the distribution of work for the next execution of this loop and cleans up
+	if(irt_atomic_sub_and_fetch(&sched_data->ranges_active, 1, uint32) == 0) {
+		irt_wi_implementation_runtime_data* rt_data = &impl->variants[0].rt_data;
+		if(numit > 0) {
+			for(uint32 i = 0; i < participants; ++i) {
+				rt_data->stealing_distribution[i] = ranges[i].executed / (double)numit;
+			}
+			rt_data->stealing_participants = participants;
+		}
+		sched_data->ranges = NULL;
+		free(ranges);
+	}
+}
+
+// prepare for range stealing loop before entry
+// the iteration space is partitioned according to the work distribution of the previous execution of the same loop body
+// (if it had the same number of participants), such that participants keep working on the same (cache-warm) part of the data
+static inline void irt_schedule_loop_stealing_prepare(volatile irt_loop_sched_data* sched_data, irt_work_item_range base_range,
+		irt_wi_implementation* impl) {
+	uint32 participants = sched_data->policy.participants;
+	uint64 numit = _irt_loop_num_iterations(base_range);
+	if(sched_data->policy.type == IRT_STEALING) {
+		uint64 chunk = (numit / participants) / 16;
+		sched_data->policy.param.chunk_size = MAX(chunk, 1);
+	}
+
+	irt_wi_implementation_runtime_data* rt_data = &impl->variants[0].rt_data;
+	double total = 0.0;
+	if(rt_data->stealing_participants == participants) {
+		for(uint32 i = 0; i < participants; ++i) total += rt_data->stealing_distribution[i];
+	}
+
+	irt_loop_sched_range* ranges = (irt_loop_sched_range*)malloc(participants * sizeof(irt_loop_sched_range));
+	double pos = 0.0;
+	uint64 begin = 0;
+	for(uint32 i = 0; i < participants; ++i) {
+		pos += (total > 0.0) ? rt_data->stealing_distribution[i] / total : 1.0 / participants;
+		uint64 end = (i == participants - 1) ? numit : MIN(MAX((uint64)(pos * numit + 0.5), begin), numit);
+		ranges[i].begin = begin;
+		ranges[i].end = end;
+		ranges[i].executed = 0;
+		irt_spin_init(&ranges[i].lock);
+		begin = end;
+	}
+	sched_data->ranges = ranges;
+	sched_data->ranges_active = participants;
+}
+
 // prepare for dynamically scheduled loop with set chunk size before entry
 static inline void irt_schedule_loop_dynamic_chunked_prepare(volatile irt_loop_sched_data* sched_data, irt_work_item_range base_range) {
 	sched_data->completed = base_range.begin;
@@ -363,6 +487,8 @@ inline static void irt_schedule_loop(
 		case IRT_DYNAMIC_CHUNKED_COUNTING: irt_schedule_loop_dynamic_chunked_prepare(sched_data, base_range); break;
 		case IRT_GUIDED: irt_schedule_loop_guided_prepare(sched_data, base_range); break;
 		case IRT_GUIDED_CHUNKED: irt_schedule_loop_guided_chunked_prepare(sched_data, base_range); break;
+		case IRT_STEALING:
+		case IRT_STEALING_CHUNKED: irt_schedule_loop_stealing_prepare(sched_data, base_range, impl); break;
 		default: IRT_ASSERT(false, IRT_ERR_INTERNAL, "Unknown scheduling policy");
 		}
 
@@ -390,6 +516,8 @@ inline static void irt_schedule_loop(
 	case IRT_GUIDED_CHUNKED: irt_schedule_loop_guided_chunked(self, mem->num, base_range, impl, args, sched_data); break;
 	case IRT_FIXED: irt_schedule_loop_fixed(self, mem->num, base_range, impl, args, sched_data); break;
 	case IRT_SHARES: irt_schedule_loop_shares(self, mem->num, base_range, impl, args, sched_data); break;
+	case IRT_STEALING:
+	case IRT_STEALING_CHUNKED: irt_schedule_loop_stealing(self, mem->num, base_range, impl, args, sched_data); break;
 	default: IRT_ASSERT(false, IRT_ERR_INTERNAL, "Unknown scheduling policy");
 	}
 	
@@ -469,6 +597,17 @@ void irt_loop_sched_policy_init() {
 					irt_g_loop_sched_policy_default.participants = IRT_SANE_PARALLEL_MAX;
 					irt_g_loop_sched_policy_default.param.chunk_size = 0;
 				}
+			} else if(strcmp("IRT_STEALING", policy_str) == 0) {
+				if(chunksize_str) {
+					irt_g_loop_sched_policy_default.type = IRT_STEALING_CHUNKED;
+					irt_g_loop_sched_policy_default.participants = IRT_SANE_PARALLEL_MAX;
+					irt_g_loop_sched_policy_default.param.chunk_size = atoi(chunksize_str);
+					IRT_ASSERT(irt_g_loop_sched_policy_default.param.chunk_size > 0, IRT_ERR_INTERNAL, "Chunk size must not be 0");
+				} else {
+					irt_g_loop_sched_policy_default.type = IRT_STEALING;
+					irt_g_loop_sched_policy_default.participants = IRT_SANE_PARALLEL_MAX;
+					irt_g_loop_sched_policy_default.param.chunk_size = 0;
+				}
 			} else {
 				fprintf(stderr, "unknown loop scheduler policy requested: %s\n", policy_env_copy);
 				#ifdef _GEMS_SIM
@@ -306,7 +306,8 @@ void irt_optimizer_compute_optimizations(irt_wi_implementation_variant* variant,
                 return;
             }
 
-            // collecting data                          
+            // collecting data (region metrics are accumulated per worker and need to be merged first)
+            irt_inst_region_merge(context);
 
             irt_optimizer_resources cur_resources;
 
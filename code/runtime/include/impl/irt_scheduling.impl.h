@@ -50,6 +50,8 @@
 #include "sched_policies/impl/irt_sched_stealing.impl.h"
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CIRCULAR
 #include "sched_policies/impl/irt_sched_stealing_circular.impl.h"
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV
+#include "sched_policies/impl/irt_sched_stealing_chase_lev.impl.h"
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_UBER
 #include "sched_policies/impl/irt_sched_uber.impl.h"
 #endif
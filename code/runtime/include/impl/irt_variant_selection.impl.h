@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+#ifndef __GUARD_IMPL_IRT_VARIANT_SELECTION_IMPL_H
+#define __GUARD_IMPL_IRT_VARIANT_SELECTION_IMPL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#include "irt_variant_selection.h"
+#include "irt_context.h"
+#include "irt_logging.h"
+#include "wi_implementation.h"
+#include "work_item.h"
+#include "abstraction/atomic.h"
+
+void irt_variant_selection_init(irt_context* context) {
+	const char* setting = getenv(IRT_VARIANT_SELECTION_ENV);
+	irt_g_variant_selection_adaptive = setting && strcmp(setting, "adaptive") == 0;
+	irt_log_setting_s(IRT_VARIANT_SELECTION_ENV, irt_g_variant_selection_adaptive ? "adaptive" : "default");
+	const char* filename = getenv(IRT_VARIANT_SELECTION_FILE_ENV);
+	if(irt_g_variant_selection_adaptive && filename) {
+		irt_log_setting_s(IRT_VARIANT_SELECTION_FILE_ENV, filename);
+		if(!irt_variant_selection_load(context, filename)) {
+			irt_log_comment("no usable variant selection statistics found, starting from scratch");
+		}
+	}
+}
+
+void irt_variant_selection_finalize(irt_context* context) {
+	const char* filename = getenv(IRT_VARIANT_SELECTION_FILE_ENV);
+	if(irt_g_variant_selection_adaptive && filename) {
+		if(!irt_variant_selection_store(context, filename)) {
+			irt_log_comment("unable to store variant selection statistics");
+		}
+	}
+}
+
+uint32 irt_variant_selection_size_class(const irt_work_item_range* range) {
+	int64 size = irt_wi_range_get_size(range);
+	uint32 size_class = 0;
+	while(size > 1 && size_class < IRT_VARIANT_SELECTION_SIZE_CLASSES - 1) {
+		size >>= 1;
+		++size_class;
+	}
+	return size_class;
+}
+
+uint32 irt_variant_selection_select(irt_wi_implementation* impl, const irt_work_item_range* range, unsigned int* seed) {
+	uint32 size_class = irt_variant_selection_size_class(range);
+	uint32 least_sampled = 0, fastest = 0;
+	uint64 least_samples = UINT64_MAX, total_samples = 0;
+	double fastest_mean = DBL_MAX;
+	for(uint32 i = 0; i < impl->num_variants; ++i) {
+		irt_variant_selection_stats* stats = &impl->variants[i].rt_data.selection_stats[size_class];
+		uint64 samples = stats->num_executions;
+		total_samples += samples;
+		if(samples < least_samples) {
+			least_samples = samples;
+			least_sampled = i;
+		}
+		if(samples > 0) {
+			double mean = (double)stats->total_ticks / samples;
+			if(mean < fastest_mean) {
+				fastest_mean = mean;
+				fastest = i;
+			}
+		}
+	}
+	// measure every variant a few times before trusting the statistics
+	if(least_samples < IRT_VARIANT_SELECTION_MIN_SAMPLES) return least_sampled;
+	// otherwise exploit the fastest variant, but keep exploring with decaying probability
+	if(rand_r(seed) % total_samples < IRT_VARIANT_SELECTION_EXPLORATION * impl->num_variants) {
+		return rand_r(seed) % impl->num_variants;
+	}
+	return fastest;
+}
+
+void irt_variant_selection_record(irt_wi_implementation_variant* variant, const irt_work_item_range* range, uint64 ticks) {
+	irt_variant_selection_stats* stats = &variant->rt_data.selection_stats[irt_variant_selection_size_class(range)];
+	irt_atomic_fetch_and_add(&stats->total_ticks, ticks, uint64);
+	irt_atomic_inc(&stats->num_executions, uint64);
+}
+
+void irt_variant_selection_start(irt_work_item* wi) {
+	wi->variant_ticks = 0;
+	wi->variant_start_ticks = irt_time_ticks();
+}
+
+void irt_variant_selection_suspend(irt_work_item* wi) {
+	if(wi->variant_start_ticks != 0) wi->variant_ticks += irt_time_ticks() - wi->variant_start_ticks;
+}
+
+void irt_variant_selection_resume(irt_work_item* wi) {
+	if(wi->variant_start_ticks != 0) wi->variant_start_ticks = irt_time_ticks();
+}
+
+uint64 irt_variant_selection_elapsed(const irt_work_item* wi) {
+	return wi->variant_ticks + (irt_time_ticks() - wi->variant_start_ticks);
+}
+
+// FNV-1a
+static inline uint64 _irt_variant_selection_hash_step(uint64 hash, uint64 value) {
+	for(uint32 i = 0; i < sizeof(value); ++i) {
+		hash ^= (value >> (8 * i)) & 0xff;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64 irt_variant_selection_table_hash(irt_context* context) {
+	uint64 hash = 14695981039346656037ull;
+	// all implementations of a context reside in the same binary, their offsets are stable between runs
+	uintptr_t base = 0;
+	for(uint32 i = 0; i < context->impl_table_size && base == 0; ++i) {
+		if(context->impl_table[i].num_variants > 0) base = (uintptr_t)context->impl_table[i].variants[0].implementation;
+	}
+	hash = _irt_variant_selection_hash_step(hash, context->impl_table_size);
+	for(uint32 i = 0; i < context->impl_table_size; ++i) {
+		irt_wi_implementation* impl = &context->impl_table[i];
+		hash = _irt_variant_selection_hash_step(hash, impl->num_variants);
+		for(uint32 j = 0; j < impl->num_variants; ++j) {
+			irt_wi_implementation_variant* variant = &impl->variants[j];
+			hash = _irt_variant_selection_hash_step(hash, (uint64)((uintptr_t)variant->implementation - base));
+			hash = _irt_variant_selection_hash_step(hash, variant->num_required_data_items);
+			hash = _irt_variant_selection_hash_step(hash, variant->num_required_channels);
+		}
+	}
+	return hash;
+}
+
+bool irt_variant_selection_load(irt_context* context, const char* filename) {
+	FILE* file = fopen(filename, "r");
+	if(!file) return false;
+	char header[32];
+	uint32 impl_table_size;
+	uint64 table_hash;
+	// statistics of a different program are of no use
+	if(fscanf(file, "%31s %u %" SCNx64, header, &impl_table_size, &table_hash) != 3 || strcmp(header, IRT_VARIANT_SELECTION_FILE_HEADER) != 0
+			|| impl_table_size != context->impl_table_size || table_hash != irt_variant_selection_table_hash(context)) {
+		fclose(file);
+		return false;
+	}
+	uint32 impl_index, variant_index, size_class;
+	uint64 num_executions, total_ticks;
+	while(fscanf(file, "%u %u %u %" SCNu64 " %" SCNu64, &impl_index, &variant_index, &size_class, &num_executions, &total_ticks) == 5) {
+		if(impl_index >= context->impl_table_size || variant_index >= context->impl_table[impl_index].num_variants
+				|| size_class >= IRT_VARIANT_SELECTION_SIZE_CLASSES) {
+			continue;
+		}
+		irt_variant_selection_stats* stats = &context->impl_table[impl_index].variants[variant_index].rt_data.selection_stats[size_class];
+		stats->num_executions = num_executions;
+		stats->total_ticks = total_ticks;
+	}
+	fclose(file);
+	return true;
+}
+
+bool irt_variant_selection_store(irt_context* context, const char* filename) {
+	FILE* file = fopen(filename, "w");
+	if(!file) return false;
+	fprintf(file, "%s %u %" PRIx64 "\n", IRT_VARIANT_SELECTION_FILE_HEADER, context->impl_table_size, irt_variant_selection_table_hash(context));
+	for(uint32 i = 0; i < context->impl_table_size; ++i) {
+		irt_wi_implementation* impl = &context->impl_table[i];
+		// a single variant leaves nothing to select
+		if(impl->num_variants < 2) continue;
+		for(uint32 j = 0; j < impl->num_variants; ++j) {
+			for(uint32 c = 0; c < IRT_VARIANT_SELECTION_SIZE_CLASSES; ++c) {
+				irt_variant_selection_stats* stats = &impl->variants[j].rt_data.selection_stats[c];
+				if(stats->num_executions == 0) continue;
+				fprintf(file, "%u %u %u %" PRIu64 " %" PRIu64 "\n", i, j, c, stats->num_executions, stats->total_ticks);
+			}
+		}
+	}
+	return fclose(file) == 0;
+}
+
+#endif // ifndef __GUARD_IMPL_IRT_VARIANT_SELECTION_IMPL_H
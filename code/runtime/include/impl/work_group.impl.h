@@ -43,18 +43,29 @@
 #include "impl/work_item.impl.h"
 #include "abstraction/atomic.h"
 #include "impl/instrumentation_events.impl.h"
+#include "hwinfo.h"
 
-static inline irt_work_group* _irt_wg_new() {
-	return (irt_work_group*)malloc(sizeof(irt_work_group));
+static inline irt_work_group* _irt_wg_new(irt_worker* self) {
+	// wgs are reused rather than freed, since their event register may be accessed using stale ids
+	irt_work_group* wg = self->wg_reuse_stack;
+	if(wg) {
+		self->wg_reuse_stack = wg->next_reuse;
+	} else {
+		wg = (irt_work_group*)malloc(sizeof(irt_work_group));
+		irt_wg_event_register_init(&wg->event_register);
+	}
+	return wg;
 }
 static inline void _irt_wg_recycle(irt_work_group* wg) {
 	free(wg->redistribute_data_array);
-	// TODO reuse list?
-	free(wg);
+	free(wg->barrier_data);
+	irt_worker* self = irt_worker_get_current();
+	wg->next_reuse = self->wg_reuse_stack;
+	self->wg_reuse_stack = wg;
 }
 
 irt_work_group* _irt_wg_create(irt_worker* self) {
-	irt_work_group* wg = _irt_wg_new();
+	irt_work_group* wg = _irt_wg_new(self);
 	wg->id = irt_generate_work_group_id(IRT_LOOKUP_GENERATOR_ID_PTR);
 	//IRT_ASSERT((wg->id.thread<100) && (wg->id.index<30000), IRT_ERR_INTERNAL, "ALB! t: %d, id: %d", wg->id.thread, wg->id.index); // TODO DEBUG remove!
 	wg->id.cached = wg;
@@ -63,6 +74,8 @@ irt_work_group* _irt_wg_create(irt_worker* self) {
 	wg->ended_member_count = 0;
 	wg->cur_barrier_count = 0;
 	wg->tot_barrier_count = 0;
+	wg->barrier_sense = 0;
+	wg->barrier_data = NULL;
 	wg->pfor_count = 0;
 	wg->joined_pfor_count = 0;
 	wg->redistribute_data_array = NULL;
@@ -83,13 +96,9 @@ irt_work_group* irt_wg_create() {
 void irt_wg_end(irt_work_group* wg) {
 	irt_inst_region_wg_finalize(wg);
 	IRT_DEBUG_ONLY(
-		irt_wg_event_register_id tgid;
-		tgid.full = wg->id.full;
-		tgid.cached = NULL;
-		irt_wg_event_register* reg = irt_wg_event_register_table_lookup(tgid);
-		IRT_ASSERT(reg->handler[IRT_WG_EV_COMPLETED] == NULL, IRT_ERR_INTERNAL, "Unfinished business");
-		IRT_ASSERT(reg->occured_flag[IRT_WG_EV_COMPLETED], IRT_ERR_INTERNAL, "Incomplete triggering");
-		irt_spin_unlock(&reg->lock);
+		uintptr_t completed_handlers = irt_atomic_load(&wg->event_register.handler[IRT_WG_EV_COMPLETED]);
+		IRT_ASSERT((completed_handlers & ~IRT_EVENT_OCCURRED_FLAG) == 0, IRT_ERR_INTERNAL, "Unfinished business");
+		IRT_ASSERT(completed_handlers & IRT_EVENT_OCCURRED_FLAG, IRT_ERR_INTERNAL, "Incomplete triggering");
 	)
 	irt_wg_event_register_destroy(wg->id);
 	irt_spin_destroy(&wg->lock);
@@ -195,8 +204,145 @@ void irt_wg_barrier_smart(irt_work_group* wg) {
 		irt_wg_barrier_scheduled(wg);
 	}
 }
+
+// combining tree barrier
+// Members arrive in groups of IRT_WG_BARRIER_ARITY, the last arrival of each group moves up one level
+// and the last arrival at the root completes the barrier by flipping the sense of the work group.
+// Waiting members spin on the sense for a bounded time and then suspend. Every released member
+// continues its suspended children in a tree of the same fan-in, with member 0 as its root.
+
+#define IRT_WG_BARRIER_RUNNING 0
+#define IRT_WG_BARRIER_SUSPENDED 2 // combined with the sense the member waits for
+
+static inline void _irt_wg_barrier_cpu_relax() {
+	#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+	#endif
+}
+
+// number of nodes required for the given number of members: one per member for its wait state,
+// and one per group of every level of the combining tree for its arrival counter
+static inline uint32 _irt_wg_barrier_num_nodes(uint32 members) {
+	uint32 groups = 0;
+	for(uint32 width = members; width > 1; width = (width + IRT_WG_BARRIER_ARITY - 1) / IRT_WG_BARRIER_ARITY) {
+		groups += (width + IRT_WG_BARRIER_ARITY - 1) / IRT_WG_BARRIER_ARITY;
+	}
+	return MAX(members, groups);
+}
+
+static inline irt_wg_barrier_data* _irt_wg_get_barrier_data(irt_work_group* wg) {
+	irt_wg_barrier_data* tree = wg->barrier_data;
+	if(tree == NULL) {
+		uint32 members = wg->local_member_count;
+		uint32 nodes = _irt_wg_barrier_num_nodes(members);
+		tree = (irt_wg_barrier_data*)calloc(1, sizeof(irt_wg_barrier_data) + sizeof(irt_wg_barrier_node)*nodes);
+		tree->members = members;
+		// spinning only pays off if all members can run at the same time
+		tree->spin_limit = (members <= irt_g_worker_count && irt_g_worker_count <= irt_hw_get_num_cpus()) ? IRT_WG_BARRIER_SPIN_MAX : 0;
+		if(!irt_atomic_bool_compare_and_swap((uintptr_t*)&wg->barrier_data, (uintptr_t)0, (uintptr_t)tree, uintptr_t)) {
+			free(tree);
+			tree = wg->barrier_data;
+		}
+	}
+	return tree;
+}
+
+// registers the arrival of member num, returns true for the last member to arrive
+// (the counters of the groups of all levels are stored consecutively, see _irt_wg_barrier_num_nodes)
+static inline bool _irt_wg_barrier_arrive(irt_wg_barrier_data* tree, uint32 num) {
+	uint32 width = tree->members, index = num, offset = 0;
+	while(width > 1) {
+		uint32 group = index / IRT_WG_BARRIER_ARITY;
+		uint32 groups = (width + IRT_WG_BARRIER_ARITY - 1) / IRT_WG_BARRIER_ARITY;
+		uint32 size = MIN(IRT_WG_BARRIER_ARITY, width - group * IRT_WG_BARRIER_ARITY);
+		irt_wg_barrier_node* node = &tree->nodes[offset + group];
+		if(irt_atomic_add_and_fetch(&node->arrived, 1, uint32) < size) return false;
+		// group complete, nobody else touches its counter before the barrier completes
+		node->arrived = 0;
+		offset += groups;
+		index = group;
+		width = groups;
+	}
+	return true;
+}
+
+static inline bool _irt_wg_barrier_spin(irt_work_group* wg, irt_wg_barrier_data* tree, uint32 sense) {
+	uint32 limit = tree->spin_limit;
+	if(limit == 0) return false;
+	for(uint32 i = 0; i < limit; ++i) {
+		if(irt_atomic_load(&wg->barrier_sense) == sense) {
+			// move towards twice the number of iterations it took, as for irt_lock
+			limit = limit + ((int32)(2*i) - (int32)limit) / 8;
+			tree->spin_limit = MIN(MAX(limit, IRT_WG_BARRIER_SPIN_MIN), IRT_WG_BARRIER_SPIN_MAX);
+			return true;
+		}
+		_irt_wg_barrier_cpu_relax();
+	}
+	// members sharing a worker can not arrive while this one spins, back off
+	// (races only lose updates of a heuristic value)
+	tree->spin_limit = MAX(limit / 2, IRT_WG_BARRIER_SPIN_MIN);
+	return false;
+}
+
+// continues member num if it is suspended waiting for the given sense
+static inline void _irt_wg_barrier_wake(irt_wg_barrier_data* tree, uint32 num, uint32 sense) {
+	irt_wg_barrier_node* node = &tree->nodes[num];
+	// a stale wakeup from the previous barrier can not match, since the sense differs
+	if(irt_atomic_load(&node->state) == (IRT_WG_BARRIER_SUSPENDED | sense)
+			&& irt_atomic_bool_compare_and_swap(&node->state, IRT_WG_BARRIER_SUSPENDED | sense, IRT_WG_BARRIER_RUNNING, uint32)) {
+		irt_scheduling_continue_wi(node->worker, node->wi);
+		irt_signal_worker(node->worker);
+	}
+}
+
+static inline void _irt_wg_barrier_wake_children(irt_wg_barrier_data* tree, uint32 num, uint32 sense) {
+	uint32 first = num * IRT_WG_BARRIER_ARITY + 1;
+	for(uint32 child = first; child < first + IRT_WG_BARRIER_ARITY && child < tree->members; ++child) {
+		_irt_wg_barrier_wake(tree, child, sense);
+	}
+}
+
+void irt_wg_barrier_tree(irt_work_group* wg) {
+	irt_worker* self = irt_worker_get_current();
+	irt_work_item* swi = self->cur_wi;
+	IRT_ASSERT(wg->id.index != 0, IRT_ERR_INTERNAL, "WG 0 barrier");
+	irt_wg_barrier_data* tree = _irt_wg_get_barrier_data(wg);
+	if(tree->members != wg->local_member_count) {
+		// membership changed since the tree was built
+		irt_wg_barrier_scheduled(wg);
+		return;
+	}
+	uint32 num = irt_wg_get_wi_num(wg, swi);
+	// the sense can not change before this member arrived
+	uint32 sense = 1 - irt_atomic_load(&wg->barrier_sense);
+	if(_irt_wg_barrier_arrive(tree, num)) {
+		irt_inst_insert_wg_event(self, IRT_INST_WORK_GROUP_BARRIER_COMPLETE, wg->id);
+		irt_atomic_store(&wg->barrier_sense, sense);
+		if(num != 0) _irt_wg_barrier_wake(tree, 0, sense);
+	} else if(!_irt_wg_barrier_spin(wg, tree, sense)) {
+		irt_wg_barrier_node* node = &tree->nodes[num];
+		node->wi = swi;
+		node->worker = self;
+		irt_atomic_store(&node->state, IRT_WG_BARRIER_SUSPENDED | sense);
+		// suspend unless the barrier completed meanwhile and no waker claimed this member yet
+		if(irt_atomic_load(&wg->barrier_sense) != sense
+				|| !irt_atomic_bool_compare_and_swap(&node->state, IRT_WG_BARRIER_SUSPENDED | sense, IRT_WG_BARRIER_RUNNING, uint32)) {
+			irt_inst_region_end_measurements(swi);
+			irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_SUSPENDED_BARRIER, swi->id);
+			_irt_worker_switch_from_wi(self, swi);
+			irt_inst_region_start_measurements(swi);
+			irt_inst_insert_wi_event(irt_worker_get_current(), IRT_INST_WORK_ITEM_RESUMED_BARRIER, swi->id); // self might no longer be self!
+		}
+	}
+	_irt_wg_barrier_wake_children(tree, num, sense);
+}
+
 inline void irt_wg_barrier(irt_work_group* wg) {
+#ifdef IRT_WG_BARRIER_SCHEDULED
 	irt_wg_barrier_scheduled(wg);
+#else
+	irt_wg_barrier_tree(wg);
+#endif // IRT_WG_BARRIER_SCHEDULED
 #ifdef IRT_ENABLE_APP_TIME_ACCOUNTING
 	irt_atomic_add_and_fetch(&irt_g_app_progress, 1, uint64);
 #endif // IRT_ENABLE_APP_TIME_ACCOUNTING
@@ -41,6 +41,7 @@
 #include "work_item.h"
 
 #include <stdlib.h>
+#include <stddef.h>
 #include "impl/worker.impl.h"
 #include "utils/impl/minlwt.impl.h"
 #include "abstraction/atomic.h"
@@ -50,6 +51,7 @@
 #include "impl/irt_events.impl.h"
 #include "impl/instrumentation_regions.impl.h"
 #include "impl/instrumentation_events.impl.h"
+#include "impl/irt_variant_selection.impl.h"
 #include "irt_types.h"
 
 static inline irt_wi_wg_membership irt_wi_get_wg_membership(irt_work_item *wi, uint32 index) {
@@ -80,6 +82,7 @@ static inline irt_work_item* _irt_wi_new(irt_worker* self) {
 	} else {
 		ret = (irt_work_item*)malloc(sizeof(irt_work_item));
 		ret->wg_memberships = NULL;
+		irt_wi_event_register_init(&ret->event_register);
 		//IRT_DEBUG("WI_FU\n");
 	}
 	return ret;
@@ -134,6 +137,8 @@ static inline void _irt_wi_init(irt_worker* self, irt_work_item* wi, const irt_w
 	irt_atomic_store(&wi->state, IRT_WI_STATE_NEW);
 	wi->source_id = irt_work_item_null_id();
 	wi->num_fragments = 0;
+	wi->variant_start_ticks = 0;
+	wi->variant_ticks = 0;
 	wi->stack_storage = NULL;
 	wi->wg_memberships = NULL;
 	// if this WI has a parent (which means it's not the entry point) migrate some values
@@ -171,10 +176,14 @@ static inline irt_work_item* irt_wi_create(irt_work_item_range range, irt_wi_imp
 irt_work_item* _irt_wi_create_fragment(irt_work_item* source, irt_work_item_range range) {
 	irt_worker *self = irt_worker_get_current();
 	irt_work_item* retval = _irt_wi_new(self);
-	memcpy(retval, source, sizeof(irt_work_item));
+	// the event register of the reused wi may still be accessed by threads holding a stale id
+	memcpy(retval, source, offsetof(irt_work_item, event_register));
 	retval->id = irt_generate_work_item_id(IRT_LOOKUP_GENERATOR_ID_PTR);
 	retval->id.cached = retval;
+	irt_wi_event_register_create(retval->id);
 	retval->num_fragments = 0;
+	retval->variant_start_ticks = 0;
+	retval->variant_ticks = 0;
 	retval->range = range;
 	irt_inst_region_list_copy(retval, self->cur_wi);
 	irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_CREATED, retval->id);
@@ -325,6 +334,9 @@ void irt_wi_end(irt_work_item* wi) {
 	IRT_DEBUG(" ! %p end\n", (void*) wi);
 
 	irt_wi_implementation *wimpl = wi->impl;
+	if(wi->variant_start_ticks != 0 && wimpl->num_variants > 1) {
+		irt_variant_selection_record(&(wimpl->variants[wi->selected_impl_variant]), &wi->range, irt_variant_selection_elapsed(wi));
+	}
 	irt_optimizer_remove_dvfs(&(wimpl->variants[wi->selected_impl_variant]));
 	irt_optimizer_compute_optimizations(&(wimpl->variants[wi->selected_impl_variant]), wi, false);
 
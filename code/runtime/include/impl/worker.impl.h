@@ -59,6 +59,7 @@
 #include "utils/impl/affinity.impl.h"
 #include "impl/error_handling.impl.h"
 #include "impl/instrumentation_events.impl.h"
+#include "impl/irt_variant_selection.impl.h"
 #include "meta_information/meta_infos.h"
 #include "utils/frequency.h"
 
@@ -157,7 +158,7 @@ void* _irt_worker_func(void *argvp) {
 #endif // IRT_ENABLE_APP_TIME_ACCOUNTING
 
 #ifdef IRT_ENABLE_INSTRUMENTATION
-	self->instrumentation_event_data = irt_inst_create_event_data_table();
+	self->instrumentation_event_data = irt_inst_create_event_data_table(self);
 #endif
 #ifdef IRT_OCL_INSTR
 	self->event_data = irt_ocl_create_event_table();
@@ -176,6 +177,7 @@ void* _irt_worker_func(void *argvp) {
 	self->wi_ev_register_list = NULL; // prepare some?
 	self->wg_ev_register_list = NULL; // prepare some?
 	self->wi_reuse_stack = NULL; // prepare some?
+	self->wg_reuse_stack = NULL;
 	self->stack_reuse_stack = NULL;
 
 	irt_atomic_store(&self->state, IRT_WORKER_STATE_READY);
@@ -198,10 +200,12 @@ void* _irt_worker_func(void *argvp) {
 	return NULL;
 }
 
-uint32 _irt_worker_select_implementation_variant(const irt_worker* self, const irt_work_item* wi) {
+uint32 _irt_worker_select_implementation_variant(irt_worker* self, const irt_work_item* wi) {
 	irt_wi_implementation *wimpl = wi->impl;
 	#ifndef IRT_TASK_OPT
-	if(self->default_variant < wimpl->num_variants) {
+	if(irt_g_variant_selection_adaptive && wimpl->num_variants > 1) {
+		return irt_variant_selection_select(wimpl, &wi->range, &self->rand_seed);
+	} else if(self->default_variant < wimpl->num_variants) {
 		return self->default_variant;
 	} else {
 		return 0;
@@ -223,6 +227,13 @@ void _irt_worker_switch_to_wi(irt_worker* self, irt_work_item *wi) {
 	if(irt_atomic_load(&wi->state) == IRT_WI_STATE_NEW) {
 		// start WI from scratch
 		irt_atomic_store(&wi->state, IRT_WI_STATE_STARTED);
+		//determine and store the implementation variant to use, its stack usage determines the stack size
+		wi->selected_impl_variant = _irt_worker_select_implementation_variant(self, wi);
+		if(irt_g_variant_selection_adaptive && wi->impl->num_variants > 1) {
+			irt_variant_selection_start(wi);
+		} else {
+			wi->variant_start_ticks = 0;
+		}
 		lwt_prepare(self->id.thread, wi, &self->basestack);
 		self->cur_wi = wi;
 		#ifdef USING_MINLWT
@@ -233,8 +244,6 @@ void _irt_worker_switch_to_wi(irt_worker* self, irt_work_item *wi) {
 		IRT_VERBOSE_ONLY(_irt_worker_print_debug_info(self));
 		irt_inst_region_start_measurements(wi);
 		irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_STARTED, wi->id);
-		//determine and store the implementation variant to use
-		wi->selected_impl_variant = _irt_worker_select_implementation_variant(self, wi);
 		irt_wi_implementation_variant* impl_variant = &(wi->impl->variants[wi->selected_impl_variant]);
 		//and start that variant
 		irt_optimizer_apply_dvfs(impl_variant);
@@ -254,6 +263,7 @@ void _irt_worker_switch_to_wi(irt_worker* self, irt_work_item *wi) {
 		irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_RESUMED_UNKNOWN, wi->id);
 		irt_wi_implementation *wimpl = wi->impl;
 		irt_optimizer_apply_dvfs(&(wimpl->variants[wi->selected_impl_variant]));
+		irt_variant_selection_resume(wi);
 		lwt_continue(&wi->stack_ptr, &self->basestack);
 		IRT_DEBUG("Worker %p _irt_worker_switch_to_wi - 2B.", (void*) self);
 		IRT_VERBOSE_ONLY(_irt_worker_print_debug_info(self));
@@ -263,6 +273,7 @@ void _irt_worker_switch_to_wi(irt_worker* self, irt_work_item *wi) {
 void _irt_worker_switch_from_wi(irt_worker* self, irt_work_item *wi) {
 	irt_wi_implementation *wimpl = wi->impl;
 	irt_optimizer_remove_dvfs(&(wimpl->variants[wi->selected_impl_variant]));
+	irt_variant_selection_suspend(wi);
 	lwt_continue(&self->basestack, &wi->stack_ptr);
 }
 
@@ -293,7 +304,23 @@ void irt_worker_run_immediate(irt_worker* target, const irt_work_item_range* ran
 	self->num_active_children = &active_child_count;
 	// call wi
 	self->selected_impl_variant = _irt_worker_select_implementation_variant(target, self);
-	(impl->variants[self->selected_impl_variant].implementation)(self);
+	// the immediate execution has its own clock, the clock of the current wi only keeps running while it runs
+	uint64 prev_variant_start_ticks = self->variant_start_ticks;
+	uint64 prev_variant_ticks = self->variant_ticks;
+	if(prev_variant_start_ticks != 0 || (irt_g_variant_selection_adaptive && impl->num_variants > 1)) {
+		uint64 start_ticks = irt_time_ticks();
+		irt_variant_selection_start(self);
+		(impl->variants[self->selected_impl_variant].implementation)(self);
+		uint64 ticks = irt_variant_selection_elapsed(self);
+		if(irt_g_variant_selection_adaptive && impl->num_variants > 1) {
+			irt_variant_selection_record(&impl->variants[self->selected_impl_variant], &self->range, ticks);
+		}
+		// exclude the time the immediate execution was suspended from the clock of the current wi
+		self->variant_ticks = prev_variant_ticks;
+		self->variant_start_ticks = prev_variant_start_ticks != 0 ? prev_variant_start_ticks + (irt_time_ticks() - start_ticks - ticks) : 0;
+	} else {
+		(impl->variants[self->selected_impl_variant].implementation)(self);
+	}
 	// restore active child number(s)
 	self->num_active_children = self->parent_num_active_children;
 	self->parent_num_active_children = prev_parent_active_child_count;
@@ -382,13 +409,25 @@ void irt_worker_cleanup(irt_worker* self) {
 		}
 		self->wi_reuse_stack = NULL;
 	}
+	// clean up WG reuse stack
+	{
+		irt_work_group *cur, *next;
+		cur = self->wg_reuse_stack;
+		while(cur) {
+			next = cur->next_reuse;
+			free(cur);
+			cur = next;
+		}
+		self->wg_reuse_stack = NULL;
+	}
+	// clean up idle work item stacks
+	lwt_cleanup_stacks(self->id.thread);
 	// clean up event register reuse stacks
 	{ // wi registers
 		irt_wi_event_register *cur, *next;
 		cur = self->wi_ev_register_list;
 		while(cur) {
 			next = cur->lookup_table_next;
-			irt_spin_destroy(&cur->lock);
 			free(cur);
 			cur = next;
 		}
@@ -399,12 +438,15 @@ void irt_worker_cleanup(irt_worker* self) {
 		cur = self->wg_ev_register_list;
 		while(cur) {
 			next = cur->lookup_table_next;
-			irt_spin_destroy(&cur->lock);
 			free(cur);
 			cur = next;
 		}
 		self->wg_ev_register_list = NULL;
 	}
+#if IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV || IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CIRCULAR
+	// clean up work stealing data
+	irt_scheduling_cleanup_worker(self);
+#endif
 }
 
 
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+#ifndef __GUARD_INSTRUMENTATION_EVENT_TRACE_H
+#define __GUARD_INSTRUMENTATION_EVENT_TRACE_H
+
+#include <stdio.h>
+
+#include "instrumentation_events.h"
+
+// -----------------------------------------------------------------------------------------------------------------
+//													File Format
+// -----------------------------------------------------------------------------------------------------------------
+
+/*
+ * Compressed event trace as written by the streaming event output (one file per worker). Unlike the
+ * INSIEME1 format (see instrumentation_events.h), it is written incrementally while the program runs.
+ *
+ *  8 byte: char, file version identifier, must read "INSIEME2"!
+ *  8 byte: uint64, clock ticks per second (written when the trace is closed, 0 if it was never closed)
+ * -------------------------------------------------------------
+ *  4 byte: uint32, number of event name table entries (=n)
+ *  4 byte: char, event group identifier 1
+ * 60 byte: char, event name identifier 1
+ * ...
+ * ...
+ * ...
+ *  4 byte: char, event group identifier n
+ * 60 byte: char, event name identifier n
+ * -------------------------------------------------------------
+ * any number of blocks until EOF, each consisting of
+ *  varint: number of events in the block (=k)
+ *  varint: zigzag encoded timestamp (clock ticks) difference to the previous event of the file 1
+ *  varint: event id 1
+ *  varint: thread id 1
+ *  varint: target index 1
+ *  ...
+ *  ...
+ *  ...
+ *  varint: zigzag encoded timestamp (clock ticks) difference to the previous event of the file k
+ *  varint: event id k
+ *  varint: thread id k
+ *  varint: target index k
+ * -------------------------------------------------------------
+ * EOF
+ * (note: the strings are written without the termination character '\0' and padded with blanks,
+ *  varints store 7 bits per byte starting with the least significant ones, the highest bit of
+ *  each byte marks whether another byte follows, the timestamp of the first event is relative to 0)
+ */
+
+#define IRT_INST_EVENT_TRACE_VERSION "INSIEME2"
+#define IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH 4
+#define IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH 60
+
+typedef struct _irt_inst_event_trace_reader {
+	FILE* file;
+	uint64 ticks_per_sec;
+	uint32 num_event_types;
+	char (*group_names)[IRT_INST_EVENT_TRACE_GROUP_NAME_LENGTH+1];
+	char (*event_names)[IRT_INST_EVENT_TRACE_EVENT_NAME_LENGTH+1];
+	uint64 last_timestamp;
+	uint64 remaining_block_events;
+} irt_inst_event_trace_reader;
+
+// writing
+
+void irt_inst_event_trace_write_header(FILE* file);
+void irt_inst_event_trace_write_block(FILE* file, const irt_instrumentation_event_data* events, uint32 count, uint64* last_timestamp);
+void irt_inst_event_trace_write_ticks_per_sec(FILE* file, uint64 ticks_per_sec);
+
+// reading
+
+bool irt_inst_event_trace_open(irt_inst_event_trace_reader* reader, FILE* file);
+bool irt_inst_event_trace_next(irt_inst_event_trace_reader* reader, irt_instrumentation_event_data* event);
+void irt_inst_event_trace_close(irt_inst_event_trace_reader* reader);
+
+#endif // #ifndef __GUARD_INSTRUMENTATION_EVENT_TRACE_H
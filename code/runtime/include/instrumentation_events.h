@@ -41,6 +41,7 @@
 #include <stdio.h>
 
 #include "declarations.h"
+#include "abstraction/threads.h"
 
 #ifdef USE_OPENCL
 #define IRT_ENABLE_INSTRUMENTATION
@@ -99,8 +100,27 @@ typedef struct _irt_instrumentation_event_data_table {
 	uint32 size;
 	uint32 number_of_elements;
 	irt_instrumentation_event_data* data;
+	struct _irt_instrumentation_event_stream* stream; // NULL unless streaming output is enabled
 } irt_instrumentation_event_data_table;
 
+// in streaming mode, the table of a worker only holds the block it is currently filling while the
+// other one may be written to disk by the writer thread in the background
+typedef struct _irt_instrumentation_event_stream {
+	irt_instrumentation_event_data* blocks[2];
+	volatile uint32 pending_elements[2]; // number of events in a full block handed to the writer, 0 if free
+	uint32 current;
+	FILE* file;
+	uint64 last_timestamp;
+} irt_instrumentation_event_stream;
+
+typedef struct _irt_instrumentation_event_stream_writer {
+	irt_thread thread;
+	irt_cond_bundle signal;
+	volatile bool running;
+	volatile uint32 num_tables; // one past the highest worker index owning a stream
+	irt_instrumentation_event_data_table* volatile tables[IRT_MAX_WORKERS];
+} irt_instrumentation_event_stream_writer;
+
 #ifdef USE_OPENCL
 
 typedef struct _irt_inst_ocl_performance_helper {
@@ -121,7 +141,7 @@ typedef enum {
 
 // functions for creating and destroying performance tables
 
-irt_instrumentation_event_data_table* irt_inst_create_event_data_table();
+irt_instrumentation_event_data_table* irt_inst_create_event_data_table(irt_worker* worker);
 
 void irt_inst_destroy_event_data_table(irt_instrumentation_event_data_table* table);
 
@@ -145,6 +165,11 @@ void irt_inst_event_data_output(irt_worker* worker, bool binary_format);
 void irt_inst_region_context_data_output(irt_worker* worker);
 void irt_inst_aggregated_data_output();
 
+// streaming output functions
+
+void irt_inst_event_stream_start();
+void irt_inst_event_stream_finalize();
+
 // instrumentation function pointer toggle functions
 
 void irt_inst_set_wi_instrumentation(bool enable);
@@ -172,6 +197,8 @@ void (*irt_inst_insert_wo_event)(irt_worker* worker, irt_instrumentation_event e
 void (*irt_inst_insert_db_event)(irt_worker* worker, irt_instrumentation_event event, irt_worker_id subject_id) = &_irt_inst_insert_no_db_event;
 bool irt_g_instrumentation_event_output_is_enabled = false;
 bool irt_g_instrumentation_event_output_is_binary = false;
+bool irt_g_instrumentation_event_output_is_streaming = false;
+irt_instrumentation_event_stream_writer irt_g_inst_event_stream_writer;
 
 #endif // IRT_ENABLE_INSTRUMENTATION
 
@@ -210,6 +237,8 @@ bool irt_g_instrumentation_event_output_is_binary = false;
  * -------------------------------------------------------------
  * EOF
  * (note: the strings are written without the termination character '\0'!)
+ *
+ * For the compressed format written by the streaming output see instrumentation_event_trace.h
  */
 
 #endif // #ifndef __GUARD_INSTRUMENTATION_EVENTS_H
@@ -93,6 +93,25 @@ typedef struct {
 #include "irt_metrics.def"
 } irt_inst_region_context_data;
 
+// per-worker accumulator of a region, only folded into irt_inst_region_context_data by irt_inst_region_merge
+// AVG metrics are kept as (sum, count) and NONE metrics as (value, sequence stamp) such that they can be merged
+typedef struct {
+	uint64 num_executions;
+#define METRIC(_name__, _id__, _unit__, _data_type__, _format_string__, _scope__, _aggregation__, _group__, _wi_start_code__, wi_end_code__, _region_early_start_code__, _region_late_end_code__, _output_conversion_code__) \
+	_data_type__ aggregated_##_name__; \
+	double sum_##_name__; \
+	uint64 count_##_name__;
+#include "irt_metrics.def"
+} irt_inst_region_worker_data;
+
+// ring buffer made of IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS segments of IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE slots each,
+// segments are allocated on first use and freed as soon as all of their slots have been retired
+typedef struct {
+	void* volatile segments[IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS];
+	volatile uint32 retired[IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SEGMENTS];
+	uint32 slot_size;
+} irt_inst_region_ring_buffer;
+
 typedef struct {
 	volatile uint64 region_entries;
 	volatile uint64 region_exits;
@@ -134,6 +153,8 @@ void irt_inst_region_finalize_worker(irt_worker* worker);
 
 void irt_inst_region_propagate_data_from_wi_to_regions(irt_work_item* wi);
 
+void irt_inst_region_merge(irt_context* context);
+
 void irt_inst_region_start_measurements(irt_work_item* wi);
 
 void irt_inst_region_end_measurements(irt_work_item* wi);
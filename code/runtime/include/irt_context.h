@@ -69,6 +69,7 @@ struct _irt_context {
 	uint32 num_regions;													// initialized by compiler
 #ifdef IRT_ENABLE_REGION_INSTRUMENTATION
 	irt_inst_region_context_data* inst_region_data;							// initialized by runtime
+	irt_inst_region_worker_data** inst_region_worker_data;					// initialized by runtime, one entry per worker
 	irt_inst_region_context_declarations inst_region_metric_group_support_data;					// initialized by runtime
 #endif
 
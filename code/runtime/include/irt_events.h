@@ -70,6 +70,9 @@
 
 
 
+// marks an event as occurred in the handler list of an event register
+#define IRT_EVENT_OCCURRED_FLAG ((uintptr_t)1)
+
 // Event system declarations
 #define IRT_DECLARE_EVENTS(__subject__, __short__, __num_events__) \
  \
@@ -89,12 +92,17 @@ typedef struct _irt_##__short__##_event_lambda { \
 	struct _irt_##__short__##_event_lambda *next; \
 } irt_##__short__##_event_lambda; \
  \
-/* The internal event register used to manage registered items and events */ \
+/* The internal event register used to manage registered items and events.
+ * The registers of local items are embedded in the item and found using the cached pointer
+ * of its id, only items without a cached pointer are looked up in the register table.
+ * Registers are never locked, all state is modified using atomic operations. */ \
 struct _irt_##__short__##_event_register { \
-	irt_spinlock lock; \
+	/* the full id of the item, 0 while the register is not in use */ \
 	irt_##__short__##_event_register_id id; \
-	bool occured_flag[__num_events__]; \
-	irt_##__short__##_event_lambda *handler[__num_events__]; \
+	/* number of threads currently accessing the register, it is not reused before this drops to 0 */ \
+	volatile uint32 users; \
+	/* lock-free stack of handlers per event, the lowest bit is the occurred flag */ \
+	volatile uintptr_t handler[__num_events__]; \
 	struct _irt_##__short__##_event_register *lookup_table_next; \
 }; \
 IRT_MAKE_ID_TYPE(__short__##_event_register) \
@@ -103,6 +111,9 @@ IRT_MAKE_ID_TYPE(__short__##_event_register) \
 _IRT_EVENT_DEBUG_DEFINES(__short__) \
  \
  \
+/* Prepares the memory of an embedded event register, needs to be called once after allocating the containing item */ \
+void irt_##__short__##_event_register_init(irt_##__short__##_event_register* reg); \
+ \
 /* Creates a new event register for a given ##__short__##_item identified by ##__short__##_id */ \
 void irt_##__short__##_event_register_create(const irt_##__subject__##_id item_id); \
  \
@@ -121,7 +132,8 @@ bool irt_##__short__##_event_handler_register(const irt_##__subject__##_id item_
  * exist or the event already happened) */ \
 bool irt_##__short__##_event_handler_check_and_register(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code, irt_##__short__##_event_lambda* handler); \
  \
-/* Removes a given event handler for the ##__short__##_item identified by##__short__##_id, for the event event_code */ \
+/* Removes a given event handler for the ##__short__##_item identified by##__short__##_id, for the event event_code.
+ * Must not be called concurrently to triggering the same event. */ \
 void irt_##__short__##_event_handler_remove(const irt_##__subject__##_id item_id, const irt_##__short__##_event_code event_code, irt_##__short__##_event_lambda* handler); \
  \
 /* Triggers the event event_code on ##__short__##_id, failing in case the register doesn't exist. \
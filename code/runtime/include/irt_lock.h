@@ -41,21 +41,63 @@
 #include "declarations.h"
 #include "abstraction/threads.h"
 
+/*
+ * Locks are acquired in two phases: a bounded spinning phase, followed by suspending the calling
+ * work item. The spinning budget of each lock is tuned adaptively - it grows while spinning succeeds
+ * and shrinks while acquisitions end up suspending anyway.
+ *
+ * Suspended work items are queued in FIFO order. A release hands the lock directly to the oldest
+ * waiter (the lock remains held throughout), hence spinning acquirers can not overtake queued ones.
+ */
+
 typedef struct _locked_wi {
 	irt_work_item *wi;
 	irt_worker *worker;
+	bool exclusive;				// false for readers waiting on a irt_rwlock
 	struct _locked_wi *next;
 } locked_wi;
 
+// contention statistics of a lock
+typedef struct _irt_lock_stats {
+	uint64 acquisitions;		// total number of acquisitions
+	uint64 contended;			// acquisitions which did not succeed immediately
+	uint64 suspended;			// acquisitions which had to suspend the acquiring work item
+} irt_lock_stats;
+
 struct _irt_lock {
-	irt_spinlock mutex;
-	uint32 locked;
-	locked_wi *top;
+	volatile uint32 locked;
+	volatile uint32 spin_limit;	// current spinning budget, within [IRT_LOCK_SPIN_MIN, IRT_LOCK_SPIN_MAX]
+	irt_spinlock mutex;			// protects the waiter queue
+	locked_wi *front, *back;
+	irt_lock_stats stats;		// only modified by the holder of the lock
 };
 
 void irt_lock_init(irt_lock* lock);
 void irt_lock_acquire(irt_lock* lock);
 void irt_lock_release(irt_lock* lock);
 
+irt_lock_stats irt_lock_get_stats(irt_lock* lock);
+
+/*
+ * A reader-writer lock sharing the acquisition scheme of irt_lock. Readers are only admitted
+ * as long as no writer is queued, and a releasing writer admits all readers at the front of the queue.
+ */
+
+struct _irt_rwlock {
+	volatile uint32 state;		// bit 0: held by a writer, remaining bits: number of readers
+	volatile uint32 spin_limit;
+	irt_spinlock mutex;
+	locked_wi *front, *back;
+	irt_lock_stats stats;		// updated atomically, readers hold the lock concurrently
+};
+
+void irt_rwlock_init(irt_rwlock* lock);
+void irt_rwlock_read_acquire(irt_rwlock* lock);
+void irt_rwlock_read_release(irt_rwlock* lock);
+void irt_rwlock_write_acquire(irt_rwlock* lock);
+void irt_rwlock_write_release(irt_rwlock* lock);
+
+irt_lock_stats irt_rwlock_get_stats(irt_rwlock* lock);
+
 
 #endif // ifndef __GUARD_IRT_LOCK_H
@@ -40,6 +40,7 @@
 
 #include "declarations.h"
 #include "irt_optimizer.h"
+#include "abstraction/threads.h"
 #include "insieme/common/common.h"
 #ifdef __cplusplus
 using namespace insieme::common;
@@ -58,10 +59,21 @@ struct _irt_loop_sched_policy {
 static irt_loop_sched_policy irt_g_loop_sched_policy_default;
 static irt_loop_sched_policy irt_g_loop_sched_policy_single;
 
+// the part of the iteration space owned by a participant of a range stealing loop, padded to a cache line
+typedef struct _irt_loop_sched_range {
+	volatile uint64 begin;		// remaining iterations [begin, end), as indices into the iteration space
+	volatile uint64 end;
+	uint64 executed;			// number of iterations executed by the owning participant
+	irt_spinlock lock;
+	char padding[64 - 3 * sizeof(uint64) - sizeof(irt_spinlock)];
+} irt_loop_sched_range;
+
 struct _irt_loop_sched_data {
 	irt_loop_sched_policy policy;
 	volatile uint64 completed;
 	volatile uint64 block_size;
+	irt_loop_sched_range* ranges;
+	volatile uint32 ranges_active;
 #ifdef IRT_RUNTIME_TUNING
 	volatile uint32 participants_complete;
 	uint64 start_time;
@@ -45,6 +45,7 @@
 #define IRT_SCHED_POLICY_LAZY_BINARY_SPLIT 2
 #define IRT_SCHED_POLICY_STEALING 3
 #define IRT_SCHED_POLICY_STEALING_CIRCULAR 4
+#define IRT_SCHED_POLICY_STEALING_CHASE_LEV 5
 #define IRT_SCHED_POLICY_UBER 9000
 
 // default scheduling policy
@@ -138,6 +139,8 @@ bool irt_scheduling_worker_sleep(irt_worker *self);
 #include "sched_policies/irt_sched_stealing.h"
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CIRCULAR
 #include "sched_policies/irt_sched_stealing_circular.h"
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV
+#include "sched_policies/irt_sched_stealing_chase_lev.h"
 #elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_UBER
 #include "sched_policies/irt_sched_uber.h"
 #else
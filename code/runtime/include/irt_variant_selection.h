@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+#ifndef __GUARD_IRT_VARIANT_SELECTION_H
+#define __GUARD_IRT_VARIANT_SELECTION_H
+
+#include "declarations.h"
+
+/*
+ * Adaptive implementation variant selection.
+ *
+ * For every implementation variant the runtime records the execution times of its work items, bucketed
+ * by the size class of their range. Once every variant of an implementation has been executed
+ * IRT_VARIANT_SELECTION_MIN_SAMPLES times for a size class, the variant with the lowest mean execution
+ * time is selected, while a random variant is still chosen with a probability decaying with the number
+ * of observed executions to follow changes in the behavior of the program.
+ *
+ * The gathered statistics may be stored to the file named by IRT_VARIANT_SELECTION_FILE_ENV at shutdown
+ * and are loaded from it at startup, such that subsequent runs of the same program start out tuned.
+ * The file contains one line per variant and size class:
+ *
+ *   <implementation index> <variant index> <size class> <number of executions> <total clock ticks>
+ *
+ * preceded by a header line identifying the format, the size of the implementation table and a hash of
+ * its layout (see irt_variant_selection_table_hash).
+ *
+ * The execution time of a work item only covers the time it was running, the time it was suspended
+ * (e.g. waiting for a join, a barrier or a lock) is excluded.
+ */
+
+#define IRT_VARIANT_SELECTION_FILE_HEADER "IRT_VARIANT_SELECTION_V2"
+
+// true if variants are selected adaptively rather than using the default variant
+bool irt_g_variant_selection_adaptive = false;
+
+// reads the settings from the environment and loads the statistics file if configured
+void irt_variant_selection_init(irt_context* context);
+// stores the statistics file if configured
+void irt_variant_selection_finalize(irt_context* context);
+
+// size class of the given range
+uint32 irt_variant_selection_size_class(const irt_work_item_range* range);
+// selects the variant of impl to execute the given range with
+uint32 irt_variant_selection_select(irt_wi_implementation* impl, const irt_work_item_range* range, unsigned int* seed);
+// records an execution of the given range with the given variant
+void irt_variant_selection_record(irt_wi_implementation_variant* variant, const irt_work_item_range* range, uint64 ticks);
+
+// measure the execution time of the selected variant of wi, the clock is stopped while wi is suspended
+void irt_variant_selection_start(irt_work_item* wi);
+void irt_variant_selection_suspend(irt_work_item* wi);
+void irt_variant_selection_resume(irt_work_item* wi);
+// ticks wi was running since irt_variant_selection_start
+uint64 irt_variant_selection_elapsed(const irt_work_item* wi);
+
+// identifies the implementation table of context by the number of variants, their requirements and
+// the relative placement of their implementation functions, such that statistics of a different
+// build of the program are rejected
+uint64 irt_variant_selection_table_hash(irt_context* context);
+
+// loads / stores the statistics of all implementations of context, returns false on failure
+bool irt_variant_selection_load(irt_context* context, const char* filename);
+bool irt_variant_selection_store(irt_context* context, const char* filename);
+
+#endif // ifndef __GUARD_IRT_VARIANT_SELECTION_H
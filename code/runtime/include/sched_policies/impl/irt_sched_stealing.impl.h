@@ -201,16 +201,11 @@ void irt_scheduling_assign_wi(irt_worker* target, irt_work_item* wi) {
 // ------------------------------------------------------------ optional scheduling -----------------------------------
 
 irt_joinable irt_scheduling_optional_wi(irt_worker* target, irt_work_item* wi) {
-	if(target->sched_data.queue.size >= irt_g_worker_count) {
-		irt_work_item_id wi_id = wi->id;
-		_irt_worker_run_optional_wi(target, wi->id);
-		return wi;
-	}
-	else {
-		irt_work_item *real_wi = irt_wi_create(wi->range, wi->impl, wi->parameters);
-		irt_scheduling_assign_wi(target, real_wi);
-		return real_wi;
-	}
+	return irt_scheduling_optional(target, &wi->range, wi->impl, wi->parameters);
+}
+
+void irt_scheduling_generate_wi(irt_worker* target, irt_work_item* wi) {
+	irt_scheduling_assign_wi(target, wi);
 }
 
 void irt_scheduling_yield(irt_worker* self, irt_work_item* yielding_wi) {
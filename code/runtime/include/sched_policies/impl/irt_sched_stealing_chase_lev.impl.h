@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_SCHED_POLICIES_IMPL_IRT_SCHED_STEALING_CHASE_LEV_IMPL_H
+#define __GUARD_SCHED_POLICIES_IMPL_IRT_SCHED_STEALING_CHASE_LEV_IMPL_H
+
+#include "sched_policies/utils/impl/irt_sched_ipc_base.impl.h"
+#include "sched_policies/utils/impl/irt_sched_victim_selection.impl.h"
+#include "sched_policies/irt_sched_stealing_chase_lev.h"
+#include "impl/worker.impl.h"
+
+#include "ir_interface.h"
+
+#ifdef _WIN32
+	#include "../../include_win32/rand_r.h"
+#elif defined(_GEMS_SIM)
+	#include "include_gems/rand_r.h"
+#endif
+
+// ============================================================================ Scheduling (general)
+
+static inline void _irt_cl_inbox_push(irt_worker* target, irt_work_item* wi) {
+	wi->next_reuse = NULL;
+	irt_spin_lock(&target->sched_data.inbox_lock);
+	if(target->sched_data.inbox_back) target->sched_data.inbox_back->next_reuse = wi;
+	else target->sched_data.inbox_front = wi;
+	target->sched_data.inbox_back = wi;
+	irt_spin_unlock(&target->sched_data.inbox_lock);
+}
+
+static inline irt_work_item* _irt_cl_inbox_pop(irt_worker* target) {
+	// unsynchronized check to avoid taking the lock on empty inboxes
+	if(target->sched_data.inbox_front == NULL) return NULL;
+	irt_spin_lock(&target->sched_data.inbox_lock);
+	irt_work_item* wi = target->sched_data.inbox_front;
+	if(wi) {
+		target->sched_data.inbox_front = wi->next_reuse;
+		if(target->sched_data.inbox_front == NULL) target->sched_data.inbox_back = NULL;
+	}
+	irt_spin_unlock(&target->sched_data.inbox_lock);
+	return wi;
+}
+
+void irt_scheduling_init_worker(irt_worker* self) {
+	irt_cld_init(&self->sched_data.queue);
+	self->sched_data.inbox_front = NULL;
+	self->sched_data.inbox_back = NULL;
+	irt_spin_init(&self->sched_data.inbox_lock);
+	irt_sched_victim_selection_init(&self->sched_data.victims);
+}
+
+void irt_scheduling_cleanup_worker(irt_worker* self) {
+	irt_cld_cleanup(&self->sched_data.queue);
+	irt_spin_destroy(&self->sched_data.inbox_lock);
+	irt_sched_victim_selection_cleanup(self, &self->sched_data.victims);
+}
+
+void irt_scheduling_yield(irt_worker* self, irt_work_item* yielding_wi) {
+	IRT_DEBUG("Worker yield, worker: %p,  wi: %p", (void*) self, (void*) yielding_wi);
+	irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_YIELD, yielding_wi->id);
+	// use the inbox, pushing to the deque would resume the yielding wi immediately
+	_irt_cl_inbox_push(self, yielding_wi);
+	_irt_worker_switch_from_wi(self, yielding_wi);
+}
+
+static inline void irt_scheduling_continue_wi(irt_worker* target, irt_work_item* wi) {
+	irt_scheduling_assign_wi(target, wi);
+}
+
+irt_joinable irt_scheduling_optional_wi(irt_worker* target, irt_work_item* wi) {
+	return irt_scheduling_optional(target, &wi->range, wi->impl, wi->parameters);
+}
+
+irt_joinable irt_scheduling_optional(irt_worker* target, const irt_work_item_range* range,
+		irt_wi_implementation* impl, irt_lw_data_item* args) {
+	if(irt_g_worker_count == 1 || irt_cld_size(&target->sched_data.queue) >= IRT_CLDEQUE_OPTIONAL_THRESHOLD) {
+		// no thieves or enough work available for them, run sequentially
+		irt_worker_run_immediate(target, range, impl, args);
+		return irt_joinable_null();
+	}
+	irt_work_item *real_wi = _irt_wi_create(target, range, impl, args);
+	irt_joinable joinable;
+	joinable.wi_id = real_wi->id;
+	irt_scheduling_assign_wi(target, real_wi);
+	return joinable;
+}
+
+void irt_scheduling_generate_wi(irt_worker* target, irt_work_item* wi) {
+	irt_scheduling_assign_wi(target, wi);
+}
+
+// ============================================================================ Scheduling (CHASE-LEV STEALING)
+
+void irt_scheduling_assign_wi(irt_worker* target, irt_work_item* wi) {
+	irt_inst_insert_wi_event(irt_worker_get_current(), IRT_INST_WORK_ITEM_QUEUED, wi->id);
+	// the deque may only be pushed to by its owner - note that irt_worker_get_current
+	// can not be used to check this, since it is also set for the main thread
+	irt_thread calling_thread;
+	irt_thread_get_current(&calling_thread);
+	if(irt_thread_check_equality(&calling_thread, &target->thread)) {
+		irt_cld_push(&target->sched_data.queue, wi);
+	} else {
+		_irt_cl_inbox_push(target, wi);
+		irt_signal_worker(target);
+	}
+}
+
+int irt_scheduling_iteration(irt_worker* self) {
+	irt_inst_insert_wo_event(self, IRT_INST_WORKER_SCHEDULING_LOOP, self->id);
+	irt_work_item* wi = NULL;
+
+	// try to take a work item from the own deque, then from the inbox
+	if((wi = irt_cld_pop(&self->sched_data.queue)) || (wi = _irt_cl_inbox_pop(self))) {
+		irt_inst_insert_wo_event(self, IRT_INST_WORKER_SCHEDULING_LOOP_END, self->id);
+		_irt_worker_switch_to_wi(self, wi);
+		return 1;
+	}
+
+	// try to steal half of the work items of a random victim
+	if(irt_g_worker_count > 1) {
+		irt_inst_insert_wo_event(self, IRT_INST_WORKER_STEAL_TRY, self->id);
+		irt_worker *victim = irt_sched_select_victim(self, &self->sched_data.victims);
+		wi = irt_cld_steal_half(&victim->sched_data.queue, &self->sched_data.queue, IRT_CLDEQUE_STEAL_MAX);
+		if(!wi) wi = _irt_cl_inbox_pop(victim);
+		irt_sched_victim_steal_result(self, &self->sched_data.victims, wi != NULL);
+		if(wi) {
+			irt_inst_insert_wo_event(self, IRT_INST_WORKER_STEAL_SUCCESS, self->id);
+			irt_inst_insert_wo_event(self, IRT_INST_WORKER_SCHEDULING_LOOP_END, self->id);
+			_irt_worker_switch_to_wi(self, wi);
+			return 1;
+		}
+	}
+
+	// if that failed as well, look in the IPC message queue
+#ifndef IRT_MIN_MODE
+	if(_irt_sched_check_ipc_queue(self)) return 1;
+#endif
+
+	// didn't find any work
+	return 0;
+}
+
+#endif // ifndef __GUARD_SCHED_POLICIES_IMPL_IRT_SCHED_STEALING_CHASE_LEV_IMPL_H
@@ -39,6 +39,7 @@
 #define __GUARD_SCHED_POLICIES_IMPL_IRT_SCHED_STEALING_CIRCULAR_IMPL_H
 
 #include "sched_policies/utils/impl/irt_sched_ipc_base.impl.h"
+#include "sched_policies/utils/impl/irt_sched_victim_selection.impl.h"
 #include "sched_policies/irt_sched_stealing_circular.h"
 #include "impl/worker.impl.h"
 
@@ -81,11 +82,16 @@ void irt_scheduling_init_worker(irt_worker* self) {
 	irt_cwb_init(&self->sched_data.queue);
 	self->sched_data.overflow_stack = NULL;
 	irt_spin_init(&self->sched_data.overflow_stack_lock);
+	irt_sched_victim_selection_init(&self->sched_data.victims);
 #ifdef IRT_TASK_OPT
 	self->sched_data.demand = IRT_CWBUFFER_LENGTH;
 #endif //IRT_TASK_OPT
 }
 
+void irt_scheduling_cleanup_worker(irt_worker* self) {
+	irt_sched_victim_selection_cleanup(self, &self->sched_data.victims);
+}
+
 void irt_scheduling_yield(irt_worker* self, irt_work_item* yielding_wi) {
 	IRT_DEBUG("Worker yield, worker: %p,  wi: %p", (void*) self, (void*) yielding_wi);
 	irt_inst_insert_wi_event(self, IRT_INST_WORK_ITEM_YIELD, yielding_wi->id);
@@ -215,12 +221,14 @@ int irt_scheduling_iteration(irt_worker* self) {
 
 	// try to steal a work item from random
 	irt_inst_insert_wo_event(self, IRT_INST_WORKER_STEAL_TRY, self->id);
-	irt_worker *wo = irt_g_workers[rand_r(&self->rand_seed)%irt_g_worker_count];
+	irt_worker *wo = irt_sched_select_victim(self, &self->sched_data.victims);
 #ifdef IRT_STEAL_OTHER_POP_FRONT
-	if((wi = irt_cwb_pop_front(&wo->sched_data.queue))) {
+	wi = irt_cwb_pop_front(&wo->sched_data.queue);
 #else
-	if((wi = irt_cwb_pop_back(&wo->sched_data.queue))) {
+	wi = irt_cwb_pop_back(&wo->sched_data.queue);
 #endif
+	irt_sched_victim_steal_result(self, &self->sched_data.victims, wi != NULL);
+	if(wi) {
 		irt_inst_insert_wo_event(self, IRT_INST_WORKER_STEAL_SUCCESS, self->id);
 		irt_inst_insert_wo_event(self, IRT_INST_WORKER_SCHEDULING_LOOP_END, self->id);
 		_irt_worker_switch_to_wi(self, wi);
@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_SCHED_POLICIES_IRT_SCHED_STEALING_CHASE_LEV_H
+#define __GUARD_SCHED_POLICIES_IRT_SCHED_STEALING_CHASE_LEV_H
+
+#include "declarations.h"
+#include "abstraction/spin_locks.h"
+
+#include "utils/chase_lev_deques.h"
+#include "sched_policies/utils/irt_sched_victim_selection.h"
+
+// number of queued wis up to which optional wis are still created as real wis
+#ifndef IRT_CLDEQUE_OPTIONAL_THRESHOLD
+#define IRT_CLDEQUE_OPTIONAL_THRESHOLD 64
+#endif
+
+// maximum number of wis taken from a victim in a single steal-half operation
+#ifndef IRT_CLDEQUE_STEAL_MAX
+#define IRT_CLDEQUE_STEAL_MAX 32
+#endif
+
+typedef struct _irt_cl_data {
+	// only pushed/popped by the owning worker, stolen from by all others
+	irt_chase_lev_deque queue;
+	// wis assigned to this worker by other threads, FIFO
+	irt_work_item *inbox_front, *inbox_back;
+	irt_spinlock inbox_lock;
+	irt_sched_victim_selection victims;
+} irt_cl_data;
+
+#define irt_worker_scheduling_data irt_cl_data
+
+// placeholder, not required
+#define irt_wi_scheduling_data uint32
+
+#ifdef IRT_TASK_OPT
+#error "IRT_TASK_OPT is not supported by IRT_SCHED_POLICY_STEALING_CHASE_LEV"
+#endif //IRT_TASK_OPT
+
+/* Releases the memory held by the deque and the victim selection of the given worker.
+ */
+void irt_scheduling_cleanup_worker(irt_worker* self);
+
+
+#endif // ifndef __GUARD_SCHED_POLICIES_IRT_SCHED_STEALING_CHASE_LEV_H
@@ -45,11 +45,13 @@
 #endif
 
 #include "utils/circular_work_buffers.h"
+#include "sched_policies/utils/irt_sched_victim_selection.h"
 
 typedef struct _irt_cw_data {
 	irt_circular_work_buffer queue;
 	irt_work_item *overflow_stack;
 	irt_spinlock overflow_stack_lock;
+	irt_sched_victim_selection victims;
 #ifdef IRT_TASK_OPT
 	int64 demand;
 #endif //IRT_TASK_OPT
@@ -60,6 +62,10 @@ typedef struct _irt_cw_data {
 // placeholder, not required
 #define irt_wi_scheduling_data uint32
 
+/* Releases the victim selection data of the given worker.
+ */
+void irt_scheduling_cleanup_worker(irt_worker* self);
+
 #ifdef IRT_TASK_OPT
 inline uint32 irt_scheduling_select_taskopt_variant(irt_work_item* wi, irt_worker* wo);
 #endif //IRT_TASK_OPT
@@ -41,8 +41,8 @@
 #include "sched_policies/utils/irt_sched_queue_pool_base.h"
 #include "ir_interface.h"
 
-IRT_DEFINE_DEQUE(work_item, sched_data.work_deque_next, sched_data.work_deque_prev);
-IRT_DEFINE_COUNTED_DEQUE(work_item, sched_data.work_deque_next, sched_data.work_deque_prev);
+IRT_DEFINE_DEQUE(work_item, sched_data.work_deque_next, sched_data.work_deque_prev)
+IRT_DEFINE_COUNTED_DEQUE(work_item, sched_data.work_deque_next, sched_data.work_deque_prev)
 
 static inline void irt_scheduling_continue_wi(irt_worker* target, irt_work_item* wi) {
 	irt_work_item_deque_insert_back(&target->sched_data.pool, wi);
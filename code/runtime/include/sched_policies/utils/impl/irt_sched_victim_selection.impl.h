@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_SCHED_POLICIES_UTILS_IMPL_IRT_SCHED_VICTIM_SELECTION_IMPL_H
+#define __GUARD_SCHED_POLICIES_UTILS_IMPL_IRT_SCHED_VICTIM_SELECTION_IMPL_H
+
+#include <stdlib.h>
+
+#include "sched_policies/utils/irt_sched_victim_selection.h"
+#include "impl/worker.impl.h"
+#include "irt_logging.h"
+
+#include "utils/impl/affinity.impl.h"
+#include "utils/impl/topology.impl.h"
+
+#ifdef _WIN32
+	#include "../../../include_win32/rand_r.h"
+#elif defined(_GEMS_SIM)
+	#include "include_gems/rand_r.h"
+#endif
+
+static const irt_instrumentation_event irt_g_sched_steal_level_events[IRT_TOPOLOGY_LEVELS] = {
+	IRT_INST_WORKER_STEAL_SUCCESS_CACHE, IRT_INST_WORKER_STEAL_SUCCESS_NODE, IRT_INST_WORKER_STEAL_SUCCESS_REMOTE
+};
+
+static inline void irt_sched_victim_selection_init(irt_sched_victim_selection* sel) {
+	memset(sel, 0, sizeof(irt_sched_victim_selection));
+	sel->hierarchical = getenv(IRT_HIERARCHICAL_STEALING_ENV) != NULL;
+	uint32 escalation[IRT_TOPOLOGY_LEVELS] = IRT_STEAL_ESCALATION_DEFAULT;
+	const char* escalation_str = getenv(IRT_STEAL_ESCALATION_ENV);
+	for(uint32 l = 0; l < IRT_TOPOLOGY_LEVELS; ++l) {
+		if(escalation_str && *escalation_str) {
+			char* end;
+			long val = strtol(escalation_str, &end, 10);
+			if(end != escalation_str && val > 0) escalation[l] = (uint32)val;
+			escalation_str = (*end == ',') ? end + 1 : end;
+		}
+		sel->escalation[l] = escalation[l];
+	}
+}
+
+static inline int32 _irt_sched_victim_get_cpu(irt_worker* worker) {
+	if(irt_affinity_mask_is_empty(worker->affinity)) return -1;
+	return (int32)irt_g_affinity_physical_mapping.map[irt_affinity_mask_get_first_cpu(worker->affinity)];
+}
+
+/* Groups all other workers by their topology level relative to self.
+ * Done on first use, since all workers need to be set up.
+ */
+static inline void _irt_sched_victim_selection_build(irt_worker* self, irt_sched_victim_selection* sel) {
+	for(uint32 l = 0; l < IRT_TOPOLOGY_LEVELS; ++l) {
+		sel->victims[l] = (uint32*)malloc(irt_g_worker_count * sizeof(uint32));
+		sel->num_victims[l] = 0;
+	}
+	const irt_topology* topology = irt_topology_get();
+	int32 own_cpu = _irt_sched_victim_get_cpu(self);
+	for(uint32 i = 0; i < irt_g_worker_count; ++i) {
+		if(i == self->id.thread) continue;
+		irt_topology_level level = irt_topology_get_level(topology, own_cpu, _irt_sched_victim_get_cpu(irt_g_workers[i]));
+		sel->victims[level][sel->num_victims[level]++] = i;
+	}
+	sel->level = IRT_TOPOLOGY_LEVEL_CACHE;
+	sel->failed_attempts = 0;
+	sel->initialized = true;
+}
+
+static inline void irt_sched_victim_selection_cleanup(irt_worker* self, irt_sched_victim_selection* sel) {
+	if(!sel->initialized) return;
+	for(uint32 l = 0; l < IRT_TOPOLOGY_LEVELS; ++l) {
+		irt_log("# worker %u, %s steals (successful/attempted): %" PRIu64 "/%" PRIu64 "\n", self->id.thread,
+			irt_topology_level_name((irt_topology_level)l), sel->steal_successes[l], sel->steal_attempts[l]);
+	}
+	for(uint32 l = 0; l < IRT_TOPOLOGY_LEVELS; ++l) {
+		free(sel->victims[l]);
+		sel->victims[l] = NULL;
+		sel->num_victims[l] = 0;
+	}
+	sel->initialized = false;
+}
+
+static inline irt_worker* irt_sched_select_victim(irt_worker* self, irt_sched_victim_selection* sel) {
+	if(irt_g_worker_count == 1) return self;
+	if(!sel->hierarchical) {
+		// uniformly at random, excluding self
+		uint32 victim_index = rand_r(&self->rand_seed) % (irt_g_worker_count - 1);
+		if(victim_index >= self->id.thread) victim_index++;
+		return irt_g_workers[victim_index];
+	}
+	if(!sel->initialized) _irt_sched_victim_selection_build(self, sel);
+	// skip levels without any workers
+	while(sel->num_victims[sel->level] == 0) {
+		sel->level = (sel->level + 1) % IRT_TOPOLOGY_LEVELS;
+		sel->failed_attempts = 0;
+	}
+	sel->steal_attempts[sel->level]++;
+	return irt_g_workers[sel->victims[sel->level][rand_r(&self->rand_seed) % sel->num_victims[sel->level]]];
+}
+
+static inline void irt_sched_victim_steal_result(irt_worker* self, irt_sched_victim_selection* sel, bool success) {
+	if(!sel->initialized) return;
+	if(success) {
+		sel->steal_successes[sel->level]++;
+		irt_inst_insert_wo_event(self, irt_g_sched_steal_level_events[sel->level], self->id);
+		sel->level = IRT_TOPOLOGY_LEVEL_CACHE;
+		sel->failed_attempts = 0;
+	} else if(++sel->failed_attempts >= sel->escalation[sel->level]) {
+		// escalate, restarting with the closest level after the most distant one
+		sel->level = (sel->level + 1) % IRT_TOPOLOGY_LEVELS;
+		sel->failed_attempts = 0;
+	}
+}
+
+
+#endif // ifndef __GUARD_SCHED_POLICIES_UTILS_IMPL_IRT_SCHED_VICTIM_SELECTION_IMPL_H
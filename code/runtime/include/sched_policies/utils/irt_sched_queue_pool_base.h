@@ -41,8 +41,8 @@
 #include "utils/deques.h"
 #include "utils/counted_deques.h"
 
-IRT_DECLARE_DEQUE(work_item);
-IRT_DECLARE_COUNTED_DEQUE(work_item);
+IRT_DECLARE_DEQUE(work_item)
+IRT_DECLARE_COUNTED_DEQUE(work_item)
 
 typedef struct _irt_worker_queue_pool_base {
 	irt_work_item_cdeque queue;
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_SCHED_POLICIES_UTILS_IRT_SCHED_VICTIM_SELECTION_H
+#define __GUARD_SCHED_POLICIES_UTILS_IRT_SCHED_VICTIM_SELECTION_H
+
+#include "declarations.h"
+#include "utils/topology.h"
+
+/* Victim selection for the random work stealing policies.
+ * By default, victims are selected uniformly at random. In hierarchical mode (IRT_HIERARCHICAL_STEALING_ENV),
+ * victims are selected from the workers sharing a cache first, escalating to workers on the same NUMA node and
+ * finally to remote workers after a configurable number of failed attempts per level. A successful steal
+ * restarts at the closest level.
+ */
+typedef struct _irt_sched_victim_selection {
+	bool hierarchical;
+	bool initialized;
+	uint32 level;
+	uint32 failed_attempts;
+	uint32 escalation[IRT_TOPOLOGY_LEVELS];
+	// worker ids of the victims on each level
+	uint32 num_victims[IRT_TOPOLOGY_LEVELS];
+	uint32* victims[IRT_TOPOLOGY_LEVELS];
+	// statistics
+	uint64 steal_attempts[IRT_TOPOLOGY_LEVELS];
+	uint64 steal_successes[IRT_TOPOLOGY_LEVELS];
+} irt_sched_victim_selection;
+
+static inline void irt_sched_victim_selection_init(irt_sched_victim_selection* sel);
+
+static inline void irt_sched_victim_selection_cleanup(irt_worker* self, irt_sched_victim_selection* sel);
+
+/* Selects the next victim for self to steal from, self is only returned if it is the only worker.
+ */
+static inline irt_worker* irt_sched_select_victim(irt_worker* self, irt_sched_victim_selection* sel);
+
+/* Reports the outcome of a steal attempt on the victim last returned by irt_sched_select_victim.
+ */
+static inline void irt_sched_victim_steal_result(irt_worker* self, irt_sched_victim_selection* sel, bool success);
+
+
+#endif // ifndef __GUARD_SCHED_POLICIES_UTILS_IRT_SCHED_VICTIM_SELECTION_H
@@ -139,6 +139,7 @@ void irt_cleanup_globals() {
 #endif
 	irt_mutex_destroy(&irt_g_error_mutex);
 	irt_tls_key_delete(irt_g_worker_key);
+	lwt_log_stack_statistics();
 	irt_log_cleanup();
 	irt_hwloc_cleanup();
 	irt_g_globals_initialization_done = false;
@@ -0,0 +1,209 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_UTILS_CHASE_LEV_DEQUES_H
+#define __GUARD_UTILS_CHASE_LEV_DEQUES_H
+
+#include <stdlib.h>
+
+#include "declarations.h"
+#include "abstraction/atomic.h"
+#include "error_handling.h"
+
+#ifndef IRT_CLDEQUE_INITIAL_LOG_SIZE
+#define IRT_CLDEQUE_INITIAL_LOG_SIZE 5
+#endif
+
+// ============================================================================ Chase-Lev work stealing deques
+// Dynamic circular work-stealing deque as described by Chase and Lev (SPAA 2005).
+// bottom = owner end, top = thief end
+// top INCLUSIVE, bottom EXCLUSIVE
+//
+// - only the owning worker may call irt_cld_push and irt_cld_pop
+// - any worker may call irt_cld_steal
+// - the owner only needs a CAS when competing with thieves for the last element
+// - the item array grows without bounds; arrays which have been replaced are retained
+//   until irt_cld_cleanup, since concurrent thieves may still be reading from them
+//
+// Indices are stored unsigned to be usable with the atomic CAS primitives, all size
+// computations are performed on the signed difference of bottom and top.
+
+typedef struct _irt_cld_array {
+	uint64 mask;
+	irt_work_item** items;
+	struct _irt_cld_array* retired_next;
+} irt_cld_array;
+
+typedef struct _irt_chase_lev_deque {
+	volatile uint64 top;
+	volatile uint64 bottom;
+	irt_cld_array* volatile array;
+	// arrays replaced by growing, kept alive for concurrent thieves
+	irt_cld_array* retired;
+} irt_chase_lev_deque;
+
+// ============================================================================ Chase-Lev work stealing deques implementation
+
+static inline irt_cld_array* _irt_cld_array_create(uint64 size) {
+	irt_cld_array* arr = (irt_cld_array*)malloc(sizeof(irt_cld_array));
+	arr->items = (irt_work_item**)malloc(size * sizeof(irt_work_item*));
+	IRT_ASSERT(arr->items != NULL, IRT_ERR_INTERNAL, "Chase-Lev deque: failed to allocate %lu slots", (unsigned long)size);
+	arr->mask = size - 1;
+	arr->retired_next = NULL;
+	return arr;
+}
+
+static inline void _irt_cld_array_destroy(irt_cld_array* arr) {
+	free(arr->items);
+	free(arr);
+}
+
+static inline void irt_cld_init(irt_chase_lev_deque* dq) {
+	dq->top = 0;
+	dq->bottom = 0;
+	dq->array = _irt_cld_array_create(((uint64)1) << IRT_CLDEQUE_INITIAL_LOG_SIZE);
+	dq->retired = NULL;
+}
+
+static inline void irt_cld_cleanup(irt_chase_lev_deque* dq) {
+	irt_cld_array *cur = dq->retired, *next;
+	while(cur) {
+		next = cur->retired_next;
+		_irt_cld_array_destroy(cur);
+		cur = next;
+	}
+	dq->retired = NULL;
+	if(dq->array) _irt_cld_array_destroy(dq->array);
+	dq->array = NULL;
+}
+
+/* Returns the number of elements currently in the deque.
+ * Only a snapshot when called concurrently with other operations.
+ */
+static inline uint64 irt_cld_size(irt_chase_lev_deque* dq) {
+	int64 size = (int64)(irt_atomic_load(&dq->bottom) - irt_atomic_load(&dq->top));
+	return size > 0 ? (uint64)size : 0;
+}
+
+/* Returns the number of slots available before the next growing step.
+ */
+static inline uint64 irt_cld_capacity(irt_chase_lev_deque* dq) {
+	return dq->array->mask + 1;
+}
+
+/* Replaces the array of dq by one of twice the size holding the elements [top, bottom).
+ * Only called by the owner.
+ */
+static inline irt_cld_array* _irt_cld_grow(irt_chase_lev_deque* dq, irt_cld_array* arr, uint64 top, uint64 bottom) {
+	irt_cld_array* grown = _irt_cld_array_create((arr->mask + 1) * 2);
+	for(uint64 i = top; i != bottom; ++i) {
+		grown->items[i & grown->mask] = arr->items[i & arr->mask];
+	}
+	arr->retired_next = dq->retired;
+	dq->retired = arr;
+	irt_atomic_store(&dq->array, grown);
+	return grown;
+}
+
+/* Adds wi at the bottom of dq. Only the owner of dq may call this function.
+ */
+static inline void irt_cld_push(irt_chase_lev_deque* dq, irt_work_item* wi) {
+	uint64 bottom = dq->bottom;
+	uint64 top = irt_atomic_load(&dq->top);
+	irt_cld_array* arr = dq->array;
+	if((int64)(bottom - top) > (int64)arr->mask) {
+		arr = _irt_cld_grow(dq, arr, top, bottom);
+	}
+	arr->items[bottom & arr->mask] = wi;
+	irt_atomic_store(&dq->bottom, bottom + 1);
+}
+
+/* Removes the bottom element of dq, returns NULL if dq is empty.
+ * Only the owner of dq may call this function.
+ */
+static inline irt_work_item* irt_cld_pop(irt_chase_lev_deque* dq) {
+	uint64 bottom = dq->bottom - 1;
+	irt_cld_array* arr = dq->array;
+	// the sequentially consistent store orders the bottom update before the load of top
+	irt_atomic_store(&dq->bottom, bottom);
+	uint64 top = irt_atomic_load(&dq->top);
+	int64 size = (int64)(bottom - top);
+	if(size < 0) {
+		// empty, restore canonical state
+		irt_atomic_store(&dq->bottom, top);
+		return NULL;
+	}
+	irt_work_item* wi = arr->items[bottom & arr->mask];
+	if(size > 0) return wi;
+	// last element, race against thieves
+	if(!irt_atomic_bool_compare_and_swap(&dq->top, top, top + 1, uint64)) wi = NULL;
+	irt_atomic_store(&dq->bottom, top + 1);
+	return wi;
+}
+
+/* Removes the top element of dq, returns NULL if dq is empty or if the
+ * element was taken by a concurrent operation.
+ */
+static inline irt_work_item* irt_cld_steal(irt_chase_lev_deque* dq) {
+	uint64 top = irt_atomic_load(&dq->top);
+	uint64 bottom = irt_atomic_load(&dq->bottom);
+	if((int64)(bottom - top) <= 0) return NULL;
+	irt_cld_array* arr = irt_atomic_load(&dq->array);
+	irt_work_item* wi = arr->items[top & arr->mask];
+	if(!irt_atomic_bool_compare_and_swap(&dq->top, top, top + 1, uint64)) return NULL;
+	return wi;
+}
+
+/* Steals up to half (at most max_count) of the elements of victim.
+ * The first stolen element is returned, the remaining ones are pushed to target,
+ * which needs to be owned by the calling thread. Returns NULL if nothing could be stolen.
+ */
+static inline irt_work_item* irt_cld_steal_half(irt_chase_lev_deque* victim, irt_chase_lev_deque* target, uint64 max_count) {
+	IRT_ASSERT(max_count > 0, IRT_ERR_INVALIDARGUMENT, "Chase-Lev deque: steal count needs to be positive");
+	irt_work_item* first = irt_cld_steal(victim);
+	if(first == NULL) return NULL;
+	uint64 count = irt_cld_size(victim) / 2;
+	if(count > max_count - 1) count = max_count - 1;
+	for(uint64 i = 0; i < count; ++i) {
+		irt_work_item* wi = irt_cld_steal(victim);
+		if(wi == NULL) break;
+		irt_cld_push(target, wi);
+	}
+	return first;
+}
+
+
+#endif // ifndef __GUARD_UTILS_CHASE_LEV_DEQUES_H
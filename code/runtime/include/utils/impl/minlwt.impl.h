@@ -41,66 +41,233 @@
 #include "utils/minlwt.h"
 #include "work_item.h"
 #include "wi_implementation.h"
+#include "meta_information/meta_infos.h"
 #include "impl/error_handling.impl.h"
 #include "abstraction/atomic.h"
+#include "irt_logging.h"
 
-//#include <sys/mman.h> /* not required for now, mmap not used (see below) */
+#ifdef LWT_STACK_USE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 struct _lwt_g_stack_reuse {
-	lwt_reused_stack* stacks[IRT_MAX_WORKERS];
+	// idle stacks per worker and size class, trimmed ones are only reused if there are no committed ones left
+	lwt_reused_stack* stacks[IRT_MAX_WORKERS][IRT_WI_STACK_CLASSES];
+	lwt_reused_stack* trimmed[IRT_MAX_WORKERS][IRT_WI_STACK_CLASSES];
+	uint32 num_stacks[IRT_MAX_WORKERS][IRT_WI_STACK_CLASSES];
+	uint32 num_prepared[IRT_MAX_WORKERS];
 } lwt_g_stack_reuse;
 
-lwt_reused_stack* _lwt_get_stack(int w_id) {
-	lwt_reused_stack* ret = lwt_g_stack_reuse.stacks[w_id];
-#ifdef LWT_STACK_STEALING_ENABLED
-	if(ret) {
-		if(irt_atomic_bool_compare_and_swap(&lwt_g_stack_reuse.stacks[w_id], ret, ret->next, intptr_t)) {
-			//IRT_DEBUG("LWT_RE\n");
-			return ret;
-		} else {
-			return _lwt_get_stack(w_id);
-		}
-	} else {
-		for(int i=0; i<irt_g_worker_count; ++i) {
-			ret = lwt_g_stack_reuse.stacks[i];
-			if(ret && irt_atomic_bool_compare_and_swap(&lwt_g_stack_reuse.stacks[i], ret, ret->next, intptr_t)) {
-				//IRT_DEBUG("LWT_ST\n");
-				return ret;
-			}
+struct _lwt_g_stack_stats {
+	volatile uint64 created;
+	volatile uint64 reserved;			// bytes of address space reserved for stacks
+	volatile uint64 committed;			// bytes of committed stack memory, estimated from the sampled measurements
+	volatile uint64 peak_committed;
+} lwt_g_stack_stats;
+
+static inline uint64 lwt_stack_class_size(uint32 size_class) {
+	return ((uint64)(IRT_WI_STACK_SIZE)) >> (2 * size_class);
+}
+
+// the header is placed slightly above the top of the stack body
+static inline char* _lwt_stack_top(lwt_reused_stack* stack) {
+	return (char*)stack - LWT_STACK_ALIGNMENT;
+}
+
+static inline char* _lwt_stack_body(lwt_reused_stack* stack) {
+	return _lwt_stack_top(stack) - lwt_stack_class_size(stack->size_class);
+}
+
+#ifdef LWT_STACK_USE_MMAP
+static inline uint64 _lwt_page_size() {
+	static uint64 page_size = 0;
+	if(!page_size) page_size = (uint64)sysconf(_SC_PAGESIZE);
+	return page_size;
+}
+#endif
+
+static inline void _lwt_stack_account(int64 delta) {
+	uint64 committed = irt_atomic_add_and_fetch(&lwt_g_stack_stats.committed, (uint64)delta, uint64);
+	uint64 peak;
+	while(committed > (peak = lwt_g_stack_stats.peak_committed)
+			&& !irt_atomic_bool_compare_and_swap(&lwt_g_stack_stats.peak_committed, peak, committed, uint64));
+}
+
+static lwt_reused_stack* _lwt_stack_create(uint32 size_class) {
+	uint64 size = lwt_stack_class_size(size_class);
+	char* body;
+	lwt_reused_stack* ret;
+#ifdef LWT_STACK_USE_MMAP
+	// reserve guard page, body and header page - memory is committed on first touch
+	uint64 page_size = _lwt_page_size();
+	char* mapping = (char*)mmap(NULL, page_size + size + page_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+	IRT_ASSERT(mapping != MAP_FAILED, IRT_ERR_IO, "Mmap of lwt stack failed.\n");
+	IRT_ASSERT(mprotect(mapping, page_size, PROT_NONE) == 0, IRT_ERR_IO, "Protecting lwt stack guard page failed.\n");
+	body = mapping + page_size;
+	irt_atomic_add_and_fetch(&lwt_g_stack_stats.reserved, page_size + size + page_size, uint64);
+	_lwt_stack_account(page_size);
+#else
+	// the slack below the header also covers the gemsclaim compiler storing the sp above the stack when entering a function call
+	char* mapping = (char*)malloc(LWT_STACK_ALIGNMENT + size + LWT_STACK_ALIGNMENT + sizeof(lwt_reused_stack));
+	IRT_ASSERT(mapping != NULL, IRT_ERR_IO, "Malloc of lwt stack failed.\n");
+	body = (char*)(((uintptr_t)mapping + LWT_STACK_ALIGNMENT - 1) & ~(uintptr_t)(LWT_STACK_ALIGNMENT - 1));
+	irt_atomic_add_and_fetch(&lwt_g_stack_stats.reserved, size, uint64);
+#endif
+	irt_atomic_inc(&lwt_g_stack_stats.created, uint64);
+	ret = (lwt_reused_stack*)(body + size + LWT_STACK_ALIGNMENT);
+	ret->next = NULL;
+	ret->mapping = mapping;
+	ret->size_class = size_class;
+	ret->sampled = false;
+#ifdef LWT_STACK_USE_MMAP
+	ret->resident = 0;
+#else
+	ret->resident = size;
+	_lwt_stack_account(size);
+#endif
+	return ret;
+}
+
+static void _lwt_stack_destroy(lwt_reused_stack* stack) {
+#ifdef LWT_STACK_USE_MMAP
+	uint64 size = lwt_stack_class_size(stack->size_class);
+	uint64 page_size = _lwt_page_size();
+	_lwt_stack_account(-(int64)(stack->resident + page_size));
+	munmap(stack->mapping, page_size + size + page_size);
+#else
+	_lwt_stack_account(-(int64)stack->resident);
+	free(stack->mapping);
+#endif
+}
+
+// releases the memory of the stack body, while keeping the reservation
+static inline void _lwt_stack_trim(lwt_reused_stack* stack) {
+#ifdef LWT_STACK_USE_MMAP
+	madvise(_lwt_stack_body(stack), lwt_stack_class_size(stack->size_class), MADV_DONTNEED);
+	_lwt_stack_account(-(int64)stack->resident);
+	stack->resident = 0;
+#endif
+}
+
+// determines the size of the stack body from its lowest resident page up to the top
+static inline uint64 _lwt_stack_measure(lwt_reused_stack* stack) {
+	uint64 size = lwt_stack_class_size(stack->size_class);
+#ifdef LWT_STACK_USE_MMAP
+	uint64 page_size = _lwt_page_size();
+	char* body = _lwt_stack_body(stack);
+	unsigned char residency[256];
+	for(uint64 offset = 0; offset < size; offset += sizeof(residency) * page_size) {
+		uint64 length = size - offset < sizeof(residency) * page_size ? size - offset : sizeof(residency) * page_size;
+		if(mincore(body + offset, length, residency) != 0) return size;
+		for(uint64 page = 0; page < length / page_size; ++page) {
+			if(residency[page] & 1) return size - offset - page * page_size;
 		}
 	}
+	return 0;
+#else
+	return size;
+#endif
+}
+
+// selects the smallest size class covering the stack bound annotated to the given variant
+// (observed stack usage is no bound - a later work item may run deeper and overflow into the guard page,
+// hence variants without an annotated bound always get the default size)
+static inline uint32 _lwt_stack_select_class(irt_wi_implementation_variant* variant) {
+	if(!irt_meta_info_is_stack_bound_available(variant->meta_info)) return 0;
+	uint64 required = irt_meta_info_get_stack_bound(variant->meta_info)->max_bytes;
+	if(required == 0) return 0;
+	uint32 size_class = 0;
+	while(size_class + 1 < IRT_WI_STACK_CLASSES && lwt_stack_class_size(size_class + 1) >= required) size_class++;
+	return size_class;
+}
+
+/*
+ * Reuse lists are only popped by their owning worker, which rules out ABA on the CAS in _lwt_stack_pop - the owner
+ * can not re-push a stack while it is popping. Other workers only push, or detach entire lists in _lwt_stack_steal.
+ */
+
+static inline lwt_reused_stack* _lwt_stack_pop(lwt_reused_stack** list) {
+#ifdef LWT_STACK_STEALING_ENABLED
+	lwt_reused_stack* ret;
+	while((ret = irt_atomic_load(list)) && !irt_atomic_bool_compare_and_swap(list, (intptr_t)ret, (intptr_t)ret->next, intptr_t));
+	return ret;
+#else
+	lwt_reused_stack* ret = *list;
+	if(ret) *list = ret->next;
+	return ret;
+#endif
+}
+
+static inline void _lwt_stack_push_list(lwt_reused_stack** list, lwt_reused_stack* first, lwt_reused_stack* last) {
+#ifdef LWT_STACK_STEALING_ENABLED
+	lwt_reused_stack* top;
+	do {
+		top = irt_atomic_load(list);
+		last->next = top;
+	} while(!irt_atomic_bool_compare_and_swap(list, (intptr_t)top, (intptr_t)first, intptr_t));
 #else
-	if(ret) {
-		//IRT_DEBUG("LWT_RE\n");
-		//IRT_VERBOSE_ONLY(
-		//{
-		//	int num_stacks=1;
-		//	lwt_reused_stack* cur = ret;
-		//	while(cur = cur->next) num_stacks++;
-		//	printf("-- %d, Reusing stack %p, %d stack(s) available:\n", w_id, (void*) ret, num_stacks);
-		//	cur = ret;
-		//	printf("---- ");
-		//	do { printf("%p, ", (void*) cur);  } while(cur = cur->next);
-		//	printf("\n");
-		//});
-		lwt_g_stack_reuse.stacks[w_id] = ret->next;
-		return ret;
+	last->next = *list;
+	*list = first;
+#endif
+}
+
+#ifdef LWT_STACK_STEALING_ENABLED
+// takes one stack from another worker's list by detaching it as a whole and returning the remainder
+static inline lwt_reused_stack* _lwt_stack_steal(lwt_reused_stack** list) {
+	lwt_reused_stack* ret;
+	while((ret = irt_atomic_load(list)) && !irt_atomic_bool_compare_and_swap(list, (intptr_t)ret, (intptr_t)NULL, intptr_t));
+	if(ret && ret->next) {
+		lwt_reused_stack* last = ret->next;
+		while(last->next) last = last->next;
+		_lwt_stack_push_list(list, ret->next, last);
 	}
+	return ret;
+}
 #endif
-	
-	// create new
-	//static unsigned long long total = 0;
-	//total += sizeof(lwt_reused_stack) + IRT_WI_STACK_SIZE;
-	//printf("Total allocated: %6.2lf MB\n", total/(1024.0*1024.0));
-	// TODO [_GEMS]: we need +4 because of gemsclaim compiler generated instruction: when entering a function call the sp is stored on the stack
-	ret = (lwt_reused_stack*)malloc(sizeof(lwt_reused_stack) + IRT_WI_STACK_SIZE + 4);
-		
-    IRT_ASSERT(ret != NULL, IRT_ERR_IO, "Malloc of lwt stack failed.\n");
-		
+
+lwt_reused_stack* _lwt_get_stack(int w_id, uint32 size_class, bool sampled) {
+	lwt_reused_stack* ret;
+	lwt_reused_stack** committed = &lwt_g_stack_reuse.stacks[w_id][size_class];
+	lwt_reused_stack** trimmed = &lwt_g_stack_reuse.trimmed[w_id][size_class];
+	uint32* num_committed = &lwt_g_stack_reuse.num_stacks[w_id][size_class];
+
+	// measured work items need a clean stack, all others prefer committed memory
+	lwt_reused_stack* from_committed = NULL;
+	if(sampled) {
+		ret = _lwt_stack_pop(trimmed);
+		if(!ret && (ret = from_committed = _lwt_stack_pop(committed))) _lwt_stack_trim(ret);
+	} else {
+		ret = from_committed = _lwt_stack_pop(committed);
+		if(!ret) ret = _lwt_stack_pop(trimmed);
+	}
+	// the count may be off after other workers stole stacks, resynchronize once the list is empty
+	if(from_committed && *num_committed > 0) --*num_committed;
+	else if(!from_committed) *num_committed = 0;
+
+#ifdef LWT_STACK_STEALING_ENABLED
+	for(uint32 i = 0; !ret && i < irt_g_worker_count; ++i) {
+		ret = _lwt_stack_steal(&lwt_g_stack_reuse.stacks[i][size_class]);
+		if(!ret) ret = _lwt_stack_steal(&lwt_g_stack_reuse.trimmed[i][size_class]);
+		if(ret && sampled) _lwt_stack_trim(ret);
+	}
+#endif
+
+	if(!ret) ret = _lwt_stack_create(size_class);
 	ret->next = NULL;
+	ret->sampled = sampled;
 	return ret;
 }
 
+// decides whether to measure the stack usage of the given work item and provides a stack of the matching size class
+static inline lwt_reused_stack* _lwt_get_stack_for(int tid, irt_work_item *wi) {
+	irt_wi_implementation_variant* variant = &wi->impl->variants[wi->selected_impl_variant];
+	bool sampled = variant->rt_data.stack_samples < IRT_WI_STACK_SAMPLES
+			|| (++lwt_g_stack_reuse.num_prepared[tid] % IRT_WI_STACK_SAMPLE_INTERVAL) == 0;
+	return _lwt_get_stack(tid, _lwt_stack_select_class(variant), sampled);
+}
+
 static inline void lwt_recycle(int tid, irt_work_item *wi) {
 	if(!wi->stack_storage) {
 #ifdef IRT_ASTEROIDEA_STACKS
@@ -112,40 +279,53 @@ static inline void lwt_recycle(int tid, irt_work_item *wi) {
 #endif //IRT_ASTEROIDEA_STACKS
 		return;
 	}
-#ifdef LWT_STACK_STEALING_ENABLED
-	for(;;) {
-		lwt_reused_stack* top = lwt_g_stack_reuse.stacks[tid];
-		wi->stack_storage->next = top;
-		if(irt_atomic_bool_compare_and_swap(&lwt_g_stack_reuse.stacks[tid], top, wi->stack_storage, intptr_t)) {
-			//IRT_DEBUG("LWT_CYC\n");
-			return;
-		} else {
-			//IRT_DEBUG("LWT_FCY\n");
+	lwt_reused_stack* stack = wi->stack_storage;
+	wi->stack_storage = NULL;
+
+	if(stack->sampled) {
+		// the stack was clean, so its resident part has been touched by this work item
+		uint64 resident = _lwt_stack_measure(stack);
+		_lwt_stack_account((int64)resident - (int64)stack->resident);
+		stack->resident = resident;
+		irt_wi_implementation_runtime_data* rt_data = &wi->impl->variants[wi->selected_impl_variant].rt_data;
+		uint64 usage;
+		while(resident > (usage = rt_data->stack_usage)
+				&& !irt_atomic_bool_compare_and_swap(&rt_data->stack_usage, usage, resident, uint64));
+		irt_atomic_inc(&rt_data->stack_samples, uint32);
+	}
+
+	// keep the memory of a limited number of idle stacks committed
+	uint32 size_class = stack->size_class;
+	if(lwt_g_stack_reuse.num_stacks[tid][size_class] < IRT_WI_STACK_POOL_HIGH_WATER) {
+		lwt_g_stack_reuse.num_stacks[tid][size_class]++;
+		_lwt_stack_push_list(&lwt_g_stack_reuse.stacks[tid][size_class], stack, stack);
+	} else {
+		_lwt_stack_trim(stack);
+		_lwt_stack_push_list(&lwt_g_stack_reuse.trimmed[tid][size_class], stack, stack);
+	}
+}
+
+void lwt_cleanup_stacks(int tid) {
+	for(uint32 c = 0; c < IRT_WI_STACK_CLASSES; ++c) {
+		lwt_reused_stack** lists[] = { &lwt_g_stack_reuse.stacks[tid][c], &lwt_g_stack_reuse.trimmed[tid][c] };
+		for(uint32 l = 0; l < 2; ++l) {
+			lwt_reused_stack *cur = *lists[l], *next;
+			while(cur) {
+				next = cur->next;
+				_lwt_stack_destroy(cur);
+				cur = next;
+			}
+			*lists[l] = NULL;
 		}
+		lwt_g_stack_reuse.num_stacks[tid][c] = 0;
 	}
-#else
-	//IRT_VERBOSE_ONLY(
-	//{
-	//	int num_stacks=0;
-	//	if(lwt_g_stack_reuse.stacks[tid]) {
-	//		num_stacks=1;
-	//		lwt_reused_stack* cur = lwt_g_stack_reuse.stacks[tid];
-	//		while(cur = cur->next) num_stacks++;
-	//	}
-	//	printf("-- %d, Recycling stack %p, %d stack(s) available:\n", tid, (void*) wi->stack_storage, num_stacks);
-	//	if(lwt_g_stack_reuse.stacks[tid]) {
-	//		lwt_reused_stack* cur = lwt_g_stack_reuse.stacks[tid];
-	//		printf("---- ");
-	//		do { printf("%p, ", (void*) cur);  } while(cur = cur->next);
-	//		printf("\n");
-	//	}
-	//});
-	wi->stack_storage->next = lwt_g_stack_reuse.stacks[tid];
-	lwt_g_stack_reuse.stacks[tid] = wi->stack_storage;
-	wi->stack_storage = NULL;
-	//printf("Reuse!");
-	//IRT_DEBUG("LWT_CYC\n");
-#endif
+}
+
+void lwt_log_stack_statistics() {
+	irt_log_comment("Work item stacks:");
+	irt_log_setting_u("stacks_created", lwt_g_stack_stats.created);
+	irt_log_setting_u("stacks_reserved_bytes", lwt_g_stack_stats.reserved);
+	irt_log_setting_u("stacks_peak_committed_bytes", lwt_g_stack_stats.peak_committed);
 }
 
 #ifdef USING_MINLWT
@@ -173,19 +353,8 @@ static inline void lwt_prepare(int tid, irt_work_item *wi, intptr_t *basestack)
 	}
 #endif
 
-	// heap allocated thread memory
-	wi->stack_storage = _lwt_get_stack(tid);
-	wi->stack_ptr = (intptr_t)(&wi->stack_storage->stack) + IRT_WI_STACK_SIZE;
-
-	// let stack be allocated by the OS kernel
-	// see http://www.evanjones.ca/software/threading.html
-	// section: Implementing Kernel Threads on Linux
-//	wi->stack_ptr = (intptr_t)(mmap(NULL, IRT_WI_STACK_SIZE,
-//			PROT_READ | PROT_WRITE,
-//			MAP_PRIVATE | MAP_32BIT | MAP_ANONYMOUS | MAP_GROWSDOWN | MAP_STACK,
-//			-1, 0)
-//	);
-//	wi->stack_start = wi->stack_ptr - IRT_WI_STACK_SIZE;
+	wi->stack_storage = _lwt_get_stack_for(tid, wi);
+	wi->stack_ptr = (intptr_t)_lwt_stack_top(wi->stack_storage);
 }
 
 
@@ -272,10 +441,10 @@ void lwt_end(intptr_t *basestack) {
 // Fallback ucontext implementation
 
 static inline void lwt_prepare(int tid, irt_work_item *wi, lwt_context *basestack) {
-	wi->stack_storage =  _lwt_get_stack(tid);
+	wi->stack_storage = _lwt_get_stack_for(tid, wi);
 	wi->stack_ptr.uc_link          = basestack;
-	wi->stack_ptr.uc_stack.ss_sp   = (char*)wi->stack_storage->stack;
-	wi->stack_ptr.uc_stack.ss_size = IRT_WI_STACK_SIZE;
+	wi->stack_ptr.uc_stack.ss_sp   = _lwt_stack_body(wi->stack_storage);
+	wi->stack_ptr.uc_stack.ss_size = lwt_stack_class_size(wi->stack_storage->size_class);
 	getcontext(&wi->stack_ptr);
 }
 
@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_UTILS_IMPL_TOPOLOGY_IMPL_H
+#define __GUARD_UTILS_IMPL_TOPOLOGY_IMPL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/topology.h"
+#include "abstraction/atomic.h"
+#include "hwinfo.h"
+
+#define IRT_TOPOLOGY_PATH_MAX_LENGTH 512
+#define IRT_TOPOLOGY_LINE_MAX_LENGTH 4096
+#define IRT_TOPOLOGY_MAX_CACHE_INDICES 16
+
+static irt_topology irt_g_topology;
+// 0 ... not loaded, 1 ... loading, 2 ... loaded
+static volatile uint32 irt_g_topology_state = 0;
+
+/*
+ * reads the first line of the given file into buffer, returns false if the file can not be read
+ */
+static inline bool _irt_topology_read_line(const char* path, char* buffer, uint32 length) {
+	FILE* file = fopen(path, "r");
+	if(file == NULL) return false;
+	bool success = fgets(buffer, length, file) != NULL;
+	fclose(file);
+	return success;
+}
+
+/*
+ * parses a sysfs cpu list such as "0-3,8,10-11" and sets the contained entries in flags (size IRT_MAX_CORES),
+ * returns the lowest contained id or -1 if the list is empty
+ */
+static inline int32 _irt_topology_parse_list(const char* list, bool* flags) {
+	int32 first = -1;
+	const char* cur = list;
+	while(*cur >= '0' && *cur <= '9') {
+		char* end;
+		long from = strtol(cur, &end, 10);
+		long to = from;
+		if(*end == '-') to = strtol(end + 1, &end, 10);
+		for(long i = from; i <= to && i < (long)IRT_MAX_CORES; ++i) {
+			if(flags) flags[i] = true;
+			if(first < 0 || i < first) first = (int32)i;
+		}
+		cur = (*end == ',') ? end + 1 : end;
+	}
+	return first;
+}
+
+static inline int32 _irt_topology_read_int(const char* path) {
+	char buffer[IRT_TOPOLOGY_LINE_MAX_LENGTH];
+	if(!_irt_topology_read_line(path, buffer, sizeof(buffer))) return -1;
+	return atoi(buffer);
+}
+
+void irt_topology_load(irt_topology* topology, const char* root) {
+	char path[IRT_TOPOLOGY_PATH_MAX_LENGTH];
+	char buffer[IRT_TOPOLOGY_LINE_MAX_LENGTH];
+	static bool flags[IRT_MAX_CORES];
+
+	// determine the set of cpus
+	memset(flags, 0, sizeof(flags));
+	snprintf(path, sizeof(path), "%s/cpu/possible", root);
+	topology->num_cpus = 0;
+	if(_irt_topology_read_line(path, buffer, sizeof(buffer)) && _irt_topology_parse_list(buffer, flags) >= 0) {
+		for(uint32 i = 0; i < IRT_MAX_CORES; ++i) {
+			if(flags[i]) topology->num_cpus = i + 1;
+		}
+	} else {
+		topology->num_cpus = irt_hw_get_num_cpus();
+	}
+	if(topology->num_cpus > IRT_MAX_CORES) topology->num_cpus = IRT_MAX_CORES;
+
+	int32 package[IRT_MAX_CORES];
+	for(uint32 cpu = 0; cpu < IRT_MAX_CORES; ++cpu) {
+		topology->cache_group[cpu] = -1;
+		topology->node[cpu] = -1;
+		package[cpu] = -1;
+	}
+
+	for(uint32 cpu = 0; cpu < topology->num_cpus; ++cpu) {
+		snprintf(path, sizeof(path), "%s/cpu/cpu%u/topology/physical_package_id", root, cpu);
+		package[cpu] = _irt_topology_read_int(path);
+
+		// the highest cache level of at least 2 determines the cache group
+		int32 best_level = 1;
+		for(uint32 index = 0; index < IRT_TOPOLOGY_MAX_CACHE_INDICES; ++index) {
+			snprintf(path, sizeof(path), "%s/cpu/cpu%u/cache/index%u/level", root, cpu, index);
+			int32 level = _irt_topology_read_int(path);
+			if(level < 0) break;
+			if(level <= best_level) continue;
+			snprintf(path, sizeof(path), "%s/cpu/cpu%u/cache/index%u/shared_cpu_list", root, cpu, index);
+			if(!_irt_topology_read_line(path, buffer, sizeof(buffer))) continue;
+			int32 group = _irt_topology_parse_list(buffer, NULL);
+			if(group < 0) continue;
+			best_level = level;
+			topology->cache_group[cpu] = group;
+		}
+	}
+
+	// NUMA nodes, falling back to packages if not available
+	bool numa_found = false;
+	memset(flags, 0, sizeof(flags));
+	snprintf(path, sizeof(path), "%s/node/possible", root);
+	if(_irt_topology_read_line(path, buffer, sizeof(buffer)) && _irt_topology_parse_list(buffer, flags) >= 0) {
+		bool cpus[IRT_MAX_CORES];
+		for(uint32 node = 0; node < IRT_MAX_CORES; ++node) {
+			if(!flags[node]) continue;
+			snprintf(path, sizeof(path), "%s/node/node%u/cpulist", root, node);
+			if(!_irt_topology_read_line(path, buffer, sizeof(buffer))) continue;
+			memset(cpus, 0, sizeof(cpus));
+			_irt_topology_parse_list(buffer, cpus);
+			for(uint32 cpu = 0; cpu < topology->num_cpus; ++cpu) {
+				if(cpus[cpu]) {
+					topology->node[cpu] = (int32)node;
+					numa_found = true;
+				}
+			}
+		}
+	}
+	if(!numa_found) {
+		for(uint32 cpu = 0; cpu < topology->num_cpus; ++cpu) topology->node[cpu] = package[cpu];
+	}
+}
+
+const irt_topology* irt_topology_get() {
+	if(irt_atomic_load(&irt_g_topology_state) != 2) {
+		if(irt_atomic_bool_compare_and_swap(&irt_g_topology_state, 0, 1, uint32)) {
+			irt_topology_load(&irt_g_topology, IRT_TOPOLOGY_SYSFS_ROOT);
+			irt_atomic_store(&irt_g_topology_state, 2);
+		} else {
+			while(irt_atomic_load(&irt_g_topology_state) != 2) { }
+		}
+	}
+	return &irt_g_topology;
+}
+
+irt_topology_level irt_topology_get_level(const irt_topology* topology, int32 cpu_a, int32 cpu_b) {
+	if(cpu_a < 0 || cpu_b < 0 || (uint32)cpu_a >= topology->num_cpus || (uint32)cpu_b >= topology->num_cpus) return IRT_TOPOLOGY_LEVEL_REMOTE;
+	if(cpu_a == cpu_b) return IRT_TOPOLOGY_LEVEL_CACHE;
+	if(topology->cache_group[cpu_a] >= 0 && topology->cache_group[cpu_a] == topology->cache_group[cpu_b]) return IRT_TOPOLOGY_LEVEL_CACHE;
+	if(topology->node[cpu_a] >= 0 && topology->node[cpu_a] == topology->node[cpu_b]) return IRT_TOPOLOGY_LEVEL_NODE;
+	return IRT_TOPOLOGY_LEVEL_REMOTE;
+}
+
+const char* irt_topology_level_name(irt_topology_level level) {
+	switch(level) {
+	case IRT_TOPOLOGY_LEVEL_CACHE: return "cache";
+	case IRT_TOPOLOGY_LEVEL_NODE: return "node";
+	case IRT_TOPOLOGY_LEVEL_REMOTE: return "remote";
+	default: return "unknown";
+	}
+}
+
+
+#endif // ifndef __GUARD_UTILS_IMPL_TOPOLOGY_IMPL_H
@@ -61,22 +61,25 @@
 
 #define LWT_STACK_ALIGNMENT 128
 
+#if !defined(_WIN32) && !defined(_GEMS_SIM)
+// reserve stacks using mmap, otherwise they are malloc'ed without guard page and trimming
+#define LWT_STACK_USE_MMAP
+#endif
+
+/*
+ * Work item stacks are reserved as separate mappings, laid out as
+ *
+ *    [ guard page | stack body (size of the size class) | header page ]
+ *
+ * and committed on demand by the OS. The stack grows downwards from the header, overflows hit the guard page.
+ * Size class c provides IRT_WI_STACK_SIZE / 4^c bytes, see lwt_stack_class_size.
+ */
 typedef struct _lwt_reused_stack {
 	struct _lwt_reused_stack *next;
-
-	#if defined(__GNUC__)
-		char stack[] __attribute__ ((aligned (LWT_STACK_ALIGNMENT)));
-	//	char stack[] __attribute__ ((aligned (__BIGGEST_ALIGNMENT__))); // older versions of gcc don't like this
-	#elif defined(__MINGW32__) || defined(__MINGW64__)
-		char stack[] __attribute__((aligned(LWT_STACK_ALIGNMENT)));
-	#elif _MSC_VER
-		__declspec(align(LWT_STACK_ALIGNMENT))
-		char stack[];
-	#else
-		#pragma warning "Unknown platform, stack unaligned" 
-		char stack[];
-	#endif
-
+	void* mapping;				// start of the underlying mapping (or allocation)
+	uint32 size_class;
+	bool sampled;				// whether the stack usage of the current work item will be measured
+	uint64 resident;			// resident bytes of the stack body, as of the last measurement
 } lwt_reused_stack;
 
 #if  defined(__x86_64__) || defined(_WIN32) || defined(_GEMS_SIM) || defined(__arm__)
@@ -94,6 +97,8 @@ typedef ucontext_t lwt_context;
 
 static inline void lwt_prepare(int tid, irt_work_item *wi, lwt_context *basestack);
 static inline void lwt_recycle(int tid, irt_work_item *wi);
+void lwt_cleanup_stacks(int tid);
+void lwt_log_stack_statistics();
 void lwt_start(irt_work_item *wi, lwt_context *basestack, wi_implementation_func* func);
 void lwt_continue(lwt_context *newstack, lwt_context *basestack);
 void lwt_end(lwt_context *basestack);
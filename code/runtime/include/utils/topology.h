@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#pragma once
+#ifndef __GUARD_UTILS_TOPOLOGY_H
+#define __GUARD_UTILS_TOPOLOGY_H
+
+#include "config.h"
+#include "declarations.h"
+
+/*
+ * Provides the cache and NUMA structure of the machine as exported by Linux in sysfs.
+ * Used to prefer nearby victims when stealing work.
+ */
+
+#define IRT_TOPOLOGY_SYSFS_ROOT "/sys/devices/system"
+
+// distance between two cpus, ordered from closest to most distant
+typedef enum _irt_topology_level {
+	IRT_TOPOLOGY_LEVEL_CACHE = 0,	// sharing an L2 or L3 cache
+	IRT_TOPOLOGY_LEVEL_NODE = 1,	// on the same NUMA node
+	IRT_TOPOLOGY_LEVEL_REMOTE = 2,	// anything else, e.g. another socket
+	IRT_TOPOLOGY_LEVELS = 3
+} irt_topology_level;
+
+typedef struct _irt_topology {
+	uint32 num_cpus;
+	// for each cpu, the lowest cpu id sharing its last level cache (L2/L3), -1 if unknown
+	int32 cache_group[IRT_MAX_CORES];
+	// for each cpu, its NUMA node (or its package on non-NUMA systems), -1 if unknown
+	int32 node[IRT_MAX_CORES];
+} irt_topology;
+
+/*
+ * reads the topology from the sysfs tree at root (usually IRT_TOPOLOGY_SYSFS_ROOT), missing information is set to unknown
+ */
+void irt_topology_load(irt_topology* topology, const char* root);
+
+/*
+ * returns the machine topology, loaded from sysfs on first use
+ */
+const irt_topology* irt_topology_get();
+
+/*
+ * returns the topology level connecting two (os) cpu ids, unknown cpus are considered remote
+ */
+irt_topology_level irt_topology_get_level(const irt_topology* topology, int32 cpu_a, int32 cpu_b);
+
+/*
+ * returns a printable name for a topology level
+ */
+const char* irt_topology_level_name(irt_topology_level level);
+
+
+#endif // ifndef __GUARD_UTILS_TOPOLOGY_H
@@ -61,17 +61,31 @@ typedef enum _irt_wi_implementation_type {
 	IRT_WI_IMPL_SHARED_MEM, IRT_WI_IMPL_DISTRIBUTED, IRT_WI_IMPL_OPENCL
 } irt_wi_implementation_type;
 
+// execution time statistics of one implementation variant for one range size class
+typedef struct _irt_variant_selection_stats {
+	volatile uint64 num_executions;
+	volatile uint64 total_ticks;
+} irt_variant_selection_stats;
+
 struct _irt_wi_implementation_runtime_data {
 	bool flat_profile;
 	bool tested;
 	bool force_dyn;
 	double distribution[IRT_MAX_WORKERS];
+	// work distribution of the last range stealing loop, reused as initial partition of the next one
+	double stealing_distribution[IRT_MAX_WORKERS];
+	uint32 stealing_participants;	// number of valid entries in stealing_distribution
 #ifdef IRT_ENABLE_OMPP_OPTIMIZER
     irt_optimizer_runtime_data optimizer_rt_data;
     irt_optimizer_runtime_data* wrapping_optimizer_rt_data;
     uint32 completed_wi_count;
 #endif
 	uint32 chunk_size;
+	// peak stack usage observed for sampled work items (statistics only, it is no bound for selecting a stack size class)
+	volatile uint32 stack_samples;
+	volatile uint64 stack_usage;
+	// observed execution times, used by adaptive variant selection
+	irt_variant_selection_stats selection_stats[IRT_VARIANT_SELECTION_SIZE_CLASSES];
 };
 
 struct _irt_wi_implementation_variant {
@@ -39,6 +39,7 @@
 #define __GUARD_WORK_GROUP_H
 
 #include "declarations.h"
+#include "irt_events.h"
 #include "irt_loop_sched.h"
 
 #include "abstraction/threads.h"
@@ -49,6 +50,21 @@
 
 IRT_MAKE_ID_TYPE(work_group)
 
+// state of a work group member in the combining tree barrier, padded to avoid false sharing
+typedef struct _irt_wg_barrier_node {
+	volatile uint32 arrived;	// number of arrivals in the combining tree group stored at this index
+	volatile uint32 state;		// wait state of the member with this index
+	irt_work_item* wi;			// suspended work item of the member
+	irt_worker* worker;			// worker to continue the suspended work item on
+	char padding[64 - 2*sizeof(uint32) - sizeof(irt_work_item*) - sizeof(irt_worker*)];
+} irt_wg_barrier_node;
+
+typedef struct _irt_wg_barrier_data {
+	uint32 members;
+	volatile uint32 spin_limit;
+	irt_wg_barrier_node nodes[];
+} irt_wg_barrier_data;
+
 struct _irt_work_group {
 	irt_work_group_id id;
 	//bool distributed;	// starts at false, set to true if part of the group is not on the same shared memory node
@@ -59,19 +75,23 @@ struct _irt_work_group {
 	volatile uint32 ended_member_count;
 	volatile uint32 cur_barrier_count;
 	volatile uint32 tot_barrier_count;
+	volatile uint32 barrier_sense; // flipped whenever a combining tree barrier completes
+	irt_wg_barrier_data* volatile barrier_data; // allocated by the first combining tree barrier
 	void** redistribute_data_array;
 	volatile uint32 pfor_count; // index of the most recently added pfor
 	volatile uint32 joined_pfor_count; // index of the latest joined pfor
 	irt_loop_sched_policy cur_sched; // current scheduling policy
 	irt_loop_sched_data loop_sched_data[IRT_WG_RING_BUFFER_SIZE];
+	irt_work_group* next_reuse;
 #ifdef IRT_ENABLE_REGION_INSTRUMENTATION
 	volatile uint64 regions_started;
 	volatile uint64 regions_ended;
 	volatile uint64* region_data_entries;
 	volatile uint64* region_data_exits;
-	volatile uint64 region_completions_required[IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE];
-	volatile irt_inst_region_wi_data** region_data; //[IRT_INST_REGION_INSTRUMENTATION_RING_BUFFER_SIZE];
+	irt_inst_region_ring_buffer region_completions_required;			// slots of type uint64
+	irt_inst_region_ring_buffer* region_data;						// one ring per region, slots of type irt_inst_region_wi_data
 #endif //IRT_ENABLE_REGION_INSTRUMENTATION
+	irt_wg_event_register event_register;
 };
 
 struct _irt_wi_wg_membership {
@@ -100,6 +120,8 @@ static inline uint32 irt_wg_get_wi_num(irt_work_group* wg, irt_work_item* wi);
 static inline irt_wi_wg_membership* irt_wg_get_wi_membership(irt_work_group* wg, irt_work_item* wi);
 
 void irt_wg_barrier(irt_work_group* wg);
+void irt_wg_barrier_scheduled(irt_work_group* wg);
+void irt_wg_barrier_tree(irt_work_group* wg);
 void irt_wg_joining_barrier(irt_work_group* wg);
 void irt_wg_redistribute(irt_work_group* wg, irt_work_item* this_wi, void* my_data, void* result_data, irt_wg_redistribution_function* func);
 void irt_wg_join(irt_work_group_id wg_id);
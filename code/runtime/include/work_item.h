@@ -92,6 +92,10 @@ struct _irt_work_item {
 	irt_work_item *next_reuse;
 	lwt_reused_stack *stack_storage;
 	lwt_context stack_ptr;
+	// time the selected implementation variant was started or last resumed, 0 if not measured
+	uint64 variant_start_ticks;
+	// ticks the selected implementation variant was running before its last suspension
+	uint64 variant_ticks;
 #ifdef IRT_ASTEROIDEA_STACKS
 	volatile bool stack_available;
 #endif
@@ -104,6 +108,8 @@ struct _irt_work_item {
 		char param_storage[IRT_WI_PARAM_BUFFER_SIZE];
 		irt_lw_data_item param_buffer;
 	};
+	// needs to stay the last member, it is excluded when copying wis
+	irt_wi_event_register event_register;
 };
 
 /* ------------------------------ operations ----- */
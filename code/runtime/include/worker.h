@@ -105,6 +105,7 @@ struct _irt_worker {
 	irt_wi_event_register *wi_ev_register_list;
 	irt_wg_event_register *wg_ev_register_list;
 	irt_work_item *wi_reuse_stack;
+	irt_work_group *wg_reuse_stack;
 	intptr_t *stack_reuse_stack;
 };
 
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/*
+ * Converts the compressed event traces written by the streaming event output (IRT_INST_STREAMING_OUTPUT)
+ * into the csv format of the regular worker event logs.
+ *
+ * usage: insieme_event_trace_to_csv <worker_event_trace.XXXX> [<output file>]
+ */
+
+#include <stdio.h>
+
+#include "declarations.h"
+#include "runtime.h"
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+
+int main(int argc, char** argv) {
+	if(argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s <worker_event_trace.XXXX> [<output file>]\n", argv[0]);
+		return 1;
+	}
+
+	FILE* tracefile = fopen(argv[1], "rb");
+	if(!tracefile) {
+		fprintf(stderr, "Unable to open %s for reading\n", argv[1]);
+		return 1;
+	}
+
+	irt_inst_event_trace_reader reader;
+	if(!irt_inst_event_trace_open(&reader, tracefile)) {
+		fprintf(stderr, "%s is not a valid %s event trace\n", argv[1], IRT_INST_EVENT_TRACE_VERSION);
+		irt_inst_event_trace_close(&reader);
+		fclose(tracefile);
+		return 1;
+	}
+	if(reader.ticks_per_sec == 0)
+		fprintf(stderr, "Warning: trace %s was not closed properly, timestamps will be given in clock ticks\n", argv[1]);
+
+	FILE* outputfile = stdout;
+	if(argc == 3 && !(outputfile = fopen(argv[2], "w"))) {
+		fprintf(stderr, "Unable to open %s for writing\n", argv[2]);
+		irt_inst_event_trace_close(&reader);
+		fclose(tracefile);
+		return 1;
+	}
+
+	// same format as irt_inst_event_data_output_single
+	irt_instrumentation_event_data event;
+	uint64 num_events = 0;
+	while(irt_inst_event_trace_next(&reader, &event)) {
+		if(event.event_id >= reader.num_event_types) {
+			fprintf(stderr, "Unknown event id %u in %s\n", event.event_id, argv[1]);
+			break;
+		}
+		uint64 time = reader.ticks_per_sec == 0 ? event.timestamp : (uint64)(event.timestamp/((double)reader.ticks_per_sec/1000000000));
+		fprintf(outputfile, "%s,[%d %d],%20s,%32" PRIu64 "\n", reader.group_names[event.event_id], event.thread, event.index, reader.event_names[event.event_id], time);
+		++num_events;
+	}
+
+	fprintf(stderr, "Converted %" PRIu64 " events\n", num_events);
+
+	if(outputfile != stdout)
+		fclose(outputfile);
+	irt_inst_event_trace_close(&reader);
+	fclose(tracefile);
+	return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <omp.h>
+
+#include <utils/chase_lev_deques.h>
+
+#include <irt_all_impls.h>
+#include <standalone.h>
+
+#define PARALLEL_ITERATIONS 100
+#define TEST_ELEMS 10000
+
+#define NUM_THREADS 8
+
+TEST(chase_lev_deques, sequential) {
+	irt_chase_lev_deque dq;
+	irt_cld_init(&dq);
+
+	static irt_work_item wis[TEST_ELEMS];
+	EXPECT_EQ(NULL, irt_cld_pop(&dq));
+	EXPECT_EQ(NULL, irt_cld_steal(&dq));
+
+	// grows beyond the initial capacity
+	for(int i=0; i<TEST_ELEMS; ++i) irt_cld_push(&dq, &wis[i]);
+	EXPECT_EQ(TEST_ELEMS, irt_cld_size(&dq));
+	EXPECT_LE(TEST_ELEMS, irt_cld_capacity(&dq));
+
+	// owner end is LIFO, thief end is FIFO
+	EXPECT_EQ(&wis[TEST_ELEMS-1], irt_cld_pop(&dq));
+	EXPECT_EQ(&wis[0], irt_cld_steal(&dq));
+	EXPECT_EQ(&wis[1], irt_cld_steal(&dq));
+	EXPECT_EQ(&wis[TEST_ELEMS-2], irt_cld_pop(&dq));
+	EXPECT_EQ(TEST_ELEMS-4, irt_cld_size(&dq));
+
+	for(int i=TEST_ELEMS-3; i>=2; --i) EXPECT_EQ(&wis[i], irt_cld_pop(&dq));
+	EXPECT_EQ(0, irt_cld_size(&dq));
+	EXPECT_EQ(NULL, irt_cld_pop(&dq));
+	EXPECT_EQ(NULL, irt_cld_steal(&dq));
+
+	irt_cld_cleanup(&dq);
+}
+
+TEST(chase_lev_deques, steal_half) {
+	irt_chase_lev_deque victim, thief;
+	irt_cld_init(&victim);
+	irt_cld_init(&thief);
+
+	irt_work_item wis[100];
+	for(int i=0; i<100; ++i) irt_cld_push(&victim, &wis[i]);
+
+	// the first stolen element is returned, half of the remaining ones are moved
+	EXPECT_EQ(&wis[0], irt_cld_steal_half(&victim, &thief, 100));
+	EXPECT_EQ(49, irt_cld_size(&thief));
+	EXPECT_EQ(50, irt_cld_size(&victim));
+	EXPECT_EQ(&wis[49], irt_cld_pop(&thief));
+	EXPECT_EQ(&wis[50], irt_cld_steal(&victim));
+
+	// batches are limited by the maximum count
+	EXPECT_EQ(&wis[51], irt_cld_steal_half(&victim, &thief, 4));
+	EXPECT_EQ(48 + 3, irt_cld_size(&thief));
+
+	irt_chase_lev_deque empty;
+	irt_cld_init(&empty);
+	EXPECT_EQ(NULL, irt_cld_steal_half(&empty, &thief, 4));
+
+	irt_cld_cleanup(&empty);
+	irt_cld_cleanup(&thief);
+	irt_cld_cleanup(&victim);
+}
+
+TEST(chase_lev_deques, owner_vs_thieves) {
+	for(int j=0; j<PARALLEL_ITERATIONS; ++j) {
+		irt_chase_lev_deque dq;
+		irt_cld_init(&dq);
+
+		static irt_work_item wis[TEST_ELEMS];
+		static uint32 taken[TEST_ELEMS];
+		for(int i=0; i<TEST_ELEMS; ++i) taken[i] = 0;
+		volatile uint32 num = 0;
+
+		#pragma omp parallel num_threads(NUM_THREADS)
+		{
+			if(omp_get_thread_num() == 0) {
+				// owner: push all elements, popping one after every second push
+				for(int i=0; i<TEST_ELEMS; ++i) {
+					irt_cld_push(&dq, &wis[i]);
+					if(i%2 == 1) {
+						if(irt_work_item* wi = irt_cld_pop(&dq)) {
+							irt_atomic_inc(&taken[wi-wis], uint32);
+							irt_atomic_inc(&num, uint32);
+						}
+					}
+				}
+				while(irt_work_item* wi = irt_cld_pop(&dq)) {
+					irt_atomic_inc(&taken[wi-wis], uint32);
+					irt_atomic_inc(&num, uint32);
+				}
+			} else {
+				while(num < TEST_ELEMS) {
+					if(irt_work_item* wi = irt_cld_steal(&dq)) {
+						irt_atomic_inc(&taken[wi-wis], uint32);
+						irt_atomic_inc(&num, uint32);
+					}
+				}
+			}
+		}
+
+		EXPECT_EQ(TEST_ELEMS, num);
+		for(int i=0; i<TEST_ELEMS; ++i) EXPECT_EQ(1u, taken[i]);
+
+		irt_cld_cleanup(&dq);
+	}
+}
+
+TEST(chase_lev_deques, token_passing_steal_half) {
+	for(int j=0; j<PARALLEL_ITERATIONS; ++j) {
+		irt_chase_lev_deque dq[NUM_THREADS];
+		for(int i=0; i<NUM_THREADS; ++i) irt_cld_init(&dq[i]);
+		volatile uint32 num = 0;
+
+		irt_work_item wis[NUM_THREADS*4];
+		for(int i=0; i<NUM_THREADS*4; ++i) irt_cld_push(&dq[0], &wis[i]);
+
+		#pragma omp parallel num_threads(NUM_THREADS)
+		{
+			int self = omp_get_thread_num();
+			uint32 rand_seed = 123 + self;
+			while(num < TEST_ELEMS) {
+				irt_work_item* wi = irt_cld_pop(&dq[self]);
+				if(!wi) wi = irt_cld_steal_half(&dq[rand_r(&rand_seed)%NUM_THREADS], &dq[self], 8);
+				if(wi) {
+					irt_cld_push(&dq[self], wi);
+					irt_atomic_inc(&num, uint32);
+				}
+			}
+		}
+
+		uint64 nwi = 0;
+		for(int i=0; i<NUM_THREADS; ++i) {
+			nwi += irt_cld_size(&dq[i]);
+			irt_cld_cleanup(&dq[i]);
+		}
+		EXPECT_EQ(NUM_THREADS*4, nwi);
+	}
+}
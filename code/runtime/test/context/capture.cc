@@ -357,3 +357,167 @@ TEST_F(ContextCapturing, ParallelMatrixMul) {
 	EXPECT_EQ(sumA, sumB);
 
 }
+
+
+TEST_F(ContextCapturing, ManyBlocks) {
+
+	// the type of list node to be used
+	typedef struct _list {
+		int value;
+		struct _list* next;
+	} list;
+
+
+	// test recording a long list, every element forming its own block
+
+	// --- recording ---
+
+	const int N = 10000;
+
+	int sumA = 0;
+	int sumB = 0;
+
+	{
+		// initializing the mechanism
+		INIT();
+
+		// create a list
+		list* l = NULL;
+		for(int i=0; i<N; i++) {
+			list* cur = (list*)CREATE_BLOCK(sizeof(list));
+			cur->value = i;
+			cur->next = l;
+			l = cur;
+		}
+
+		// start the block
+		START(0);
+
+		// tag list
+		TAG_BLOCK(l,0);
+
+		// sum up list elements, reading every element twice
+		sumA = 0;
+		for(int r=0; r<2; r++) {
+			list* cur = READ_PTR(l);
+			while(cur != NULL) {
+				sumA += READ(READ_PTR(cur)->value);
+				cur = READ_PTR(READ_PTR(cur)->next);
+			}
+		}
+
+		// end block
+		STOP(0);
+
+		// delete list
+		while(l != NULL) {
+			list* cur = l->next;
+			free(l);
+			l = cur;
+		}
+
+		// finish processing => profile should be created
+		FINISH();
+	}
+
+	// --- restoring ---
+
+	{
+		// reload profile
+		LOAD(list*, l, 0, 0);
+
+		// sum up list elements
+		sumB = 0;
+		int i = N;
+		while(l != NULL) {
+			EXPECT_EQ(--i, l->value);
+			sumB += 2 * l->value;
+			l = l->next;
+		}
+		EXPECT_EQ(0, i);
+
+		// done
+		FINALIZE();
+	}
+
+	EXPECT_EQ(sumA, sumB);
+
+}
+
+
+TEST_F(ContextCapturing, BlockLookup) {
+
+	INIT();
+
+	char* data = (char*)malloc(3*4096);
+
+	// a block spanning multiple pages
+	const irt_cap_data_block_info* a = irt_cap_dbi_register_block(data, 3*4096);
+	EXPECT_EQ(a, irt_cap_dbi_lookup(data));
+	EXPECT_EQ(a, irt_cap_dbi_lookup(data + 4096 + 17));
+	EXPECT_EQ(a, irt_cap_dbi_lookup(data + 3*4096 - 1));
+	EXPECT_EQ(NULL, irt_cap_dbi_lookup(data + 3*4096));
+
+	// more recent blocks are covering older ones
+	const irt_cap_data_block_info* b = irt_cap_dbi_register_block(data + 4000, 200);
+	EXPECT_EQ(a, irt_cap_dbi_lookup(data + 3999));
+	EXPECT_EQ(b, irt_cap_dbi_lookup(data + 4000));
+	EXPECT_EQ(b, irt_cap_dbi_lookup(data + 4199));
+	EXPECT_EQ(a, irt_cap_dbi_lookup(data + 4200));
+	EXPECT_LT(a->id, b->id);
+
+	FINISH();
+
+	free(data);
+}
+
+
+TEST_F(ContextCapturing, RangeSet) {
+
+	irt_cap_range_set set;
+	irt_cap_range_set_init(&set);
+
+	irt_cap_range_set_add(&set, 10, 20);
+	irt_cap_range_set_add(&set, 30, 40);
+	irt_cap_range_set_add(&set, 0, 5);
+	EXPECT_EQ(3u, set.size);
+
+	// adjacent and overlapping ranges are merged
+	irt_cap_range_set_add(&set, 20, 25);
+	irt_cap_range_set_add(&set, 24, 31);
+	ASSERT_EQ(2u, set.size);
+	EXPECT_EQ(10u, set.ranges[1].begin);
+	EXPECT_EQ(40u, set.ranges[1].end);
+
+	EXPECT_TRUE(irt_cap_range_set_contains(&set, 4));
+	EXPECT_FALSE(irt_cap_range_set_contains(&set, 5));
+	EXPECT_TRUE(irt_cap_range_set_intersects(&set, 8, 11));
+	EXPECT_FALSE(irt_cap_range_set_intersects(&set, 5, 10));
+
+	// removing splits ranges
+	irt_cap_range_set_remove(&set, 15, 16);
+	irt_cap_range_set_remove(&set, 3, 12);
+	ASSERT_EQ(3u, set.size);
+	EXPECT_EQ(0u, set.ranges[0].begin);
+	EXPECT_EQ(3u, set.ranges[0].end);
+	EXPECT_EQ(12u, set.ranges[1].begin);
+	EXPECT_EQ(15u, set.ranges[1].end);
+	EXPECT_EQ(16u, set.ranges[2].begin);
+	EXPECT_EQ(40u, set.ranges[2].end);
+
+	// gaps are enumerated in order
+	uint32 cursor = 0;
+	irt_cap_range gap;
+	EXPECT_TRUE(irt_cap_range_set_next_gap(&set, &cursor, 50, &gap));
+	EXPECT_EQ(3u, gap.begin);
+	EXPECT_EQ(12u, gap.end);
+	EXPECT_TRUE(irt_cap_range_set_next_gap(&set, &cursor, 50, &gap));
+	EXPECT_EQ(15u, gap.begin);
+	EXPECT_EQ(16u, gap.end);
+	EXPECT_TRUE(irt_cap_range_set_next_gap(&set, &cursor, 50, &gap));
+	EXPECT_EQ(40u, gap.begin);
+	EXPECT_EQ(50u, gap.end);
+	EXPECT_FALSE(irt_cap_range_set_next_gap(&set, &cursor, 50, &gap));
+
+	irt_cap_range_set_destroy(&set);
+}
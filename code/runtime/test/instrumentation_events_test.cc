@@ -38,6 +38,7 @@
 #define IRT_RUNTIME_TUNING
 
 #include <gtest/gtest.h>
+#include <stdlib.h>
 #include "standalone.h"
 
 // type table
@@ -50,18 +51,25 @@ irt_type g_insieme_type_table[] = {
 
 void insieme_wi_startup_implementation_simple(irt_work_item* wi);
 
+void insieme_wi_startup_implementation_streaming(irt_work_item* wi);
+
 irt_wi_implementation_variant g_insieme_wi_startup_variants_simple[] = {
 	{ &insieme_wi_startup_implementation_simple, 0, NULL, 0, NULL, 0, NULL }
 };
 
+irt_wi_implementation_variant g_insieme_wi_startup_variants_streaming[] = {
+	{ &insieme_wi_startup_implementation_streaming, 0, NULL, 0, NULL, 0, NULL }
+};
+
 irt_wi_implementation g_insieme_impl_table[] = {
 	{ 1, 1, g_insieme_wi_startup_variants_simple },
+	{ 2, 1, g_insieme_wi_startup_variants_streaming },
 };
 
 // initialization
 void insieme_init_context(irt_context* context) {
 	context->type_table_size = 1;
-	context->impl_table_size = 1;
+	context->impl_table_size = 2;
 	context->type_table = g_insieme_type_table;
 	context->impl_table = g_insieme_impl_table;
 	context->num_regions = 0;
@@ -99,7 +107,76 @@ void insieme_wi_startup_implementation_simple(irt_work_item* wi) {
 	EXPECT_EQ(table->number_of_elements, 2);
 }
 
+#define STREAMING_MARKER_THREAD 4711
+#define STREAMING_NUM_EVENTS (3 * IRT_INST_WORKER_EVENT_STREAM_BLOCKSIZE + 5)
+
+uint16 g_streaming_worker = 0;
+
+void insieme_wi_startup_implementation_streaming(irt_work_item* wi) {
+	irt_worker* worker = irt_worker_get_current();
+	irt_instrumentation_event_data_table* table = worker->instrumentation_event_data;
+	g_streaming_worker = worker->id.thread;
+
+	ASSERT_TRUE(table->stream != NULL);
+
+	irt_work_item_id id = { (uint64)0 };
+	id.thread = STREAMING_MARKER_THREAD;
+	for(uint32 i = 0; i < STREAMING_NUM_EVENTS; ++i) {
+		id.index = i;
+		irt_inst_insert_wi_event(worker, IRT_INST_WORK_ITEM_CREATED, id);
+		// the table never holds more than a single block
+		EXPECT_LE(table->number_of_elements, IRT_INST_WORKER_EVENT_STREAM_BLOCKSIZE);
+	}
+}
+
 TEST(event_instrumentation, simple) {
 	uint32 wcount = irt_get_default_worker_count();
 	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
 }
+
+TEST(event_instrumentation, streaming) {
+	char outputpath[] = "/tmp/insieme_event_trace_test_XXXXXX";
+	ASSERT_TRUE(mkdtemp(outputpath) != NULL);
+	setenv(IRT_INST_OUTPUT_PATH_ENV, outputpath, 1);
+	setenv(IRT_INST_WORKER_EVENT_LOGGING_ENV, "enabled", 1);
+	setenv(IRT_INST_WORKER_EVENT_TYPES_ENV, "WI", 1);
+	setenv(IRT_INST_STREAMING_OUTPUT_ENV, "enabled", 1);
+
+	uint32 wcount = irt_get_default_worker_count();
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[1], NULL);
+
+	unsetenv(IRT_INST_OUTPUT_PATH_ENV);
+	unsetenv(IRT_INST_WORKER_EVENT_LOGGING_ENV);
+	unsetenv(IRT_INST_WORKER_EVENT_TYPES_ENV);
+	unsetenv(IRT_INST_STREAMING_OUTPUT_ENV);
+
+	char filename[IRT_INST_OUTPUT_PATH_CHAR_SIZE];
+	sprintf(filename, "%s/worker_event_trace.%04u", outputpath, g_streaming_worker);
+	FILE* file = fopen(filename, "rb");
+	ASSERT_TRUE(file != NULL);
+
+	irt_inst_event_trace_reader reader;
+	ASSERT_TRUE(irt_inst_event_trace_open(&reader, file));
+	EXPECT_GT(reader.ticks_per_sec, 0);
+	EXPECT_EQ(reader.num_event_types, irt_g_inst_num_event_types);
+	EXPECT_STREQ(reader.group_names[IRT_INST_WORK_ITEM_CREATED], irt_g_instrumentation_group_names[IRT_INST_WORK_ITEM_CREATED]);
+	EXPECT_STREQ(reader.event_names[IRT_INST_WORK_ITEM_CREATED], irt_g_instrumentation_event_names[IRT_INST_WORK_ITEM_CREATED]);
+
+	// all marker events need to be present in order, interleaved with the events of the runtime itself
+	irt_instrumentation_event_data event;
+	uint32 num_marker_events = 0;
+	uint64 last_timestamp = 0;
+	while(irt_inst_event_trace_next(&reader, &event)) {
+		if(event.thread != STREAMING_MARKER_THREAD)
+			continue;
+		EXPECT_EQ(event.event_id, IRT_INST_WORK_ITEM_CREATED);
+		EXPECT_EQ(event.index, num_marker_events);
+		EXPECT_GE(event.timestamp, last_timestamp);
+		last_timestamp = event.timestamp;
+		++num_marker_events;
+	}
+	EXPECT_EQ(num_marker_events, STREAMING_NUM_EVENTS);
+
+	irt_inst_event_trace_close(&reader);
+	fclose(file);
+}
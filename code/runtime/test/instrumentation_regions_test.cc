@@ -97,6 +97,7 @@ TEST(region_instrumentation, simple) {
 		irt_nanosleep(1e8);
 		ir_inst_region_end(0);
 		uint64 end = irt_time_ticks();
+		irt_inst_region_merge(irt_context_get_current());
 		
 		double elapsed = end-start;
 
@@ -126,6 +127,7 @@ TEST(region_instrumentation, multiple_metrics) {
 		irt_nanosleep(1e8);
 		ir_inst_region_end(0);
 		uint64 end = irt_time_ticks();
+		irt_inst_region_merge(irt_context_get_current());
 
 		double elapsed = end-start;
 
@@ -164,6 +166,7 @@ TEST(region_instrumentation, nested) {
 			ir_inst_region_end(1);
 		ir_inst_region_end(0);
 		uint64 end = irt_time_ticks();
+		irt_inst_region_merge(irt_context_get_current());
 
 		double elapsed = end-start;
 
@@ -206,6 +209,7 @@ TEST(region_instrumentation, repeated_execution) {
 
 		ir_inst_region_start(0);
 		ir_inst_region_end(0);
+		irt_inst_region_merge(irt_context_get_current());
 
 		EXPECT_EQ(reg0->num_executions, 1);
 		EXPECT_GT(reg0->aggregated_cpu_time, 0);
@@ -217,6 +221,7 @@ TEST(region_instrumentation, repeated_execution) {
 
 		ir_inst_region_start(0);
 		ir_inst_region_end(0);
+		irt_inst_region_merge(irt_context_get_current());
 
 		EXPECT_EQ(reg0->num_executions, 2);
 		EXPECT_GT(reg0->aggregated_cpu_time, 0);
@@ -230,6 +235,7 @@ TEST(region_instrumentation, repeated_execution) {
 			ir_inst_region_start(0);
 			ir_inst_region_end(0);
 		}
+		irt_inst_region_merge(irt_context_get_current());
 
 		EXPECT_GT(reg0->aggregated_cpu_time, 0);
 		EXPECT_LT(reg0->aggregated_cpu_time, 1e11);
@@ -266,6 +272,7 @@ TEST(region_instrumentation, parallel) {
 		};
 
 		irt::merge(irt::parallel(workload));
+		irt_inst_region_merge(irt_context_get_current());
 
 		irt_inst_region_context_data* region[3];
 
@@ -284,6 +291,32 @@ TEST(region_instrumentation, parallel) {
 	irt::shutdown();
 }
 
+TEST(region_instrumentation, ring_buffer_growth) {
+	irt::init_in_context(MAX_PARA, insieme_init_context_simple, insieme_cleanup_context);
+	irt::run([]() {
+		irt_inst_region_select_metrics("cpu_time,wall_time");
+
+		// many more region instances than the region ring buffers of the work group can hold at once
+		const uint32 iterations = 20000;
+		auto workload = [&]() {
+			for(uint32 i = 0; i < iterations; ++i) {
+				ir_inst_region_start(0);
+				ir_inst_region_end(0);
+			}
+		};
+
+		irt::merge(irt::parallel(workload));
+		irt_inst_region_merge(irt_context_get_current());
+
+		irt_inst_region_context_data* reg0 = &(irt_context_get_current()->inst_region_data[0]);
+		EXPECT_EQ(reg0->num_executions, iterations);
+		EXPECT_GT(reg0->aggregated_wall_time, 0);
+		EXPECT_EQ(reg0->last_cpu_time, 0);
+		EXPECT_EQ(reg0->last_wall_time, 0);
+	});
+	irt::shutdown();
+}
+
 TEST(region_instrumentation, rapl) {
 
 #ifdef DISABLE_ENERGY
@@ -340,6 +373,7 @@ TEST(region_instrumentation, rapl) {
 		ir_inst_region_start(0);
 		irt_nanosleep(1e8);
 		ir_inst_region_end(0);
+		irt_inst_region_merge(irt_context_get_current());
 
 		EXPECT_GT(reg0->aggregated_cpu_energy, 0);
 		EXPECT_LT(reg0->aggregated_cpu_energy, 100);
@@ -375,6 +409,7 @@ TEST(region_instrumentation, pfor) {
 		irt::merge(irt::parallel(workload));
 		ir_inst_region_end(0);
 		uint64 end = irt_time_ticks();
+		irt_inst_region_merge(irt_context_get_current());
 
 		double elapsed = end-start;
 
@@ -409,6 +444,7 @@ TEST(region_instrumentation, papi) {
 			a = a + b;
 		}
 		ir_inst_region_end(0);
+		irt_inst_region_merge(irt_context_get_current());
 
 		irt_inst_region_context_data* reg0 = &(irt_context_get_current()->inst_region_data[0]);
 
@@ -434,6 +470,7 @@ TEST(region_instrumentation, all_metrics) {
 		ir_inst_region_start(0);
 		irt_nanosleep(1e8);
 		ir_inst_region_end(0);
+		irt_inst_region_merge(irt_context_get_current());
 
 		irt_inst_region_context_data* reg0 = &(irt_context_get_current()->inst_region_data[0]);
 		EXPECT_GT(reg0->aggregated_cpu_time, 8e7);
@@ -491,6 +528,7 @@ TEST(region_instrumentation, pfor_nested) {
 		irt::merge(irt::parallel(workload));
 		ir_inst_region_end(0);
 		uint64 end = irt_time_ticks();
+		irt_inst_region_merge(irt_context_get_current());
 
 		double elapsed = end-start;
 
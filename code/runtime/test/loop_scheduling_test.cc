@@ -117,32 +117,49 @@ TEST_P(LoopSchedTest, RangeCoverage) {
 #define xstr(s) str(s)
 #define str(s) #s
 
+void addRanges(vector<LoopTestCase>& cases, LoopTestCase t, const vector<int64>& steps) {
+	for(int64 step : steps) {
+		if(step < 0) {
+			t.range = { VEC_SIZE, 0, step };
+			cases.push_back(t);
+			continue;
+		}
+		t.range = { 0, VEC_SIZE, step };
+		cases.push_back(t);
+		t.range = { 0, VEC_SIZE / 2, step };
+		cases.push_back(t);
+		t.range = { VEC_SIZE / 3, 2 * (VEC_SIZE / 3), step };
+		cases.push_back(t);
+	}
+}
+
 vector<LoopTestCase> getAllCases() {
 	vector<LoopTestCase> ret;
 
 	vector<irt_loop_sched_policy_type> policies = { IRT_STATIC, IRT_STATIC_CHUNKED, IRT_DYNAMIC, IRT_DYNAMIC_CHUNKED, IRT_GUIDED, IRT_GUIDED_CHUNKED };
+	vector<int64> steps = { -4, -3, -2, -1, 1, 2, 3, 4, 5, 6, 7 };
 
 	for(auto policy_type : policies) {
 		for(int32 chunk_size = 1; chunk_size <= 9; ++chunk_size) {
 			for(uint32 participants = 1; participants <= MAX_PARA; ++participants) {
 				LoopTestCase t;
 				t.policy = { policy_type, participants, { chunk_size } };
-
-				for(int64 step = -4; step <= -1; step++) {
-					t.range = { VEC_SIZE, 0, step };
-					ret.push_back(t);
-				}
-				for(int64 step = 1; step < 8; step++) {
-					t.range = { 0, VEC_SIZE, step };
-					ret.push_back(t);
-					t.range = { 0, VEC_SIZE / 2, step };
-					ret.push_back(t);
-					t.range = { VEC_SIZE / 3, 2 * (VEC_SIZE / 3), step };
-					ret.push_back(t);
-				}
+				addRanges(ret, t, steps);
 			}
 		}
 	}
+
+	// range stealing is covered on a reduced grid, IRT_STEALING derives its chunk size from the range
+	vector<int64> stealingSteps = { -3, -1, 1, 2, 7 };
+	for(uint32 participants = 1; participants <= MAX_PARA; ++participants) {
+		LoopTestCase t;
+		t.policy = { IRT_STEALING, participants, { 1 } };
+		addRanges(ret, t, stealingSteps);
+		for(int32 chunk_size : { 1, 3, 8 }) {
+			t.policy = { IRT_STEALING_CHUNKED, participants, { chunk_size } };
+			addRanges(ret, t, stealingSteps);
+		}
+	}
 	return ret; 
 }
  
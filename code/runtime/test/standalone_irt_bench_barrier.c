@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/* Work group barrier benchmark comparing the combining tree barrier against the event based one.
+ * Reports the average latency per barrier for groups of 1 to 128 members.
+ * usage: [worker count] [barriers per measurement] [max members]
+ */
+
+#include <stdlib.h>
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+#include "utils/timing.h"
+
+#define DEFAULT_BARRIERS 1000
+#define DEFAULT_MAX_MEMBERS 128
+
+irt_type g_insieme_type_table[] = {
+	{ IRT_T_INT64, 8, 0, 0 }
+};
+
+// work item table
+
+void insieme_wi_startup_implementation(irt_work_item* wi);
+void insieme_wi_bench_implementation(irt_work_item* wi);
+
+irt_wi_implementation_variant g_insieme_wi_startup_variants[] = { { &insieme_wi_startup_implementation } };
+irt_wi_implementation_variant g_insieme_wi_bench_variants[] = { { &insieme_wi_bench_implementation } };
+
+irt_wi_implementation g_insieme_impl_table[] = {
+	{ 1, 1, g_insieme_wi_startup_variants },
+	{ 2, 1, g_insieme_wi_bench_variants }
+};
+
+// initialization
+void insieme_init_context(irt_context* context) {
+	context->type_table_size = 1;
+	context->impl_table_size = 2;
+	context->type_table = g_insieme_type_table;
+	context->impl_table = g_insieme_impl_table;
+}
+
+void insieme_cleanup_context(irt_context* context) {
+	// nothing
+}
+
+uint32 g_barriers = DEFAULT_BARRIERS;
+uint32 g_max_members = DEFAULT_MAX_MEMBERS;
+
+typedef void bench_barrier(irt_work_group* wg);
+
+typedef struct _bench_variant {
+	const char* name;
+	bench_barrier* barrier;
+	uint64 time_ns;
+} bench_variant;
+
+bench_variant g_variants[] = {
+	{ "tree", &irt_wg_barrier_tree, 0 },
+	{ "scheduled", &irt_wg_barrier_scheduled, 0 }
+};
+#define NUM_VARIANTS (sizeof(g_variants) / sizeof(bench_variant))
+
+// work item function definitions
+
+void insieme_wi_startup_implementation(irt_work_item* wi) {
+	printf("======================\n= work group barrier benchmark, %u workers, %u barriers per measurement\n", irt_g_worker_count, g_barriers);
+	printf("= members");
+	for(uint32 v = 0; v < NUM_VARIANTS; ++v) printf("  %12s ns", g_variants[v].name);
+	printf("\n");
+	for(uint32 members = 1; members <= g_max_members; members *= 2) {
+		irt_parallel_job job = { members, members, 1, &g_insieme_impl_table[1], NULL };
+		irt_merge(irt_parallel(&job));
+		printf("= %7u", members);
+		for(uint32 v = 0; v < NUM_VARIANTS; ++v) printf("  %15.1f", g_variants[v].time_ns / (double)g_barriers);
+		printf("\n");
+	}
+	printf("======================\n");
+}
+
+void insieme_wi_bench_implementation(irt_work_item* wi) {
+	uint32 id = wi->wg_memberships[0].num;
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
+	for(uint32 v = 0; v < NUM_VARIANTS; ++v) {
+		// warm up and align all members
+		g_variants[v].barrier(wg);
+		g_variants[v].barrier(wg);
+		uint64 start_time = irt_time_ns();
+		for(uint32 b = 0; b < g_barriers; ++b) {
+			g_variants[v].barrier(wg);
+		}
+		if(id == 0) g_variants[v].time_ns = irt_time_ns() - start_time;
+		g_variants[v].barrier(wg);
+	}
+}
+
+
+int main(int argc, char **argv) {
+	uint32 wcount = irt_get_default_worker_count();
+	if(argc>=2) wcount = atoi(argv[1]);
+	if(argc>=3) g_barriers = atoi(argv[2]);
+	if(argc>=4) g_max_members = atoi(argv[3]);
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
+	return 0;
+}
@@ -0,0 +1,258 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/* Lock contention benchmark comparing irt_lock against the previous suspend-only LIFO lock.
+ * usage: [worker count] [acquisitions per contender] [critical section length] [repeats]
+ */
+
+#include <stdlib.h>
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+#include "utils/timing.h"
+
+#define DEFAULT_ACQUISITIONS 20000
+#define DEFAULT_CRITICAL_LENGTH 50
+#define DEFAULT_REPEATS 3
+// number of concurrent contenders per worker
+#define CONTENDERS_PER_WORKER 4
+// every READ_RATIO-th access of the rwlock benchmark is a write
+#define READ_RATIO 10
+
+// the irt_lock implementation preceding the adaptive FIFO lock, waiters are suspended immediately and resumed in LIFO order
+
+typedef struct _legacy_lock {
+	irt_spinlock mutex;
+	uint32 locked;
+	locked_wi *top;
+} legacy_lock;
+
+void legacy_lock_init(legacy_lock* lock) {
+	irt_spin_init(&lock->mutex);
+	lock->top = NULL;
+	lock->locked = 0;
+}
+
+void legacy_lock_acquire(legacy_lock* lock) {
+	irt_spin_lock(&lock->mutex);
+	if(lock->locked) {
+		irt_worker *wo = irt_worker_get_current();
+		irt_work_item *wi = wo->cur_wi;
+		locked_wi selflocked = {wi, wo, true, lock->top};
+		lock->top = &selflocked;
+		irt_spin_unlock(&lock->mutex);
+		_irt_worker_switch_from_wi(wo, wi);
+	} else {
+		lock->locked = 1;
+		irt_spin_unlock(&lock->mutex);
+	}
+}
+
+void legacy_lock_release(legacy_lock* lock) {
+	irt_spin_lock(&lock->mutex);
+	if(lock->top) {
+		locked_wi *task = lock->top;
+		lock->top = task->next;
+		irt_worker* wo = task->worker;
+		irt_scheduling_continue_wi(task->worker, task->wi);
+		irt_signal_worker(wo);
+	} else {
+		lock->locked = 0;
+	}
+	irt_spin_unlock(&lock->mutex);
+}
+
+typedef enum { BENCH_LEGACY_LOCK, BENCH_LOCK, BENCH_RWLOCK_WRITE, BENCH_RWLOCK_READ_MOSTLY } bench_mode;
+
+typedef struct _insieme_wi_bench_params {
+	irt_type_id type_id;
+	bench_mode mode;
+} insieme_wi_bench_params;
+
+irt_type g_insieme_type_table[] = {
+	{ IRT_T_INT64, 8, 0, 0 },
+	{ IRT_T_STRUCT, sizeof(insieme_wi_bench_params), 0, 0 }
+};
+
+// work item table
+
+void insieme_wi_startup_implementation(irt_work_item* wi);
+void insieme_wi_contender_implementation(irt_work_item* wi);
+
+irt_wi_implementation_variant g_insieme_wi_startup_variants[] = { { &insieme_wi_startup_implementation } };
+irt_wi_implementation_variant g_insieme_wi_contender_variants[] = { { &insieme_wi_contender_implementation } };
+
+irt_wi_implementation g_insieme_impl_table[] = {
+	{ 1, 1, g_insieme_wi_startup_variants },
+	{ 2, 1, g_insieme_wi_contender_variants }
+};
+
+// initialization
+void insieme_init_context(irt_context* context) {
+	context->type_table_size = 2;
+	context->impl_table_size = 2;
+	context->type_table = g_insieme_type_table;
+	context->impl_table = g_insieme_impl_table;
+}
+
+void insieme_cleanup_context(irt_context* context) {
+	// nothing
+}
+
+uint32 g_acquisitions = DEFAULT_ACQUISITIONS;
+uint32 g_critical_length = DEFAULT_CRITICAL_LENGTH;
+uint32 g_repeats = DEFAULT_REPEATS;
+
+legacy_lock g_legacy_lock;
+irt_lock g_lock;
+irt_rwlock g_rwlock;
+
+// protected by the lock under test
+volatile uint64 g_counter;
+volatile uint64 g_reads;
+
+static void critical_section() {
+	for(uint32 i = 0; i < g_critical_length; ++i) {
+		g_counter++;
+	}
+}
+
+static void read_section() {
+	uint64 sum = 0;
+	for(uint32 i = 0; i < g_critical_length; ++i) {
+		sum += g_counter;
+	}
+	irt_atomic_inc(&g_reads, uint64);
+	(void)sum;
+}
+
+static void print_stats(irt_lock_stats stats) {
+	printf("=   acquisitions: %10lu   contended: %10lu   suspended: %10lu\n",
+		(unsigned long)stats.acquisitions, (unsigned long)stats.contended, (unsigned long)stats.suspended);
+}
+
+static void run_bench(const char* name, bench_mode mode) {
+	uint32 num_contenders = irt_g_worker_count * CONTENDERS_PER_WORKER;
+	uint64 total_time = 0;
+	insieme_wi_bench_params params = { 1, mode };
+	irt_work_item_id *ids = (irt_work_item_id*)malloc(num_contenders * sizeof(irt_work_item_id));
+	legacy_lock_init(&g_legacy_lock);
+	irt_lock_init(&g_lock);
+	irt_rwlock_init(&g_rwlock);
+	g_counter = 0;
+	g_reads = 0;
+	for(uint32 r = 0; r < g_repeats; ++r) {
+		uint64 start_time = irt_time_ms();
+		for(uint32 i = 0; i < num_contenders; ++i) {
+			irt_work_item* contender = irt_wi_create(irt_g_wi_range_one_elem, &g_insieme_impl_table[1], (irt_lw_data_item*)&params);
+			ids[i] = contender->id;
+			irt_scheduling_assign_wi(irt_g_workers[i % irt_g_worker_count], contender);
+		}
+		for(uint32 i = 0; i < num_contenders; ++i) {
+			irt_wi_join(ids[i]);
+		}
+		total_time += irt_time_ms() - start_time;
+	}
+	free(ids);
+
+	uint64 total = (uint64)g_acquisitions * num_contenders * g_repeats;
+	uint64 writes = (mode == BENCH_RWLOCK_READ_MOSTLY) ? total - g_reads : total;
+	if(g_counter != writes * g_critical_length) {
+		printf("= %s: lost updates, counter %lu, expected %lu\n", name, (unsigned long)g_counter, (unsigned long)(writes * g_critical_length));
+		exit(1);
+	}
+	printf("= %-22s acquisitions: %10lu   time: %6lu ms   acquisitions/s: %10lu\n", name, (unsigned long)total, (unsigned long)total_time,
+		(unsigned long)(total / (total_time > 0 ? total_time / 1000.0 : 0.001)));
+	if(mode == BENCH_LOCK) print_stats(irt_lock_get_stats(&g_lock));
+	if(mode == BENCH_RWLOCK_WRITE || mode == BENCH_RWLOCK_READ_MOSTLY) print_stats(irt_rwlock_get_stats(&g_rwlock));
+}
+
+// work item function definitions
+
+void insieme_wi_startup_implementation(irt_work_item* wi) {
+	printf("======================\n= lock benchmark, %u workers, %u contenders x %u acquisitions x %u, critical section %u\n",
+		irt_g_worker_count, irt_g_worker_count * CONTENDERS_PER_WORKER, g_acquisitions, g_repeats, g_critical_length);
+	run_bench("legacy lock", BENCH_LEGACY_LOCK);
+	run_bench("irt_lock", BENCH_LOCK);
+	run_bench("irt_rwlock writes", BENCH_RWLOCK_WRITE);
+	run_bench("irt_rwlock read-mostly", BENCH_RWLOCK_READ_MOSTLY);
+	printf("======================\n");
+}
+
+void insieme_wi_contender_implementation(irt_work_item* wi) {
+	insieme_wi_bench_params *params = (insieme_wi_bench_params*)wi->parameters;
+	for(uint32 i = 0; i < g_acquisitions; ++i) {
+		switch(params->mode) {
+		case BENCH_LEGACY_LOCK:
+			legacy_lock_acquire(&g_legacy_lock);
+			critical_section();
+			legacy_lock_release(&g_legacy_lock);
+			break;
+		case BENCH_LOCK:
+			irt_lock_acquire(&g_lock);
+			critical_section();
+			irt_lock_release(&g_lock);
+			break;
+		case BENCH_RWLOCK_WRITE:
+			irt_rwlock_write_acquire(&g_rwlock);
+			critical_section();
+			irt_rwlock_write_release(&g_rwlock);
+			break;
+		case BENCH_RWLOCK_READ_MOSTLY:
+			if(i % READ_RATIO == 0) {
+				irt_rwlock_write_acquire(&g_rwlock);
+				critical_section();
+				irt_rwlock_write_release(&g_rwlock);
+			} else {
+				irt_rwlock_read_acquire(&g_rwlock);
+				read_section();
+				irt_rwlock_read_release(&g_rwlock);
+			}
+			break;
+		}
+	}
+}
+
+
+int main(int argc, char **argv) {
+	uint32 wcount = irt_get_default_worker_count();
+	if(argc>=2) wcount = atoi(argv[1]);
+	if(argc>=3) g_acquisitions = atoi(argv[2]);
+	if(argc>=4) g_critical_length = atoi(argv[3]);
+	if(argc>=5) g_repeats = atoi(argv[4]);
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
+	return 0;
+}
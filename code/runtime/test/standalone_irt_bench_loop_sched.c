@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/* Loop scheduling benchmark comparing the range stealing policy against the existing ones.
+ * A pfor over a shared array is repeated, optionally with linearly growing effort per iteration.
+ * usage: [worker count] [iterations] [repeats] [imbalanced (0/1)]
+ */
+
+#include <stdlib.h>
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+#include "utils/timing.h"
+
+#define DEFAULT_ITERATIONS 1000000
+#define DEFAULT_REPEATS 50
+// effort per iteration (in inner loop steps) for balanced loops, imbalanced loops average the same effort
+#define EFFORT 8
+
+irt_type g_insieme_type_table[] = {
+	{ IRT_T_INT64, 8, 0, 0 }
+};
+
+// work item table
+
+void insieme_wi_startup_implementation(irt_work_item* wi);
+void insieme_wi_bench_implementation(irt_work_item* wi);
+void insieme_wi_loop_implementation(irt_work_item* wi);
+
+irt_wi_implementation_variant g_insieme_wi_startup_variants[] = { { &insieme_wi_startup_implementation } };
+irt_wi_implementation_variant g_insieme_wi_bench_variants[] = { { &insieme_wi_bench_implementation } };
+irt_wi_implementation_variant g_insieme_wi_loop_variants[] = { { &insieme_wi_loop_implementation } };
+
+irt_wi_implementation g_insieme_impl_table[] = {
+	{ 1, 1, g_insieme_wi_startup_variants },
+	{ 2, 1, g_insieme_wi_bench_variants },
+	{ 3, 1, g_insieme_wi_loop_variants }
+};
+
+// initialization
+void insieme_init_context(irt_context* context) {
+	context->type_table_size = 1;
+	context->impl_table_size = 3;
+	context->type_table = g_insieme_type_table;
+	context->impl_table = g_insieme_impl_table;
+}
+
+void insieme_cleanup_context(irt_context* context) {
+	// nothing
+}
+
+uint64 g_iterations = DEFAULT_ITERATIONS;
+uint32 g_repeats = DEFAULT_REPEATS;
+bool g_imbalanced = false;
+double* g_data;
+
+typedef struct _bench_policy {
+	const char* name;
+	irt_loop_sched_policy policy;
+} bench_policy;
+
+bench_policy g_policies[] = {
+	{ "IRT_STATIC", { IRT_STATIC, IRT_SANE_PARALLEL_MAX, { 0 } } },
+	{ "IRT_DYNAMIC", { IRT_DYNAMIC, IRT_SANE_PARALLEL_MAX, { 0 } } },
+	{ "IRT_DYNAMIC,64", { IRT_DYNAMIC_CHUNKED, IRT_SANE_PARALLEL_MAX, { 64 } } },
+	{ "IRT_GUIDED", { IRT_GUIDED, IRT_SANE_PARALLEL_MAX, { 0 } } },
+	{ "IRT_STEALING", { IRT_STEALING, IRT_SANE_PARALLEL_MAX, { 0 } } },
+	{ "IRT_STEALING,64", { IRT_STEALING_CHUNKED, IRT_SANE_PARALLEL_MAX, { 64 } } }
+};
+
+// work item function definitions
+
+void insieme_wi_startup_implementation(irt_work_item* wi) {
+	printf("======================\n= loop scheduling benchmark, %u workers, %lu iterations x %u, %s\n",
+		irt_g_worker_count, (unsigned long)g_iterations, g_repeats, g_imbalanced ? "imbalanced" : "balanced");
+	g_data = (double*)calloc(g_iterations, sizeof(double));
+	irt_parallel_job job = { irt_g_worker_count, irt_g_worker_count, 1, &g_insieme_impl_table[1], NULL };
+	irt_merge(irt_parallel(&job));
+	free(g_data);
+	printf("======================\n");
+}
+
+void insieme_wi_bench_implementation(irt_work_item* wi) {
+	uint32 id = wi->wg_memberships[0].num;
+	irt_work_group* wg = wi->wg_memberships[0].wg_id.cached;
+	irt_work_item_range loop_range = { 0, (int64)g_iterations, 1 };
+
+	for(uint32 p = 0; p < sizeof(g_policies) / sizeof(bench_policy); ++p) {
+		if(id == 0) irt_wg_set_loop_scheduling_policy(wg, &g_policies[p].policy);
+		irt_wg_barrier(wg);
+		uint64 start_time = irt_time_ms();
+		for(uint32 r = 0; r < g_repeats; ++r) {
+			irt_schedule_loop(wi, wg, loop_range, &g_insieme_impl_table[2], NULL);
+			irt_wg_barrier(wg);
+		}
+		if(id == 0) {
+			uint64 time = irt_time_ms() - start_time;
+			printf("= %-16s time: %6lu ms   iterations/s: %12lu\n", g_policies[p].name, (unsigned long)time,
+				(unsigned long)(g_iterations * g_repeats / (time > 0 ? time / 1000.0 : 0.001)));
+		}
+		irt_wg_barrier(wg);
+	}
+}
+
+void insieme_wi_loop_implementation(irt_work_item* wi) {
+	for(int64 i = wi->range.begin; i < wi->range.end; i += wi->range.step) {
+		uint64 effort = g_imbalanced ? (2 * EFFORT * i) / g_iterations : EFFORT;
+		double value = g_data[i];
+		for(uint64 j = 0; j < effort; ++j) {
+			value = value * 0.5 + 1.0;
+		}
+		g_data[i] = value;
+	}
+}
+
+
+int main(int argc, char **argv) {
+	uint32 wcount = irt_get_default_worker_count();
+	if(argc>=2) wcount = atoi(argv[1]);
+	if(argc>=3) g_iterations = atol(argv[2]);
+	if(argc>=4) g_repeats = atoi(argv[3]);
+	if(argc>=5) g_imbalanced = atoi(argv[4]) != 0;
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
+	return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/* Spawn/join throughput benchmark stressing the work item event registers.
+ * usage: [worker count] [wis per spawner] [repeats], e.g. for sweeping worker counts:
+ *   for w in 1 2 4 8 16 32 64; do ./standalone_irt_bench_spawn_join $w; done
+ */
+
+#include <stdlib.h>
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+#include "utils/timing.h"
+
+#define DEFAULT_NUM_WIS 10000
+#define DEFAULT_REPEATS 5
+// number of concurrent spawners per worker in the parallel benchmark
+#define SPAWNERS_PER_WORKER 4
+
+typedef struct _insieme_wi_spawn_params {
+	irt_type_id type_id;
+	uint64 *check;
+} insieme_wi_spawn_params;
+
+irt_type g_insieme_type_table[] = {
+	{ IRT_T_INT64, 8, 0, 0 },
+	{ IRT_T_STRUCT, sizeof(insieme_wi_spawn_params), 0, 0 }
+};
+
+// work item table
+
+void insieme_wi_startup_implementation(irt_work_item* wi);
+void insieme_wi_leaf_implementation(irt_work_item* wi);
+void insieme_wi_spawn_join_implementation(irt_work_item* wi);
+void insieme_wi_spawn_join_all_implementation(irt_work_item* wi);
+
+irt_wi_implementation_variant g_insieme_wi_startup_variants[] = { { &insieme_wi_startup_implementation } };
+irt_wi_implementation_variant g_insieme_wi_leaf_variants[] = { { &insieme_wi_leaf_implementation } };
+irt_wi_implementation_variant g_insieme_wi_spawn_join_variants[] = { { &insieme_wi_spawn_join_implementation } };
+irt_wi_implementation_variant g_insieme_wi_spawn_join_all_variants[] = { { &insieme_wi_spawn_join_all_implementation } };
+
+irt_wi_implementation g_insieme_impl_table[] = {
+	{ 1, 1, g_insieme_wi_startup_variants },
+	{ 2, 1, g_insieme_wi_leaf_variants },
+	{ 3, 1, g_insieme_wi_spawn_join_variants },
+	{ 4, 1, g_insieme_wi_spawn_join_all_variants }
+};
+
+// initialization
+void insieme_init_context(irt_context* context) {
+	context->type_table_size = 2;
+	context->impl_table_size = 4;
+	context->type_table = g_insieme_type_table;
+	context->impl_table = g_insieme_impl_table;
+}
+
+void insieme_cleanup_context(irt_context* context) {
+	// nothing
+}
+
+uint32 g_num_wis = DEFAULT_NUM_WIS;
+uint32 g_repeats = DEFAULT_REPEATS;
+
+static void print_result(const char* name, uint64 wis, uint64 check, uint64 time) {
+	if(check != wis) {
+		printf("= %s: wrong number of executed wis %lu, expected %lu\n", name, (unsigned long)check, (unsigned long)wis);
+		exit(1);
+	}
+	printf("= %-22s wis: %10lu   time: %6lu ms   wis/s: %10lu\n", name, (unsigned long)wis, (unsigned long)time,
+		(unsigned long)(wis / (time > 0 ? time / 1000.0 : 0.001)));
+}
+
+// spawns g_num_wis leaf wis from each of the given number of spawners and waits for them
+static void run_bench(const char* name, irt_wi_implementation* spawner_impl, uint32 num_spawners) {
+	uint64 total_time = 0, check = 0;
+	insieme_wi_spawn_params params = { 1, &check };
+	irt_work_item_id *spawner_ids = (irt_work_item_id*)malloc(num_spawners * sizeof(irt_work_item_id));
+	for(uint32 r = 0; r < g_repeats; ++r) {
+		uint64 start_time = irt_time_ms();
+		for(uint32 i = 0; i < num_spawners; ++i) {
+			irt_work_item* spawner = irt_wi_create(irt_g_wi_range_one_elem, spawner_impl, (irt_lw_data_item*)&params);
+			spawner_ids[i] = spawner->id;
+			irt_scheduling_assign_wi(irt_g_workers[i % irt_g_worker_count], spawner);
+		}
+		for(uint32 i = 0; i < num_spawners; ++i) {
+			irt_wi_join(spawner_ids[i]);
+		}
+		total_time += irt_time_ms() - start_time;
+	}
+	free(spawner_ids);
+	print_result(name, (uint64)g_num_wis * num_spawners * g_repeats, check, total_time);
+}
+
+// work item function definitions
+
+void insieme_wi_startup_implementation(irt_work_item* wi) {
+	printf("======================\n= spawn/join benchmark, %u workers, %u wis per spawner x %u\n",
+		irt_g_worker_count, g_num_wis, g_repeats);
+	run_bench("join single spawner", &g_insieme_impl_table[2], 1);
+	run_bench("join parallel", &g_insieme_impl_table[2], irt_g_worker_count * SPAWNERS_PER_WORKER);
+	run_bench("join_all parallel", &g_insieme_impl_table[3], irt_g_worker_count * SPAWNERS_PER_WORKER);
+	printf("======================\n");
+}
+
+void insieme_wi_leaf_implementation(irt_work_item* wi) {
+	insieme_wi_spawn_params *params = (insieme_wi_spawn_params*)wi->parameters;
+	irt_atomic_inc(params->check, uint64);
+}
+
+// spawns all wis first, then joins them one by one - most joins will find their wi completed already
+void insieme_wi_spawn_join_implementation(irt_work_item* wi) {
+	insieme_wi_spawn_params *params = (insieme_wi_spawn_params*)wi->parameters;
+	irt_work_item_id *ids = (irt_work_item_id*)malloc(g_num_wis * sizeof(irt_work_item_id));
+	for(uint32 i = 0; i < g_num_wis; ++i) {
+		irt_work_item *leaf = irt_wi_create(irt_g_wi_range_one_elem, &g_insieme_impl_table[1], (irt_lw_data_item*)params);
+		ids[i] = leaf->id;
+		irt_scheduling_assign_wi(irt_worker_get_current(), leaf);
+	}
+	for(uint32 i = 0; i < g_num_wis; ++i) {
+		irt_wi_join(ids[i]);
+	}
+	free(ids);
+}
+
+void insieme_wi_spawn_join_all_implementation(irt_work_item* wi) {
+	insieme_wi_spawn_params *params = (insieme_wi_spawn_params*)wi->parameters;
+	for(uint32 i = 0; i < g_num_wis; ++i) {
+		irt_work_item *leaf = irt_wi_create(irt_g_wi_range_one_elem, &g_insieme_impl_table[1], (irt_lw_data_item*)params);
+		irt_scheduling_assign_wi(irt_worker_get_current(), leaf);
+	}
+	irt_wi_join_all(wi);
+}
+
+
+int main(int argc, char **argv) {
+	uint32 wcount = irt_get_default_worker_count();
+	if(argc>=2) wcount = atoi(argv[1]);
+	if(argc>=3) g_num_wis = atoi(argv[2]);
+	if(argc>=4) g_repeats = atoi(argv[3]);
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
+	return 0;
+}
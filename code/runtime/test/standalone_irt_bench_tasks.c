@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+/* Recursive task-parallel throughput benchmark (fib-style) for the work stealing policies.
+ * Build with -DIRT_SCHED_POLICY=... to compare policies; usage: [worker count] [fib n] [repeats]
+ */
+
+#include <stdlib.h>
+
+#include "irt_all_impls.h"
+#include "standalone.h"
+#include "utils/timing.h"
+
+#define DEFAULT_FIB_N 24
+#define DEFAULT_REPEATS 5
+
+#if IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING
+#define BENCH_POLICY_NAME "IRT_SCHED_POLICY_STEALING"
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CIRCULAR
+#define BENCH_POLICY_NAME "IRT_SCHED_POLICY_STEALING_CIRCULAR"
+#elif IRT_SCHED_POLICY == IRT_SCHED_POLICY_STEALING_CHASE_LEV
+#define BENCH_POLICY_NAME "IRT_SCHED_POLICY_STEALING_CHASE_LEV"
+#else
+#define BENCH_POLICY_NAME "other"
+#endif
+
+typedef struct _insieme_wi_fib_params {
+	irt_type_id type_id;
+	uint32 n;
+	uint64 *result;
+} insieme_wi_fib_params;
+
+irt_type g_insieme_type_table[] = {
+	{ IRT_T_INT64, 8, 0, 0 },
+	{ IRT_T_STRUCT, sizeof(insieme_wi_fib_params), 0, 0 }
+};
+
+// work item table
+
+void insieme_wi_startup_implementation(irt_work_item* wi);
+void insieme_wi_fib_implementation(irt_work_item* wi);
+void insieme_wi_opt_fib_implementation(irt_work_item* wi);
+
+irt_wi_implementation_variant g_insieme_wi_startup_variants[] = { { &insieme_wi_startup_implementation } };
+irt_wi_implementation_variant g_insieme_wi_fib_variants[] = { { &insieme_wi_fib_implementation } };
+irt_wi_implementation_variant g_insieme_wi_opt_fib_variants[] = { { &insieme_wi_opt_fib_implementation } };
+
+irt_wi_implementation g_insieme_impl_table[] = {
+	{ 1, 1, g_insieme_wi_startup_variants },
+	{ 2, 1, g_insieme_wi_fib_variants },
+	{ 3, 1, g_insieme_wi_opt_fib_variants }
+};
+
+// initialization
+void insieme_init_context(irt_context* context) {
+	context->type_table_size = 2;
+	context->impl_table_size = 3;
+	context->type_table = g_insieme_type_table;
+	context->impl_table = g_insieme_impl_table;
+}
+
+void insieme_cleanup_context(irt_context* context) {
+	// nothing
+}
+
+uint32 g_fib_n = DEFAULT_FIB_N;
+uint32 g_repeats = DEFAULT_REPEATS;
+
+// number of tasks spawned by fib(n): 2*fib(n+1)-1 calls, minus the root
+uint64 num_tasks(uint32 n) {
+	uint64 a = 0, b = 1;
+	for(uint32 i = 0; i < n + 1; ++i) {
+		uint64 t = a + b;
+		a = b;
+		b = t;
+	}
+	return 2 * a - 2;
+}
+
+uint64 fib_seq(uint32 n) {
+	return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+void run_bench(const char* name, irt_wi_implementation* impl, uint64 expected) {
+	uint64 total_time = 0;
+	for(uint32 i = 0; i < g_repeats; ++i) {
+		uint64 result = 0;
+		insieme_wi_fib_params params = { 1, g_fib_n, &result };
+		uint64 start_time = irt_time_ms();
+		irt_work_item* fib_wi = irt_wi_create(irt_g_wi_range_one_elem, impl, (irt_lw_data_item*)&params);
+		irt_work_item_id wi_id = fib_wi->id;
+		irt_scheduling_assign_wi(irt_worker_get_current(), fib_wi);
+		irt_wi_join(wi_id);
+		total_time += irt_time_ms() - start_time;
+		if(result != expected) {
+			printf("= %s: wrong result %lu, expected %lu\n", name, (unsigned long)result, (unsigned long)expected);
+			exit(1);
+		}
+	}
+	uint64 total_tasks = num_tasks(g_fib_n) * g_repeats;
+	printf("= %-8s tasks: %10lu   time: %6lu ms   tasks/s: %10lu\n", name, (unsigned long)total_tasks, (unsigned long)total_time,
+		(unsigned long)(total_tasks / (total_time > 0 ? total_time / 1000.0 : 0.001)));
+}
+
+// work item function definitions
+
+void insieme_wi_startup_implementation(irt_work_item* wi) {
+	uint64 expected = fib_seq(g_fib_n);
+	printf("======================\n= task benchmark, policy %s, %u workers, fib(%u) x %u\n",
+		BENCH_POLICY_NAME, irt_g_worker_count, g_fib_n, g_repeats);
+	run_bench("real", &g_insieme_impl_table[1], expected);
+	run_bench("optional", &g_insieme_impl_table[2], expected);
+	printf("======================\n");
+}
+
+void insieme_wi_fib_implementation(irt_work_item* wi) {
+	insieme_wi_fib_params *params = (insieme_wi_fib_params*)wi->parameters;
+	if(params->n < 2) {
+		*params->result = params->n;
+		return;
+	}
+	uint64 a, b;
+	insieme_wi_fib_params params_a = { 1, params->n - 1, &a };
+	insieme_wi_fib_params params_b = { 1, params->n - 2, &b };
+	irt_work_item *wi_a = irt_wi_create(irt_g_wi_range_one_elem, &g_insieme_impl_table[1], (irt_lw_data_item*)&params_a);
+	irt_work_item_id id_a = wi_a->id;
+	irt_scheduling_assign_wi(irt_worker_get_current(), wi_a);
+	irt_work_item *wi_b = irt_wi_create(irt_g_wi_range_one_elem, &g_insieme_impl_table[1], (irt_lw_data_item*)&params_b);
+	irt_work_item_id id_b = wi_b->id;
+	irt_scheduling_assign_wi(irt_worker_get_current(), wi_b);
+	irt_wi_join(id_a);
+	irt_wi_join(id_b);
+	*params->result = a + b;
+}
+
+void insieme_wi_opt_fib_implementation(irt_work_item* wi) {
+	insieme_wi_fib_params *params = (insieme_wi_fib_params*)wi->parameters;
+	if(params->n < 2) {
+		*params->result = params->n;
+		return;
+	}
+	uint64 a, b;
+	insieme_wi_fib_params params_a = { 1, params->n - 1, &a };
+	insieme_wi_fib_params params_b = { 1, params->n - 2, &b };
+	irt_parallel_job job_a = { 1, 1, 1, &g_insieme_impl_table[2], (irt_lw_data_item*)&params_a };
+	irt_parallel_job job_b = { 1, 1, 1, &g_insieme_impl_table[2], (irt_lw_data_item*)&params_b };
+	irt_joinable joinable_a = irt_task(&job_a);
+	irt_joinable joinable_b = irt_task(&job_b);
+	irt_merge(joinable_a);
+	irt_merge(joinable_b);
+	*params->result = a + b;
+}
+
+
+int main(int argc, char **argv) {
+	uint32 wcount = irt_get_default_worker_count();
+	if(argc>=2) wcount = atoi(argv[1]);
+	if(argc>=3) g_fib_n = atoi(argv[2]);
+	if(argc>=4) g_repeats = atoi(argv[3]);
+	irt_runtime_standalone(wcount, &insieme_init_context, &insieme_cleanup_context, &g_insieme_impl_table[0], NULL);
+	return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+
+#include <irt_all_impls.h>
+#include <standalone.h>
+
+#include "utils/impl/topology.impl.h"
+
+namespace {
+
+	void writeFile(const std::string& path, const std::string& content) {
+		// create all parent directories
+		for(size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+			mkdir(path.substr(0, pos).c_str(), 0755);
+		}
+		FILE* file = fopen(path.c_str(), "w");
+		ASSERT_TRUE(file != NULL);
+		fprintf(file, "%s\n", content.c_str());
+		fclose(file);
+	}
+
+	// 8 cpus on 2 sockets / NUMA nodes, each pair of cpus sharing an L3 cache
+	std::string createTopology(bool numa) {
+		char root_template[] = "/tmp/irt_topology_test_XXXXXX";
+		std::string root = mkdtemp(root_template);
+		writeFile(root + "/cpu/possible", "0-7");
+		for(int cpu = 0; cpu < 8; ++cpu) {
+			std::string dir = root + "/cpu/cpu" + std::to_string(cpu);
+			writeFile(dir + "/topology/physical_package_id", std::to_string(cpu / 4));
+			writeFile(dir + "/cache/index0/level", "1");
+			writeFile(dir + "/cache/index0/shared_cpu_list", std::to_string(cpu));
+			writeFile(dir + "/cache/index1/level", "2");
+			writeFile(dir + "/cache/index1/shared_cpu_list", std::to_string(cpu));
+			writeFile(dir + "/cache/index2/level", "3");
+			int first = cpu - cpu % 2;
+			writeFile(dir + "/cache/index2/shared_cpu_list", std::to_string(first) + "-" + std::to_string(first + 1));
+		}
+		if(numa) {
+			writeFile(root + "/node/possible", "0-1");
+			writeFile(root + "/node/node0/cpulist", "0-3");
+			writeFile(root + "/node/node1/cpulist", "4-7");
+		}
+		return root;
+	}
+
+}
+
+TEST(topology, parse_list) {
+	bool flags[IRT_MAX_CORES] = { false };
+	EXPECT_EQ(0, _irt_topology_parse_list("0-3,8,10-11", flags));
+	for(int i = 0; i < 16; ++i) {
+		EXPECT_EQ(i <= 3 || i == 8 || i == 10 || i == 11, flags[i]) << "cpu " << i;
+	}
+	EXPECT_EQ(5, _irt_topology_parse_list("7,5-6", NULL));
+	EXPECT_EQ(-1, _irt_topology_parse_list("", NULL));
+}
+
+TEST(topology, levels) {
+	irt_topology topology;
+	irt_topology_load(&topology, createTopology(true).c_str());
+
+	EXPECT_EQ(8u, topology.num_cpus);
+	EXPECT_EQ(2, topology.cache_group[3]);
+	EXPECT_EQ(1, topology.node[5]);
+
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_CACHE, irt_topology_get_level(&topology, 0, 0));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_CACHE, irt_topology_get_level(&topology, 0, 1));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_CACHE, irt_topology_get_level(&topology, 7, 6));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_NODE, irt_topology_get_level(&topology, 0, 3));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_NODE, irt_topology_get_level(&topology, 4, 7));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_REMOTE, irt_topology_get_level(&topology, 0, 4));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_REMOTE, irt_topology_get_level(&topology, 3, 4));
+
+	// unknown cpus are considered remote
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_REMOTE, irt_topology_get_level(&topology, -1, 0));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_REMOTE, irt_topology_get_level(&topology, 0, 8));
+}
+
+TEST(topology, package_fallback) {
+	// without NUMA information, packages are used as nodes
+	irt_topology topology;
+	irt_topology_load(&topology, createTopology(false).c_str());
+
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_CACHE, irt_topology_get_level(&topology, 2, 3));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_NODE, irt_topology_get_level(&topology, 1, 2));
+	EXPECT_EQ(IRT_TOPOLOGY_LEVEL_REMOTE, irt_topology_get_level(&topology, 1, 6));
+}
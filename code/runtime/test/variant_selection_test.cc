@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <irt_all_impls.h>
+#include <standalone.h>
+
+namespace {
+
+	irt_work_item_range range(int64 size) {
+		irt_work_item_range r = { 0, size, 1 };
+		return r;
+	}
+
+	// executes impl num times, variant v taking ticks[v] clock ticks, returns how often the last variant was selected
+	uint32 simulate(irt_wi_implementation* impl, const uint64* ticks, uint32 num, unsigned int* seed) {
+		irt_work_item_range r = range(100);
+		uint32 last_selected = 0;
+		for(uint32 i = 0; i < num; ++i) {
+			uint32 v = irt_variant_selection_select(impl, &r, seed);
+			EXPECT_LT(v, impl->num_variants);
+			irt_variant_selection_record(&impl->variants[v], &r, ticks[v]);
+			if(v == impl->num_variants - 1) last_selected++;
+		}
+		return last_selected;
+	}
+
+}
+
+TEST(VariantSelection, SizeClasses) {
+	irt_work_item_range r = range(0);
+	EXPECT_EQ(0u, irt_variant_selection_size_class(&r));
+	r = range(1);
+	EXPECT_EQ(0u, irt_variant_selection_size_class(&r));
+	r = range(2);
+	EXPECT_EQ(1u, irt_variant_selection_size_class(&r));
+	r = range(1000);
+	EXPECT_EQ(9u, irt_variant_selection_size_class(&r));
+	r = range(INT64_MAX);
+	EXPECT_EQ(IRT_VARIANT_SELECTION_SIZE_CLASSES - 1u, irt_variant_selection_size_class(&r));
+}
+
+TEST(VariantSelection, ExploreThenExploit) {
+	irt_wi_implementation_variant variants[3];
+	memset(variants, 0, sizeof(variants));
+	irt_wi_implementation impl = { 1, 3, variants };
+	unsigned int seed = 42;
+	const uint64 ticks[] = { 3000, 2000, 1000 };
+
+	// every variant is measured before any of them is exploited
+	simulate(&impl, ticks, 3 * IRT_VARIANT_SELECTION_MIN_SAMPLES, &seed);
+	for(uint32 i = 0; i < 3; ++i) {
+		EXPECT_EQ(IRT_VARIANT_SELECTION_MIN_SAMPLES, variants[i].rt_data.selection_stats[6].num_executions);
+	}
+
+	// afterwards the fastest variant dominates
+	uint32 fastest = simulate(&impl, ticks, 1000, &seed);
+	EXPECT_GT(fastest, 900u);
+	// but the others are still explored occasionally
+	EXPECT_GT(variants[0].rt_data.selection_stats[6].num_executions + variants[1].rt_data.selection_stats[6].num_executions,
+			2u * IRT_VARIANT_SELECTION_MIN_SAMPLES);
+
+	// statistics of other size classes are unaffected
+	irt_work_item_range r = range(1);
+	EXPECT_EQ(0u, variants[0].rt_data.selection_stats[0].num_executions);
+	EXPECT_EQ(0u, irt_variant_selection_select(&impl, &r, &seed));
+}
+
+TEST(VariantSelection, Persistence) {
+	irt_wi_implementation_variant variants[2];
+	memset(variants, 0, sizeof(variants));
+	irt_wi_implementation impl_table[] = { { 0, 2, variants } };
+	irt_context context;
+	memset(&context, 0, sizeof(context));
+	context.impl_table = impl_table;
+	context.impl_table_size = 1;
+	unsigned int seed = 7;
+	const uint64 ticks[] = { 1000, 5000 };
+	simulate(&impl_table[0], ticks, 100, &seed);
+	irt_variant_selection_stats stored[2];
+	stored[0] = variants[0].rt_data.selection_stats[6];
+	stored[1] = variants[1].rt_data.selection_stats[6];
+
+	char filename[] = "variant_selection_test.XXXXXX";
+	int fd = mkstemp(filename);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	EXPECT_TRUE(irt_variant_selection_store(&context, filename));
+
+	// a new run starts out with the stored statistics and exploits right away
+	memset(variants, 0, sizeof(variants));
+	EXPECT_TRUE(irt_variant_selection_load(&context, filename));
+	for(uint32 i = 0; i < 2; ++i) {
+		EXPECT_EQ(stored[i].num_executions, variants[i].rt_data.selection_stats[6].num_executions);
+		EXPECT_EQ(stored[i].total_ticks, variants[i].rt_data.selection_stats[6].total_ticks);
+	}
+	EXPECT_LT(simulate(&impl_table[0], ticks, 100, &seed), 10u);
+
+	// statistics of a different program are rejected
+	memset(variants, 0, sizeof(variants));
+	context.impl_table_size = 2;
+	EXPECT_FALSE(irt_variant_selection_load(&context, filename));
+	EXPECT_EQ(0u, variants[0].rt_data.selection_stats[6].num_executions);
+
+	// even if only the layout of the implementation table differs
+	context.impl_table_size = 1;
+	variants[1].num_required_data_items = 1;
+	EXPECT_FALSE(irt_variant_selection_load(&context, filename));
+	EXPECT_EQ(0u, variants[0].rt_data.selection_stats[6].num_executions);
+	variants[1].num_required_data_items = 0;
+	EXPECT_TRUE(irt_variant_selection_load(&context, filename));
+
+	remove(filename);
+	EXPECT_FALSE(irt_variant_selection_load(&context, filename));
+}
+
+TEST(VariantSelection, SuspendedTimeExcluded) {
+	irt_work_item wi;
+	memset(&wi, 0, sizeof(wi));
+	const uint64 suspended = 10 * 1000 * 1000;
+
+	irt_variant_selection_start(&wi);
+	irt_variant_selection_suspend(&wi);
+	uint64 start = irt_time_ticks();
+	while(irt_time_ticks() - start < suspended) { }
+	irt_variant_selection_resume(&wi);
+	EXPECT_LT(irt_variant_selection_elapsed(&wi), suspended);
+
+	// a work item which is not measured is not affected
+	memset(&wi, 0, sizeof(wi));
+	irt_variant_selection_suspend(&wi);
+	irt_variant_selection_resume(&wi);
+	EXPECT_EQ(0u, wi.variant_start_ticks);
+	EXPECT_EQ(0u, wi.variant_ticks);
+}
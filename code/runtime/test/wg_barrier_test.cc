@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <atomic>
+
+#define MAX_PARA 4
+
+#define ROUNDS 100
+
+#define IRT_LIBRARY_MAIN
+#define IRT_LIBRARY_NO_MAIN_FUN
+#include "irt_library.hxx"
+
+// runs the given number of barrier rounds within a work group of the given size
+// every member checks that all members arrived at a round before any of them passed its barrier
+void checkBarrier(uint32 members, uint32 rounds) {
+	irt::run([members, rounds]() {
+		std::vector<std::atomic<uint32>> arrived(rounds);
+		for(auto& cur : arrived) { cur = 0; }
+		std::atomic<uint32> failures(0);
+
+		irt::merge(irt::parallel(members, [&]() {
+			EXPECT_EQ(members, irt::group_size());
+			for(uint32 r = 0; r < rounds; ++r) {
+				arrived[r]++;
+				irt::barrier();
+				if(arrived[r] != members) { failures++; }
+				// the next round must not have started yet
+				if(r + 1 < rounds && arrived[r + 1] > members) { failures++; }
+			}
+		}));
+
+		EXPECT_EQ(0u, failures.load()) << "Members: " << members;
+		for(uint32 r = 0; r < rounds; ++r) {
+			EXPECT_EQ(members, arrived[r].load()) << "Members: " << members << " / round: " << r;
+		}
+	});
+}
+
+TEST(WorkGroupBarrier, SingleMember) {
+	irt::init(MAX_PARA);
+	checkBarrier(1, ROUNDS);
+	irt::shutdown();
+}
+
+// group sizes up to the number of workers, members may spin
+TEST(WorkGroupBarrier, FewMembers) {
+	irt::init(MAX_PARA);
+	for(uint32 members = 2; members <= MAX_PARA; ++members) {
+		checkBarrier(members, ROUNDS);
+	}
+	irt::shutdown();
+}
+
+// more members than workers, members have to suspend, the sizes cover incomplete groups on several tree levels
+TEST(WorkGroupBarrier, ManyMembers) {
+	irt::init(MAX_PARA);
+	for(uint32 members : { 5u, 7u, 16u, 17u, 33u, 63u, 100u }) {
+		checkBarrier(members, ROUNDS);
+	}
+	irt::shutdown();
+}
+
+// the same work group state has to be reusable by consecutive parallel regions
+TEST(WorkGroupBarrier, RepeatedGroups) {
+	irt::init(MAX_PARA);
+	for(uint32 i = 0; i < 20; ++i) {
+		checkBarrier(3 + (i % 6) * 5, 10);
+	}
+	irt::shutdown();
+}
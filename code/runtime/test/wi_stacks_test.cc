@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include <irt_all_impls.h>
+#include <standalone.h>
+
+namespace {
+
+	const uint64 kib = 1024;
+
+	// touches the given number of bytes below the top of the stack
+	void touch(lwt_reused_stack* stack, uint64 bytes) {
+		memset(_lwt_stack_top(stack) - bytes, 1, bytes);
+	}
+
+	// a dummy work item of the given implementation, suitable for lwt_recycle
+	irt_work_item* dummyWi(irt_wi_implementation* impl, lwt_reused_stack* stack) {
+		irt_work_item* wi = (irt_work_item*)calloc(1, sizeof(irt_work_item));
+		wi->impl = impl;
+		wi->selected_impl_variant = 0;
+		wi->stack_storage = stack;
+		return wi;
+	}
+
+}
+
+TEST(WorkItemStacks, Layout) {
+	lwt_reused_stack* stack = _lwt_get_stack(0, 0, true);
+	EXPECT_EQ(0u, stack->size_class);
+	EXPECT_EQ(0u, (uintptr_t)_lwt_stack_top(stack) % LWT_STACK_ALIGNMENT);
+	EXPECT_EQ(lwt_stack_class_size(0), (uint64)(_lwt_stack_top(stack) - _lwt_stack_body(stack)));
+	// the whole body is usable
+	touch(stack, lwt_stack_class_size(0));
+	// overflows hit the guard page
+	EXPECT_DEATH(touch(stack, lwt_stack_class_size(0) + 1), "");
+	_lwt_stack_destroy(stack);
+}
+
+TEST(WorkItemStacks, MeasureAndTrim) {
+	lwt_reused_stack* stack = _lwt_get_stack(0, 0, true);
+	EXPECT_EQ(0u, _lwt_stack_measure(stack));
+
+	touch(stack, 20 * kib);
+	uint64 resident = _lwt_stack_measure(stack);
+	EXPECT_GE(resident, 20 * kib);
+	EXPECT_LE(resident, 20 * kib + _lwt_page_size());
+
+	_lwt_stack_trim(stack);
+	EXPECT_EQ(0u, _lwt_stack_measure(stack));
+	_lwt_stack_destroy(stack);
+}
+
+TEST(WorkItemStacks, SizeClassSelection) {
+	irt_wi_implementation_variant variant;
+	memset(&variant, 0, sizeof(variant));
+	irt_meta_info_table_entry info;
+	memset(&info, 0, sizeof(info));
+
+	// full size without an annotated bound, regardless of the observed usage
+	EXPECT_EQ(0u, _lwt_stack_select_class(&variant));
+	variant.rt_data.stack_usage = 4 * kib;
+	variant.rt_data.stack_samples = IRT_WI_STACK_SAMPLES;
+	EXPECT_EQ(0u, _lwt_stack_select_class(&variant));
+	variant.meta_info = &info;
+	EXPECT_EQ(0u, _lwt_stack_select_class(&variant));
+
+	// the smallest class covering the bound otherwise
+	info.stack_bound.available = true;
+	info.stack_bound.max_bytes = 4 * kib;
+	EXPECT_EQ(IRT_WI_STACK_CLASSES - 1u, _lwt_stack_select_class(&variant));
+
+	for(uint32 c = 1; c < IRT_WI_STACK_CLASSES; ++c) {
+		info.stack_bound.max_bytes = lwt_stack_class_size(c);
+		EXPECT_EQ(c, _lwt_stack_select_class(&variant));
+		info.stack_bound.max_bytes = lwt_stack_class_size(c) + 1;
+		EXPECT_EQ(c - 1, _lwt_stack_select_class(&variant));
+	}
+
+	// an unknown bound does not restrict the stack
+	info.stack_bound.max_bytes = 0;
+	EXPECT_EQ(0u, _lwt_stack_select_class(&variant));
+}
+
+TEST(WorkItemStacks, RecycleFeedback) {
+	irt_wi_implementation_variant variants[] = { { NULL } };
+	irt_wi_implementation impl = { 1, 1, variants };
+
+	// sampled work items report their stack usage to the implementation variant
+	lwt_reused_stack* stack = _lwt_get_stack(1, 0, true);
+	touch(stack, 40 * kib);
+	irt_work_item* wi = dummyWi(&impl, stack);
+	lwt_recycle(1, wi);
+	EXPECT_TRUE(wi->stack_storage == NULL);
+	EXPECT_EQ(1u, variants[0].rt_data.stack_samples);
+	EXPECT_GE(variants[0].rt_data.stack_usage, 40 * kib);
+	EXPECT_GT(lwt_g_stack_stats.peak_committed, 40 * kib);
+
+	// the committed stack is reused first
+	EXPECT_EQ(stack, _lwt_get_stack(1, 0, false));
+	EXPECT_EQ(stack->resident, _lwt_stack_measure(stack));
+
+	// a sampled work item gets a clean stack
+	wi->stack_storage = stack;
+	lwt_recycle(1, wi);
+	stack = _lwt_get_stack(1, 0, true);
+	EXPECT_EQ(0u, _lwt_stack_measure(stack));
+	wi->stack_storage = stack;
+	lwt_recycle(1, wi);
+
+	free(wi);
+	lwt_cleanup_stacks(1);
+}
+
+TEST(WorkItemStacks, HighWaterTrimming) {
+	irt_wi_implementation_variant variants[] = { { NULL } };
+	irt_wi_implementation impl = { 1, 1, variants };
+	irt_work_item* wi = dummyWi(&impl, NULL);
+
+	const uint32 num = IRT_WI_STACK_POOL_HIGH_WATER + 2;
+	lwt_reused_stack* stacks[num];
+	for(uint32 i = 0; i < num; ++i) {
+		stacks[i] = _lwt_get_stack(2, 0, false);
+		touch(stacks[i], 8 * kib);
+	}
+	for(uint32 i = 0; i < num; ++i) {
+		wi->stack_storage = stacks[i];
+		lwt_recycle(2, wi);
+	}
+
+	// only the first stacks keep their memory committed
+	EXPECT_EQ(IRT_WI_STACK_POOL_HIGH_WATER, lwt_g_stack_reuse.num_stacks[2][0]);
+	for(uint32 i = 0; i < num; ++i) {
+		if(i < IRT_WI_STACK_POOL_HIGH_WATER) {
+			EXPECT_GT(_lwt_stack_measure(stacks[i]), 0u);
+		} else {
+			EXPECT_EQ(0u, _lwt_stack_measure(stacks[i]));
+		}
+	}
+
+	free(wi);
+	lwt_cleanup_stacks(2);
+	EXPECT_TRUE(lwt_g_stack_reuse.stacks[2][0] == NULL);
+	EXPECT_TRUE(lwt_g_stack_reuse.trimmed[2][0] == NULL);
+}
@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2002-2013 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please 
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details 
+ * regarding third party software licenses.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <boost/utility.hpp>
+
+#include "insieme/utils/assert.h"
+
+namespace insieme {
+namespace utils {
+
+	/**
+	 * A bump-pointer allocator handing out memory from a list of large slabs. Individual
+	 * allocations can not be freed. Instead, all slabs are released at once when the arena
+	 * is cleared or destroyed. Objects placed within an arena are not destructed by the
+	 * arena - this remains the responsibility of the owner of those objects.
+	 *
+	 * Synchronized arenas may be used by multiple threads concurrently.
+	 */
+	class Arena : private boost::noncopyable {
+
+		/**
+		 * The size of the slabs requested from the system.
+		 */
+		std::size_t slabSize;
+
+		/**
+		 * The list of slabs currently owned by this arena.
+		 */
+		std::vector<char*> slabs;
+
+		/**
+		 * The next free byte within the current slab and the end of the current slab.
+		 */
+		char* cur;
+		char* end;
+
+		/**
+		 * The number of bytes handed out by this arena and the number of bytes requested
+		 * from the system for its slabs.
+		 */
+		std::size_t allocated;
+		std::size_t reserved;
+
+		/**
+		 * A flag determining whether operations on this arena are synchronized and the
+		 * lock used for the synchronization.
+		 */
+		bool synchronized;
+		std::mutex lock;
+
+		/**
+		 * Obtains a fresh slab of the given size from the system and registers it within
+		 * the list of slabs to be released by this arena.
+		 */
+		char* newSlab(std::size_t size) {
+			char* slab = static_cast<char*>(std::malloc(size));
+			if (!slab) throw std::bad_alloc();
+			slabs.push_back(slab);
+			reserved += size;
+			return slab;
+		}
+
+	public:
+
+		/**
+		 * The default size of slabs (1 MiB).
+		 */
+		static const std::size_t DEFAULT_SLAB_SIZE = 1 << 20;
+
+		/**
+		 * Creates a new, empty arena requesting memory in slabs of the given size.
+		 *
+		 * @param slabSize the size of the slabs to be requested from the system
+		 * @param synchronized if true, the arena may be accessed by multiple threads concurrently
+		 */
+		explicit Arena(std::size_t slabSize = DEFAULT_SLAB_SIZE, bool synchronized = false)
+			: slabSize(slabSize), cur(nullptr), end(nullptr), allocated(0), reserved(0), synchronized(synchronized) {
+			assert_gt(slabSize, 0u) << "Slab size must not be zero!";
+		}
+
+		/**
+		 * Releases all slabs owned by this arena.
+		 */
+		~Arena() {
+			clear();
+		}
+
+		/**
+		 * Obtains a block of the given size with the given alignment from this arena. The block
+		 * remains valid until the arena is cleared or destroyed.
+		 *
+		 * @param size the number of bytes to be allocated
+		 * @param alignment the alignment of the resulting block, has to be a power of 2
+		 * @return a pointer to the allocated block
+		 */
+		void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+			assert_eq(0u, alignment & (alignment - 1)) << "Alignment must be a power of 2!";
+
+			std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+			if (synchronized) guard.lock();
+
+			// large requests get a slab of their own (the current slab is continued afterwards)
+			if (size + alignment > slabSize / 4) {
+				allocated += size;
+				char* slab = newSlab(size + alignment);
+				return slab + (alignment - reinterpret_cast<std::size_t>(slab) % alignment) % alignment;
+			}
+
+			// start a new slab if the request does not fit into the current one
+			std::size_t offset = (alignment - reinterpret_cast<std::size_t>(cur) % alignment) % alignment;
+			if (!cur || offset + size > static_cast<std::size_t>(end - cur)) {
+				cur = newSlab(slabSize);
+				end = cur + slabSize;
+				offset = (alignment - reinterpret_cast<std::size_t>(cur) % alignment) % alignment;
+			}
+
+			// serve request from current slab
+			void* res = cur + offset;
+			cur += offset + size;
+			allocated += size;
+			return res;
+		}
+
+		/**
+		 * Releases all slabs of this arena at once, invalidating all blocks handed out so far.
+		 */
+		void clear() {
+			std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+			if (synchronized) guard.lock();
+
+			for(char* slab : slabs) {
+				std::free(slab);
+			}
+			slabs.clear();
+			cur = nullptr;
+			end = nullptr;
+			allocated = 0;
+			reserved = 0;
+		}
+
+		/**
+		 * Obtains the number of bytes handed out by this arena since it has been cleared the last time.
+		 */
+		std::size_t getAllocatedBytes() const {
+			return allocated;
+		}
+
+		/**
+		 * Obtains the number of bytes this arena has requested from the system.
+		 */
+		std::size_t getReservedBytes() const {
+			return reserved;
+		}
+
+		/**
+		 * Obtains the number of slabs currently owned by this arena.
+		 */
+		std::size_t getNumSlabs() const {
+			return slabs.size();
+		}
+
+	};
+
+} // end namespace utils
+} // end namespace insieme
@@ -138,6 +138,12 @@ namespace compiler {
 
 		string getCommand(const vector<string>& inputFiles, const string& outputFile) const;
 
+		/**
+		 * Obtains a copy of this compiler suitable for linking object files. Language selection
+		 * flags (-x) are dropped since they would cause object files to be treated as sources.
+		 */
+		Compiler getLinker() const;
+
 	};
 		
 	const vector<string> getDefaultCIncludePaths();
@@ -166,6 +172,20 @@ namespace compiler {
 	 */
 	bool compile(const string& sourcefile, const string& targetfile, const Compiler& compiler = Compiler::getDefaultC99Compiler());
 
+	/**
+	 * Compiles the given source files into individual object files using up to the given number of concurrent
+	 * compiler invocations and links the results into the given target file. For each source file, the object
+	 * file is placed next to it. A hash of the source code and the compiler command is stored alongside each
+	 * object file such that unchanged sources are not recompiled by subsequent invocations.
+	 *
+	 * @param sourcefiles the files to be compiled
+	 * @param targetfile the file to be produced
+	 * @param compiler the compiler to be used for the compilation - the default is a C99 compiler
+	 * @param numThreads the maximum number of concurrent compiler invocations - 0 for the number of cores
+	 * @return true if successful, false otherwise
+	 */
+	bool compileParallel(const vector<string>& sourcefiles, const string& targetfile, const Compiler& compiler = Compiler::getDefaultC99Compiler(), unsigned numThreads = 0);
+
 	/**
 	 * Compiles the given source code using the given compiler and temporary source and target files.
 	 *
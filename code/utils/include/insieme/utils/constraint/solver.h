@@ -39,6 +39,8 @@
 #include <set>
 #include <map>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <memory>
 #include <type_traits>
@@ -65,6 +67,43 @@ namespace constraint {
 
 	class LazySolver {
 
+	public:
+
+		/**
+		 * The strategies supported for processing pending updates.
+		 */
+		enum Strategy {
+			Worklist,		// < a LIFO work-list, altered values reset all transitively dependent variables
+			Components		// < strongly connected components are solved in topological order
+		};
+
+		/**
+		 * The statistics collected for an individual variable.
+		 */
+		struct VariableStats {
+			std::size_t updates;		// < the number of updates of constraints defining the variable
+			std::size_t resets;			// < the number of times the variable has been cleared
+			VariableStats() : updates(0), resets(0) {}
+		};
+
+		/**
+		 * The statistics collected by a solver instance.
+		 */
+		struct Stats : public Printable {
+			std::size_t updates;			// < the number of constraint updates
+			std::size_t resets;				// < the number of cleared variables
+			std::size_t passes;				// < the number of component passes (Components strategy only)
+			std::size_t components;			// < the number of non-trivially processed components
+			std::size_t maxComponentSize;	// < the largest component processed so far
+			std::unordered_map<Variable, VariableStats> variables;	// < only collected on request, see setCollectVariableStats
+
+			Stats() : updates(0), resets(0), passes(0), components(0), maxComponentSize(0) {}
+
+			std::ostream& printTo(std::ostream& out) const;
+		};
+
+	private:
+
 		/**
 		 * The source of lazy-generated constraints.
 		 */
@@ -91,15 +130,58 @@ namespace constraint {
 		typedef std::unordered_map<Variable, std::set<const Constraint*>> Edges;
 		Edges edges;
 
+		/**
+		 * The constraints defining the value of each variable (the reverse of the edges).
+		 */
+		Edges producers;
+
 		/**
 		 * A set of fully resolved constraints (all inputs resolved, just for performance)
 		 */
 		std::unordered_set<const Constraint*> resolvedConstraints;
 
+		/**
+		 * The strategy utilized for processing updates.
+		 */
+		Strategy strategy;
+
+		/**
+		 * The statistics collected so far.
+		 */
+		Stats stats;
+
+		/**
+		 * A flag determining whether statistics are also collected per variable.
+		 */
+		bool collectVariableStats;
+
 	public:
 
-		LazySolver(const ConstraintResolver& resolver, const Assignment& initial = Assignment())
-			: resolver(resolver), ass(initial) {}
+		LazySolver(const ConstraintResolver& resolver, const Assignment& initial = Assignment(), Strategy strategy = Worklist)
+			: resolver(resolver), ass(initial), strategy(strategy), collectVariableStats(false) {}
+
+		/**
+		 * Updates the strategy utilized by future solver runs. Previously computed results are preserved.
+		 */
+		void setStrategy(Strategy newStrategy) {
+			strategy = newStrategy;
+		}
+
+		Strategy getStrategy() const {
+			return strategy;
+		}
+
+		/**
+		 * Enables or disables the collection of per-variable statistics for future solver runs.
+		 * It is disabled by default since it adds a hash-map lookup to every update.
+		 */
+		void setCollectVariableStats(bool collect) {
+			collectVariableStats = collect;
+		}
+
+		bool isCollectingVariableStats() const {
+			return collectVariableStats;
+		}
 
 		/**
 		 * Obtains an assignment including the solution of the requested set. This is an incremental
@@ -140,10 +222,27 @@ namespace constraint {
 			return resolved.find(set) != resolved.end();
 		}
 
+		/**
+		 * Obtains the statistics collected by this solver.
+		 */
+		const Stats& getStats() const {
+			return stats;
+		}
+
 	private:
 
 		// -- internal utility functions ---
 
+		void solveWorklist(vector<Variable>& worklist);
+
+		void solveComponents(vector<Variable>& worklist);
+
+		vector<vector<Variable>> getComponents(const vector<Variable>& roots) const;
+
+		void recordUpdate(const Constraint& cur);
+
+		void recordReset(const Variable& var);
+
 		bool hasUnresolvedInput(const Constraint& cur);
 
 		void resolveConstraints(const Constraint& cur, vector<Variable>& worklist);
@@ -161,6 +260,9 @@ namespace constraint {
 	// a lazy solver implementation
 	Assignment solve(const std::set<Variable>& sets, const ConstraintResolver& resolver, Assignment initial = Assignment());
 
+	// a lazy solver implementation using the given strategy
+	Assignment solve(const std::set<Variable>& sets, const ConstraintResolver& resolver, LazySolver::Strategy strategy, Assignment initial = Assignment());
+
 } // end namespace constraint
 } // end namespace utils
 } // end namespace insieme
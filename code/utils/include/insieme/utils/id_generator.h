@@ -36,6 +36,8 @@
 
 #pragma once
 
+#include <atomic>
+
 namespace insieme {
 namespace utils {
 
@@ -88,6 +90,54 @@ namespace utils {
 
 	};
 
+	/**
+	 * A variant of the simple ID generator which may be utilized by multiple threads concurrently.
+	 *
+	 * @tparma T the type of ID to be generated by the instance, has to be supported by std::atomic.
+	 */
+	template<typename T = std::size_t>
+	class AtomicIDGenerator {
+
+		/**
+		 * The last id produced by this generator.
+		 */
+		std::atomic<T> last;
+
+	public:
+
+		/**
+		 * A member type representing the type of value generated by this generator.
+		 */
+		typedef T id_type;
+
+		/**
+		 * A default constructor initializing this ID generator with 0. The first
+		 * ID to be generated will be the 1.
+		 */
+		AtomicIDGenerator() : last(0) {}
+
+		/**
+		 * A default constructor initializing this ID generator with the given value.
+		 * The first ID to be returned will be the init + 1.
+		 */
+		AtomicIDGenerator(id_type init) : last(init) {}
+
+		/**
+		 * Produces the next ID.
+		 */
+		id_type getNext() {
+			return ++last;
+		}
+
+		/**
+		 * Updates the generator to continue with the given value.
+		 */
+		void setNext(id_type value) {
+			last = value - 1;
+		}
+
+	};
+
 
 } // end namespace utils
 } // end namespace insieme
@@ -41,15 +41,19 @@
 #include <functional>
 
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <boost/functional/hash.hpp>
 #include <boost/type_traits/is_base_of.hpp>
 #include <boost/type_traits/is_const.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/utility.hpp>
-#include <boost/iterator/transform_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
 #include "insieme/utils/pointer.h"
+#include "insieme/utils/arena.h"
 #include "insieme/utils/container_utils.h"
 #include "insieme/utils/functional_utils.h"
 #include "insieme/utils/assert.h"
@@ -72,6 +76,14 @@ struct no_post_add_action {
  * Instance managers can be chained to form hierarchies of sharing domains. The derived manager
  * extends the base manager and thereby "inherits" all elements.
  *
+ * Optionally, an instance manager may own an arena from which the clones of its instances are
+ * allocated. In this case, the cloneTo(..) implementation of the managed types has to place new
+ * instances within the arena obtained via getArena(). All instances are then released at once
+ * when the manager is destroyed.
+ *
+ * Concurrent instance managers split their storage into shards protected by individual locks,
+ * such that instances may be added and looked up by multiple threads in parallel.
+ *
  * @tparam T the type of elements managed by the concrete manager instance. The type has to
  * 			 be a constant type.
  */
@@ -89,12 +101,31 @@ class InstanceManager : private boost::noncopyable {
 	typedef std::unordered_set<const T*, hash_target<const T*>, equal_target<const T*>> storage_type;
 
 	/**
-	 * The storage used to maintain instances. It is based on a unordered set which
-	 * is modified to support operations based on pointers. All the elements stored
+	 * The number of shards the storage of a concurrent instance manager is split into.
+	 */
+	enum { CONCURRENT_SHARDS = 64 };
+
+	/**
+	 * A shard of the storage used to maintain instances. It is based on a unordered set
+	 * which is modified to support operations based on pointers. All the elements stored
 	 * within this set will be automatically deleted when this instance manager instance
-	 * is destroyed.
+	 * is destroyed. The lock is only acquired by concurrent managers.
+	 */
+	struct Shard {
+		storage_type storage;
+		mutable std::mutex lock;
+	};
+
+	/**
+	 * The shards of the storage - instances are distributed among them based on their hash.
+	 * Sequential managers only utilize a single shard.
 	 */
-	storage_type storage;
+	std::vector<Shard> shards;
+
+	/**
+	 * A flag determining whether this manager is supporting concurrent accesses.
+	 */
+	bool concurrent;
 
 	/**
 	 * The base manager of this manager, null if not present. This field is realizing
@@ -103,6 +134,12 @@ class InstanceManager : private boost::noncopyable {
 	 */
 	InstanceManager* base;
 
+	/**
+	 * The arena maintaining the storage of the managed instances, null if instances
+	 * are allocated individually on the heap.
+	 */
+	std::unique_ptr<insieme::utils::Arena> arena;
+
 	/**
 	 * A private method used to clone instances to be managed by this type.
 	 *
@@ -120,29 +157,98 @@ class InstanceManager : private boost::noncopyable {
 		return static_cast<const S*>(clone);
 	}
 
+	/**
+	 * Obtains the index of the shard responsible for maintaining the given instance.
+	 */
+	std::size_t getShardIndex(const T* instance) const {
+		if (shards.size() == 1) return 0;
+		std::size_t hash = hash_target<const T*>()(instance);
+		return (hash ^ (hash >> 16)) % shards.size();
+	}
+
+	/**
+	 * Obtains a lock for the given shard which is only acquired if this manager is concurrent.
+	 */
+	std::unique_lock<std::mutex> lockShard(const Shard& shard) const {
+		std::unique_lock<std::mutex> guard(shard.lock, std::defer_lock);
+		if (concurrent) guard.lock();
+		return guard;
+	}
+
+	/**
+	 * Frees an instance which has been cloned but not been added to the storage.
+	 */
+	void dispose(const T* instance) {
+		if (arena) {
+			instance->~T();		// memory will be released with the arena
+		} else {
+			delete instance;
+		}
+	}
+
 public:
 
 	/**
 	 * The default constructor initializing an empty instance manager outside any
 	 * inheritance hierarchy.
 	 */
-	InstanceManager() : base(0) {}
+	InstanceManager() : shards(1), concurrent(false), base(0) {}
+
+	/**
+	 * A constructor creating an empty instance manager outside any inheritance hierarchy
+	 * which is allocating its instances within an arena if requested.
+	 *
+	 * @param useArena if true, instances will be allocated within an arena owned by this manager
+	 * @param concurrent if true, the resulting manager may be accessed by multiple threads concurrently
+	 */
+	explicit InstanceManager(bool useArena, bool concurrent = false)
+		: shards(concurrent ? CONCURRENT_SHARDS : 1), concurrent(concurrent),
+		  base(0), arena(useArena ? new insieme::utils::Arena(insieme::utils::Arena::DEFAULT_SLAB_SIZE, concurrent) : nullptr) {}
 
 	/**
 	 * A constructor creating an instance manager extending the given manager. The life
 	 * cycle of the given manager has to be at least as long as the life cycle of the newly
-	 * constructed manager.
+	 * constructed manager. The new manager is using an arena and supporting concurrent
+	 * accesses if the given manager does.
 	 */
-	explicit InstanceManager(InstanceManager& manager) : base(&manager) {}
+	explicit InstanceManager(InstanceManager& manager)
+		: shards(manager.shards.size()), concurrent(manager.concurrent),
+		  base(&manager), arena(manager.arena ? new insieme::utils::Arena(insieme::utils::Arena::DEFAULT_SLAB_SIZE, manager.concurrent) : nullptr) {}
 
 	/**
 	 * The destructor of this instance manager freeing all elements within the store.
 	 */
 	virtual ~InstanceManager() {
-		// delete all elements maintained by the manager
-		std::for_each(storage.begin(), storage.end(),
-				[](const T* cur) { delete cur; }
-		);
+		for(const Shard& shard : shards) {
+			// if there is an arena, only destruct elements - the memory is released in bulk by the arena
+			if (arena) {
+				std::for_each(shard.storage.begin(), shard.storage.end(),
+						[](const T* cur) { cur->~T(); }
+				);
+				continue;
+			}
+
+			// delete all elements maintained by the manager
+			std::for_each(shard.storage.begin(), shard.storage.end(),
+					[](const T* cur) { delete cur; }
+			);
+		}
+	}
+
+	/**
+	 * Determines whether this manager may be accessed by multiple threads concurrently.
+	 */
+	bool isConcurrent() const {
+		return concurrent;
+	}
+
+	/**
+	 * Obtains a pointer to the arena new instances are supposed to be allocated in.
+	 *
+	 * @return a pointer to the arena of this manager; Null if instances are allocated on the heap
+	 */
+	insieme::utils::Arena* getArena() const {
+		return arena.get();
 	}
 
 	/**
@@ -176,18 +282,29 @@ public:
 			return std::make_pair(R<const S>(dynamic_cast<const S*>(res)), false);
 		}
 
-		// clone element (to ensure private copy)
+		// clone element (to ensure private copy) - no lock is held since cloning may add further elements
 		const S* newElement = clone(instance);
-		__unused auto check = storage.insert(newElement);
 
 		// ensure this is a clone
 		assert_ne(instance, newElement);
 
-		// ensure the element has really been added (hash and equals is properly implemented)
-		assert_true(*check.first == newElement || check.second);
+		const T* present;
+		{
+			Shard& shard = shards[getShardIndex(newElement)];
+			auto guard = lockShard(shard);
+			auto check = shard.storage.insert(newElement);
+			present = *check.first;
 
-		// ensure the element can be found again
-		assert_true(check.first == storage.find(instance)) << "Unable to add clone - value already present!";
+			// ensure the element can be found again
+			assert_true(check.first == shard.storage.find(instance)) << "Unable to add clone - value already present!";
+		}
+
+		// if another thread has added an identical element in the meanwhile, the clone is dropped
+		if (present != newElement) {
+			assert_true(concurrent) << "Element has not been added - hash and equals not properly implemented?";
+			dispose(newElement);
+			return std::make_pair(R<const S>(dynamic_cast<const S*>(present)), false);
+		}
 
 		// apply post-insert action
 		postAddAction(instance, newElement);
@@ -318,8 +435,10 @@ public:
 		}
 
 		// check local storage
-		auto res = storage.find(instance);
-		if (res != storage.end()) {
+		const Shard& shard = shards[getShardIndex(instance)];
+		auto guard = lockShard(shard);
+		auto res = shard.storage.find(instance);
+		if (res != shard.storage.end()) {
 			// found locally
 			return static_cast<const S*>(*res);
 		}
@@ -420,7 +539,13 @@ public:
 	 */
 	template<class S>
 	bool contains(const S* element) const {
-		return element==NULL || storage.find(element) != storage.cend() || (base && base->contains(element));
+		if (element==NULL) return true;
+		{
+			const Shard& shard = shards[getShardIndex(element)];
+			auto guard = lockShard(shard);
+			if (shard.storage.find(element) != shard.storage.cend()) return true;
+		}
+		return base && base->contains(element);
 	}
 
 	/**
@@ -497,8 +622,10 @@ public:
 		}
 
 		// check whether a corresponding element is present
-		auto local = storage.find(&*ptr);
-		if (local == storage.cend()) {
+		const Shard& shard = shards[getShardIndex(&*ptr)];
+		auto guard = lockShard(shard);
+		auto local = shard.storage.find(&*ptr);
+		if (local == shard.storage.cend()) {
 			// not present => not local
 			return false;
 		}
@@ -539,30 +666,64 @@ public:
 	 * @return the total number of elements currently managed
 	 */
 	std::size_t size() const {
-		return storage.size();
+		std::size_t res = 0;
+		for(const Shard& shard : shards) {
+			auto guard = lockShard(shard);
+			res += shard.storage.size();
+		}
+		return res;
 	}
 
 	// --- offer an iterator over all elements within this instance manager ---
 
-private:
-
 	/**
-	 * A functor required for realizing a transforming iterator. This functor
-	 * is simply wrapping a pointer to some internally maintained data element
-	 * into a pointer instances as it is expected to be offered by this instance
-	 * manager.
+	 * The type of constant iterator offered by an instance manager to iterate over
+	 * all contained elements. The iterator is visiting the shards one after another
+	 * and is wrapping pointers to the internally maintained data elements into pointer
+	 * instances as they are expected to be offered by this instance manager.
+	 *
+	 * Iterators are not synchronized - the manager must not be modified while iterating.
 	 */
-	struct PtrWrapper : public std::unary_function<const T*, R<const T>> {
-		R<const T> operator()(const T* ptr) const { return R<const T>(ptr); }
-	};
+	class const_iterator : public boost::iterator_facade<const_iterator, R<const T>, boost::forward_traversal_tag, R<const T>> {
 
-public:
+		friend class boost::iterator_core_access;
 
-	/**
-	 * The type of constant iterator offered by an instance manager to iterate over
-	 * all contained elements.
-	 */
-	typedef boost::transform_iterator<PtrWrapper,typename storage_type::const_iterator> const_iterator;
+		typedef typename std::vector<Shard>::const_iterator shard_iterator;
+
+		shard_iterator shard;
+		shard_iterator shardEnd;
+		typename storage_type::const_iterator cur;
+
+		void skipEmptyShards() {
+			while (shard != shardEnd && cur == shard->storage.end()) {
+				++shard;
+				if (shard != shardEnd) cur = shard->storage.begin();
+			}
+		}
+
+		R<const T> dereference() const {
+			return R<const T>(*cur);
+		}
+
+		bool equal(const const_iterator& other) const {
+			return shard == other.shard && (shard == shardEnd || cur == other.cur);
+		}
+
+		void increment() {
+			++cur;
+			skipEmptyShards();
+		}
+
+	public:
+
+		const_iterator(shard_iterator shard, shard_iterator shardEnd)
+			: shard(shard), shardEnd(shardEnd) {
+			if (shard != shardEnd) {
+				cur = shard->storage.begin();
+				skipEmptyShards();
+			}
+		}
+	};
 
 	/**
 	 * Obtains an iterator referencing the first element maintained by this instance
@@ -574,7 +735,7 @@ public:
 	 * @return a reference to the first element stored internally
 	 */
 	const_iterator begin() const {
-		return boost::make_transform_iterator<PtrWrapper>(storage.begin());
+		return const_iterator(shards.begin(), shards.end());
 	}
 
 	/**
@@ -587,7 +748,7 @@ public:
 	 * @return a reference to the end element referencing the end of the internally stored nodes
 	 */
 	const_iterator end() const {
-		return boost::make_transform_iterator<PtrWrapper>(storage.end());
+		return const_iterator(shards.end(), shards.end());
 	}
 
 };
@@ -0,0 +1,355 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "insieme/utils/assert.h"
+#include "insieme/utils/string_utils.h"
+
+namespace insieme {
+namespace utils {
+
+	/**
+	 * A vector-like container storing up to N elements within an inline buffer. Only if the
+	 * number of elements exceeds N, the elements are moved to the heap. This way, containers
+	 * holding a small number of elements - the common case for many short-lived objects - do
+	 * not cause any dynamic memory allocation.
+	 *
+	 * The container provides the subset of the std::vector interface utilized within this
+	 * code base. Iterators are plain pointers and are invalidated by any modification of the
+	 * container - including moves, since inline elements can not be transferred.
+	 */
+	template<typename T, unsigned N>
+	class SmallVector {
+
+	public:
+
+		typedef T value_type;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T& reference;
+		typedef const T& const_reference;
+		typedef T* pointer;
+		typedef const T* const_pointer;
+		typedef T* iterator;
+		typedef const T* const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	private:
+
+		/**
+		 * The memory providing the inline storage for up to N elements.
+		 */
+		typename std::aligned_storage<sizeof(T) * N, std::alignment_of<T>::value>::type buffer;
+
+		/**
+		 * The begin and end of the stored elements and the end of the current storage.
+		 */
+		T* first;
+		T* last;
+		T* limit;
+
+	public:
+
+		SmallVector() : first(getBuffer()), last(first), limit(first + N) {}
+
+		SmallVector(std::initializer_list<T> list) : first(getBuffer()), last(first), limit(first + N) {
+			append(list.begin(), list.end());
+		}
+
+		template<typename Iter>
+		SmallVector(Iter begin, Iter end) : first(getBuffer()), last(first), limit(first + N) {
+			append(begin, end);
+		}
+
+		SmallVector(const SmallVector& other) : first(getBuffer()), last(first), limit(first + N) {
+			append(other.begin(), other.end());
+		}
+
+		SmallVector(SmallVector&& other) : first(getBuffer()), last(first), limit(first + N) {
+			take(other);
+		}
+
+		~SmallVector() {
+			release();
+		}
+
+		SmallVector& operator=(const SmallVector& other) {
+			if (this == &other) return *this;
+			clear();
+			append(other.begin(), other.end());
+			return *this;
+		}
+
+		SmallVector& operator=(SmallVector&& other) {
+			if (this == &other) return *this;
+			release();
+			first = getBuffer(); last = first; limit = first + N;
+			take(other);
+			return *this;
+		}
+
+		// -- element access --
+
+		reference operator[](size_type i) { assert_lt(i, size()); return first[i]; }
+		const_reference operator[](size_type i) const { assert_lt(i, size()); return first[i]; }
+
+		reference front() { assert_false(empty()); return *first; }
+		const_reference front() const { assert_false(empty()); return *first; }
+
+		reference back() { assert_false(empty()); return *(last - 1); }
+		const_reference back() const { assert_false(empty()); return *(last - 1); }
+
+		pointer data() { return first; }
+		const_pointer data() const { return first; }
+
+		// -- iterators --
+
+		iterator begin() { return first; }
+		iterator end() { return last; }
+		const_iterator begin() const { return first; }
+		const_iterator end() const { return last; }
+		const_iterator cbegin() const { return first; }
+		const_iterator cend() const { return last; }
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+		// -- capacity --
+
+		bool empty() const { return first == last; }
+		size_type size() const { return last - first; }
+		size_type capacity() const { return limit - first; }
+
+		/**
+		 * Determines whether the elements are currently stored within the inline buffer.
+		 */
+		bool isInline() const { return first == getBuffer(); }
+
+		void reserve(size_type n) {
+			if (n > capacity()) grow(n);
+		}
+
+		// -- modifiers --
+
+		void clear() {
+			destroy(first, last);
+			last = first;
+		}
+
+		void push_back(const T& value) {
+			if (last == limit) {
+				// the value may be an element of this container
+				T copy(value);
+				grow(size() + 1);
+				new (last) T(std::move(copy));
+			} else {
+				new (last) T(value);
+			}
+			++last;
+		}
+
+		void push_back(T&& value) {
+			if (last == limit) {
+				T tmp(std::move(value));
+				grow(size() + 1);
+				new (last) T(std::move(tmp));
+			} else {
+				new (last) T(std::move(value));
+			}
+			++last;
+		}
+
+		template<typename ... Args>
+		void emplace_back(Args&& ... args) {
+			push_back(T(std::forward<Args>(args)...));
+		}
+
+		void pop_back() {
+			assert_false(empty());
+			--last;
+			last->~T();
+		}
+
+		iterator insert(const_iterator pos, const T& value) {
+			size_type index = pos - first;
+			push_back(value);
+			std::rotate(first + index, last - 1, last);
+			return first + index;
+		}
+
+		template<typename Iter>
+		void insert(const_iterator pos, Iter begin, Iter end) {
+			size_type index = pos - first;
+			size_type old = size();
+			append(begin, end);
+			std::rotate(first + index, first + old, last);
+		}
+
+		iterator erase(const_iterator pos) {
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator from, const_iterator to) {
+			iterator a = first + (from - first);
+			iterator b = first + (to - first);
+			iterator newLast = std::move(b, last, a);
+			destroy(newLast, last);
+			last = newLast;
+			return a;
+		}
+
+		void resize(size_type n) {
+			if (n < size()) {
+				erase(first + n, last);
+				return;
+			}
+			reserve(n);
+			while(size() < n) {
+				new (last) T();
+				++last;
+			}
+		}
+
+		void swap(SmallVector& other) {
+			SmallVector tmp(std::move(other));
+			other = std::move(*this);
+			*this = std::move(tmp);
+		}
+
+		// -- comparison --
+
+		bool operator==(const SmallVector& other) const {
+			return size() == other.size() && std::equal(begin(), end(), other.begin());
+		}
+
+		bool operator!=(const SmallVector& other) const {
+			return !(*this == other);
+		}
+
+		bool operator<(const SmallVector& other) const {
+			return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+		}
+
+	private:
+
+		T* getBuffer() {
+			return reinterpret_cast<T*>(&buffer);
+		}
+
+		const T* getBuffer() const {
+			return reinterpret_cast<const T*>(&buffer);
+		}
+
+		static void destroy(T* from, T* to) {
+			for(T* cur = from; cur != to; ++cur) {
+				cur->~T();
+			}
+		}
+
+		template<typename Iter>
+		void append(Iter begin, Iter end) {
+			for(; begin != end; ++begin) {
+				push_back(*begin);
+			}
+		}
+
+		/**
+		 * Moves the elements of the given container into this empty container.
+		 */
+		void take(SmallVector& other) {
+			if (!other.isInline()) {
+				// steal heap storage
+				first = other.first; last = other.last; limit = other.limit;
+				other.first = other.getBuffer(); other.last = other.first; other.limit = other.first + N;
+				return;
+			}
+			for(T* cur = other.first; cur != other.last; ++cur) {
+				new (last) T(std::move(*cur));
+				++last;
+			}
+			other.clear();
+		}
+
+		/**
+		 * Destroys all elements and frees the heap storage, if any.
+		 */
+		void release() {
+			destroy(first, last);
+			if (!isInline()) {
+				::operator delete(first);
+			}
+		}
+
+		/**
+		 * Moves the elements to a heap-allocated storage of at least the given capacity.
+		 */
+		void grow(size_type n) {
+			size_type newCapacity = std::max<size_type>(n, 2 * capacity());
+			T* storage = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+			T* pos = storage;
+			for(T* cur = first; cur != last; ++cur, ++pos) {
+				new (pos) T(std::move(*cur));
+			}
+			release();
+			first = storage;
+			last = pos;
+			limit = storage + newCapacity;
+		}
+	};
+
+	/**
+	 * Allows to print small vectors including printable elements.
+	 */
+	template<typename T, unsigned N>
+	std::ostream& operator<<(std::ostream& out, const SmallVector<T,N>& list) {
+		return out << "[" << join(",", list) << "]";
+	}
+
+} // end namespace utils
+} // end namespace insieme
@@ -36,6 +36,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include "insieme/utils/string_utils.h"
 
@@ -59,3 +60,8 @@ bool notContainsSubString(const string& str, const string& substr);
  * @param n the times
  */
 bool containsNTimesSubString(const string& str, const string& substr, const int n);
+
+/**
+ * Obtains the resident set size of this process in bytes.
+ */
+std::size_t getResidentSetSize();
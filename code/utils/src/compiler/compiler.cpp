@@ -39,6 +39,8 @@
 #include <cstdio>
 #include <sstream>
 #include <fstream>
+#include <atomic>
+#include <thread>
 
 #include <boost/filesystem.hpp>
 
@@ -136,6 +138,17 @@ namespace compiler {
 		return cmd.str();
 	}
 
+	Compiler Compiler::getLinker() const {
+		Compiler res = *this;
+		res.flags.clear();
+		for(auto cur : flags) {
+			if (!(cur[0] == '-' && cur[1] == 'x')) {
+				res.flags.push_back(cur);
+			}
+		}
+		return res;
+	}
+
 	const vector<string> getDefaultIncludePaths(string cmd) {
 		vector<string> paths;
 		char line[256];
@@ -207,6 +220,83 @@ namespace compiler {
 		return compile(files, targetfile, compiler);
 	}
 
+	namespace {
+
+		string readFile(const string& file) {
+			std::ifstream in(file);
+			std::stringstream content;
+			content << in.rdbuf();
+			return content.str();
+		}
+
+		/**
+		 * Compiles the given source file to the given object file unless the hash recorded for the
+		 * object file shows that neither the source code nor the compiler command has changed.
+		 */
+		bool compileObject(const string& sourcefile, const string& objectfile, const Compiler& compiler) {
+			string cmd = compiler.getCommand(toVector(sourcefile), objectfile);
+			string hash = toString(std::hash<string>()(cmd + "\n" + readFile(sourcefile)));
+
+			// check whether the existing object file is still up to date
+			string hashfile = objectfile + ".hash";
+			if (fs::exists(objectfile) && fs::exists(hashfile) && readFile(hashfile) == hash) {
+				LOG(INFO) << "Skipping unchanged " << sourcefile << std::endl;
+				return true;
+			}
+
+			LOG(INFO) << "Compiling with: " << cmd << std::endl;
+			int res = system(cmd.c_str());
+			if (res) {
+				std::cerr << "Failure with exit status " << res << std::endl;
+				if (fs::exists(hashfile)) fs::remove(hashfile);
+				return false;
+			}
+
+			// record hash of the compiled version
+			std::ofstream out(hashfile);
+			out << hash;
+			return true;
+		}
+
+	}
+
+	bool compileParallel(const vector<string>& sourcefiles, const string& targetfile, const Compiler& compiler, unsigned numThreads) {
+
+		// compile all sources to object files
+		Compiler objCompiler = compiler;
+		objCompiler.addFlag("-c");
+
+		vector<string> objectfiles;
+		for(const auto& cur : sourcefiles) {
+			objectfiles.push_back(cur + ".o");
+		}
+
+		if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+		numThreads = std::min<unsigned>(numThreads, sourcefiles.size());
+
+		std::atomic<std::size_t> next(0);
+		std::atomic<bool> success(true);
+		auto worker = [&]() {
+			for(std::size_t i = next++; i < sourcefiles.size(); i = next++) {
+				if (!compileObject(sourcefiles[i], objectfiles[i], objCompiler)) success = false;
+			}
+		};
+
+		vector<std::thread> threads;
+		for(unsigned i=1; i<numThreads; i++) {
+			threads.push_back(std::thread(worker));
+		}
+		worker();
+		for(auto& cur : threads) {
+			cur.join();
+		}
+
+		if (!success) return false;
+
+		// link the resulting object files
+		return compile(objectfiles, targetfile, compiler.getLinker());
+	}
+
 
 	bool compile(const VirtualPrintable& source, const Compiler& compiler) {
 		string target = compileToBinary(source, compiler);
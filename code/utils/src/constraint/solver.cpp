@@ -38,6 +38,8 @@
 
 #include "insieme/utils/assert.h"
 
+#include <algorithm>
+#include <deque>
 #include <utility>
 #include <unordered_set>
 #include <vector>
@@ -178,6 +180,25 @@ namespace constraint {
 		resolveConstraints(std::vector<Variable>(sets.begin(), sets.end()), worklist);
 
 		// 2. solve constraints
+		if (strategy == Components) {
+			solveComponents(worklist);
+		} else {
+			solveWorklist(worklist);
+		}
+
+		// check all constraints (only for debugging, not valid if resets are involved)
+//		assert_true(all(constraints, [&](const ConstraintPtr& cur)->bool {
+//			auto res = cur->check(ass);
+//			if (!res) std::cout << "Constraint " << *cur << " violated!\n";
+//			return res;
+//		}));
+
+		// return assignment - TODO: find way to project to requested values
+		return ass;
+	}
+
+	void LazySolver::solveWorklist(vector<Variable>& worklist) {
+
 		while(!worklist.empty()) {
 
 			// retrieve first element
@@ -200,6 +221,7 @@ namespace constraint {
 
 				// trigger update
 				auto change = cc.update(ass);
+				recordUpdate(cc);
 
 				// register outputs in work-list
 				if (change != Constraint::Unchanged) {
@@ -222,21 +244,301 @@ namespace constraint {
 
 					// clear all dependent sets and re-schedule them
 					for(auto cur : dependent) {
-						if (!contains(outputs, cur)) ass.clear(cur);		// do not reset value causing this operation
+						if (!contains(outputs, cur)) {		// do not reset value causing this operation
+							ass.clear(cur);
+							recordReset(cur);
+						}
 					}
 				}
 			}
 		}
+	}
 
-		// check all constraints (only for debugging, not valid if resets are involved)
-//		assert_true(all(constraints, [&](const ConstraintPtr& cur)->bool {
-//			auto res = cur->check(ass);
-//			if (!res) std::cout << "Constraint " << *cur << " violated!\n";
-//			return res;
-//		}));
+	void LazySolver::solveComponents(vector<Variable>& worklist) {
 
-		// return assignment - TODO: find way to project to requested values
-		return ass;
+		static const std::set<const Constraint*> none;
+
+		auto lookup = [](const Edges& edges, const Variable& var)->const std::set<const Constraint*>& {
+			auto pos = edges.find(var);
+			return (pos == edges.end()) ? none : pos->second;
+		};
+
+		// the variables whose consumers need to be updated
+		std::unordered_set<Variable> dirty(worklist.begin(), worklist.end());
+		worklist.clear();
+
+		// the variables derived from altered values, they are reset when their component is processed
+		std::unordered_set<Variable> stale;
+
+		while(!dirty.empty() || !stale.empty()) {
+
+			stats.passes++;
+
+			// compute the components of the affected part of the constraint graph in topological order
+			vector<Variable> roots(dirty.begin(), dirty.end());
+			roots.insert(roots.end(), stale.begin(), stale.end());
+			vector<vector<Variable>> components = getComponents(roots);
+
+			std::unordered_map<Variable, std::size_t> componentOf;
+			for(std::size_t i = 0; i < components.size(); ++i) {
+				for(const auto& cur : components[i]) {
+					componentOf[cur] = i;
+				}
+			}
+
+			// solve one component after the other
+			for(std::size_t i = 0; i < components.size(); ++i) {
+				const vector<Variable>& component = components[i];
+
+				auto inComponent = [&](const Variable& var) {
+					auto pos = componentOf.find(var);
+					return pos != componentOf.end() && pos->second == i;
+				};
+
+				// the de-duplicated work-list of constraints to be updated
+				std::deque<const Constraint*> queue;
+				std::unordered_set<const Constraint*> queued;
+
+				auto enqueue = [&](const std::set<const Constraint*>& list) {
+					for(const Constraint* cur : list) {
+						if (queued.insert(cur).second) queue.push_back(cur);
+					}
+				};
+
+				// constraints leaving the component are only updated once the local fixpoint is reached
+				std::set<const Constraint*> deferred;
+
+				auto enqueueConsumers = [&](const Variable& var) {
+					for(const Constraint* cur : lookup(edges, var)) {
+						if (any(cur->getOutputs(), inComponent)) {
+							if (queued.insert(cur).second) queue.push_back(cur);
+						} else {
+							deferred.insert(cur);
+						}
+					}
+				};
+
+				// registers a change of the given variable
+				auto changed = [&](const Variable& var) {
+					if (inComponent(var)) {
+						enqueueConsumers(var);
+					} else {
+						dirty.insert(var);
+					}
+				};
+
+				// clears all variables of this component depending on the given roots, except those to be kept
+				auto reset = [&](const vector<Variable>& roots, const vector<Variable>& keep) {
+					std::unordered_set<Variable> seen(roots.begin(), roots.end());
+					vector<Variable> list = roots;
+					while(!list.empty()) {
+						Variable cur = list.back();
+						list.pop_back();
+
+						if (!contains(keep, cur)) {
+							ass.clear(cur);
+							recordReset(cur);
+							enqueue(lookup(producers, cur));
+						}
+
+						// consumers are re-evaluated once the variable is recomputed, their outputs are reset
+						for(const Constraint* con : lookup(edges, cur)) {
+							for(const auto& out : con->getOutputs()) {
+								if (!inComponent(out)) {
+									// the reset is continued once the other component is processed
+									stale.insert(out);
+								} else if (seen.insert(out).second) {
+									list.push_back(out);
+								}
+							}
+						}
+					}
+				};
+
+				// seed the work-list
+				vector<Variable> staleRoots;
+				for(const auto& cur : component) {
+					if (stale.erase(cur)) staleRoots.push_back(cur);
+					if (dirty.erase(cur)) enqueueConsumers(cur);
+				}
+				if (!staleRoots.empty()) reset(staleRoots, vector<Variable>());
+
+				if (queue.empty() && deferred.empty()) continue;
+
+				stats.components++;
+				stats.maxComponentSize = std::max(stats.maxComponentSize, component.size());
+
+				// iterate until the local fixpoint is reached
+				while(!queue.empty()) {
+					const Constraint& cc = *queue.front();
+					queue.pop_front();
+					queued.erase(&cc);
+
+					// update dynamic dependencies if necessary
+					if (cc.hasDynamicDependencies() && cc.updateDynamicDependencies(ass)) {
+						for(const auto& cur : cc.getUsedInputs(ass)) {
+							edges[cur].insert(&cc);
+						}
+					}
+
+					// add and resolve list of used filters
+					resolveConstraints(cc, worklist);
+					for(const auto& cur : worklist) {
+						changed(cur);
+					}
+					worklist.clear();
+
+					// trigger update
+					auto change = cc.update(ass);
+					recordUpdate(cc);
+
+					if (change != Constraint::Unchanged) {
+						for(const auto& cur : cc.getOutputs()) {
+							changed(cur);
+						}
+					}
+
+					// if the output value has been altered, the values derived from it are reset
+					if (change == Constraint::Altered) {
+						reset(cc.getOutputs(), cc.getOutputs());
+					}
+				}
+
+				// propagate the values of this component to its successors
+				for(const Constraint* cur : deferred) {
+					const Constraint& cc = *cur;
+
+					// skip constraints whose outputs will be reset and recomputed anyway
+					if (all(cc.getOutputs(), [&](const Variable& out) { return stale.find(out) != stale.end(); })) continue;
+
+					if (cc.hasDynamicDependencies() && cc.updateDynamicDependencies(ass)) {
+						for(const auto& in : cc.getUsedInputs(ass)) {
+							edges[in].insert(&cc);
+						}
+					}
+
+					resolveConstraints(cc, worklist);
+					dirty.insert(worklist.begin(), worklist.end());
+					worklist.clear();
+
+					auto change = cc.update(ass);
+					recordUpdate(cc);
+
+					if (change != Constraint::Unchanged) {
+						dirty.insert(cc.getOutputs().begin(), cc.getOutputs().end());
+					}
+					if (change == Constraint::Altered) {
+						reset(cc.getOutputs(), cc.getOutputs());
+					}
+				}
+			}
+		}
+	}
+
+	vector<vector<Variable>> LazySolver::getComponents(const vector<Variable>& roots) const {
+
+		// an iterative version of Tarjan's algorithm, constraints define edges from their inputs to their outputs
+		struct Frame {
+			Variable var;
+			vector<Variable> succ;
+			std::size_t next;
+		};
+
+		std::unordered_map<Variable, pair<std::size_t,std::size_t>> index;		// the index and low-link of each variable
+		std::unordered_set<Variable> onStack;
+		vector<Variable> stack;
+		vector<Frame> calls;
+		std::size_t counter = 0;
+
+		vector<vector<Variable>> res;
+
+		auto visit = [&](const Variable& var) {
+			index[var] = std::make_pair(counter, counter);
+			counter++;
+			stack.push_back(var);
+			onStack.insert(var);
+
+			Frame frame { var, vector<Variable>(), 0 };
+			auto pos = edges.find(var);
+			if (pos != edges.end()) {
+				for(const Constraint* cur : pos->second) {
+					for(const auto& out : cur->getOutputs()) {
+						frame.succ.push_back(out);
+					}
+				}
+			}
+			calls.push_back(frame);
+		};
+
+		for(const auto& root : roots) {
+			if (index.find(root) != index.end()) continue;
+
+			visit(root);
+			while(!calls.empty()) {
+				Frame& cur = calls.back();
+
+				// process the next successor
+				if (cur.next < cur.succ.size()) {
+					Variable succ = cur.succ[cur.next++];
+					auto pos = index.find(succ);
+					if (pos == index.end()) {
+						visit(succ);
+					} else if (onStack.find(succ) != onStack.end()) {
+						auto& low = index[cur.var].second;
+						low = std::min(low, pos->second.first);
+					}
+					continue;
+				}
+
+				// all successors are done
+				Variable var = cur.var;
+				calls.pop_back();
+
+				auto entry = index[var];
+				if (entry.first == entry.second) {
+					vector<Variable> component;
+					Variable member;
+					do {
+						member = stack.back();
+						stack.pop_back();
+						onStack.erase(member);
+						component.push_back(member);
+					} while(member != var);
+					res.push_back(component);
+				}
+
+				if (!calls.empty()) {
+					auto& low = index[calls.back().var].second;
+					low = std::min(low, entry.second);
+				}
+			}
+		}
+
+		// Tarjan's algorithm enumerates components in reverse topological order
+		std::reverse(res.begin(), res.end());
+		return res;
+	}
+
+	void LazySolver::recordUpdate(const Constraint& cur) {
+		stats.updates++;
+		if (!collectVariableStats) return;
+		for(const auto& out : cur.getOutputs()) {
+			stats.variables[out].updates++;
+		}
+	}
+
+	void LazySolver::recordReset(const Variable& var) {
+		stats.resets++;
+		if (!collectVariableStats) return;
+		stats.variables[var].resets++;
+	}
+
+	std::ostream& LazySolver::Stats::printTo(std::ostream& out) const {
+		return out << "updates: " << updates
+				<< ", resets: " << resets
+				<< ", passes: " << passes
+				<< ", components: " << components
+				<< ", max component size: " << maxComponentSize;
 	}
 
 
@@ -302,6 +604,11 @@ namespace constraint {
 				edges[set].insert(&*cur);
 			}
 
+			// record the constraints defining each variable
+			for (auto out : cur->getOutputs()) {
+				producers[out].insert(&*cur);
+			}
+
 			// collect missing inputs
 			if (cur->hasAssignmentDependentDependencies()) {
 				// update dynamic dependencies if required
@@ -343,6 +650,10 @@ namespace constraint {
 		return LazySolver(resolver, initial).solve(sets);
 	}
 
+	Assignment solve(const std::set<Variable>& sets, const ConstraintResolver& resolver, LazySolver::Strategy strategy, Assignment initial) {
+		return LazySolver(resolver, initial, strategy).solve(sets);
+	}
+
 
 } // end namespace constraint
 } // end namespace utils
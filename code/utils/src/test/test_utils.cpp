@@ -36,6 +36,9 @@
 
 #include "insieme/utils/test/test_utils.h"
 
+#include <fstream>
+#include <unistd.h>
+
 // a small test verifying that the given substr is contained within the given string
 bool notContainsSubString(const string& str, const string& substr) {
 	return !containsSubString(str, substr);
@@ -49,3 +52,10 @@ bool containsNTimesSubString(const string& str, const string& substr, const int
 	}
 	return (count == n);
 }
+
+std::size_t getResidentSetSize() {
+	std::size_t size = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	statm >> size >> resident;
+	return resident * sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2002-2013 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please 
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details 
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+
+#include "insieme/utils/arena.h"
+
+namespace insieme {
+namespace utils {
+
+	TEST(Arena, Basic) {
+
+		Arena arena(1024);
+		EXPECT_EQ(0u, arena.getNumSlabs());
+		EXPECT_EQ(0u, arena.getAllocatedBytes());
+
+		// small allocations are served from a single slab
+		int* a = static_cast<int*>(arena.allocate(sizeof(int)));
+		int* b = static_cast<int*>(arena.allocate(sizeof(int)));
+		*a = 1; *b = 2;
+		EXPECT_NE(a, b);
+		EXPECT_EQ(1, *a);
+		EXPECT_EQ(2, *b);
+		EXPECT_EQ(1u, arena.getNumSlabs());
+		EXPECT_EQ(2*sizeof(int), arena.getAllocatedBytes());
+		EXPECT_EQ(1024u, arena.getReservedBytes());
+
+		// all slabs are released at once
+		arena.clear();
+		EXPECT_EQ(0u, arena.getNumSlabs());
+		EXPECT_EQ(0u, arena.getAllocatedBytes());
+		EXPECT_EQ(0u, arena.getReservedBytes());
+	}
+
+	TEST(Arena, Alignment) {
+
+		Arena arena(1024);
+		arena.allocate(1);
+		for (std::size_t alignment : { 1, 2, 4, 8, 16, 64 }) {
+			void* ptr = arena.allocate(3, alignment);
+			EXPECT_EQ(0u, reinterpret_cast<std::size_t>(ptr) % alignment) << "Alignment: " << alignment;
+		}
+	}
+
+	TEST(Arena, SlabOverflow) {
+
+		Arena arena(1024);
+
+		// fill more than one slab
+		for (int i=0; i<100; i++) {
+			arena.allocate(64);
+		}
+		EXPECT_LT(1u, arena.getNumSlabs());
+		EXPECT_EQ(100*64u, arena.getAllocatedBytes());
+
+		// large blocks are obtaining their own slab
+		std::size_t slabs = arena.getNumSlabs();
+		char* block = static_cast<char*>(arena.allocate(4096));
+		block[0] = block[4095] = 'x';
+		EXPECT_EQ(slabs + 1, arena.getNumSlabs());
+
+		// the current slab is continued afterwards
+		arena.allocate(8);
+		EXPECT_EQ(slabs + 1, arena.getNumSlabs());
+	}
+
+} // end namespace utils
+} // end namespace insieme
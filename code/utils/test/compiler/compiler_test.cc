@@ -108,6 +108,54 @@ TEST(TargetCodeCompilerTest, DirectHelloWorldTest) {
 
 }
 
+TEST(TargetCodeCompilerTest, ParallelCompilation) {
+
+	namespace fs = boost::filesystem;
+
+	// create a few dummy code files to be compiled
+	fs::path dir = "./";
+	fs::path srcA = dir / "_ut_parallel_a.c";
+	fs::path srcB = dir / "_ut_parallel_b.c";
+	fs::path binFile = dir / "_ut_parallel";
+
+	fs::ofstream code;
+	code.open(srcA);
+	code << "int f();\n";
+	code << "int main() { return f() - 12; }\n";
+	code.close();
+
+	code.open(srcB);
+	code << "int f() { return 12; }\n";
+	code.close();
+
+	vector<string> sources = toVector(srcA.string(), srcB.string());
+
+	// compile and link
+	EXPECT_TRUE(compileParallel(sources, binFile.string(), Compiler::getDefaultC99Compiler(), 2));
+	EXPECT_TRUE(fs::exists(binFile));
+	EXPECT_EQ(0, system(binFile.string().c_str()));
+
+	// the second run should be skipping the unchanged files
+	auto time = fs::last_write_time(srcB.string() + ".o");
+	EXPECT_TRUE(compileParallel(sources, binFile.string(), Compiler::getDefaultC99Compiler(), 2));
+	EXPECT_EQ(time, fs::last_write_time(srcB.string() + ".o"));
+
+	// modified sources need to be re-compiled
+	code.open(srcB);
+	code << "int f() { return 14; }\n";
+	code.close();
+	EXPECT_TRUE(compileParallel(sources, binFile.string(), Compiler::getDefaultC99Compiler(), 2));
+	EXPECT_NE(0, system(binFile.string().c_str()));
+
+	// delete all files
+	for(const auto& cur : sources) {
+		fs::remove(cur);
+		fs::remove(cur + ".o");
+		fs::remove(cur + ".o.hash");
+	}
+	fs::remove(binFile);
+}
+
 TEST(TargetCodeCompiler, GetIncludePaths) {
 	EXPECT_FALSE(getDefaultCIncludePaths().empty());
 	EXPECT_FALSE(getDefaultCIncludePaths().empty());
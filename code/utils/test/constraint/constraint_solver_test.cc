@@ -546,6 +546,110 @@ namespace constraint {
 
 	}
 
+	TEST(Solver, ComponentsLazy) {
+
+		auto resolver = [](const std::set<Variable>& sets)->Constraints {
+			Constraints res;
+			for(auto cur : sets) {
+				int id = cur.getID();
+				if (id == 0) {
+					res.add(elem(0, TypedSetVariable<int>(id)));
+				} else if (id == 1 || id == 2) {
+					res.add(elem(1, TypedSetVariable<int>(id)));
+				} else {
+					TypedSetVariable<int> a(id-1);
+					TypedSetVariable<int> b(id-2);
+					TypedSetVariable<int> r(id);
+					res.add(subsetBinary(a, b, r, [](const std::set<int>& a, const std::set<int>& b)->std::set<int> {
+						std::set<int> res;
+						for( int x : a) for (int y : b) res.insert(x+y);
+						return res;
+					}));
+				}
+			}
+			return res;
+		};
+
+		std::set<Variable> sets;
+		sets.insert(TypedSetVariable<int>(46));
+
+		LazySolver solver(resolver, Assignment(), LazySolver::Components);
+		auto res = solver.solve(sets);
+		EXPECT_EQ("{1836311903}", toString(res[TypedSetVariable<int>(46)]));
+
+		// the dependency graph is acyclic, every variable forms its own component
+		EXPECT_EQ(1u, solver.getStats().maxComponentSize) << solver.getStats();
+		EXPECT_EQ(0u, solver.getStats().resets) << solver.getStats();
+
+		// per-variable statistics are only collected on request
+		EXPECT_LT(0u, solver.getStats().updates);
+		EXPECT_TRUE(solver.getStats().variables.empty());
+	}
+
+	TEST(Solver, ComponentsResetConstraints) {
+
+		auto s = [](int id) { return TypedSetVariable<int>(id); };
+
+		auto resolver = [&](const std::set<Variable>& sets)->Constraints {
+			Constraints res;
+			for(auto cur : sets) {
+				int id = cur.getID();
+				if (id == 1) {
+					res.add(increment(s(3),s(1)));
+				} else if (id == 2) {
+					res.add(subset(s(1),s(2)));
+				} else if (id == 3) {
+					res.add(subset(s(2),s(3)));
+				} else if (id == 4) {
+					res.add(subset(s(3),s(4)));
+				}
+			}
+			return res;
+		};
+
+		std::set<Variable> sets;
+		sets.insert(s(4));
+
+		LazySolver solver(resolver, Assignment(), LazySolver::Components);
+		solver.setCollectVariableStats(true);
+		auto res = solver.solve(sets);
+		EXPECT_EQ("{v1={10},v2={10},v3={10},v4={10}}", toString(res));
+
+		// resets are confined to the cycle, v4 is only updated once the cycle is stable
+		const auto& stats = solver.getStats();
+		EXPECT_EQ(3u, stats.maxComponentSize) << stats;
+		EXPECT_LT(0u, stats.resets) << stats;
+		EXPECT_GE(1u, stats.variables.find(s(4))->second.resets) << stats;
+		EXPECT_EQ(1u, stats.variables.find(s(4))->second.updates) << stats;
+	}
+
+	TEST(Solver, ComponentsDynamicDependencies) {
+
+		auto s = [](int id) { return TypedSetVariable<int>(id); };
+		auto m = [](int id) { return TypedSetVariable<TypedSetVariable<int>>(id); };
+
+		ConstraintMap map;
+
+		map[s(1)] = toVector(elem(1, s(1)), elem( 2, s(1)));
+		map[s(2)] = toVector(elem(4, s(2)), elem( 6, s(2)));
+		map[s(3)] = toVector(elem(8, s(3)));
+		map[s(4)] = toVector(elem(10, s(4)));
+		map[s(5)] = toVector(collect  (m(10), s(5)));
+
+		map[m(10)] = toVector(
+				elem(s(1), m(10)),
+				elemIf(2, s(5), s(2), m(10)),
+				elemIf(4, s(5), s(3), m(10))
+		);
+
+		std::set<Variable> sets;
+		sets.insert(s(5));
+
+		auto res = solve(sets, MapResolver(map), LazySolver::Components);
+		EXPECT_EQ("{v10={v1,v2,v3},v1={1,2},v2={4,6},v3={8},v5={1,2,4,6,8}}", toString(res));
+	}
+
+
 
 } // end namespace set_constraint
 } // end namespace utils
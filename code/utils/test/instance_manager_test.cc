@@ -36,6 +36,7 @@
 
 #include <string>
 #include <iostream>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -54,6 +55,7 @@ struct CloneableStringManager : public InstanceManager<CloneableString> {
 
 	CloneableStringManager() {}
 	CloneableStringManager(CloneableStringManager& manager) : InstanceManager<CloneableString>(manager) {}
+	CloneableStringManager(bool concurrent) : InstanceManager<CloneableString>(false, concurrent) {}
 
 };
 
@@ -372,3 +374,41 @@ TEST(InstanceManager, Chaining) {
 
 }
 
+TEST(InstanceManager, Concurrent) {
+
+	CloneableStringManager manager(true);
+	EXPECT_TRUE(manager.isConcurrent());
+
+	CloneableStringManager child(manager);
+	EXPECT_TRUE(child.isConcurrent());
+
+	// let multiple threads add overlapping sets of elements
+	const int N = 1000;
+	const int T = 4;
+	vector<vector<MyPtr>> results(T);
+	vector<std::thread> threads;
+	for (int t=0; t<T; t++) {
+		threads.push_back(std::thread([&, t]() {
+			for (int i=0; i<N; i++) {
+				results[t].push_back(manager.get(CloneableString(toString(i))));
+			}
+		}));
+	}
+	for (auto& cur : threads) {
+		cur.join();
+	}
+
+	// all threads should have obtained the same instances
+	EXPECT_EQ(static_cast<std::size_t>(N), manager.size());
+	for (int t=1; t<T; t++) {
+		EXPECT_EQ(results[0], results[t]);
+	}
+
+	// iterating over the sharded storage should visit every element once
+	vector<MyPtr> list(manager.begin(), manager.end());
+	EXPECT_EQ(static_cast<std::size_t>(N), list.size());
+	for (const MyPtr& cur : results[0]) {
+		EXPECT_TRUE(manager.addressesLocal(cur));
+		EXPECT_TRUE(contains(list, cur));
+	}
+}
@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2002-2015 Distributed and Parallel Systems Group,
+ *                Institute of Computer Science,
+ *               University of Innsbruck, Austria
+ *
+ * This file is part of the INSIEME Compiler and Runtime System.
+ *
+ * We provide the software of this file (below described as "INSIEME")
+ * under GPL Version 3.0 on an AS IS basis, and do not warrant its
+ * validity or performance.  We reserve the right to update, modify,
+ * or discontinue this software at any time.  We shall have no
+ * obligation to supply such updates or modifications or any other
+ * form of support to you.
+ *
+ * If you require different license terms for your intended use of the
+ * software, e.g. for proprietary commercial or industrial use, please
+ * contact us at:
+ *                   insieme@dps.uibk.ac.at
+ *
+ * We kindly ask you to acknowledge the use of this software in any
+ * publication or other disclosure of results by referring to the
+ * following citation:
+ *
+ * H. Jordan, P. Thoman, J. Durillo, S. Pellegrini, P. Gschwandtner,
+ * T. Fahringer, H. Moritsch. A Multi-Objective Auto-Tuning Framework
+ * for Parallel Codes, in Proc. of the Intl. Conference for High
+ * Performance Computing, Networking, Storage and Analysis (SC 2012),
+ * IEEE Computer Society Press, Nov. 2012, Salt Lake City, USA.
+ *
+ * All copyright notices must be kept intact.
+ *
+ * INSIEME depends on several third party software packages. Please
+ * refer to http://www.dps.uibk.ac.at/insieme/license.html for details
+ * regarding third party software licenses.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "insieme/utils/small_vector.h"
+#include "insieme/utils/string_utils.h"
+#include "insieme/utils/container_utils.h"
+
+namespace insieme {
+namespace utils {
+
+	TEST(SmallVector, Basic) {
+
+		SmallVector<int, 2> list;
+		EXPECT_TRUE(list.empty());
+		EXPECT_EQ(2u, list.capacity());
+		EXPECT_TRUE(list.isInline());
+
+		list.push_back(1);
+		list.push_back(2);
+		EXPECT_EQ(2u, list.size());
+		EXPECT_TRUE(list.isInline());
+		EXPECT_EQ("[1,2]", toString(list));
+
+		// exceeding the inline capacity moves elements to the heap
+		list.push_back(3);
+		EXPECT_FALSE(list.isInline());
+		EXPECT_EQ("[1,2,3]", toString(list));
+		EXPECT_EQ(1, list.front());
+		EXPECT_EQ(3, list.back());
+		EXPECT_EQ(2, list[1]);
+
+		list.pop_back();
+		EXPECT_EQ("[1,2]", toString(list));
+
+		list.clear();
+		EXPECT_TRUE(list.empty());
+	}
+
+	TEST(SmallVector, CopyMove) {
+
+		SmallVector<std::string, 2> a = { "a", "b" };
+		SmallVector<std::string, 2> b = { "c", "d", "e" };
+
+		// copies
+		SmallVector<std::string, 2> c = a;
+		SmallVector<std::string, 2> d = b;
+		EXPECT_EQ(a, c);
+		EXPECT_EQ(b, d);
+		EXPECT_TRUE(c.isInline());
+		EXPECT_FALSE(d.isInline());
+
+		// moves
+		SmallVector<std::string, 2> e = std::move(c);
+		SmallVector<std::string, 2> f = std::move(d);
+		EXPECT_EQ(a, e);
+		EXPECT_EQ(b, f);
+		EXPECT_TRUE(c.empty());
+		EXPECT_TRUE(d.empty());
+
+		// assignments
+		e = b;
+		f = a;
+		EXPECT_EQ(b, e);
+		EXPECT_EQ(a, f);
+
+		e = std::move(f);
+		EXPECT_EQ(a, e);
+
+		// swap between inline and heap storage
+		SmallVector<std::string, 2> g = { "x" };
+		SmallVector<std::string, 2> h = { "1", "2", "3", "4" };
+		g.swap(h);
+		EXPECT_EQ("[1,2,3,4]", toString(g));
+		EXPECT_EQ("[x]", toString(h));
+
+		// self assignment
+		g = g;
+		EXPECT_EQ("[1,2,3,4]", toString(g));
+	}
+
+	TEST(SmallVector, Modifiers) {
+
+		SmallVector<int, 3> list = { 1, 2, 3, 4, 5 };
+
+		list.erase(list.begin() + 1);
+		EXPECT_EQ("[1,3,4,5]", toString(list));
+
+		list.erase(list.begin(), list.begin() + 2);
+		EXPECT_EQ("[4,5]", toString(list));
+
+		list.insert(list.begin(), 7);
+		EXPECT_EQ("[7,4,5]", toString(list));
+
+		std::vector<int> other = { 8, 9 };
+		list.insert(list.begin() + 1, other.begin(), other.end());
+		EXPECT_EQ("[7,8,9,4,5]", toString(list));
+
+		list.resize(2);
+		EXPECT_EQ("[7,8]", toString(list));
+		list.resize(3);
+		EXPECT_EQ("[7,8,0]", toString(list));
+
+		// pushing an element of the container itself while growing
+		SmallVector<std::string, 1> strs = { "a" };
+		strs.push_back(strs[0]);
+		strs.push_back(strs[1]);
+		EXPECT_EQ("[a,a,a]", toString(strs));
+
+		// comparison
+		SmallVector<int, 3> a = { 1, 2 };
+		SmallVector<int, 3> b = { 1, 3 };
+		EXPECT_LT(a, b);
+		EXPECT_NE(a, b);
+		EXPECT_TRUE(all(a, [](int x) { return x > 0; }));
+	}
+
+} // end namespace utils
+} // end namespace insieme